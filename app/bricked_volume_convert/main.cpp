@@ -0,0 +1,95 @@
+#include <chrono>
+#include <iostream>
+
+#include <array>
+
+#include <scivis/common/zhongdian15.h>
+#include <scivis/io/bricked_vol_io.h>
+
+static const std::string rawVolPath = DATA_PATH_PREFIX"OSS/OSS000.raw";
+static const std::array<uint32_t, 3> rawDim = { 300, 350, 50 };
+static const std::array<float, 2> rawLonRng = { 100.05f, 129.95f };
+static const std::array<float, 2> rawLatRng = { -4.95f, 29.95f };
+
+static const std::string txtVolPath = DATA_PATH_PREFIX"salt.txt";
+static const float txtNullVal = 9999.f;
+static const std::array<uint32_t, 3> txtDim = { 720, 348, 35 };
+static const std::array<float, 2> txtLonRng = { -180.f, +180.f };
+static const std::array<float, 2> txtLatRng = { -75.24f, +84.75f };
+
+static const std::array<float, 2> hRng = { 1.f, 5316.f };
+
+static void report(const std::string& filePath, double sec)
+{
+	SciVis::BrickedVolumeData::FromFileParameters param;
+	param.filePath = filePath;
+	auto vol = SciVis::BrickedVolumeData::LoadFromFile(param);
+	if (!vol.ok) {
+		std::cout << vol.result.errMsg << std::endl;
+		return;
+	}
+
+	auto& hdr = vol.result.dat.GetHeader();
+	auto& brickPerVol = vol.result.dat.GetBrickPerVolume();
+	std::cout << filePath << ": " << brickPerVol[0] << "x" << brickPerVol[1] << "x" << brickPerVol[2]
+		<< " bricks of " << hdr.brickLen << "^3, value range [" << hdr.valRng[0] << ", " << hdr.valRng[1]
+		<< "], converted in " << sec << " s" << std::endl;
+}
+
+int main(int argc, char** argv)
+{
+	std::string errMsg;
+	{
+		auto startTime = std::chrono::steady_clock::now();
+
+		SciVis::RAWVolumeData::FromFileParameters loadParam;
+		loadParam.filePath = SciVis::GetDataPathPrefix() + rawVolPath;
+		loadParam.voxPerVol = rawDim;
+		loadParam.voxTy = SciVis::ESupportedVoxelType::UInt8;
+		loadParam.useMemoryMap = true;
+		loadParam.accessHint = SciVis::MappedFile::EAccessHint::Sequential;
+		auto vol = SciVis::RAWVolumeData::LoadFromFile(loadParam);
+		if (!vol.ok) {
+			errMsg = vol.result.errMsg;
+			goto ERR;
+		}
+
+		SciVis::BrickedVolumeData::ToFileParameters param;
+		param.filePath = loadParam.filePath + ".bvol";
+		param.lonRng = rawLonRng;
+		param.latRng = rawLatRng;
+		param.hRng = hRng;
+		if (!SciVis::Convertor::BrickedVolume::FromRAWVolume(vol.result.dat, param, &errMsg))
+			goto ERR;
+
+		report(param.filePath,
+			std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count());
+	}
+	{
+		auto startTime = std::chrono::steady_clock::now();
+
+		auto txtVol = SciVis::Loader::TXTVolume::LoadFromFile(
+			SciVis::GetDataPathPrefix() + txtVolPath, txtDim, txtNullVal, true, &errMsg);
+		if (!errMsg.empty())
+			goto ERR;
+
+		SciVis::BrickedVolumeData::ToFileParameters param;
+		param.filePath = SciVis::GetDataPathPrefix() + txtVolPath + ".bvol";
+		param.hasNullVal = true;
+		param.nullVal = txtNullVal;
+		param.lonRng = txtLonRng;
+		param.latRng = txtLatRng;
+		param.hRng = hRng;
+		if (!SciVis::Convertor::BrickedVolume::FromTXTVolume(txtVol, txtDim, param, &errMsg))
+			goto ERR;
+
+		report(param.filePath,
+			std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count());
+	}
+
+	return 0;
+
+ERR:
+	std::cerr << errMsg << std::endl;
+	return 1;
+}
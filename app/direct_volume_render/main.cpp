@@ -1,4 +1,7 @@
+#include <chrono>
+#include <iostream>
 #include <memory>
+#include <thread>
 
 #include <array>
 
@@ -9,8 +12,11 @@
 
 #include <common/osg.h>
 
+#include <scivis/data/vol_region.h>
+#include <scivis/data/vol_time_series.h>
 #include <scivis/io/tf_io.h>
 #include <scivis/io/tf_osg_io.h>
+#include <scivis/io/time_series_prefetcher.h>
 #include <scivis/io/vol_io.h>
 #include <scivis/io/vol_osg_io.h>
 #include <scivis/scalar_viser/direct_volume_renderer.h>
@@ -30,49 +36,146 @@ static const std::array<std::string, 11> volPaths = {
 		DATA_PATH_PREFIX"OSS/OSS108.raw",
 		DATA_PATH_PREFIX"OSS/OSS120.raw"
 };
-static const std::array<std::string, 11> volNames = {
-		"0", "1", "2", "3", "4", "5", "6", "7", "8", "9", "10"
-};
+static const std::string volName = "OSS";
 static const std::array<uint32_t, 3> dim = { 300, 350, 50 };
-static const std::array<uint8_t, 3> log2Dim = { 9, 9, 6 };
 static const std::array<float, 2> lonRng = { 100.05f, 129.95f };
 static const std::array<float, 2> latRng = { -4.95f, 29.95f };
 static const std::array<float, 2> hRng = { 1.f, 5316.f };
 static const float hScale = 150.f;
+// 只加载该地理范围内的体素，绘制范围随之调整。默认为整个体，缩小为某一海峡等子范围时，加载的时间与内存随之减少
+static const std::array<float, 2> roiLonRng = lonRng;
+static const std::array<float, 2> roiLatRng = latRng;
+static const std::array<float, 2> roiHRng = hRng;
 
 class DVRSwitchVolumeCallback : public osg::NodeCallback {
 private:
 	size_t currIdx;
 	clock_t prevClk;
 	std::shared_ptr<SciVis::ScalarViser::DirectVolumeRenderer> renderer;
+	std::shared_ptr<SciVis::TimeSeriesPrefetcher> prefetcher; // 为空时，体由AddTimeSeries加入
 
 public:
-	DVRSwitchVolumeCallback(std::shared_ptr<SciVis::ScalarViser::DirectVolumeRenderer> renderer)
-		: renderer(renderer), currIdx(0) {
+	DVRSwitchVolumeCallback(
+		std::shared_ptr<SciVis::ScalarViser::DirectVolumeRenderer> renderer,
+		std::shared_ptr<SciVis::TimeSeriesPrefetcher> prefetcher)
+		: renderer(renderer), prefetcher(prefetcher), currIdx(0) {
 		prevClk = clock();
 	}
 	virtual void operator()(osg::Node* node, osg::NodeVisitor* nv) {
 		auto currClk = clock();
 		auto duration = currClk - prevClk;
-		if (duration >= CLOCKS_PER_SEC / 3) {
-			++currIdx;
-			if (currIdx == renderer->GetVolumeNum())
-				currIdx = 0;
-			renderer->DisplayVolume(volNames[currIdx]);
-
+		if (duration >= CLOCKS_PER_SEC / 3 && !prefetcher) {
+			currIdx = currIdx + 1 == volPaths.size() ? 0 : currIdx + 1;
+			renderer->DisplayVolume(volName, currIdx);
 			prevClk = clock();
 		}
+		else if (duration >= CLOCKS_PER_SEC / 3) {
+			// 下一时间步尚未加载完成时，继续显示当前时间步，不阻塞绘制
+			auto nextIdx = currIdx + 1 == prefetcher->GetStepNum() ? 0 : currIdx + 1;
+			auto volTex = prefetcher->Acquire(nextIdx);
+			if (volTex) {
+				renderer->GetVolume(volName)->SetVolumeTexture(volTex);
+				currIdx = nextIdx;
+				prevClk = clock();
+			}
+			else if (prefetcher->HasFailed(nextIdx))
+				currIdx = nextIdx;
+		}
 
 		traverse(node, nv);
 	}
 };
 
+/*
+* 函数: addPrefetchedVolume
+* 功能: 时间步由工作线程从磁盘流式加载，并沿播放方向预取，首帧只需等待第0个时间步
+*/
+static std::shared_ptr<SciVis::TimeSeriesPrefetcher> addPrefetchedVolume(
+	SciVis::ScalarViser::DirectVolumeRenderer& dvr, const SciVis::VolumeRegion& region,
+	osg::ref_ptr<osg::Texture1D> tfTex, osg::ref_ptr<osg::Texture2D> tfTexPreInt, std::string& errMsg)
+{
+	SciVis::TimeSeriesPrefetcher::Parameters prefetchParam;
+	prefetchParam.memoryCap = static_cast<size_t>(64) << 20;
+	auto prefetcher = std::make_shared<SciVis::TimeSeriesPrefetcher>(
+		volPaths.size(), [region](size_t step) -> osg::ref_ptr<osg::Texture3D> {
+			SciVis::RAWVolumeData::FromFileParameters param;
+			param.filePath = volPaths[step];
+			param.voxPerVol = dim;
+			param.voxTy = SciVis::ESupportedVoxelType::UInt8;
+			param.region = region;
+			auto vol = SciVis::RAWVolumeData::LoadFromFile(param);
+			if (!vol.ok) {
+				std::cerr << vol.result.errMsg << std::endl;
+				return nullptr;
+			}
+			// 源数据为8位，以R8纹理绘制
+			return vol.result.dat.ToOSGTexture3D();
+		}, prefetchParam);
+
+	osg::ref_ptr<osg::Texture3D> volTex;
+	while (!(volTex = prefetcher->Acquire(0))) {
+		if (prefetcher->HasFailed(0)) {
+			errMsg = "Failed to load the first time step.";
+			return nullptr;
+		}
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+
+	dvr.AddVolume(volName, volTex, tfTex, tfTexPreInt, region.dim, false);
+	return prefetcher;
+}
+
+/*
+* 函数: addTimeSeries
+* 功能: 各时间步只存放相对前一步的差分（见VolumeTimeSeries），切换时间步时只改写并上传发生变化的体素
+*/
+static bool addTimeSeries(
+	SciVis::ScalarViser::DirectVolumeRenderer& dvr, const SciVis::VolumeRegion& region,
+	osg::ref_ptr<osg::Texture1D> tfTex, osg::ref_ptr<osg::Texture2D> tfTexPreInt, std::string& errMsg)
+{
+	auto series = std::make_shared<SciVis::VolumeTimeSeries>(SciVis::ESupportedVoxelType::UInt8, region.dim);
+	for (auto& volPath : volPaths) {
+		SciVis::RAWVolumeData::FromFileParameters param;
+		param.filePath = volPath;
+		param.voxPerVol = dim;
+		param.voxTy = SciVis::ESupportedVoxelType::UInt8;
+		param.region = region;
+		auto vol = SciVis::RAWVolumeData::LoadFromFile(param);
+		if (!vol.ok) {
+			errMsg = vol.result.errMsg;
+			return false;
+		}
+		series->AppendStep(vol.result.dat.GetData());
+	}
+	std::cout << "Time series: " << series->GetStepNum() << " steps in " << series->GetMemoryBytes()
+		<< " bytes (" << series->GetStepNum() * series->GetStepBytes() << " bytes uncompressed)" << std::endl;
+
+	if (!dvr.AddTimeSeries(volName, series, tfTex, tfTexPreInt, false)) {
+		errMsg = "Failed to add time series.";
+		return false;
+	}
+	return true;
+}
+
 int main(int argc, char** argv)
 {
 	QApplication app(argc, argv);
+	// 以--time-series启动时，时间步以差分序列驻留内存，否则由磁盘流式预取
+	auto useTimeSeries = argc > 1 && std::string(argv[1]) == "--time-series";
+
+	auto roi = SciVis::VolumeRegion::FromGeographic(dim,
+		SciVis::GeographicExtent(lonRng, latRng, hRng), SciVis::GeographicExtent(roiLonRng, roiLatRng, roiHRng));
+	if (!roi.ok) {
+		std::cerr << roi.result.errMsg << std::endl;
+		return 1;
+	}
+	auto region = roi.result.dat;
 
 	auto* viewer = new osgViewer::Viewer;
 	viewer->setUpViewInWindow(200, 50, 800, 600);
+	// 先创建图形上下文，使之后创建的体纹理按实际的非2的幂纹理支持情况确定尺寸
+	viewer->setRealizeOperation(new SciVis::VolumeTexture::NonPowerOfTwoQuery);
+	viewer->realize();
 	auto* manipulator = new osgGA::TrackballManipulator;
 	viewer->setCameraManipulator(manipulator);
 
@@ -88,30 +191,30 @@ int main(int argc, char** argv)
 	auto tfTexPreInt = mainWnd.GetPreIntegratedTFTexture();
 
 	std::string errMsg;
-	for (size_t i = 0; i < volPaths.size(); ++i) {
-		auto volU8Dat = SciVis::Loader::RAWVolume::LoadU8FromFile(
-			volPaths[i], dim, &errMsg);
-		if (!errMsg.empty())
+	std::shared_ptr<SciVis::TimeSeriesPrefetcher> prefetcher;
+	if (useTimeSeries) {
+		if (!addTimeSeries(*dvr, region, tfTex, tfTexPreInt, errMsg))
 			goto ERR;
-
-		auto volDat = SciVis::Convertor::RAWVolume::U8ToNormalizedFloat(volU8Dat);
-		auto volTex = SciVis::OSGConvertor::RAWVolume::
-			NormalizedFloatToTexture(volDat, dim, log2Dim);
-
-		dvr->AddVolume(volNames[i], volTex, tfTex, tfTexPreInt, dim, false);
-		auto vol = dvr->GetVolume(volNames[i]);
-		vol->SetLongtituteRange(lonRng[0], lonRng[1]);
-		vol->SetLatituteRange(latRng[0], latRng[1]);
+	}
+	else if (!(prefetcher = addPrefetchedVolume(*dvr, region, tfTex, tfTexPreInt, errMsg)))
+		goto ERR;
+	{
+		auto vol = dvr->GetVolume(volName);
+		vol->SetLongtituteRange(region.ext.lonRng[0], region.ext.lonRng[1]);
+		vol->SetLatituteRange(region.ext.latRng[0], region.ext.latRng[1]);
 		vol->SetHeightFromCenterRange(
-			static_cast<float>(osg::WGS_84_RADIUS_EQUATOR) + hScale * hRng[0],
-			static_cast<float>(osg::WGS_84_RADIUS_EQUATOR) + hScale * hRng[1]);
+			static_cast<float>(osg::WGS_84_RADIUS_EQUATOR) + hScale * region.ext.hRng[0],
+			static_cast<float>(osg::WGS_84_RADIUS_EQUATOR) + hScale * region.ext.hRng[1]);
 	}
 
 	mainWnd.UpdateFromRenderer();
 	mainWnd.show();
 
-	dvr->DisplayVolume(volNames[0]);
-	dvr->GetGroup()->addEventCallback(new DVRSwitchVolumeCallback(dvr));
+	if (useTimeSeries)
+		dvr->DisplayVolume(volName, 0);
+	else
+		dvr->DisplayVolume(volName);
+	dvr->GetGroup()->addEventCallback(new DVRSwitchVolumeCallback(dvr, prefetcher));
 	grp->addChild(dvr->GetGroup());
 
 	viewer->setSceneData(grp);
@@ -10,6 +10,7 @@
 #include <common/osg.h>
 
 #include <scivis/io/tf_io.h>
+#include <scivis/io/preprocess_cache.h>
 #include <scivis/io/tf_osg_io.h>
 #include <scivis/io/vol_io.h>
 #include <scivis/io/vol_osg_io.h>
@@ -20,7 +21,6 @@
 static const std::string volPath = DATA_PATH_PREFIX"salt.txt";
 static const float nullVal = 9999.f;
 static const std::array<uint32_t, 3> dim = { 720, 348, 35 };
-static const std::array<uint8_t, 3> log2Dim = { 10, 9, 6 };
 static const std::array<float, 2> lonRng = { -180.f, +180.f };
 static const std::array<float, 2> latRng = { -75.24f, +84.75f };
 static const std::array<float, 2> hRng = { 1.f, 5316.f };
@@ -32,6 +32,9 @@ int main(int argc, char** argv)
 
 	auto* viewer = new osgViewer::Viewer;
 	viewer->setUpViewInWindow(200, 50, 800, 600);
+	// 先创建图形上下文，使之后创建的体纹理按实际的非2的幂纹理支持情况确定尺寸
+	viewer->setRealizeOperation(new SciVis::VolumeTexture::NonPowerOfTwoQuery);
+	viewer->realize();
 	auto* manipulator = new osgGA::TrackballManipulator;
 	viewer->setCameraManipulator(manipulator);
 
@@ -47,15 +50,44 @@ int main(int argc, char** argv)
 
 	std::string errMsg;
 	{
-		auto txtVol = SciVis::Loader::TXTVolume::LoadFromFile(
-			SciVis::GetDataPathPrefix() + volPath, dim, nullVal, true, &errMsg);
-		if (!errMsg.empty())
+		// 解析与归一化的结果以文件内容为键持久化缓存，再次启动时直接映射，跳过文本解析
+		auto& preCache = SciVis::PreprocessCache::Instance();
+		preCache.SetDirectory(SciVis::GetDataPathPrefix() + DATA_PATH_PREFIX"cache");
+		uint64_t fileHash;
+		if (!SciVis::PreprocessCache::HashFile(SciVis::GetDataPathPrefix() + volPath, fileHash)) {
+			errMsg = "Invalid file path.";
 			goto ERR;
+		}
+		SciVis::PreprocessCache::Key key;
+		key.Add("NormalizedTXTVolume").Add(fileHash).Add(dim).Add(nullVal);
+		auto normalized = preCache.GetOrCompute<float>(key, static_cast<size_t>(dim[0]) * dim[1] * dim[2],
+			[&]() -> SciVis::ReteurnOrError<std::vector<float>> {
+			std::string loadErrMsg;
+			auto txtVol = SciVis::Loader::TXTVolume::LoadFromFile(
+				SciVis::GetDataPathPrefix() + volPath, dim, nullVal, true, &loadErrMsg);
+			if (!loadErrMsg.empty())
+				return loadErrMsg.c_str();
+			std::cout << "Parsed " << volPath << " at " << txtVol.parseMBPerSec << " MB/s" << std::endl;
+
+			SciVis::Convertor::RAWVolume::FloatToNormalizedFloatInPlace(
+				txtVol.dat, txtVol.valRng, nullVal);
+			return std::move(txtVol.dat);
+			});
+		if (!normalized.ok) {
+			errMsg = normalized.result.errMsg;
+			goto ERR;
+		}
+		std::cout << "Preprocess cache: " << preCache.GetHitCount() << " hit(s), "
+			<< preCache.GetMissCount() << " miss(es), "
+			<< (preCache.GetBytesSaved() >> 20) << " MB saved" << std::endl;
 
-		auto volDat = SciVis::Convertor::RAWVolume::FloatToNormalizedFloat(
-			txtVol.dat, txtVol.valRng, nullVal);
+		SciVis::VolumeQuantizer::Parameters quantParam;
+		quantParam.format = SciVis::VolumeQuantizer::EFormat::UNorm16;
+		SciVis::VolumeQuantizer::ErrorReport quantErr;
 		auto volTex = SciVis::OSGConvertor::RAWVolume::
-			NormalizedFloatToTexture(volDat, dim, log2Dim);
+			NormalizedFloatToQuantizedTexture(normalized.result.dat.ToVector(), dim, quantParam, &quantErr);
+		std::cout << "Quantized to R16, max error " << quantErr.maxAbsErr
+			<< ", RMS error " << quantErr.rmsErr << std::endl;
 
 		dvr->AddVolume(volPath, volTex, tfTex, dim);
 		auto vol = dvr->GetVolume(volPath);
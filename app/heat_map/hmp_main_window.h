@@ -97,6 +97,9 @@ public:
 	void SetVolume(std::shared_ptr<std::vector<float>> volDat, const std::array<uint32_t, 3>& dim)
 	{
 		heatMapWdgt.SetVolume(volDat, dim);
+		// 渐进式加载时体会被多次替换为更细的一级，窗口已显示时随之刷新
+		if (isVisible())
+			updateHeatMapWidget();
 	}
 
 	void SetTFTemplate(TransferFunctionWidget::TFTemplate tmplt)
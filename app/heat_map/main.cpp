@@ -1,4 +1,6 @@
+#include <chrono>
 #include <memory>
+#include <thread>
 
 #include <array>
 
@@ -9,6 +11,7 @@
 
 #include <common/osg.h>
 
+#include <scivis/io/progressive_vol_loader.h>
 #include <scivis/io/tf_io.h>
 #include <scivis/io/tf_osg_io.h>
 #include <scivis/io/vol_io.h>
@@ -20,18 +23,51 @@
 static const std::string volPath = DATA_PATH_PREFIX"OSS/OSS000.raw";
 static const std::string volName = "0";
 static const std::array<uint32_t, 3> dim = { 300, 350, 50 };
-static const std::array<uint8_t, 3> log2Dim = { 9, 9, 6 };
 static const std::array<float, 2> lonRng = { 100.05f, 129.95f };
 static const std::array<float, 2> latRng = { -4.95f, 29.95f };
 static const std::array<float, 2> hRng = { 1.f, 5316.f };
 static const float hScale = 100.f;
 
+static std::shared_ptr<std::vector<float>> levelToNormalizedFloat(const SciVis::ProgressiveVolumeLoader::Level& lvl)
+{
+	auto img = lvl.tex->getImage();
+	auto volDat = SciVis::Convertor::RAWVolume::U8ToNormalizedFloat(
+		img->data(), static_cast<size_t>(lvl.dim[0]) * lvl.dim[1] * lvl.dim[2]);
+	return std::make_shared<std::vector<float>>(std::move(volDat));
+}
+
+class HMPRefineVolumeCallback : public osg::NodeCallback {
+private:
+	std::shared_ptr<SciVis::ScalarViser::HeatMap3DRenderer> renderer;
+	std::shared_ptr<SciVis::ProgressiveVolumeLoader> loader;
+	HMPMainWindow* mainWnd;
+
+public:
+	HMPRefineVolumeCallback(
+		std::shared_ptr<SciVis::ScalarViser::HeatMap3DRenderer> renderer,
+		std::shared_ptr<SciVis::ProgressiveVolumeLoader> loader,
+		HMPMainWindow* mainWnd)
+		: renderer(renderer), loader(loader), mainWnd(mainWnd) {}
+	virtual void operator()(osg::Node* node, osg::NodeVisitor* nv) {
+		SciVis::ProgressiveVolumeLoader::Level lvl;
+		if (!loader->IsComplete() && loader->Poll(lvl)) {
+			renderer->GetVolume(volName)->SetVolumeTexture(lvl.tex);
+			mainWnd->SetVolume(levelToNormalizedFloat(lvl), lvl.dim);
+		}
+
+		traverse(node, nv);
+	}
+};
+
 int main(int argc, char** argv)
 {
 	QApplication app(argc, argv);
 
 	auto* viewer = new osgViewer::Viewer;
 	viewer->setUpViewInWindow(200, 50, 800, 600);
+	// 先创建图形上下文，使之后创建的体纹理按实际的非2的幂纹理支持情况确定尺寸
+	viewer->setRealizeOperation(new SciVis::VolumeTexture::NonPowerOfTwoQuery);
+	viewer->realize();
 	auto* manipulator = new osgGA::TrackballManipulator;
 	viewer->setCameraManipulator(manipulator);
 
@@ -45,15 +81,24 @@ int main(int argc, char** argv)
 
 	std::string errMsg;
 	{
-		auto volU8Dat = SciVis::Loader::RAWVolume::LoadU8FromFile(volPath, dim, &errMsg);
-		if (!errMsg.empty())
+		SciVis::RAWVolumeData::FromFileParameters param;
+		param.filePath = volPath;
+		param.voxPerVol = dim;
+		param.voxTy = SciVis::ESupportedVoxelType::UInt8;
+		param.useMemoryMap = true;
+		auto volDat = SciVis::RAWVolumeData::LoadFromFile(param);
+		if (!volDat.ok) {
+			errMsg = volDat.result.errMsg;
 			goto ERR;
+		}
 
-		auto volDat = SciVis::Convertor::RAWVolume::U8ToNormalizedFloat(volU8Dat);
-		auto volTex = SciVis::OSGConvertor::RAWVolume::
-			NormalizedFloatToTexture(volDat, dim, log2Dim, osg::Texture::LINEAR);
+		// 先显示预览级，之后由回调将纹理逐级细化到原始分辨率
+		auto loader = std::make_shared<SciVis::ProgressiveVolumeLoader>(volDat.result.dat);
+		SciVis::ProgressiveVolumeLoader::Level lvl;
+		while (!loader->Poll(lvl))
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
 
-		hmp->AddVolume(volName, volTex, tfTex);
+		hmp->AddVolume(volName, lvl.tex, tfTex);
 
 		auto vol = hmp->GetVolume(volName);
 		vol->SetLongtituteRange(lonRng[0], lonRng[1]);
@@ -65,8 +110,8 @@ int main(int argc, char** argv)
 			static_cast<float>(osg::WGS_84_RADIUS_EQUATOR) + hScale * hRng[0] +
 			static_cast<float>(osg::WGS_84_RADIUS_EQUATOR) + hScale * hRng[1]));
 
-		auto volDatShrd = std::make_shared<std::vector<float>>(volDat);
-		mainWnd.SetVolume(volDatShrd, dim);
+		mainWnd.SetVolume(levelToNormalizedFloat(lvl), lvl.dim);
+		hmp->GetGroup()->addEventCallback(new HMPRefineVolumeCallback(hmp, loader, &mainWnd));
 	}
 
 	mainWnd.UpdateFromRenderer();
@@ -21,7 +21,9 @@ int main(int argc, char** argv)
 		SciVis::RAWVolumeData::FromFileParameters{
 			voxPerVol,
 			SciVis::ESupportedVoxelType::UInt8,
-			volPath
+			volPath,
+			true,
+			SciVis::MappedFile::EAccessHint::Random
 		});
 	if (!volDat.ok)
 	{
@@ -41,7 +43,7 @@ int main(int argc, char** argv)
 
 		auto& vol = volDat.result.dat;
 		memcpy(img->data(),
-			vol.GetData().data() + vol.GetVoxelSize() * voxPerVol[0] * voxPerVol[1] * 10,
+			vol.GetData() + vol.GetVoxelSize() * voxPerVol[0] * voxPerVol[1] * 10,
 			vol.GetVoxelSize() * voxPerVol[0] * voxPerVol[1]);
 
 		rndrParam.heightMapTex = new osg::Texture2D;
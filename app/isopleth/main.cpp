@@ -49,11 +49,9 @@ int main(int argc, char** argv)
 		if (!errMsg.empty())
 			goto ERR;
 
-		auto volDat = SciVis::Convertor::RAWVolume::U8ToNormalizedFloat(volU8Dat);
-		auto volDatSmoothed = SciVis::Convertor::RAWVolume::RoughFloatToSmooth(volDat, dim);
-		auto volDatShrd = std::make_shared<std::vector<float>>(volDat);
-		auto volDatSmoothedShrd = std::make_shared<std::vector<float>>(volDatSmoothed);
-		mcb->AddVolume(volName, volDatShrd, volDatSmoothedShrd, dim);
+		auto volDatShrd = std::make_shared<std::vector<float>>(
+			SciVis::Convertor::RAWVolume::U8ToNormalizedFloat(volU8Dat));
+		mcb->AddVolume(volName, volDatShrd, dim);
 
 		auto vol = mcb->GetVolume(volName);
 		vol->SetLongtituteRange(lonRng[0], lonRng[1]);
@@ -66,7 +64,7 @@ int main(int argc, char** argv)
 			heights->emplace_back(h);
 		vol->MarchingSquare(30.f / 255.f, *heights);
 
-		mainWnd.SetVolumeAndHeights(volDatShrd, volDatSmoothedShrd, dim, heights);
+		mainWnd.SetVolumeAndHeights(volDatShrd, dim, heights);
 	}
 
 	mainWnd.UpdateFromRenderer();
@@ -89,7 +89,6 @@ public:
 
 	void SetVolumeAndHeights(
 		std::shared_ptr<std::vector<float>> volDat,
-		std::shared_ptr<std::vector<float>> volDatSmoothed,
 		const std::array<uint32_t, 3>& dim,
 		std::shared_ptr<std::vector<uint32_t>> heights)
 	{
@@ -103,7 +102,7 @@ public:
 		ui.horizontalSlider_IsoplethH->setValue(static_cast<int>(0));
 
 		this->heights = heights;
-		isoplethWdgt.SetVolume(volDat, volDatSmoothed, dim);
+		isoplethWdgt.SetVolume(volDat, dim);
 	}
 
 private:
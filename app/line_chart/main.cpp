@@ -42,7 +42,7 @@ int main(int argc, char** argv)
 	auto* viewer = new osgViewer::Viewer;
 	viewer->setUpViewInWindow(200, 50, 800, 600);
 
-	// 
+	// 相机
 	auto* manipulator = new osgGA::TrackballManipulator;
 	viewer->setCameraManipulator(manipulator);
 
@@ -27,7 +27,6 @@ static const std::vector<std::tuple<float, std::array<float, 4>>> isosurfaces =
 	std::make_tuple(160.f / 255.f, std::array<float, 4>{1.f, 0.f, 0.f, .5f})
 };
 static const std::array<uint32_t, 3> dim = { 300, 350, 50 };
-static const std::array<uint8_t, 3> log2Dim = { 9, 9, 6 };
 static const std::array<float, 2> lonRng = { 100.05f, 129.95f };
 static const std::array<float, 2> latRng = { -4.95f, 29.95f };
 static const std::array<float, 2> hRng = { 1.f, 5316.f };
@@ -124,6 +123,9 @@ int main(int argc, char** argv)
 
 	auto* viewer = new osgViewer::Viewer;
 	viewer->setUpViewInWindow(200, 50, 800, 600);
+	// 先创建图形上下文，使之后创建的体纹理按实际的非2的幂纹理支持情况确定尺寸
+	viewer->setRealizeOperation(new SciVis::VolumeTexture::NonPowerOfTwoQuery);
+	viewer->realize();
 	auto* manipulator = new osgGA::TrackballManipulator;
 	viewer->setCameraManipulator(manipulator);
 
@@ -148,14 +150,12 @@ int main(int argc, char** argv)
 		if (!errMsg.empty())
 			goto ERR;
 
-		auto volDat = SciVis::Convertor::RAWVolume::U8ToNormalizedFloat(volU8Dat);
-		auto volDatSmoothed = SciVis::Convertor::RAWVolume::RoughFloatToSmooth(volDat, dim);
+		auto volDat = std::make_shared<std::vector<float>>(
+			SciVis::Convertor::RAWVolume::U8ToNormalizedFloat(volU8Dat));
 		auto volTex = SciVis::OSGConvertor::RAWVolume::
-			NormalizedFloatToTexture(volDat, dim, log2Dim);
-		auto volTexSmoothed = SciVis::OSGConvertor::RAWVolume::
-			NormalizedFloatToTexture(volDatSmoothed, dim, log2Dim);
+			NormalizedFloatToNativeTexture(*volDat, dim);
 
-		misf->AddVolume(volName, volTex, volTexSmoothed, isosurfaces, dim);
+		misf->AddVolume(volName, volTex, volDat, isosurfaces, dim);
 		auto vol = misf->GetVolume(volName);
 		vol->SetLongtituteRange(lonRng[0], lonRng[1]);
 		vol->SetLatituteRange(latRng[0], latRng[1]);
@@ -28,6 +28,14 @@ static const float hScale = 200.f;
 
 int main()
 {
+	auto* viewer = new osgViewer::Viewer;
+	viewer->setUpViewInWindow(200, 50, 800, 600);
+	// 先创建图形上下文，使之后创建的体纹理按实际的非2的幂纹理支持情况确定尺寸
+	viewer->setRealizeOperation(new SciVis::VolumeTexture::NonPowerOfTwoQuery);
+	viewer->realize();
+	auto* manipulator = new osgGA::TrackballManipulator;
+	viewer->setCameraManipulator(manipulator);
+
 	std::array<osg::ref_ptr<osg::Texture3D>, SciVis::MultiVolumeRenderer::MaxVolumeNum> vols;
 	std::array<osg::ref_ptr<osg::Texture2D>, SciVis::MultiVolumeRenderer::MaxVolumeNum> tfPreInts;
 	for (int i = 0; i < 2; ++i)
@@ -36,7 +44,9 @@ int main()
 			SciVis::RAWVolumeData::FromFileParameters{
 				voxPerVols[i],
 				SciVis::ESupportedVoxelType::UInt8,
-				volPaths[i]
+				volPaths[i],
+				true,
+				SciVis::MappedFile::EAccessHint::Sequential
 			});
 		if (!volDat.ok)
 		{
@@ -55,11 +65,6 @@ int main()
 		tfPreInts[i] = tfDat.result.dat.ToPreIntegratedOSGTexture();
 	}
 
-	auto* viewer = new osgViewer::Viewer;
-	viewer->setUpViewInWindow(200, 50, 800, 600);
-	auto* manipulator = new osgGA::TrackballManipulator;
-	viewer->setCameraManipulator(manipulator);
-
 	osg::ref_ptr<osg::Group> grp = new osg::Group;
 	grp->addChild(createEarth());
 
@@ -0,0 +1,99 @@
+#include <iostream>
+#include <memory>
+
+#include <array>
+#include <vector>
+
+#include <osgGA/TrackballManipulator>
+#include <osgViewer/Viewer>
+
+#include <common/osg.h>
+
+#include <scivis/io/tf_osg_io.h>
+#include <scivis/scalar_viser/out_of_core_volume_renderer.h>
+
+// 由bricked_volume_convert生成的分块体，首次运行时在其旁生成各级（*.lod<k>.bvol）
+static const std::string volPath = DATA_PATH_PREFIX"OSS/OSS000.raw.bvol";
+static const float hScale = 150.f;
+
+int main(int argc, char** argv)
+{
+	auto* viewer = new osgViewer::Viewer;
+	viewer->setUpViewInWindow(200, 50, 800, 600);
+	auto* manipulator = new osgGA::TrackballManipulator;
+	viewer->setCameraManipulator(manipulator);
+
+	osg::ref_ptr<osg::Group> grp = new osg::Group;
+	grp->addChild(createEarth());
+
+	std::shared_ptr<SciVis::ScalarViser::OutOfCoreVolumeRenderer> renderer;
+	std::string errMsg;
+	{
+		SciVis::BrickedVolumeData::FromFileParameters param;
+		param.filePath = SciVis::GetDataPathPrefix() + volPath;
+		auto vol = SciVis::MultiresolutionBrickedVolumeData::LoadFromFile(param);
+		if (!vol.ok) {
+			std::cout << "Building levels of " << volPath << std::endl;
+			if (!SciVis::MultiresolutionBrickedVolumeData::BuildLevels(param.filePath, &errMsg))
+				goto ERR;
+			vol = SciVis::MultiresolutionBrickedVolumeData::LoadFromFile(param);
+			if (!vol.ok) {
+				errMsg = vol.result.errMsg;
+				goto ERR;
+			}
+		}
+		auto volPtr = std::make_shared<SciVis::MultiresolutionBrickedVolumeData>(std::move(vol.result.dat));
+		std::cout << volPath << ": " << volPtr->GetLevelNum() << " levels of " << volPtr->GetBrickLength()
+			<< "^3 bricks" << std::endl;
+
+		std::vector<std::pair<uint8_t, std::array<float, 4>>> tfPnts = {
+			{ 0, { { 0.f, 0.f, 0.f, 0.f } } },
+			{ 64, { { 0.f, 0.f, 1.f, .05f } } },
+			{ 128, { { 0.f, 1.f, 0.f, .1f } } },
+			{ 192, { { 1.f, 1.f, 0.f, .2f } } },
+			{ 255, { { 1.f, 0.f, 0.f, .3f } } }
+		};
+		// 块池为8x8x8个槽位，无论体多大，显存占用固定
+		SciVis::ScalarViser::OutOfCoreVolumeRenderer::Parameters rendererParam;
+		renderer = std::make_shared<SciVis::ScalarViser::OutOfCoreVolumeRenderer>(volPtr,
+			SciVis::OSGConvertor::TransferFunctionPoints::ToTexture(tfPnts),
+			SciVis::OSGConvertor::TransferFunctionPoints::ToPreIntgratedTexture(tfPnts),
+			rendererParam);
+
+		const auto& hdr = volPtr->GetHeader();
+		renderer->SetHeightFromCenterRange(
+			static_cast<float>(osg::WGS_84_RADIUS_EQUATOR) + hScale * hdr.hRng[0],
+			static_cast<float>(osg::WGS_84_RADIUS_EQUATOR) + hScale * hdr.hRng[1]);
+		renderer->SetDeltaT(hScale * (hdr.hRng[1] - hdr.hRng[0]) / volPtr->GetVoxelPerVolume()[2] * .3f);
+		renderer->SetMaxStepCount(800);
+	}
+
+	grp->addChild(renderer->GetGroup());
+	viewer->setSceneData(grp);
+
+	{
+		auto prevClk = clock();
+		auto prevReportClk = prevClk;
+		while (!viewer->done()) {
+			auto currClk = clock();
+			auto duration = currClk - prevClk;
+
+			if (duration >= CLOCKS_PER_SEC / 45) {
+				viewer->frame();
+				prevClk = clock();
+			}
+			if (currClk - prevReportClk >= CLOCKS_PER_SEC * 2) {
+				auto stats = renderer->GetStatistics();
+				std::cout << "Bricks selected: " << stats.selectedNum << ", missing: " << stats.missingNum
+					<< ", resident: " << stats.residentNum << std::endl;
+				prevReportClk = currClk;
+			}
+		}
+	}
+
+	return 0;
+
+ERR:
+	std::cerr << errMsg << std::endl;
+	return 1;
+}
@@ -42,7 +42,7 @@ int main(int argc, char** argv)
 	auto* viewer = new osgViewer::Viewer;
 	viewer->setUpViewInWindow(200, 50, 800, 600);
 
-	// 
+	// 相机
 	auto* manipulator = new osgGA::TrackballManipulator;
 	viewer->setCameraManipulator(manipulator);
 
@@ -54,10 +54,10 @@ int main(int argc, char** argv)
 	std::string errMsg;
 	{
 		std::vector<std::pair<const wchar_t*, float>> pieDat0;
-		pieDat0.push_back(std::make_pair(L"һ", 0.2f));
-		pieDat0.push_back(std::make_pair(L"ڶ", 0.3f));
-		pieDat0.push_back(std::make_pair(L"", 0.4f));
-		pieDat0.push_back(std::make_pair(L"ļ", 0.1f));
+		pieDat0.push_back(std::make_pair(L"第一季度", 0.2f));
+		pieDat0.push_back(std::make_pair(L"第二季度", 0.3f));
+		pieDat0.push_back(std::make_pair(L"第三季度", 0.4f));
+		pieDat0.push_back(std::make_pair(L"第四季度", 0.1f));
 		//pieDat0.push_back(std::make_pair(L"w", 0.15f));
 
 		if (!errMsg.empty())
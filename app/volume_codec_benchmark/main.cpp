@@ -0,0 +1,105 @@
+#include <chrono>
+#include <iostream>
+
+#include <array>
+
+#include <scivis/common/zhongdian15.h>
+#include <scivis/io/bricked_vol_io.h>
+
+static const std::array<std::string, 3> rawVolPaths = {
+	DATA_PATH_PREFIX"OSS/OSS000.raw",
+	DATA_PATH_PREFIX"OSS/OSS051.raw",
+	DATA_PATH_PREFIX"OSS/OSS120.raw"
+};
+static const std::array<uint32_t, 3> rawDim = { 300, 350, 50 };
+
+static const std::string txtVolPath = DATA_PATH_PREFIX"salt.txt";
+static const float txtNullVal = 9999.f;
+static const std::array<uint32_t, 3> txtDim = { 720, 348, 35 };
+
+static const uint32_t decodeRepeatNum = 10;
+
+/*
+* 函数: benchmark
+* 功能: 将体写为压缩的分块体文件，校验解码结果与原数据一致，并报告压缩率与多线程解码的吞吐量
+*/
+static bool benchmark(const void* dat, SciVis::ESupportedVoxelType voxTy, const std::array<uint32_t, 3>& dim,
+	SciVis::BrickedVolumeData::ToFileParameters param, std::string* errMsg)
+{
+	param.compression = SciVis::BrickedVolumeData::ECompression::DeltaBitPack;
+	if (!SciVis::BrickedVolumeData::DumpToFile(dat, voxTy, dim, param, errMsg))
+		return false;
+
+	SciVis::BrickedVolumeData::FromFileParameters loadParam;
+	loadParam.filePath = param.filePath;
+	auto vol = SciVis::BrickedVolumeData::LoadFromFile(loadParam);
+	if (!vol.ok) {
+		*errMsg = vol.result.errMsg;
+		return false;
+	}
+
+	auto& bricked = vol.result.dat;
+	size_t encodedBytes = 0;
+	for (auto& info : bricked.GetBrickInfos())
+		encodedBytes += static_cast<size_t>(info.size);
+	auto decodedBytes = bricked.GetBrickBytes() * bricked.GetBrickNum();
+
+	auto volBytes = static_cast<size_t>(dim[0]) * dim[1] * dim[2] * SciVis::RAWVolumeData::GetVoxelSize(voxTy);
+	std::vector<uint8_t> decoded(volBytes);
+	if (!bricked.ReadRegion({ { 0, 0, 0 } }, dim, decoded.data())
+		|| std::memcmp(decoded.data(), dat, volBytes) != 0) {
+		*errMsg = "Decoded volume differs from the source: " + param.filePath;
+		return false;
+	}
+
+	auto startTime = std::chrono::steady_clock::now();
+	for (uint32_t i = 0; i < decodeRepeatNum; ++i)
+		bricked.ReadRegion({ { 0, 0, 0 } }, dim, decoded.data());
+	auto sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+
+	std::cout << param.filePath << ": ratio " << static_cast<double>(decodedBytes) / encodedBytes
+		<< " (" << decodedBytes << " -> " << encodedBytes << " bytes), decode "
+		<< decodedBytes * decodeRepeatNum / sec / (1 << 30) << " GB/s on "
+		<< SciVis::GetWorkerThreadNum() << " threads" << std::endl;
+	return true;
+}
+
+int main(int argc, char** argv)
+{
+	std::string errMsg;
+	for (auto& rawVolPath : rawVolPaths) {
+		SciVis::RAWVolumeData::FromFileParameters loadParam;
+		loadParam.filePath = SciVis::GetDataPathPrefix() + rawVolPath;
+		loadParam.voxPerVol = rawDim;
+		loadParam.voxTy = SciVis::ESupportedVoxelType::UInt8;
+		auto vol = SciVis::RAWVolumeData::LoadFromFile(loadParam);
+		if (!vol.ok) {
+			errMsg = vol.result.errMsg;
+			goto ERR;
+		}
+
+		SciVis::BrickedVolumeData::ToFileParameters param;
+		param.filePath = loadParam.filePath + ".cbvol";
+		if (!benchmark(vol.result.dat.GetData(), vol.result.dat.GetVoxelType(), rawDim, param, &errMsg))
+			goto ERR;
+	}
+	{
+		auto txtVol = SciVis::Loader::TXTVolume::LoadFromFile(
+			SciVis::GetDataPathPrefix() + txtVolPath, txtDim, txtNullVal, true, &errMsg);
+		if (!errMsg.empty())
+			goto ERR;
+
+		SciVis::BrickedVolumeData::ToFileParameters param;
+		param.filePath = SciVis::GetDataPathPrefix() + txtVolPath + ".cbvol";
+		param.hasNullVal = true;
+		param.nullVal = txtNullVal;
+		if (!benchmark(txtVol.dat.data(), SciVis::ESupportedVoxelType::Float32, txtDim, param, &errMsg))
+			goto ERR;
+	}
+
+	return 0;
+
+ERR:
+	std::cerr << errMsg << std::endl;
+	return 1;
+}
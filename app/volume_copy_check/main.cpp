@@ -0,0 +1,112 @@
+#include <atomic>
+#include <cstdlib>
+#include <iostream>
+#include <limits>
+#include <new>
+
+#include <array>
+
+#include <scivis/common/zhongdian15.h>
+#include <scivis/data/vol_data.h>
+#include <scivis/io/vol_io.h>
+#include <scivis/io/vol_osg_io.h>
+
+static const std::string rawVolPath = DATA_PATH_PREFIX"OSS/OSS000.raw";
+static const std::array<uint32_t, 3> rawDim = { 300, 350, 50 };
+
+static const std::string txtVolPath = DATA_PATH_PREFIX"salt.txt";
+static const float txtNullVal = 9999.f;
+static const std::array<uint32_t, 3> txtDim = { 720, 348, 35 };
+
+// 不小于该字节数的分配被视为体大小的分配
+static std::atomic<size_t> largeAllocThreshold(std::numeric_limits<size_t>::max());
+static std::atomic<size_t> largeAllocNum(0);
+
+/*
+* 替换全局的operator new，统计体大小的分配次数。
+* 注意：在Windows上各模块的运行时相互独立，OSG等动态库内部的分配不经过此处
+*/
+void* operator new(std::size_t sz)
+{
+	if (sz >= largeAllocThreshold.load(std::memory_order_relaxed))
+		largeAllocNum.fetch_add(1, std::memory_order_relaxed);
+	if (auto ptr = std::malloc(sz == 0 ? 1 : sz))
+		return ptr;
+	throw std::bad_alloc();
+}
+void operator delete(void* ptr) noexcept
+{
+	std::free(ptr);
+}
+
+/*
+* 函数: check
+* 功能: 报告自上次调用以来体大小的分配次数，并与预期次数比较
+*/
+static bool check(const std::string& stage, size_t expectedNum, std::string* errMsg)
+{
+	auto num = largeAllocNum.exchange(0);
+	std::cout << stage << ": " << num << " volume-sized allocation(s), expected " << expectedNum << std::endl;
+	if (num == expectedNum)
+		return true;
+
+	*errMsg = "Unexpected volume-sized allocations in: " + stage;
+	return false;
+}
+
+int main(int argc, char** argv)
+{
+	std::string errMsg;
+	{
+		// RAW -> 归一化 -> 纹理：加载与由8位转为浮点各分配一次，纹理直接接管归一化后的缓冲
+		auto voxNum = static_cast<size_t>(rawDim[0]) * rawDim[1] * rawDim[2];
+		largeAllocThreshold = voxNum;
+		largeAllocNum = 0;
+
+		SciVis::RAWVolumeData::FromFileParameters loadParam;
+		loadParam.filePath = SciVis::GetDataPathPrefix() + rawVolPath;
+		loadParam.voxPerVol = rawDim;
+		loadParam.voxTy = SciVis::ESupportedVoxelType::UInt8;
+		auto vol = SciVis::RAWVolumeData::LoadFromFile(loadParam);
+		if (!vol.ok) {
+			errMsg = vol.result.errMsg;
+			goto ERR;
+		}
+		if (!check("RAW load", 1, &errMsg))
+			goto ERR;
+
+		auto normalized = SciVis::Convertor::RAWVolume::U8ToNormalizedFloat(vol.result.dat.GetData(), voxNum);
+		if (!check("RAW normalize", 1, &errMsg))
+			goto ERR;
+
+		auto tex = SciVis::OSGConvertor::RAWVolume::NormalizedFloatToNativeTexture(std::move(normalized), rawDim);
+		if (!check("RAW texture", 0, &errMsg))
+			goto ERR;
+	}
+	{
+		// 文本体 -> 归一化 -> 纹理：浮点体原地归一化，纹理直接接管其缓冲
+		largeAllocThreshold = std::numeric_limits<size_t>::max();
+		auto txtVol = SciVis::Loader::TXTVolume::LoadFromFile(
+			SciVis::GetDataPathPrefix() + txtVolPath, txtDim, txtNullVal, true, &errMsg);
+		if (!errMsg.empty())
+			goto ERR;
+
+		largeAllocThreshold = static_cast<size_t>(txtDim[0]) * txtDim[1] * txtDim[2];
+		largeAllocNum = 0;
+
+		auto normalized = SciVis::Convertor::RAWVolume::FloatToNormalizedFloat(
+			std::move(txtVol.dat), txtVol.valRng, txtNullVal);
+		if (!check("TXT normalize", 0, &errMsg))
+			goto ERR;
+
+		auto tex = SciVis::OSGConvertor::RAWVolume::NormalizedFloatToNativeTexture(std::move(normalized), txtDim);
+		if (!check("TXT texture", 0, &errMsg))
+			goto ERR;
+	}
+
+	return 0;
+
+ERR:
+	std::cerr << errMsg << std::endl;
+	return 1;
+}
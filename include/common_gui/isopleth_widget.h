@@ -13,6 +13,8 @@
 #include <array>
 #include <vector>
 
+#include <scivis/data/smoothed_vol_cache.h>
+
 namespace Ui
 {
 	class HeatMapWidget;
@@ -70,7 +72,6 @@ private:
 	std::array<float, 2> scaleImgToVol;
 
 	std::shared_ptr<std::vector<float>> volDat;
-	std::shared_ptr<std::vector<float>> volDatSmoothed;
 
 	QGraphicsScene isoplethScn;
 	QImage isopleth;
@@ -96,11 +97,9 @@ public:
 
 	void SetVolume(
 		std::shared_ptr<std::vector<float>> volDat,
-		std::shared_ptr<std::vector<float>> volDatSmoothed,
 		const std::array<uint32_t, 3>& dim)
 	{
 		this->volDat = volDat;
-		this->volDatSmoothed = volDatSmoothed;
 		this->dim = dim;
 
 		dimYxX = static_cast<size_t>(dim[1]) * dim[0];
@@ -133,6 +132,10 @@ private:
 	void marchingSquare() {
 		isoplethScn.clear();
 
+		auto volDatSmoothed = currUseSmoothedVol ?
+			SciVis::SmoothedVolumeCache::Instance().Get(volDat, dim) : nullptr;
+		auto volDatUsed = currUseSmoothedVol ? volDatSmoothed->data() : volDat->data();
+
 		auto volDimYxX = static_cast<size_t>(dim[1]) * dim[0];
 		auto addLineSeg = [&](const std::array<uint32_t, 2>& startPos, const std::array<float, 4>& scalars,
 			const std::array<float, 4>& omegas, uint8_t mask) {
@@ -164,9 +167,7 @@ private:
 				// |  0 ---> 1  |
 				// +------------+
 				uint8_t cornerState = 0;
-				auto surfStart =
-					(currUseSmoothedVol ? volDatSmoothed->data() : volDat->data())
-					+ currZ * volDimYxX;
+				auto surfStart = volDatUsed + currZ * volDimYxX;
 				std::array<float, 4> scalars = {
 					surfStart[pos[1] * dim[0] + pos[0]],
 					surfStart[pos[1] * dim[0] + pos[0] + 1],
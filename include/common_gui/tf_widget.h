@@ -77,7 +77,7 @@ private:
 		virtual void mousePressEvent(QMouseEvent* ev) override
 		{
 			if (isCTRLPressed) {
-				// ӹؼ
+				// 添加关键点
 				auto scenePos = mapToScene(ev->pos());
 				auto scalar = static_cast<uint8_t>(scenePos.x());
 				if (scalar == 0 || scalar == 255) return;
@@ -134,7 +134,7 @@ private:
 				if (p.y() > View::AxHeight)
 					p.setY(View::AxHeight);
 
-				// ı˵xֵ
+				// 不改变两端的x值
 				if (scalar == 0)
 					p.setX(0.);
 				else if (scalar == 255)
@@ -167,11 +167,11 @@ private:
 	uint8_t prevScalar;
 	std::array<float, 4> prevColor;
 
-	std::array<int32_t, 2> tfDatDirtyRng; // ȷtfDatҪµķΧ
-	std::array<std::array<float, 4>, 256 > tfDat; // ݣtfPntsDatֻ
+	std::array<int32_t, 2> tfDatDirtyRng; // 用于确定tfDat需要更新的范围
+	std::array<std::array<float, 4>, 256 > tfDat; // 稠密数据，依赖于tfPntsDat，只用于输出
 
-	std::array<std::array<float, 4>, 256> tfPntsDat; // ϡؼ㣬[i][3]<0 ʾiΪ
-	std::array<Point*, 256> pnts; // tfPntsDatֻʾͽ
+	std::array<std::array<float, 4>, 256> tfPntsDat; // 稀疏关键点，[i][3]<0 表示i处为空
+	std::array<Point*, 256> pnts; // 依赖于tfPntsDat，只用于显示和交互
 
 	QGraphicsScene scn;
 	View view;
@@ -190,13 +190,13 @@ public:
 			std::array<float, 4> nullRGBA = { -1.f, -1.f, -1.f, -1.f };
 			this->tfPntsDat.fill(nullRGBA);
 			this->pnts.fill(nullptr);
-			// β˵
+			// 设置首尾端点
 			tfPntsDat[0] = std::array<float, 4>{0.f, 0.f, 0.f, 0.f};
 			tfPntsDat[255] = std::array<float, 4>{1.f, 1.f, 1.f, 1.f};
-			// гݾҪ
+			// 所有稠密数据均需要更新
 			tfDatDirtyRng[0] = 0;
 			tfDatDirtyRng[1] = 255;
-			// ޽
+			// 设置无交互点
 			prevColor = std::array<float, 4>{-1.f, -1.f, -1.f, -1.f};
 
 			updatePointFromData(0);
@@ -250,13 +250,13 @@ public:
 				prevColor = color;
 			});
 		connect(ui.pushButton_DeleteTFPoint, &QPushButton::clicked, [&]() {
-			if (prevColor[3] < 0.f) return; // ޽
-			if (prevScalar == 0 || prevScalar == 255) return; // ɾβ˵
+			if (prevColor[3] < 0.f) return; // 无交互点
+			if (prevScalar == 0 || prevScalar == 255) return; // 不能删除首尾端点
 
 			tfPntsDat[prevScalar][3] = -1.f;
 			updatePointFromData(prevScalar);
 
-			prevColor[3] = -1.f; // 
+			prevColor[3] = -1.f; // 清除交互点
 
 			emit TransferFunctionChanged(prevScalar, GetTransferFunctionPointColor(prevScalar));
 			});
@@ -417,7 +417,7 @@ private:
 
 	void updateTransferFunctionData()
 	{
-		// ҪԲֵ
+		// 不需要线性插值
 		if (tfDatDirtyRng[0] == -1) return;
 
 		uint8_t lft = (tfDatDirtyRng[0] > 0) ? tfDatDirtyRng[0] - 1 : 0;
@@ -427,7 +427,7 @@ private:
 		while (tfPntsDat[rhtEnd][3] < 0.f)
 			++rhtEnd;
 
-		// ʹԲֵϡtfPntsDat䵽ܵtfDat
+		// 使用线性插值，将稀疏的tfPntsDat填充到稠密的tfDat
 		uint8_t rht = lft + 1;
 		while (true) {
 			while (rht < rhtEnd && tfPntsDat[rht][3] < 0.f)
@@ -4,6 +4,7 @@
 #include <cmath>
 #include <array>
 #include <limits>
+#include <memory>
 #include <vector>
 
 #include <QtWidgets/qfiledialog.h>
@@ -27,9 +28,51 @@ class VolumeIOWidget : public QWidget
 	Q_OBJECT
 
 private:
+	/*
+	* 结构体: Volume
+	* 功能: 导入的归一化体。稀疏体保持稀疏存储，不展开为稠密体，其中无值的体素视为空值
+	*/
+	struct Volume
+	{
+		std::vector<float> dat;
+		std::shared_ptr<const SciVis::SparseVolumeData> sparse; // 体非稠密时，数据存于此处，dat为空
+
+		/*
+		* 函数: TrySample
+		* 功能: 查询体素的值
+		* 返回值: 体素为空值时返回false
+		*/
+		bool TrySample(uint32_t x, uint32_t y, uint32_t z, const std::array<uint32_t, 3>& dim, float& val) const
+		{
+			if (sparse)
+				return sparse->TrySample(x, y, z, val);
+
+			val = dat[(static_cast<size_t>(z) * dim[1] + y) * dim[0] + x];
+			return !std::isnan(val);
+		}
+		/*
+		* 函数: ToU8
+		* 功能: 转换为8位稠密体。RAW文件不能表示空值，空值写为0。稀疏体逐Z切片展开，不产生完整的稠密浮点体
+		*/
+		std::vector<uint8_t> ToU8(const std::array<uint32_t, 3>& dim) const
+		{
+			if (!sparse)
+				return SciVis::Convertor::RAWVolume::NormalizedFloatToU8(dat);
+
+			auto sliceVoxNum = static_cast<size_t>(dim[0]) * dim[1];
+			std::vector<uint8_t> u8Dat(sliceVoxNum * dim[2]);
+			for (uint32_t z = 0; z < dim[2]; ++z) {
+				auto slice = sparse->DensifyBrick({ { 0, 0, z } }, { { dim[0], dim[1], 1 } }, 0.f);
+				auto u8Slice = SciVis::Convertor::RAWVolume::NormalizedFloatToU8(slice);
+				std::copy(u8Slice.begin(), u8Slice.end(), u8Dat.begin() + z * sliceVoxNum);
+			}
+			return u8Dat;
+		}
+	};
+
 	std::array<uint32_t, 3> dim;
-	std::vector<float> vol;
-	std::vector<std::vector<float>> vols;
+	Volume vol;
+	std::vector<Volume> vols;
 	std::vector<QString> volNames;
 
 	QImage heatMap;
@@ -108,8 +151,8 @@ private:
 			float(dim[0]) / heatMap.width(),
 			float(dim[1]) / heatMap.height()
 		};
-		auto volZ = static_cast<size_t>(ui.horizontalSlider_HeatMapZ->value());
-		auto dimYxX = static_cast<size_t>(dim[1]) * dim[0];
+		auto volZ = static_cast<uint32_t>(ui.horizontalSlider_HeatMapZ->value());
+		auto emptyColor = QColor(Qt::gray).rgb();
 		const auto& vol = this->vols.empty() ? this->vol : this->vols[0];
 		for (int y = 0; y < heatMap.height(); ++y) {
 			auto pxPtr = reinterpret_cast<QRgb*>(heatMap.scanLine(y));
@@ -118,8 +161,11 @@ private:
 				volY = dim[1] - 1 - volY;
 				auto volX = static_cast<uint32_t>(floorf(x * scaleImgToVol[0]));
 
-				auto volIdx = volZ * dimYxX + volY * dim[0] + volX;
-				auto scalar = vol[volIdx];
+				float scalar;
+				if (!vol.TrySample(volX, volY, volZ, dim, scalar)) {
+					*pxPtr = emptyColor;
+					continue;
+				}
 
 				if (ui.comboBox_TFSrc->currentIndex() == static_cast<int>(ComboBoxIndex_TFSrc::NoSRC))
 					*pxPtr = qRgb(scalar * 255.f, scalar * 255.f, scalar * 255.f);
@@ -163,7 +209,7 @@ private:
 
 		clearVolumeData();
 		this->dim = dim;
-		this->vol = SciVis::Convertor::RAWVolume::U8ToNormalizedFloat(u8Dat);
+		this->vol.dat = SciVis::Convertor::RAWVolume::U8ToNormalizedFloat(u8Dat);
 
 		updateHeatMap();
 	}
@@ -185,10 +231,6 @@ private:
 			ui.label_ImportedLabeledTXT->setText(tr(errMsg.c_str()));
 			return;
 		}
-		if (!vol.isDense) {
-			ui.label_ImportedLabeledTXT->setText(tr("Sparse Labeled TXT Volume is NOT Supported"));
-			return;
-		}
 
 		ui.label_ImportedRAW->clear();
 		ui.label_ImportedTXT->clear();
@@ -220,7 +262,8 @@ private:
 
 		clearVolumeData();
 		this->dim = vol.dim;
-		this->vol = vol.dat;
+		this->vol.dat = std::move(vol.dat);
+		this->vol.sparse = vol.sparse;
 
 		updateHeatMap();
 	}
@@ -241,13 +284,8 @@ private:
 				ui.label_ImportedLabeledTXTTimeSeries->setText(tr(errMsg.c_str()));
 				return;
 			}
-			if (!vol.isDense) {
-				ui.label_ImportedLabeledTXTTimeSeries
-					->setText(tr("Sparse Labeled TXT Volume is NOT Supported"));
-				return;
-			}
 
-			vols.emplace_back(vol);
+			vols.emplace_back(std::move(vol));
 		}
 
 		auto dim = vols[0].dim;
@@ -310,7 +348,9 @@ private:
 		this->volNames.reserve(filePaths.size());
 		for (size_t i = 0; i < filePaths.size(); ++i) {
 			vols[i].Normalize(&valRng);
-			this->vols.emplace_back(vols[i].dat);
+			this->vols.emplace_back();
+			this->vols.back().dat = std::move(vols[i].dat);
+			this->vols.back().sparse = vols[i].sparse;
 
 			QFileInfo fileInfo(filePaths[i]);
 			this->volNames.emplace_back(fileInfo.baseName());
@@ -344,7 +384,7 @@ private:
 				this, tr("Open RAW File"), "./", tr("Binary (*.raw *.bin *.dat)"));
 			if (filePath.isEmpty()) return;
 
-			auto u8Dat = SciVis::Convertor::RAWVolume::NormalizedFloatToU8(vol);
+			auto u8Dat = vol.ToU8(dim);
 			SciVis::Loader::RAWVolume::DumpToFile(filePath.toStdString(), u8Dat);
 		}
 		else {
@@ -354,7 +394,7 @@ private:
 			if (dirPath.isEmpty()) return;
 
 			for (size_t i = 0; i < vols.size(); ++i) {
-				auto u8Dat = SciVis::Convertor::RAWVolume::NormalizedFloatToU8(vols[i]);
+				auto u8Dat = vols[i].ToU8(dim);
 				auto filePath = dirPath + '/' + volNames[i] + ".raw";
 				SciVis::Loader::RAWVolume::DumpToFile(filePath.toStdString(), u8Dat);
 			}
@@ -373,7 +413,7 @@ private:
 
 	void clearVolumeData()
 	{
-		vol.clear();
+		vol = Volume();
 		vols.clear();
 		volNames.clear();
 	}
@@ -0,0 +1,121 @@
+#ifndef SCIVIS_LOCK_FREE_QUEUE_H
+#define SCIVIS_LOCK_FREE_QUEUE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+#include <vector>
+
+namespace SciVis
+{
+	/*
+	* 类: LockFreeQueue
+	* 功能: 有界的多生产者多消费者无锁队列。每个槽位带有序号，生产者与消费者以CAS争夺队尾与队头的位置，
+	*       再以槽位序号确认槽位可写或可读，任何一方都不会阻塞另一方
+	*/
+	template <typename T>
+	class LockFreeQueue
+	{
+	public:
+		/*
+		* 函数: LockFreeQueue
+		* 参数:
+		* -- capacity: 队列容量，向上取整为2的幂
+		*/
+		explicit LockFreeQueue(size_t capacity)
+		{
+			size_t cap = 2;
+			while (cap < capacity)
+				cap *= 2;
+			mask = cap - 1;
+			cells = std::vector<Cell>(cap);
+			for (size_t i = 0; i < cap; ++i)
+				cells[i].seq.store(i, std::memory_order_relaxed);
+			head.store(0, std::memory_order_relaxed);
+			tail.store(0, std::memory_order_relaxed);
+		}
+		LockFreeQueue(const LockFreeQueue&) = delete;
+		LockFreeQueue& operator=(const LockFreeQueue&) = delete;
+
+		/*
+		* 函数: TryPush
+		* 返回值: 队列已满时返回false，val保持不变
+		*/
+		bool TryPush(T&& val)
+		{
+			auto pos = tail.load(std::memory_order_relaxed);
+			Cell* cell;
+			while (true) {
+				cell = &cells[pos & mask];
+				auto seq = cell->seq.load(std::memory_order_acquire);
+				auto diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+				if (diff == 0) {
+					if (tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+						break;
+				}
+				else if (diff < 0)
+					return false;
+				else
+					pos = tail.load(std::memory_order_relaxed);
+			}
+
+			cell->val = std::move(val);
+			cell->seq.store(pos + 1, std::memory_order_release);
+			return true;
+		}
+		/*
+		* 函数: TryPop
+		* 返回值: 队列为空时返回false
+		*/
+		bool TryPop(T& val)
+		{
+			auto pos = head.load(std::memory_order_relaxed);
+			Cell* cell;
+			while (true) {
+				cell = &cells[pos & mask];
+				auto seq = cell->seq.load(std::memory_order_acquire);
+				auto diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1);
+				if (diff == 0) {
+					if (head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+						break;
+				}
+				else if (diff < 0)
+					return false;
+				else
+					pos = head.load(std::memory_order_relaxed);
+			}
+
+			val = std::move(cell->val);
+			cell->val = T();
+			cell->seq.store(pos + mask + 1, std::memory_order_release);
+			return true;
+		}
+
+		size_t GetCapacity() const
+		{
+			return mask + 1;
+		}
+
+	private:
+		struct Cell
+		{
+			std::atomic<size_t> seq;
+			T val;
+
+			Cell() {}
+			Cell(const Cell&) : seq(0) {}
+		};
+
+		std::vector<Cell> cells;
+		size_t mask;
+		// 以填充使队头与队尾位于不同的缓存行，避免生产者与消费者之间的伪共享
+		char pad0[64];
+		std::atomic<size_t> head;
+		char pad1[64];
+		std::atomic<size_t> tail;
+	};
+}
+
+#endif // !SCIVIS_LOCK_FREE_QUEUE_H
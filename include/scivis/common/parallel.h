@@ -0,0 +1,56 @@
+#ifndef SCIVIS_PARALLEL_H
+#define SCIVIS_PARALLEL_H
+
+#include <algorithm>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+namespace SciVis
+{
+	inline uint32_t GetWorkerThreadNum()
+	{
+		auto num = std::thread::hardware_concurrency();
+		return num == 0 ? 1 : num;
+	}
+
+	/*
+	* 函数: ParallelFor
+	* 功能: 将[0, num)划分为连续的若干段，每段在一个线程上执行。最后一段在调用线程上执行
+	* 参数:
+	* -- num: 任务总数
+	* -- func: 形如func(thrdIdx, beg, end)的可调用对象，处理[beg, end)
+	* -- thrdNum: 线程数，为0时使用硬件并发数
+	*/
+	template <typename Func>
+	void ParallelFor(size_t num, const Func& func, uint32_t thrdNum = 0)
+	{
+		if (num == 0) return;
+		if (thrdNum == 0)
+			thrdNum = GetWorkerThreadNum();
+		if (thrdNum > num)
+			thrdNum = static_cast<uint32_t>(num);
+
+		auto numPerThrd = num / thrdNum;
+		auto numRemained = num % thrdNum;
+		std::vector<std::thread> thrds;
+		thrds.reserve(thrdNum - 1);
+
+		size_t beg = 0;
+		for (uint32_t i = 0; i < thrdNum; ++i) {
+			auto end = beg + numPerThrd + (i < numRemained ? 1 : 0);
+			if (i == thrdNum - 1)
+				func(i, beg, end);
+			else
+				thrds.emplace_back([&func, i, beg, end]() {
+				func(i, beg, end);
+					});
+			beg = end;
+		}
+
+		for (auto& thrd : thrds)
+			thrd.join();
+	}
+}
+
+#endif // !SCIVIS_PARALLEL_H
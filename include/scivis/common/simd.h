@@ -0,0 +1,209 @@
+#ifndef SCIVIS_SIMD_H
+#define SCIVIS_SIMD_H
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+
+#include <array>
+
+#if defined(__AVX2__)
+#define SCIVIS_SIMD_AVX2
+#endif
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SCIVIS_SIMD_SSE2
+#endif
+
+#ifdef SCIVIS_SIMD_AVX2
+#include <immintrin.h>
+#elif defined(SCIVIS_SIMD_SSE2)
+#include <emmintrin.h>
+#endif
+
+namespace SciVis
+{
+	/*
+	* 类: SIMD
+	* 功能: 体数据逐体素变换的向量化内核。编译时启用AVX2（CMake选项SCIVIS_ENABLE_AVX2）则使用AVX2，否则使用SSE2，均不可用时使用标量实现。
+	*       各实现的结果与标量实现逐位一致。所有内核只处理给定的区间，由调用者负责多线程划分
+	*/
+	class SIMD
+	{
+	public:
+		/*
+		* 函数: U8ToFloat
+		* 功能: dst[i] = src[i] / div
+		*/
+		static void U8ToFloat(const uint8_t* src, float* dst, size_t num, float div)
+		{
+			size_t i = 0;
+#ifdef SCIVIS_SIMD_AVX2
+			auto vDiv = _mm256_set1_ps(div);
+			for (; i + 8 <= num; i += 8) {
+				auto v8 = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(src + i));
+				auto v = _mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(v8));
+				_mm256_storeu_ps(dst + i, _mm256_div_ps(v, vDiv));
+			}
+#elif defined(SCIVIS_SIMD_SSE2)
+			auto vDiv = _mm_set1_ps(div);
+			auto zero = _mm_setzero_si128();
+			for (; i + 16 <= num; i += 16) {
+				auto v8 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+				auto lo16 = _mm_unpacklo_epi8(v8, zero);
+				auto hi16 = _mm_unpackhi_epi8(v8, zero);
+				_mm_storeu_ps(dst + i, _mm_div_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(lo16, zero)), vDiv));
+				_mm_storeu_ps(dst + i + 4, _mm_div_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(lo16, zero)), vDiv));
+				_mm_storeu_ps(dst + i + 8, _mm_div_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(hi16, zero)), vDiv));
+				_mm_storeu_ps(dst + i + 12, _mm_div_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(hi16, zero)), vDiv));
+			}
+#endif
+			for (; i < num; ++i)
+				dst[i] = src[i] / div;
+		}
+
+		/*
+		* 函数: FloatToU8
+		* 功能: dst[i] = src[i] * mul，截断取整并饱和到[0, 255]，NaN映射为0
+		*/
+		static void FloatToU8(const float* src, uint8_t* dst, size_t num, float mul)
+		{
+			size_t i = 0;
+#ifdef SCIVIS_SIMD_AVX2
+			auto vMul = _mm256_set1_ps(mul);
+			auto vMax = _mm256_set1_ps(255.f);
+			auto vZero = _mm256_setzero_ps();
+			for (; i + 16 <= num; i += 16) {
+				auto a = clampAVX2(_mm256_mul_ps(_mm256_loadu_ps(src + i), vMul), vZero, vMax);
+				auto b = clampAVX2(_mm256_mul_ps(_mm256_loadu_ps(src + i + 8), vMul), vZero, vMax);
+				auto i16 = _mm256_packs_epi32(_mm256_cvttps_epi32(a), _mm256_cvttps_epi32(b));
+				i16 = _mm256_permute4x64_epi64(i16, 0xd8);
+				auto u8 = _mm_packus_epi16(_mm256_castsi256_si128(i16), _mm256_extracti128_si256(i16, 1));
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), u8);
+			}
+#elif defined(SCIVIS_SIMD_SSE2)
+			auto vMul = _mm_set1_ps(mul);
+			auto vMax = _mm_set1_ps(255.f);
+			auto vZero = _mm_setzero_ps();
+			for (; i + 16 <= num; i += 16) {
+				__m128i i32[4];
+				for (uint8_t j = 0; j < 4; ++j)
+					i32[j] = _mm_cvttps_epi32(
+						clampSSE2(_mm_mul_ps(_mm_loadu_ps(src + i + 4 * j), vMul), vZero, vMax));
+				auto u8 = _mm_packus_epi16(_mm_packs_epi32(i32[0], i32[1]), _mm_packs_epi32(i32[2], i32[3]));
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), u8);
+			}
+#endif
+			for (; i < num; ++i) {
+				auto v = src[i] * mul;
+				dst[i] = v > 0.f ? static_cast<uint8_t>(std::min(v, 255.f)) : 0;
+			}
+		}
+
+		/*
+		* 函数: MinMax
+		* 功能: 计算区间内除nullVal与NaN以外的最小值与最大值，结果与rng已有的值合并
+		*/
+		static void MinMax(const float* src, size_t num, float nullVal, std::array<float, 2>& rng)
+		{
+			size_t i = 0;
+#ifdef SCIVIS_SIMD_AVX2
+			auto vNull = _mm256_set1_ps(nullVal);
+			auto vPosInf = _mm256_set1_ps(std::numeric_limits<float>::infinity());
+			auto vNegInf = _mm256_set1_ps(-std::numeric_limits<float>::infinity());
+			auto vMin = _mm256_set1_ps(rng[0]);
+			auto vMax = _mm256_set1_ps(rng[1]);
+			for (; i + 8 <= num; i += 8) {
+				auto v = _mm256_loadu_ps(src + i);
+				auto isNull = _mm256_cmp_ps(v, vNull, _CMP_EQ_OQ);
+				// 操作数为NaN时_mm256_min_ps/_mm256_max_ps返回第二个操作数，因此NaN被忽略
+				vMin = _mm256_min_ps(_mm256_blendv_ps(v, vPosInf, isNull), vMin);
+				vMax = _mm256_max_ps(_mm256_blendv_ps(v, vNegInf, isNull), vMax);
+			}
+			alignas(32) float mins[8], maxs[8];
+			_mm256_store_ps(mins, vMin);
+			_mm256_store_ps(maxs, vMax);
+			for (uint8_t j = 0; j < 8; ++j) {
+				rng[0] = std::min(rng[0], mins[j]);
+				rng[1] = std::max(rng[1], maxs[j]);
+			}
+#elif defined(SCIVIS_SIMD_SSE2)
+			auto vNull = _mm_set1_ps(nullVal);
+			auto vPosInf = _mm_set1_ps(std::numeric_limits<float>::infinity());
+			auto vNegInf = _mm_set1_ps(-std::numeric_limits<float>::infinity());
+			auto vMin = _mm_set1_ps(rng[0]);
+			auto vMax = _mm_set1_ps(rng[1]);
+			for (; i + 4 <= num; i += 4) {
+				auto v = _mm_loadu_ps(src + i);
+				auto isNull = _mm_cmpeq_ps(v, vNull);
+				vMin = _mm_min_ps(_mm_or_ps(_mm_and_ps(isNull, vPosInf), _mm_andnot_ps(isNull, v)), vMin);
+				vMax = _mm_max_ps(_mm_or_ps(_mm_and_ps(isNull, vNegInf), _mm_andnot_ps(isNull, v)), vMax);
+			}
+			alignas(16) float mins[4], maxs[4];
+			_mm_store_ps(mins, vMin);
+			_mm_store_ps(maxs, vMax);
+			for (uint8_t j = 0; j < 4; ++j) {
+				rng[0] = std::min(rng[0], mins[j]);
+				rng[1] = std::max(rng[1], maxs[j]);
+			}
+#endif
+			for (; i < num; ++i) {
+				auto v = src[i];
+				if (v == nullVal || v != v) continue;
+				if (rng[0] > v)
+					rng[0] = v;
+				if (rng[1] < v)
+					rng[1] = v;
+			}
+		}
+
+		/*
+		* 函数: Normalize
+		* 功能: dst[i] = src[i] == nullVal ? nullValMap : (src[i] - minVal) / dlt。dst可与src相同
+		*/
+		static void Normalize(const float* src, float* dst, size_t num,
+			float minVal, float dlt, float nullVal, float nullValMap)
+		{
+			size_t i = 0;
+#ifdef SCIVIS_SIMD_AVX2
+			auto vMin = _mm256_set1_ps(minVal);
+			auto vDlt = _mm256_set1_ps(dlt);
+			auto vNull = _mm256_set1_ps(nullVal);
+			auto vNullMap = _mm256_set1_ps(nullValMap);
+			for (; i + 8 <= num; i += 8) {
+				auto v = _mm256_loadu_ps(src + i);
+				auto n = _mm256_div_ps(_mm256_sub_ps(v, vMin), vDlt);
+				_mm256_storeu_ps(dst + i, _mm256_blendv_ps(n, vNullMap, _mm256_cmp_ps(v, vNull, _CMP_EQ_OQ)));
+			}
+#elif defined(SCIVIS_SIMD_SSE2)
+			auto vMin = _mm_set1_ps(minVal);
+			auto vDlt = _mm_set1_ps(dlt);
+			auto vNull = _mm_set1_ps(nullVal);
+			auto vNullMap = _mm_set1_ps(nullValMap);
+			for (; i + 4 <= num; i += 4) {
+				auto v = _mm_loadu_ps(src + i);
+				auto n = _mm_div_ps(_mm_sub_ps(v, vMin), vDlt);
+				auto isNull = _mm_cmpeq_ps(v, vNull);
+				_mm_storeu_ps(dst + i, _mm_or_ps(_mm_and_ps(isNull, vNullMap), _mm_andnot_ps(isNull, n)));
+			}
+#endif
+			for (; i < num; ++i)
+				dst[i] = src[i] == nullVal ? nullValMap : (src[i] - minVal) / dlt;
+		}
+
+	private:
+#ifdef SCIVIS_SIMD_AVX2
+		static __m256 clampAVX2(__m256 v, __m256 minV, __m256 maxV)
+		{
+			// v为NaN时_mm256_max_ps返回第二个操作数，即映射为0
+			return _mm256_min_ps(_mm256_max_ps(v, minV), maxV);
+		}
+#elif defined(SCIVIS_SIMD_SSE2)
+		static __m128 clampSSE2(__m128 v, __m128 minV, __m128 maxV)
+		{
+			return _mm_min_ps(_mm_max_ps(v, minV), maxV);
+		}
+#endif
+	};
+}
+
+#endif // !SCIVIS_SIMD_H
@@ -1,6 +1,11 @@
 #ifndef SCIVIS_UTIL_H
 #define SCIVIS_UTIL_H
 
+#include <new>
+#include <string>
+#include <type_traits>
+#include <utility>
+
 namespace SciVis
 {
 	inline float Deg2Rad(float deg)
@@ -8,6 +13,11 @@ namespace SciVis
 		return deg * osg::PI / 180.f;
 	};
 
+	/*
+	* 结构体: ReteurnOrError
+	* 功能: 函数的返回结果或错误信息。结果以移动的方式传入与传出，返回大块数据（如体数据）时不产生拷贝，
+	*       结果也可以是只能移动的类型
+	*/
 	template <typename T>
 	struct ReteurnOrError
 	{
@@ -17,29 +27,66 @@ namespace SciVis
 			std::string errMsg;
 			T dat;
 
-			Result(const char* errMsg)
-			{
-				new (&this->errMsg) std::string(errMsg);
-			}
-			Result(const T& dat)
-			{
-				new (&this->dat) T(dat);
-			}
+			Result() {}
 			~Result() {}
 		} result;
 
-		ReteurnOrError(const char* errMsg) : ok(false), result(errMsg) {}
-		ReteurnOrError(const T& dat) : ok(true), result(dat) {}
-		ReteurnOrError(const ReteurnOrError& other)
+		ReteurnOrError(const char* errMsg) : ok(false)
+		{
+			new (&result.errMsg) std::string(errMsg);
+		}
+		ReteurnOrError(const T& dat) : ok(true)
+		{
+			new (&result.dat) T(dat);
+		}
+		ReteurnOrError(T&& dat) : ok(true)
+		{
+			new (&result.dat) T(std::move(dat));
+		}
+		ReteurnOrError(const ReteurnOrError& other) : ok(other.ok)
 		{
-			~ReteurnOrError();
-			ok = other.ok;
 			if (ok)
-				result = other.result;
+				new (&result.dat) T(other.result.dat);
 			else
-				result = other.result.errMsg.c_str();
+				new (&result.errMsg) std::string(other.result.errMsg);
 		}
-		~ReteurnOrError() {
+		ReteurnOrError(ReteurnOrError&& other)
+			noexcept(std::is_nothrow_move_constructible<T>::value) : ok(other.ok)
+		{
+			if (ok)
+				new (&result.dat) T(std::move(other.result.dat));
+			else
+				new (&result.errMsg) std::string(std::move(other.result.errMsg));
+		}
+		ReteurnOrError& operator=(const ReteurnOrError& other)
+		{
+			if (this != &other) {
+				ReteurnOrError tmp(other); // 拷贝失败时保持原值不变
+				*this = std::move(tmp);
+			}
+			return *this;
+		}
+		ReteurnOrError& operator=(ReteurnOrError&& other)
+			noexcept(std::is_nothrow_move_constructible<T>::value)
+		{
+			if (this != &other) {
+				destroy();
+				ok = other.ok;
+				if (ok)
+					new (&result.dat) T(std::move(other.result.dat));
+				else
+					new (&result.errMsg) std::string(std::move(other.result.errMsg));
+			}
+			return *this;
+		}
+		~ReteurnOrError()
+		{
+			destroy();
+		}
+
+	private:
+		void destroy()
+		{
 			if (ok)
 				result.dat.~T();
 			else
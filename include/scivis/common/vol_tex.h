@@ -0,0 +1,303 @@
+#ifndef SCIVIS_VOL_TEX_H
+#define SCIVIS_VOL_TEX_H
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+#include <array>
+#include <vector>
+
+#include <osg/GLExtensions>
+#include <osg/GraphicsThread>
+#include <osg/Texture3D>
+#include <osg/ValueObject>
+
+#include <scivis/data/vol_resampler.h>
+#include <scivis/io/preprocess_cache.h>
+
+namespace SciVis
+{
+	/*
+	* 枚举: ETextureSizePolicy
+	* 功能: 体数据上传为三维纹理时，纹理尺寸的确定方式
+	*/
+	enum class ETextureSizePolicy
+	{
+		Native = 0, // 保持体的原始尺寸（非2的幂纹理）。若NPOT纹理不被支持或尚未查询（见NonPowerOfTwoQuery），退化为PadToPowerOfTwo
+		PadToPowerOfTwo, // 体按原分辨率存放于2的幂纹理的一角，其余部分以边界体素填充
+		ResampleToPowerOfTwo // 重采样为2的幂尺寸
+	};
+
+	/*
+	* 类: VolumeTexture
+	* 功能: 体纹理的尺寸策略，以及纹理坐标缩放（体在纹理中所占的比例）的记录与查询。
+	*       着色器以volTexScale乘以体的归一化坐标得到纹理坐标，采样步长dSamplePos仍以体的尺寸计算
+	*/
+	class VolumeTexture
+	{
+	public:
+		/*
+		* 函数: NonPowerOfTwoSupported
+		* 功能: 当前环境是否支持非2的幂三维纹理，由NonPowerOfTwoQuery在图形上下文创建时据OpenGL扩展设置。
+		*       未经查询时不被采用，见ResolvePolicy
+		*/
+		static bool& NonPowerOfTwoSupported()
+		{
+			static bool supported = true;
+			return supported;
+		}
+		/*
+		* 函数: NonPowerOfTwoQueried
+		* 功能: NonPowerOfTwoSupported是否已由图形上下文查询得到
+		*/
+		static bool& NonPowerOfTwoQueried()
+		{
+			static bool queried = false;
+			return queried;
+		}
+
+		/*
+		* 类: NonPowerOfTwoQuery
+		* 功能: 在图形上下文创建时查询非2的幂纹理的支持情况，用法为
+		*       viewer->setRealizeOperation(new VolumeTexture::NonPowerOfTwoQuery); viewer->realize();
+		*       之后再创建纹理，使尺寸策略按实际支持情况确定
+		*/
+		class NonPowerOfTwoQuery : public osg::GraphicsOperation
+		{
+		public:
+			NonPowerOfTwoQuery()
+				: osg::GraphicsOperation("VolumeTexture::NonPowerOfTwoQuery", false)
+			{}
+
+			virtual void operator()(osg::GraphicsContext* gc) override
+			{
+				auto ext = gc->getState()->get<osg::GLExtensions>();
+				NonPowerOfTwoSupported() = ext->isTexture3DSupported
+					&& ext->isNonPowerOfTwoTextureNonMipMappedSupported;
+				NonPowerOfTwoQueried() = true;
+			}
+		};
+
+		/*
+		* 函数: ResolvePolicy
+		* 功能: 确定实际采用的尺寸策略。尚未查询或不支持非2的幂纹理时，Native在CPU上填充为2的幂尺寸，
+		*       因为OSG无法缩放三维图像（Image::scaleImage不支持r != 1）
+		*/
+		static ETextureSizePolicy ResolvePolicy(ETextureSizePolicy policy)
+		{
+			if (policy == ETextureSizePolicy::Native && (!NonPowerOfTwoQueried() || !NonPowerOfTwoSupported()))
+				return ETextureSizePolicy::PadToPowerOfTwo;
+			return policy;
+		}
+
+		/*
+		* 函数: GetTextureDimension
+		* 功能: 按尺寸策略计算纹理尺寸
+		*/
+		static std::array<uint32_t, 3> GetTextureDimension(
+			const std::array<uint32_t, 3>& volDim, ETextureSizePolicy policy)
+		{
+			if (ResolvePolicy(policy) == ETextureSizePolicy::Native)
+				return volDim;
+
+			std::array<uint32_t, 3> texDim = { 1, 1, 1 };
+			for (uint8_t i = 0; i < 3; ++i)
+				while (texDim[i] < volDim[i])
+					texDim[i] *= 2;
+			return texDim;
+		}
+
+		static void SetTextureCoordinateScale(osg::Texture3D* tex, const osg::Vec3& scale)
+		{
+			tex->setUserValue(TexCoordScaleKey(), scale);
+		}
+		/*
+		* 函数: GetTextureCoordinateScale
+		* 功能: 查询体在纹理中所占的比例。未记录时（纹理与体一一对应）返回(1,1,1)
+		*/
+		static osg::Vec3 GetTextureCoordinateScale(const osg::Texture3D* tex)
+		{
+			osg::Vec3 scale(1.f, 1.f, 1.f);
+			if (tex)
+				tex->getUserValue(TexCoordScaleKey(), scale);
+			return scale;
+		}
+
+		/*
+		* 函数: Create
+		* 功能: 按尺寸策略将体数据上传为三维纹理，并记录纹理坐标缩放
+		* 参数:
+		* -- dat: 以X为最快变化维度排列的体数据。int16_t体素经ToTexels转换后上传
+		* -- volDim: 体的三维尺寸
+		* -- dataType: 体素的OpenGL数据类型
+		* -- internalFormat: 纹理的内部格式
+		* -- policy: 纹理尺寸策略
+		* -- filterMode: 纹理的过滤方式
+		* -- resampleParam: 策略为ResampleToPowerOfTwo时的重采样参数
+		*/
+		template <typename T>
+		static osg::ref_ptr<osg::Texture3D> Create(
+			const T* dat, const std::array<uint32_t, 3>& volDim,
+			GLenum dataType, GLint internalFormat,
+			ETextureSizePolicy policy = ETextureSizePolicy::Native,
+			osg::Texture::FilterMode filterMode = osg::Texture::LINEAR,
+			const VolumeResampler::Parameters& resampleParam = VolumeResampler::Parameters())
+		{
+			policy = ResolvePolicy(policy);
+			auto texDim = GetTextureDimension(volDim, policy);
+
+			osg::ref_ptr<osg::Image> img = new osg::Image;
+			img->allocateImage(texDim[0], texDim[1], texDim[2], GL_RED, dataType);
+			img->setInternalTextureFormat(internalFormat);
+			auto* pxPtr = reinterpret_cast<T*>(img->data());
+
+			osg::Vec3 scale(1.f, 1.f, 1.f);
+			switch (policy)
+			{
+			case ETextureSizePolicy::Native:
+				std::memcpy(pxPtr, dat, sizeof(T) * volDim[0] * volDim[1] * volDim[2]);
+				break;
+			case ETextureSizePolicy::PadToPowerOfTwo:
+				padTo(dat, volDim, pxPtr, texDim);
+				for (uint8_t i = 0; i < 3; ++i)
+					scale[i] = static_cast<float>(volDim[i]) / texDim[i];
+				break;
+			default:
+				resample(dat, volDim, pxPtr, texDim, resampleParam);
+				break;
+			}
+			ToTexels(pxPtr, static_cast<size_t>(texDim[0]) * texDim[1] * texDim[2]);
+
+			return createTexture(img, filterMode, scale);
+		}
+		/*
+		* 函数: Create
+		* 功能: 同上，但接管dat的缓冲。策略为Native时，纹理图像直接引用该缓冲，上传前不再拷贝体数据
+		*/
+		template <typename T>
+		static osg::ref_ptr<osg::Texture3D> Create(
+			std::vector<T>&& dat, const std::array<uint32_t, 3>& volDim,
+			GLenum dataType, GLint internalFormat,
+			ETextureSizePolicy policy = ETextureSizePolicy::Native,
+			osg::Texture::FilterMode filterMode = osg::Texture::LINEAR,
+			const VolumeResampler::Parameters& resampleParam = VolumeResampler::Parameters())
+		{
+			if (ResolvePolicy(policy) != ETextureSizePolicy::Native
+				|| dat.size() != static_cast<size_t>(volDim[0]) * volDim[1] * volDim[2])
+				return Create(dat.data(), volDim, dataType, internalFormat, policy, filterMode, resampleParam);
+
+			osg::ref_ptr<VectorImage<T>> img = new VectorImage<T>(std::move(dat));
+			ToTexels(img->buf.data(), img->buf.size());
+			img->setImage(volDim[0], volDim[1], volDim[2], internalFormat, GL_RED, dataType,
+				reinterpret_cast<unsigned char*>(img->buf.data()), osg::Image::NO_DELETE);
+
+			return createTexture(img.get(), filterMode, osg::Vec3(1.f, 1.f, 1.f));
+		}
+
+		/*
+		* 函数: ToTexels
+		* 功能: 将体素就地转换为纹理数据。int16_t体素加上32768（翻转符号位）存为无符号16位数据，
+		*       使其与uint16_t一样以GL_R16在着色器中采样为[0, 1]，与传输函数的定义域一致。其他类型不变
+		*/
+		static void ToTexels(int16_t* dat, size_t voxNum)
+		{
+			auto texels = reinterpret_cast<uint16_t*>(dat);
+			for (size_t i = 0; i < voxNum; ++i)
+				texels[i] ^= 0x8000;
+		}
+		template <typename T>
+		static void ToTexels(T*, size_t)
+		{}
+
+	private:
+		/*
+		* 类: VectorImage
+		* 功能: 持有std::vector缓冲的图像，缓冲随图像一同释放
+		*/
+		template <typename T>
+		class VectorImage : public osg::Image
+		{
+		public:
+			std::vector<T> buf;
+
+			VectorImage(std::vector<T>&& buf) : buf(std::move(buf)) {}
+		};
+
+		static osg::ref_ptr<osg::Texture3D> createTexture(
+			osg::Image* img, osg::Texture::FilterMode filterMode, const osg::Vec3& scale)
+		{
+			osg::ref_ptr<osg::Texture3D> tex = new osg::Texture3D;
+			tex->setFilter(osg::Texture::MAG_FILTER, filterMode);
+			tex->setFilter(osg::Texture::MIN_FILTER, filterMode);
+			tex->setWrap(osg::Texture::WRAP_S, osg::Texture::WrapMode::CLAMP_TO_EDGE);
+			tex->setWrap(osg::Texture::WRAP_T, osg::Texture::WrapMode::CLAMP_TO_EDGE);
+			tex->setWrap(osg::Texture::WRAP_R, osg::Texture::WrapMode::CLAMP_TO_EDGE);
+			tex->setInternalFormatMode(osg::Texture::InternalFormatMode::USE_IMAGE_DATA_FORMAT);
+			// 纹理尺寸已由ResolvePolicy确定。OSG默认在上传时将非2的幂图像缩放为2的幂尺寸，但无法缩放三维图像，故关闭
+			tex->setResizeNonPowerOfTwoHint(false);
+			tex->setImage(img);
+			SetTextureCoordinateScale(tex, scale);
+
+			return tex;
+		}
+
+		/*
+		* 函数: resample
+		* 功能: 将体重采样到纹理。设置了持久化缓存时，以体的内容、尺寸与重采样参数为键，跨进程重启复用之前的结果
+		*/
+		template <typename T>
+		static void resample(
+			const T* dat, const std::array<uint32_t, 3>& volDim,
+			T* pxPtr, const std::array<uint32_t, 3>& texDim,
+			const VolumeResampler::Parameters& resampleParam)
+		{
+			auto& preCache = PreprocessCache::Instance();
+			if (!preCache.IsEnabled()) {
+				VolumeResampler::Resample(dat, volDim, pxPtr, texDim, resampleParam);
+				return;
+			}
+
+			auto texVoxNum = static_cast<size_t>(texDim[0]) * texDim[1] * texDim[2];
+			PreprocessCache::Key key;
+			key.Add("VolumeResampler").Add(static_cast<uint32_t>(sizeof(T)))
+				.Add(PreprocessCache::Hash(dat, sizeof(T) * volDim[0] * volDim[1] * volDim[2]))
+				.Add(volDim).Add(texDim).Add(resampleParam.kernel);
+			auto resampled = preCache.GetOrCompute<T>(key, texVoxNum, [&]() -> ReteurnOrError<std::vector<T>> {
+				std::vector<T> ret(texVoxNum);
+				VolumeResampler::Resample(dat, volDim, ret.data(), texDim, resampleParam);
+				return std::move(ret);
+				});
+			if (resampled.ok)
+				std::memcpy(pxPtr, resampled.result.dat.data, sizeof(T) * texVoxNum);
+			else
+				VolumeResampler::Resample(dat, volDim, pxPtr, texDim, resampleParam);
+		}
+
+		/*
+		* 函数: padTo
+		* 功能: 将体复制到更大的纹理的一角，超出体的部分复制最近的边界体素，使线性过滤在体的边界处不受填充影响
+		*/
+		template <typename T>
+		static void padTo(const T* dat, const std::array<uint32_t, 3>& volDim,
+			T* dst, const std::array<uint32_t, 3>& texDim)
+		{
+			auto volYxX = static_cast<size_t>(volDim[1]) * volDim[0];
+			for (uint32_t z = 0; z < texDim[2]; ++z)
+				for (uint32_t y = 0; y < texDim[1]; ++y) {
+					auto srcRow = dat + std::min(z, volDim[2] - 1) * volYxX
+						+ static_cast<size_t>(std::min(y, volDim[1] - 1)) * volDim[0];
+					std::memcpy(dst, srcRow, sizeof(T) * volDim[0]);
+					std::fill(dst + volDim[0], dst + texDim[0], srcRow[volDim[0] - 1]);
+					dst += texDim[0];
+				}
+		}
+
+		static const char* TexCoordScaleKey()
+		{
+			return "SciVis.volTexScale";
+		}
+	};
+}
+
+#endif // !SCIVIS_VOL_TEX_H
@@ -17,7 +17,7 @@ namespace SciVis
 		auto p = AppEnv::instance().getPath(AppEnv::DATA_DIR);
 		return std::string(p.c_str()) + "/";
 #else
-		return ""; // ʹú·ǰ׺CMakeLists.txt
+		return ""; // 使用宏绝对路径前缀，见CMakeLists.txt
 #endif
 	}
 }
@@ -0,0 +1,542 @@
+#ifndef SCIVIS_DATA_BRICKED_VOL_DATA_H
+#define SCIVIS_DATA_BRICKED_VOL_DATA_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <memory>
+#include <string>
+
+#include <array>
+#include <vector>
+
+#include <scivis/common/parallel.h>
+#include <scivis/data/vol_data.h>
+#include <scivis/io/mapped_file.h>
+#include <scivis/io/vol_codec.h>
+
+namespace SciVis
+{
+	/*
+	* 类: BrickedVolumeData
+	* 功能: 分块存储的体数据文件。体被划分为brickLen^3的块，位于体边界处的块以边界体素填充至完整大小。
+	*       文件依次为文件头、块索引表与按页对齐的各块数据，以本机字节序（小端）存储：
+	*       -- 文件头：体的尺寸、体素类型、全局值域、空值以及经纬高范围
+	*       -- 块索引表：每块在文件中的偏移、大小，以及块内有效体素的最小值、最大值与均值
+	*       块可经VolumeCodec无损压缩，此时各块紧密排列，读取时逐块解码。
+	*       文件以内存映射方式打开，可随机读取任意块或任意子区域
+	*/
+	class BrickedVolumeData
+	{
+	public:
+		static constexpr uint32_t Version = 2; // 第2版在文件头末尾增加了srcFingerprint
+		static constexpr size_t BrickAlignment = 4096;
+
+		enum class ECompression
+		{
+			None = 0,
+			DeltaBitPack // 见VolumeCodec
+		};
+
+		struct Header
+		{
+			char magic[4];
+			uint32_t version;
+			uint32_t voxTy; // ESupportedVoxelType
+			uint32_t brickLen;
+			std::array<uint32_t, 3> dim;
+			uint32_t hasNullVal;
+			float nullVal;
+			std::array<float, 2> valRng; // 不含空值与NaN
+			std::array<float, 2> lonRng;
+			std::array<float, 2> latRng;
+			std::array<float, 2> hRng;
+			uint32_t compression; // ECompression
+			uint64_t brickNum;
+			uint64_t indexOffset;
+			uint64_t srcFingerprint; // 由其他文件生成时为源文件的指纹（见MultiresolutionBrickedVolumeData），否则为0
+		};
+		static_assert(sizeof(Header) == 96, "Header must have no padding");
+
+		struct BrickInfo
+		{
+			uint64_t offset;
+			uint64_t size; // 块在文件中的字节数。压缩时若等于GetBrickBytes()，表示该块编码后未变小而按原样存放
+			float minVal; // 以下统计不含空值、NaN与填充体素。validNum为0时均为0
+			float maxVal;
+			float mean;
+			uint32_t validNum;
+		};
+		static_assert(sizeof(BrickInfo) == 32, "BrickInfo must have no padding");
+
+		struct ToFileParameters
+		{
+			std::string filePath;
+			uint32_t brickLen = 32;
+			ECompression compression = ECompression::None;
+			bool hasNullVal = false;
+			float nullVal = 0.f;
+			std::array<float, 2> lonRng = { { 0.f, 0.f } };
+			std::array<float, 2> latRng = { { 0.f, 0.f } };
+			std::array<float, 2> hRng = { { 0.f, 0.f } };
+			uint64_t srcFingerprint = 0;
+		};
+
+		struct FromFileParameters
+		{
+			std::string filePath;
+			MappedFile::EAccessHint accessHint = MappedFile::EAccessHint::Random;
+		};
+
+		/*
+		* 函数: DumpToFile
+		* 功能: 将稠密体数据分块写入文件。块按Z层逐层在多个线程上组装并统计，组装完一层即写出一层，
+		*       因此额外内存只有一层块的大小
+		* 参数:
+		* -- dat: 以X为最快变化维度排列的体数据，类型由voxTy指定
+		* -- voxTy: 体素类型
+		* -- dim: 体的三维尺寸
+		* -- param: 写入参数
+		* -- errMsg: 若不为空，写入失败时写入错误信息
+		*/
+		static bool DumpToFile(
+			const void* dat, ESupportedVoxelType voxTy, const std::array<uint32_t, 3>& dim,
+			const ToFileParameters& param, std::string* errMsg = nullptr)
+		{
+			auto dimYxX = static_cast<size_t>(dim[1]) * dim[0];
+			auto voxSz = RAWVolumeData::GetVoxelSize(voxTy);
+			auto src = static_cast<const uint8_t*>(dat);
+			return DumpToFile(voxTy, dim, param, [&](uint32_t y, uint32_t z, void* dst) {
+				std::memcpy(dst, src + (z * dimYxX + static_cast<size_t>(y) * dim[0]) * voxSz, dim[0] * voxSz);
+				}, errMsg);
+		}
+		/*
+		* 函数: DumpToFile
+		* 功能: 同上，体数据由getRow逐行提供，适用于数据不以稠密数组形式存在（如稀疏体）的情况
+		* 参数:
+		* -- getRow: 形如getRow(y, z, dst)的可调用对象，将第z层第y行的dim[0]个体素写入dst，会被多个线程同时调用
+		*/
+		template <typename GetRow>
+		static bool DumpToFile(
+			ESupportedVoxelType voxTy, const std::array<uint32_t, 3>& dim,
+			const ToFileParameters& param, const GetRow& getRow, std::string* errMsg = nullptr)
+		{
+			switch (voxTy)
+			{
+			case ESupportedVoxelType::UInt8:
+				return dumpToFile<uint8_t>(voxTy, dim, param, getRow, errMsg);
+			case ESupportedVoxelType::UInt16:
+				return dumpToFile<uint16_t>(voxTy, dim, param, getRow, errMsg);
+			case ESupportedVoxelType::Int16:
+				return dumpToFile<int16_t>(voxTy, dim, param, getRow, errMsg);
+			case ESupportedVoxelType::Float32:
+				return dumpToFile<float>(voxTy, dim, param, getRow, errMsg);
+			}
+			if (errMsg)
+				*errMsg = "Invalid voxTy.";
+			return false;
+		}
+
+		static ReteurnOrError<BrickedVolumeData> LoadFromFile(const FromFileParameters& param)
+		{
+			BrickedVolumeData vol;
+			vol.mapped = MappedFile::Open(param.filePath, param.accessHint);
+			if (!vol.mapped)
+				return "Invalid filePath.";
+
+			auto fileSz = vol.mapped->GetSize();
+			// 第1版的文件头没有srcFingerprint，先只读取各版共有的部分
+			const auto V1HeaderSize = offsetof(Header, srcFingerprint);
+			if (fileSz < V1HeaderSize)
+				return "Invalid file content, which is smaller than header.";
+			std::memcpy(&vol.header, vol.mapped->GetData(), V1HeaderSize);
+			auto& hdr = vol.header;
+			if (std::memcmp(hdr.magic, Magic(), 4) != 0)
+				return "Invalid file content, which is not a bricked volume.";
+			if (hdr.version == 1)
+				hdr.srcFingerprint = 0;
+			else if (hdr.version == Version) {
+				if (fileSz < sizeof(Header))
+					return "Invalid file content, which is smaller than header.";
+				std::memcpy(&hdr.srcFingerprint, vol.mapped->GetData() + V1HeaderSize, sizeof(hdr.srcFingerprint));
+			}
+			else
+				return "Unsupported bricked volume version.";
+			if (hdr.voxTy > static_cast<uint32_t>(ESupportedVoxelType::Float32))
+				return "Invalid voxTy.";
+			if (hdr.brickLen == 0 || hdr.dim[0] == 0 || hdr.dim[1] == 0 || hdr.dim[2] == 0)
+				return "Invalid brickLen or dim.";
+			if (hdr.compression > static_cast<uint32_t>(ECompression::DeltaBitPack))
+				return "Unsupported compression.";
+
+			vol.computeLayout();
+			if (hdr.brickNum != vol.GetBrickNum())
+				return "Invalid brickNum.";
+			if (hdr.indexOffset > fileSz || (fileSz - hdr.indexOffset) / sizeof(BrickInfo) < hdr.brickNum)
+				return "Invalid file content, which is not enough for index table.";
+
+			vol.brickInfos.resize(static_cast<size_t>(hdr.brickNum));
+			std::memcpy(vol.brickInfos.data(), vol.mapped->GetData() + hdr.indexOffset,
+				sizeof(BrickInfo) * vol.brickInfos.size());
+			auto maxBrickSz = vol.IsCompressed() ? VolumeCodec::GetMaxEncodedSize(
+				vol.brickBytes / RAWVolumeData::GetVoxelSize(vol.GetVoxelType()),
+				RAWVolumeData::GetVoxelSize(vol.GetVoxelType())) : vol.brickBytes;
+			for (auto& info : vol.brickInfos)
+				if ((vol.IsCompressed() ? info.size > maxBrickSz : info.size != vol.brickBytes)
+					|| info.offset > fileSz || fileSz - info.offset < info.size)
+					return "Invalid file content, which is not enough for bricks.";
+
+			return vol;
+		}
+
+		const Header& GetHeader() const
+		{
+			return header;
+		}
+		ESupportedVoxelType GetVoxelType() const
+		{
+			return static_cast<ESupportedVoxelType>(header.voxTy);
+		}
+		const std::array<uint32_t, 3>& GetVoxelPerVolume() const
+		{
+			return header.dim;
+		}
+		uint32_t GetBrickLength() const
+		{
+			return header.brickLen;
+		}
+		bool IsCompressed() const
+		{
+			return header.compression != static_cast<uint32_t>(ECompression::None);
+		}
+		/*
+		* 函数: GetBrickPerVolume
+		* 功能: 获取各轴上块的数量
+		*/
+		const std::array<uint32_t, 3>& GetBrickPerVolume() const
+		{
+			return brickPerVol;
+		}
+		size_t GetBrickNum() const
+		{
+			return static_cast<size_t>(brickPerVol[0]) * brickPerVol[1] * brickPerVol[2];
+		}
+		size_t GetBrickIndex(uint32_t bx, uint32_t by, uint32_t bz) const
+		{
+			return (static_cast<size_t>(bz) * brickPerVol[1] + by) * brickPerVol[0] + bx;
+		}
+		/*
+		* 函数: GetBrickBytes
+		* 功能: 获取每块数据的字节数，即brickLen^3个体素的大小
+		*/
+		size_t GetBrickBytes() const
+		{
+			return brickBytes;
+		}
+		const BrickInfo& GetBrickInfo(size_t brickIdx) const
+		{
+			return brickInfos[brickIdx];
+		}
+		const std::vector<BrickInfo>& GetBrickInfos() const
+		{
+			return brickInfos;
+		}
+
+		/*
+		* 函数: GetBrickData
+		* 功能: 获取块数据在文件映射中的地址，不发生拷贝。块被压缩时为编码流，大小为GetBrickInfo(brickIdx).size
+		*/
+		const uint8_t* GetBrickData(size_t brickIdx) const
+		{
+			return mapped->GetData() + brickInfos[brickIdx].offset;
+		}
+		/*
+		* 函数: ReadBrick
+		* 功能: 将块数据拷贝（或解码）到dst，dst的大小需不小于GetBrickBytes()
+		* 返回值: 块数据损坏时返回false
+		*/
+		bool ReadBrick(size_t brickIdx, void* dst) const
+		{
+			if (!IsCompressed() || brickInfos[brickIdx].size == brickBytes) {
+				std::memcpy(dst, GetBrickData(brickIdx), brickBytes);
+				return true;
+			}
+
+			auto voxSz = RAWVolumeData::GetVoxelSize(GetVoxelType());
+			return VolumeCodec::Decode(GetBrickData(brickIdx), static_cast<size_t>(brickInfos[brickIdx].size),
+				dst, brickBytes / voxSz, voxSz);
+		}
+
+		/*
+		* 函数: ReadRegion
+		* 功能: 读取体的子区域[beg, end)，只访问与其相交的块。各块在多个线程上拷贝（或解码）
+		* 参数:
+		* -- beg, end: 子区域的起止体素下标，需满足beg < end <= dim
+		* -- dst: 以X为最快变化维度排列的输出，大小需不小于子区域的体素数乘以体素大小
+		* 返回值: 子区域无效或块数据损坏时返回false
+		*/
+		bool ReadRegion(const std::array<uint32_t, 3>& beg, const std::array<uint32_t, 3>& end,
+			void* dst, uint32_t thrdNum = 0) const
+		{
+			for (uint8_t i = 0; i < 3; ++i)
+				if (beg[i] >= end[i] || end[i] > header.dim[i])
+					return false;
+
+			auto voxSz = RAWVolumeData::GetVoxelSize(GetVoxelType());
+			auto brickLen = header.brickLen;
+			std::array<uint32_t, 3> brickBeg, brickCnt;
+			for (uint8_t i = 0; i < 3; ++i) {
+				brickBeg[i] = beg[i] / brickLen;
+				brickCnt[i] = (end[i] - 1) / brickLen + 1 - brickBeg[i];
+			}
+			std::array<uint32_t, 3> outDim = { { end[0] - beg[0], end[1] - beg[1], end[2] - beg[2] } };
+			auto outYxX = static_cast<size_t>(outDim[1]) * outDim[0];
+			auto out = static_cast<uint8_t*>(dst);
+
+			std::vector<uint8_t> valids(GetWorkerThreadNum(), 1);
+			ParallelFor(static_cast<size_t>(brickCnt[0]) * brickCnt[1] * brickCnt[2],
+				[&](uint32_t thrdIdx, size_t idxBeg, size_t idxEnd) {
+				std::vector<uint8_t> decoded(IsCompressed() ? brickBytes : 0);
+				for (auto i = idxBeg; i < idxEnd; ++i) {
+					std::array<uint32_t, 3> b = { {
+						brickBeg[0] + static_cast<uint32_t>(i % brickCnt[0]),
+						brickBeg[1] + static_cast<uint32_t>(i / brickCnt[0] % brickCnt[1]),
+						brickBeg[2] + static_cast<uint32_t>(i / brickCnt[0] / brickCnt[1]) } };
+					auto brickIdx = GetBrickIndex(b[0], b[1], b[2]);
+					auto brick = GetBrickData(brickIdx);
+					if (IsCompressed()) {
+						if (!ReadBrick(brickIdx, decoded.data())) {
+							valids[thrdIdx] = 0;
+							return;
+						}
+						brick = decoded.data();
+					}
+
+					// 块与子区域相交部分的起止体素下标
+					std::array<uint32_t, 3> lo, hi;
+					for (uint8_t a = 0; a < 3; ++a) {
+						lo[a] = std::max(beg[a], b[a] * brickLen);
+						hi[a] = std::min(end[a], (b[a] + 1) * brickLen);
+					}
+					for (auto z = lo[2]; z < hi[2]; ++z)
+						for (auto y = lo[1]; y < hi[1]; ++y) {
+							auto local = (static_cast<size_t>(z - b[2] * brickLen) * brickLen + (y - b[1] * brickLen)) * brickLen
+								+ (lo[0] - b[0] * brickLen);
+							std::memcpy(out + ((z - beg[2]) * outYxX + static_cast<size_t>(y - beg[1]) * outDim[0] + (lo[0] - beg[0])) * voxSz,
+								brick + local * voxSz, (hi[0] - lo[0]) * voxSz);
+						}
+				}
+				}, std::min(thrdNum == 0 ? GetWorkerThreadNum() : thrdNum, static_cast<uint32_t>(valids.size())));
+
+			for (auto valid : valids)
+				if (!valid)
+					return false;
+			return true;
+		}
+		/*
+		* 函数: ReadVolume
+		* 功能: 读取整个体为稠密数组
+		*/
+		std::vector<uint8_t> ReadVolume(uint32_t thrdNum = 0) const
+		{
+			std::vector<uint8_t> dat(static_cast<size_t>(header.dim[0]) * header.dim[1] * header.dim[2]
+				* RAWVolumeData::GetVoxelSize(GetVoxelType()));
+			ReadRegion({ { 0, 0, 0 } }, header.dim, dat.data(), thrdNum);
+			return dat;
+		}
+
+	private:
+		Header header;
+		std::array<uint32_t, 3> brickPerVol;
+		size_t brickBytes;
+		std::vector<BrickInfo> brickInfos;
+		std::shared_ptr<MappedFile> mapped;
+
+		static const char* Magic()
+		{
+			return "SVBV";
+		}
+
+		static uint64_t alignUp(uint64_t v)
+		{
+			return (v + BrickAlignment - 1) / BrickAlignment * BrickAlignment;
+		}
+
+		void computeLayout()
+		{
+			for (uint8_t i = 0; i < 3; ++i)
+				brickPerVol[i] = (header.dim[i] + header.brickLen - 1) / header.brickLen;
+			brickBytes = static_cast<size_t>(header.brickLen) * header.brickLen * header.brickLen
+				* RAWVolumeData::GetVoxelSize(GetVoxelType());
+		}
+
+		template <typename T, typename GetRow>
+		static bool dumpToFile(
+			ESupportedVoxelType voxTy, const std::array<uint32_t, 3>& dim,
+			const ToFileParameters& param, const GetRow& getRow, std::string* errMsg)
+		{
+			auto setErr = [&](const char* msg) {
+				if (errMsg)
+					*errMsg = msg;
+				return false;
+			};
+			if (param.brickLen == 0 || dim[0] == 0 || dim[1] == 0 || dim[2] == 0)
+				return setErr("Invalid brickLen or dim.");
+
+			std::ofstream os(param.filePath, std::ios::out | std::ios::binary);
+			if (!os.is_open()) {
+				if (errMsg) {
+					*errMsg = "Invalid File Path: ";
+					errMsg->append(param.filePath);
+				}
+				return false;
+			}
+
+			BrickedVolumeData vol;
+			auto& hdr = vol.header;
+			std::memcpy(hdr.magic, Magic(), 4);
+			hdr.version = Version;
+			hdr.voxTy = static_cast<uint32_t>(voxTy);
+			hdr.brickLen = param.brickLen;
+			hdr.dim = dim;
+			hdr.hasNullVal = param.hasNullVal ? 1 : 0;
+			hdr.nullVal = param.nullVal;
+			hdr.valRng = { { 0.f, 0.f } };
+			hdr.lonRng = param.lonRng;
+			hdr.latRng = param.latRng;
+			hdr.hRng = param.hRng;
+			hdr.compression = static_cast<uint32_t>(param.compression);
+			hdr.srcFingerprint = param.srcFingerprint;
+			vol.computeLayout();
+			hdr.brickNum = vol.GetBrickNum();
+			hdr.indexOffset = sizeof(Header);
+
+			auto& brickPerVol = vol.brickPerVol;
+			auto brickLen = param.brickLen;
+			auto brickVoxNum = static_cast<size_t>(brickLen) * brickLen * brickLen;
+			auto brickStride = alignUp(vol.brickBytes);
+			auto datOffset = alignUp(hdr.indexOffset + sizeof(BrickInfo) * hdr.brickNum);
+			vol.brickInfos.resize(static_cast<size_t>(hdr.brickNum));
+
+			// 先占位写出文件头与索引表，块全部写出后再回填
+			std::vector<char> zeros(static_cast<size_t>(std::max(datOffset, brickStride)), 0);
+			os.write(zeros.data(), datOffset);
+
+			auto brickNumPerLayer = static_cast<size_t>(brickPerVol[0]) * brickPerVol[1];
+			std::vector<T> layer(brickNumPerLayer * brickVoxNum);
+			std::vector<std::vector<uint8_t>> encodeds(param.compression == ECompression::None ? 0 : brickNumPerLayer);
+			auto fileOffset = datOffset;
+			for (uint32_t bz = 0; bz < brickPerVol[2]; ++bz) {
+				ParallelFor(brickPerVol[1], [&](uint32_t, size_t byBeg, size_t byEnd) {
+					std::vector<T> row(dim[0]);
+					for (auto by = static_cast<uint32_t>(byBeg); by < byEnd; ++by) {
+						// 逐行取得体数据，分发到该行所经过的各块中，超出体的部分复制边界体素
+						for (uint32_t lz = 0; lz < brickLen; ++lz)
+							for (uint32_t ly = 0; ly < brickLen; ++ly) {
+								auto z = std::min(bz * brickLen + lz, dim[2] - 1);
+								auto y = std::min(by * brickLen + ly, dim[1] - 1);
+								getRow(y, z, row.data());
+								for (uint32_t bx = 0; bx < brickPerVol[0]; ++bx) {
+									auto brick = layer.data() + (static_cast<size_t>(by) * brickPerVol[0] + bx) * brickVoxNum;
+									auto dstRow = brick + (static_cast<size_t>(lz) * brickLen + ly) * brickLen;
+									auto x0 = bx * brickLen;
+									auto validLen = std::min(brickLen, dim[0] - x0);
+									std::memcpy(dstRow, row.data() + x0, sizeof(T) * validLen);
+									std::fill(dstRow + validLen, dstRow + brickLen, row[dim[0] - 1]);
+								}
+							}
+
+						for (uint32_t bx = 0; bx < brickPerVol[0]; ++bx)
+							vol.brickInfos[vol.GetBrickIndex(bx, by, bz)] = computeBrickInfo(
+								layer.data() + (static_cast<size_t>(by) * brickPerVol[0] + bx) * brickVoxNum,
+								brickLen, { {
+									std::min(brickLen, dim[0] - bx * brickLen),
+									std::min(brickLen, dim[1] - by * brickLen),
+									std::min(brickLen, dim[2] - bz * brickLen) } },
+								param.hasNullVal, param.nullVal);
+
+						if (encodeds.empty()) continue;
+						for (uint32_t bx = 0; bx < brickPerVol[0]; ++bx) {
+							auto i = static_cast<size_t>(by) * brickPerVol[0] + bx;
+							encodeds[i] = VolumeCodec::Encode(layer.data() + i * brickVoxNum, brickVoxNum, sizeof(T));
+						}
+					}
+					});
+
+				// 未压缩的块按页对齐，以便直接映射访问；压缩的块紧密排列
+				for (size_t i = 0; i < brickNumPerLayer; ++i) {
+					auto& info = vol.brickInfos[bz * brickNumPerLayer + i];
+					info.offset = fileOffset;
+					if (encodeds.empty()) {
+						info.size = vol.brickBytes;
+						os.write(reinterpret_cast<const char*>(layer.data() + i * brickVoxNum), vol.brickBytes);
+						os.write(zeros.data(), brickStride - vol.brickBytes);
+						fileOffset += brickStride;
+					}
+					else if (encodeds[i].size() >= vol.brickBytes) {
+						info.size = vol.brickBytes;
+						os.write(reinterpret_cast<const char*>(layer.data() + i * brickVoxNum), vol.brickBytes);
+						fileOffset += vol.brickBytes;
+					}
+					else {
+						info.size = encodeds[i].size();
+						os.write(reinterpret_cast<const char*>(encodeds[i].data()), encodeds[i].size());
+						fileOffset += encodeds[i].size();
+					}
+				}
+			}
+
+			hdr.valRng = { { std::numeric_limits<float>::max(), std::numeric_limits<float>::lowest() } };
+			for (auto& info : vol.brickInfos) {
+				if (info.validNum == 0) continue;
+				hdr.valRng[0] = std::min(hdr.valRng[0], info.minVal);
+				hdr.valRng[1] = std::max(hdr.valRng[1], info.maxVal);
+			}
+			if (hdr.valRng[0] > hdr.valRng[1])
+				hdr.valRng = { { 0.f, 0.f } };
+
+			os.seekp(0);
+			os.write(reinterpret_cast<const char*>(&hdr), sizeof(Header));
+			os.write(reinterpret_cast<const char*>(vol.brickInfos.data()), sizeof(BrickInfo) * vol.brickInfos.size());
+			if (!os.good())
+				return setErr("Failed to write file.");
+			os.close();
+
+			return true;
+		}
+
+		template <typename T>
+		static BrickInfo computeBrickInfo(const T* brick, uint32_t brickLen,
+			const std::array<uint32_t, 3>& validDim, bool hasNullVal, float nullVal)
+		{
+			BrickInfo info;
+			info.minVal = std::numeric_limits<float>::max();
+			info.maxVal = std::numeric_limits<float>::lowest();
+			info.validNum = 0;
+			auto sum = 0.;
+			for (uint32_t z = 0; z < validDim[2]; ++z)
+				for (uint32_t y = 0; y < validDim[1]; ++y) {
+					auto row = brick + (static_cast<size_t>(z) * brickLen + y) * brickLen;
+					for (uint32_t x = 0; x < validDim[0]; ++x) {
+						auto v = static_cast<float>(row[x]);
+						if (v != v || (hasNullVal && v == nullVal)) continue;
+						info.minVal = std::min(info.minVal, v);
+						info.maxVal = std::max(info.maxVal, v);
+						sum += v;
+						++info.validNum;
+					}
+				}
+
+			if (info.validNum == 0)
+				info.minVal = info.maxVal = info.mean = 0.f;
+			else
+				info.mean = static_cast<float>(sum / info.validNum);
+			return info;
+		}
+	};
+}
+
+#endif // !SCIVIS_DATA_BRICKED_VOL_DATA_H
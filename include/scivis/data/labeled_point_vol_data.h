@@ -0,0 +1,395 @@
+#ifndef SCIVIS_DATA_LABELED_POINT_VOL_DATA_H
+#define SCIVIS_DATA_LABELED_POINT_VOL_DATA_H
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <memory>
+#include <string>
+
+#include <array>
+#include <vector>
+
+#include <scivis/common/parallel.h>
+#include <scivis/common/util.h>
+#include <scivis/data/sparse_vol_data.h>
+#include <scivis/io/mapped_file.h>
+
+namespace SciVis
+{
+	/*
+	* 类: LabeledPointVolumeData
+	* 功能: 带经纬高标签的点记录（见Loader::LabeledTXTVolume）的列式二进制文件。
+	*       文件依次为文件头、各轴的坐标字典、各轴的坐标列与值列，各段按ColumnAlignment对齐，以本机字节序（小端）存储：
+	*       -- 文件头：记录数、各轴字典的大小、坐标列下标的字节数、有序与稠密标记以及值域与经纬高范围
+	*       -- 坐标字典：各轴升序排列、去重后的坐标取值，即网格在该轴上的坐标
+	*       -- 坐标列：每条记录在各轴字典中的下标，字典均不超过65536项时为uint16，否则为uint32
+	*       -- 值列：每条记录的值（float），缺失的值为NaN
+	*       记录按网格下标（X为最快变化维度）严格递增排列时置有序标记，此时稠密体的值列即为网格本身，可直接拷贝。
+	*       文件以内存映射方式打开，加载时无需任何文本解析
+	*/
+	class LabeledPointVolumeData
+	{
+	public:
+		static constexpr uint32_t Version = 1;
+		static constexpr size_t ColumnAlignment = 64;
+
+		struct Header
+		{
+			char magic[4];
+			uint32_t version;
+			uint32_t coordBytes; // 坐标列中每个下标的字节数，为2或4
+			uint32_t sorted; // 记录是否按网格下标严格递增排列
+			uint32_t dense; // 记录数是否等于网格的体素数
+			std::array<uint32_t, 3> dim; // 各轴字典的大小，即网格的三维尺寸
+			uint64_t recNum;
+			std::array<float, 2> valRng; // 不含NaN
+			std::array<float, 2> lonRng;
+			std::array<float, 2> latRng;
+			std::array<float, 2> hRng;
+			std::array<uint64_t, 3> axisOffsets;
+			std::array<uint64_t, 3> coordOffsets;
+			uint64_t valOffset;
+		};
+		static_assert(sizeof(Header) == 128, "Header must have no padding");
+
+		struct FromFileParameters
+		{
+			std::string filePath;
+			MappedFile::EAccessHint accessHint = MappedFile::EAccessHint::Sequential;
+		};
+
+		static const char* Magic()
+		{
+			return "SVLP";
+		}
+		/*
+		* 函数: IsLabeledPointVolume
+		* 功能: 由文件头的魔数判断数据是否为本格式
+		*/
+		static bool IsLabeledPointVolume(const uint8_t* dat, size_t sz)
+		{
+			return sz >= 4 && std::memcmp(dat, Magic(), 4) == 0;
+		}
+
+		/*
+		* 函数: DumpToFile
+		* 功能: 将点记录按列写入文件。记录分段取得，每段的各列写到各自的位置，因此额外内存只有一段记录的大小。
+		*       写出时检查记录是否有序，并统计值域
+		* 参数:
+		* -- filePath: 文件路径
+		* -- axes: 经度、纬度、高度各轴升序排列且去重的坐标取值
+		* -- recNum: 记录数
+		* -- getRecord: 形如getRecord(recIdx, coord, val)的可调用对象，将第recIdx条记录在各轴字典中的下标写入coord，值写入val
+		* -- errMsg: 若不为空，写入失败时写入错误信息
+		*/
+		template <typename GetRecord>
+		static bool DumpToFile(
+			const std::string& filePath, const std::array<const std::vector<float>*, 3>& axes,
+			size_t recNum, const GetRecord& getRecord, std::string* errMsg = nullptr)
+		{
+			auto setErr = [&](const char* msg) {
+				if (errMsg)
+					*errMsg = msg;
+				return false;
+			};
+			if (recNum == 0)
+				return setErr("Invalid recNum.");
+
+			Header hdr;
+			std::memcpy(hdr.magic, Magic(), 4);
+			hdr.version = Version;
+			std::array<std::array<float, 2>*, 3> rngs = { { &hdr.lonRng, &hdr.latRng, &hdr.hRng } };
+			for (uint8_t a = 0; a < 3; ++a) {
+				auto& axis = *axes[a];
+				if (axis.empty() || axis.size() > std::numeric_limits<uint32_t>::max())
+					return setErr("Invalid axes.");
+				for (size_t i = 1; i < axis.size(); ++i)
+					if (!(axis[i - 1] < axis[i]))
+						return setErr("Invalid axes, which are not ascending.");
+
+				hdr.dim[a] = static_cast<uint32_t>(axis.size());
+				(*rngs[a])[0] = axis.front();
+				(*rngs[a])[1] = axis.back();
+			}
+			hdr.coordBytes = std::max({ hdr.dim[0], hdr.dim[1], hdr.dim[2] }) <= 65536 ? 2 : 4;
+			hdr.recNum = recNum;
+			hdr.sorted = 1;
+			hdr.dense = recNum == static_cast<size_t>(hdr.dim[2]) * hdr.dim[1] * hdr.dim[0] ? 1 : 0;
+			hdr.valRng[0] = std::numeric_limits<float>::max();
+			hdr.valRng[1] = std::numeric_limits<float>::lowest();
+
+			uint64_t offset = sizeof(Header);
+			for (uint8_t a = 0; a < 3; ++a) {
+				hdr.axisOffsets[a] = offset = alignUp(offset);
+				offset += sizeof(float) * hdr.dim[a];
+			}
+			for (uint8_t a = 0; a < 3; ++a) {
+				hdr.coordOffsets[a] = offset = alignUp(offset);
+				offset += static_cast<uint64_t>(hdr.coordBytes) * recNum;
+			}
+			hdr.valOffset = alignUp(offset);
+
+			std::ofstream os(filePath, std::ios::out | std::ios::binary);
+			if (!os.is_open()) {
+				if (errMsg) {
+					*errMsg = "Invalid File Path: ";
+					errMsg->append(filePath);
+				}
+				return false;
+			}
+
+			// 各段均定位后写入，段间的对齐空隙自然补零。文件头在统计完成后回填
+			for (uint8_t a = 0; a < 3; ++a) {
+				os.seekp(hdr.axisOffsets[a]);
+				os.write(reinterpret_cast<const char*>(axes[a]->data()), sizeof(float) * hdr.dim[a]);
+			}
+
+			static constexpr size_t SegmentLen = 1 << 20;
+			std::array<std::vector<uint32_t>, 3> coords;
+			std::vector<uint16_t> coords16;
+			std::vector<float> vals;
+			for (uint8_t a = 0; a < 3; ++a)
+				coords[a].resize(std::min(recNum, SegmentLen));
+			vals.resize(coords[0].size());
+			if (hdr.coordBytes == 2)
+				coords16.resize(coords[0].size());
+
+			auto dimYxX = static_cast<uint64_t>(hdr.dim[1]) * hdr.dim[0];
+			uint64_t prevLinIdx = 0;
+			for (size_t segBeg = 0; segBeg < recNum; segBeg += SegmentLen) {
+				auto segLen = std::min(SegmentLen, recNum - segBeg);
+				for (size_t i = 0; i < segLen; ++i) {
+					std::array<uint32_t, 3> coord;
+					getRecord(segBeg + i, coord, vals[i]);
+					if (coord[0] >= hdr.dim[0] || coord[1] >= hdr.dim[1] || coord[2] >= hdr.dim[2])
+						return setErr("Invalid record, whose coordinate is out of axes.");
+					for (uint8_t a = 0; a < 3; ++a)
+						coords[a][i] = coord[a];
+
+					auto linIdx = coord[2] * dimYxX + static_cast<uint64_t>(coord[1]) * hdr.dim[0] + coord[0];
+					if (segBeg + i != 0 && linIdx <= prevLinIdx)
+						hdr.sorted = 0;
+					prevLinIdx = linIdx;
+
+					auto v = vals[i];
+					if (v != v) continue;
+					hdr.valRng[0] = std::min(hdr.valRng[0], v);
+					hdr.valRng[1] = std::max(hdr.valRng[1], v);
+				}
+
+				for (uint8_t a = 0; a < 3; ++a) {
+					os.seekp(hdr.coordOffsets[a] + hdr.coordBytes * segBeg);
+					if (hdr.coordBytes == 2) {
+						for (size_t i = 0; i < segLen; ++i)
+							coords16[i] = static_cast<uint16_t>(coords[a][i]);
+						os.write(reinterpret_cast<const char*>(coords16.data()), sizeof(uint16_t) * segLen);
+					}
+					else
+						os.write(reinterpret_cast<const char*>(coords[a].data()), sizeof(uint32_t) * segLen);
+				}
+				os.seekp(hdr.valOffset + sizeof(float) * segBeg);
+				os.write(reinterpret_cast<const char*>(vals.data()), sizeof(float) * segLen);
+			}
+			os.seekp(0);
+			os.write(reinterpret_cast<const char*>(&hdr), sizeof(Header));
+			if (!os.good())
+				return setErr("Failed to write file.");
+			os.close();
+
+			return true;
+		}
+
+		static ReteurnOrError<LabeledPointVolumeData> LoadFromFile(const FromFileParameters& param)
+		{
+			auto mapped = MappedFile::Open(param.filePath, param.accessHint);
+			if (!mapped)
+				return "Invalid filePath.";
+			return FromMappedFile(std::move(mapped));
+		}
+		/*
+		* 函数: FromMappedFile
+		* 功能: 由已映射的文件构建，只校验文件头与各段的范围，不读取各列
+		*/
+		static ReteurnOrError<LabeledPointVolumeData> FromMappedFile(std::shared_ptr<MappedFile> mapped)
+		{
+			LabeledPointVolumeData vol;
+			vol.mapped = std::move(mapped);
+
+			auto fileSz = vol.mapped->GetSize();
+			if (fileSz < sizeof(Header))
+				return "Invalid file content, which is smaller than header.";
+			std::memcpy(&vol.header, vol.mapped->GetData(), sizeof(Header));
+			auto& hdr = vol.header;
+			if (std::memcmp(hdr.magic, Magic(), 4) != 0)
+				return "Invalid file content, which is not a labeled point volume.";
+			if (hdr.version != Version)
+				return "Unsupported labeled point volume version.";
+			if (hdr.coordBytes != 2 && hdr.coordBytes != 4)
+				return "Invalid coordBytes.";
+			if (hdr.dim[0] == 0 || hdr.dim[1] == 0 || hdr.dim[2] == 0 || hdr.recNum == 0)
+				return "Invalid dim or recNum.";
+			if (hdr.coordBytes == 2 && std::max({ hdr.dim[0], hdr.dim[1], hdr.dim[2] }) > 65536)
+				return "Invalid coordBytes, which cannot index the axes.";
+			if ((hdr.dense != 0) != (hdr.recNum == vol.GetVoxelNum()))
+				return "Invalid dense flag.";
+
+			auto isInFile = [&](uint64_t offset, uint64_t elemSz, uint64_t num) {
+				return offset % sizeof(float) == 0 && offset <= fileSz && (fileSz - offset) / elemSz >= num;
+			};
+			for (uint8_t a = 0; a < 3; ++a)
+				if (!isInFile(hdr.axisOffsets[a], sizeof(float), hdr.dim[a]))
+					return "Invalid file content, which is not enough for axes.";
+			for (uint8_t a = 0; a < 3; ++a)
+				if (!isInFile(hdr.coordOffsets[a], hdr.coordBytes, hdr.recNum))
+					return "Invalid file content, which is not enough for coordinate columns.";
+			if (!isInFile(hdr.valOffset, sizeof(float), hdr.recNum))
+				return "Invalid file content, which is not enough for value column.";
+
+			return vol;
+		}
+
+		const Header& GetHeader() const
+		{
+			return header;
+		}
+		const std::array<uint32_t, 3>& GetVoxelPerVolume() const
+		{
+			return header.dim;
+		}
+		size_t GetVoxelNum() const
+		{
+			return static_cast<size_t>(header.dim[2]) * header.dim[1] * header.dim[0];
+		}
+		size_t GetRecordNumber() const
+		{
+			return static_cast<size_t>(header.recNum);
+		}
+		bool IsSorted() const
+		{
+			return header.sorted != 0;
+		}
+		bool IsDense() const
+		{
+			return header.dense != 0;
+		}
+
+		/*
+		* 函数: GetAxis
+		* 功能: 获取某轴（0为经度，1为纬度，2为高度）的坐标字典在文件映射中的地址，共GetVoxelPerVolume()[axis]项
+		*/
+		const float* GetAxis(uint8_t axis) const
+		{
+			return reinterpret_cast<const float*>(mapped->GetData() + header.axisOffsets[axis]);
+		}
+		/*
+		* 函数: GetCoordinate
+		* 功能: 获取第recIdx条记录在某轴字典中的下标
+		*/
+		uint32_t GetCoordinate(uint8_t axis, size_t recIdx) const
+		{
+			auto col = mapped->GetData() + header.coordOffsets[axis];
+			return header.coordBytes == 2 ? reinterpret_cast<const uint16_t*>(col)[recIdx]
+				: reinterpret_cast<const uint32_t*>(col)[recIdx];
+		}
+		/*
+		* 函数: GetValues
+		* 功能: 获取值列在文件映射中的地址，共GetRecordNumber()项
+		*/
+		const float* GetValues() const
+		{
+			return reinterpret_cast<const float*>(mapped->GetData() + header.valOffset);
+		}
+
+		/*
+		* 函数: ReadDense
+		* 功能: 构建稠密网格。记录有序且稠密时，值列即为网格，在多个线程上分段直接拷贝，不读取坐标列；
+		*       否则先以emptyVal填充，再按坐标列在多个线程上将各值散射到网格中
+		* 参数:
+		* -- dst: 以X为最快变化维度排列的输出，大小需不小于GetVoxelNum()
+		* -- emptyVal: 无记录的体素的填充值
+		* 返回值: 坐标列中存在超出字典的下标时返回false
+		*/
+		bool ReadDense(float* dst, float emptyVal, uint32_t thrdNum = 0) const
+		{
+			auto vals = GetValues();
+			if (IsSorted() && IsDense()) {
+				ParallelFor(GetVoxelNum(), [&](uint32_t, size_t beg, size_t end) {
+					std::memcpy(dst + beg, vals + beg, sizeof(float) * (end - beg));
+					}, thrdNum);
+				return true;
+			}
+
+			ParallelFor(GetVoxelNum(), [&](uint32_t, size_t beg, size_t end) {
+				std::fill(dst + beg, dst + end, emptyVal);
+				}, thrdNum);
+			auto dimYxX = static_cast<size_t>(header.dim[1]) * header.dim[0];
+			return forEachRecord([&](size_t recIdx, uint32_t x, uint32_t y, uint32_t z) {
+				dst[z * dimYxX + static_cast<size_t>(y) * header.dim[0] + x] = vals[recIdx];
+				}, thrdNum);
+		}
+		/*
+		* 函数: ReadVoxels
+		* 功能: 将各记录读为稀疏体的体素（见SparseVolumeData::FromVoxels），在多个线程上分段转换
+		* 返回值: 坐标列中存在超出字典的下标时返回false
+		*/
+		bool ReadVoxels(std::vector<SparseVolumeData::Voxel>& voxs, uint32_t thrdNum = 0) const
+		{
+			auto vals = GetValues();
+			voxs.resize(GetRecordNumber());
+			return forEachRecord([&](size_t recIdx, uint32_t x, uint32_t y, uint32_t z) {
+				voxs[recIdx] = SparseVolumeData::Voxel{ { { x, y, z } }, vals[recIdx] };
+				}, thrdNum);
+		}
+
+	private:
+		Header header;
+		std::shared_ptr<MappedFile> mapped;
+
+		LabeledPointVolumeData() {}
+
+		static uint64_t alignUp(uint64_t offset)
+		{
+			return (offset + ColumnAlignment - 1) / ColumnAlignment * ColumnAlignment;
+		}
+
+		/*
+		* 函数: forEachRecord
+		* 功能: 在多个线程上依次解出各记录的网格下标，并以func(recIdx, x, y, z)访问
+		*/
+		template <typename Func>
+		bool forEachRecord(const Func& func, uint32_t thrdNum) const
+		{
+			return header.coordBytes == 2 ? forEachRecord<uint16_t>(func, thrdNum)
+				: forEachRecord<uint32_t>(func, thrdNum);
+		}
+		template <typename T, typename Func>
+		bool forEachRecord(const Func& func, uint32_t thrdNum) const
+		{
+			std::array<const T*, 3> cols;
+			for (uint8_t a = 0; a < 3; ++a)
+				cols[a] = reinterpret_cast<const T*>(mapped->GetData() + header.coordOffsets[a]);
+
+			std::vector<uint8_t> valids(GetWorkerThreadNum(), 1);
+			ParallelFor(GetRecordNumber(), [&](uint32_t thrdIdx, size_t beg, size_t end) {
+				for (auto i = beg; i < end; ++i) {
+					uint32_t x = cols[0][i], y = cols[1][i], z = cols[2][i];
+					if (x >= header.dim[0] || y >= header.dim[1] || z >= header.dim[2]) {
+						valids[thrdIdx] = 0;
+						return;
+					}
+					func(i, x, y, z);
+				}
+				}, std::min(thrdNum == 0 ? GetWorkerThreadNum() : thrdNum, static_cast<uint32_t>(valids.size())));
+
+			for (auto valid : valids)
+				if (!valid)
+					return false;
+			return true;
+		}
+	};
+}
+
+#endif // !SCIVIS_DATA_LABELED_POINT_VOL_DATA_H
@@ -0,0 +1,311 @@
+#ifndef SCIVIS_DATA_MULTIRES_BRICKED_VOL_DATA_H
+#define SCIVIS_DATA_MULTIRES_BRICKED_VOL_DATA_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <mutex>
+#include <string>
+#include <type_traits>
+
+#include <array>
+#include <vector>
+
+#include <sys/stat.h>
+#include <sys/types.h>
+
+#include <scivis/data/bricked_vol_data.h>
+#include <scivis/io/preprocess_cache.h>
+
+namespace SciVis
+{
+	/*
+	* 类: MultiresolutionBrickedVolumeData
+	* 功能: 多分辨率分块体，即由分块体文件（见BrickedVolumeData）组成的八叉树。
+	*       第0级为原始分辨率的分块体文件，第k级各轴的体素数为第k-1级的一半（向上取整），由第k-1级每2x2x2个体素平均得到，
+	*       块的边长在各级之间相同，因此第k级的块(bx, by, bz)恰好覆盖第k-1级的块(2bx..2bx+1, 2by..2by+1, 2bz..2bz+1)。
+	*       最粗一级只有一个块。第k级保存在GetLevelFilePath(filePath, k)处，由BuildLevels从第0级生成。
+	*       第k级的体素i在第0级的体素坐标中覆盖[i * 2^k, (i + 1) * 2^k)，各级的归一化坐标均以第0级的尺寸换算。
+	*       各级的文件头记录生成时第0级的指纹，第0级被重新生成后，之前生成的各级不再被打开
+	*/
+	class MultiresolutionBrickedVolumeData
+	{
+	public:
+		/*
+		* 函数: GetLevelFilePath
+		* 功能: 获取第lvl级的文件路径。第0级即filePath，其余级在扩展名前插入".lod<lvl>"，如a.bvol的第1级为a.lod1.bvol
+		*/
+		static std::string GetLevelFilePath(const std::string& filePath, uint32_t lvl)
+		{
+			if (lvl == 0)
+				return filePath;
+
+			auto dot = filePath.find_last_of('.');
+			auto slash = filePath.find_last_of("/\\");
+			if (dot == std::string::npos || (slash != std::string::npos && dot < slash))
+				dot = filePath.size();
+			return filePath.substr(0, dot) + ".lod" + std::to_string(lvl) + filePath.substr(dot);
+		}
+		/*
+		* 函数: GetLevelNum
+		* 功能: 获取尺寸为dim、块边长为brickLen的体所需的级数，最粗一级只有一个块
+		*/
+		static uint32_t GetLevelNum(std::array<uint32_t, 3> dim, uint32_t brickLen)
+		{
+			uint32_t num = 1;
+			while (dim[0] > brickLen || dim[1] > brickLen || dim[2] > brickLen) {
+				for (uint8_t i = 0; i < 3; ++i)
+					dim[i] = (dim[i] + 1) / 2;
+				++num;
+			}
+			return num;
+		}
+
+		/*
+		* 函数: BuildLevels
+		* 功能: 由第0级的分块体文件逐级生成更粗的各级。第k级按Z层逐层由第k-1级读取2倍厚的区域并平均，
+		*       额外内存为第k-1级的两层块。平均时跳过空值与NaN，全部无效时写入空值（无空值时为NaN）。
+		*       块边长、压缩方式与空值沿用第0级，经纬高范围按第k级实际覆盖的体素扩展
+		* 参数:
+		* -- filePath: 第0级的文件路径
+		* -- errMsg: 若不为空，生成失败时写入错误信息
+		*/
+		static bool BuildLevels(const std::string& filePath, std::string* errMsg = nullptr)
+		{
+			BrickedVolumeData::FromFileParameters loadParam;
+			loadParam.filePath = filePath;
+			loadParam.accessHint = MappedFile::EAccessHint::Sequential;
+			auto lvl0 = BrickedVolumeData::LoadFromFile(loadParam);
+			if (!lvl0.ok) {
+				if (errMsg)
+					*errMsg = lvl0.result.errMsg;
+				return false;
+			}
+
+			const auto& hdr0 = lvl0.result.dat.GetHeader();
+			auto fingerprint = fingerprintOf(lvl0.result.dat, filePath);
+			auto lvlNum = GetLevelNum(hdr0.dim, hdr0.brickLen);
+			for (uint32_t lvl = 1; lvl < lvlNum; ++lvl) {
+				loadParam.filePath = GetLevelFilePath(filePath, lvl - 1);
+				auto fine = BrickedVolumeData::LoadFromFile(loadParam);
+				if (!fine.ok) {
+					if (errMsg)
+						*errMsg = fine.result.errMsg;
+					return false;
+				}
+
+				auto ok = false;
+				switch (fine.result.dat.GetVoxelType())
+				{
+				case ESupportedVoxelType::UInt8:
+					ok = buildLevel<uint8_t>(fine.result.dat, hdr0, fingerprint, lvl, GetLevelFilePath(filePath, lvl), errMsg);
+					break;
+				case ESupportedVoxelType::UInt16:
+					ok = buildLevel<uint16_t>(fine.result.dat, hdr0, fingerprint, lvl, GetLevelFilePath(filePath, lvl), errMsg);
+					break;
+				case ESupportedVoxelType::Int16:
+					ok = buildLevel<int16_t>(fine.result.dat, hdr0, fingerprint, lvl, GetLevelFilePath(filePath, lvl), errMsg);
+					break;
+				case ESupportedVoxelType::Float32:
+					ok = buildLevel<float>(fine.result.dat, hdr0, fingerprint, lvl, GetLevelFilePath(filePath, lvl), errMsg);
+					break;
+				}
+				if (!ok)
+					return false;
+			}
+			return true;
+		}
+
+		/*
+		* 函数: LoadFromFile
+		* 功能: 打开第0级及其各级文件（均以内存映射方式打开）。缺少某一级、某一级与第0级不匹配
+		*       或某一级不是由当前的第0级生成（指纹不符）时返回错误，此时应先调用BuildLevels
+		*/
+		static ReteurnOrError<MultiresolutionBrickedVolumeData> LoadFromFile(const BrickedVolumeData::FromFileParameters& param)
+		{
+			MultiresolutionBrickedVolumeData vol;
+			auto lvl0 = BrickedVolumeData::LoadFromFile(param);
+			if (!lvl0.ok)
+				return lvl0.result.errMsg.c_str();
+			vol.levels.emplace_back(std::move(lvl0.result.dat));
+
+			auto hdr0 = vol.levels.front().GetHeader(); // levels扩容后引用会失效，需拷贝
+			auto fingerprint = fingerprintOf(vol.levels.front(), param.filePath);
+			auto lvlNum = GetLevelNum(hdr0.dim, hdr0.brickLen);
+			auto dim = hdr0.dim;
+			for (uint32_t lvl = 1; lvl < lvlNum; ++lvl) {
+				for (uint8_t i = 0; i < 3; ++i)
+					dim[i] = (dim[i] + 1) / 2;
+
+				auto lvlParam = param;
+				lvlParam.filePath = GetLevelFilePath(param.filePath, lvl);
+				auto lvlVol = BrickedVolumeData::LoadFromFile(lvlParam);
+				if (!lvlVol.ok)
+					return (std::string("Missing level ") + std::to_string(lvl) + ": " + lvlVol.result.errMsg).c_str();
+
+				const auto& hdr = lvlVol.result.dat.GetHeader();
+				if (hdr.dim != dim || hdr.brickLen != hdr0.brickLen || hdr.voxTy != hdr0.voxTy)
+					return (std::string("Level ") + std::to_string(lvl) + " does not match level 0.").c_str();
+				if (hdr.srcFingerprint != fingerprint)
+					return (std::string("Level ") + std::to_string(lvl) + " was built from a different level 0.").c_str();
+				vol.levels.emplace_back(std::move(lvlVol.result.dat));
+			}
+
+			return vol;
+		}
+
+		const BrickedVolumeData::Header& GetHeader() const
+		{
+			return levels.front().GetHeader();
+		}
+		ESupportedVoxelType GetVoxelType() const
+		{
+			return levels.front().GetVoxelType();
+		}
+		const std::array<uint32_t, 3>& GetVoxelPerVolume() const
+		{
+			return levels.front().GetVoxelPerVolume();
+		}
+		uint32_t GetBrickLength() const
+		{
+			return levels.front().GetBrickLength();
+		}
+		uint32_t GetLevelNum() const
+		{
+			return static_cast<uint32_t>(levels.size());
+		}
+		const BrickedVolumeData& GetLevel(uint32_t lvl) const
+		{
+			return levels[lvl];
+		}
+
+	private:
+		std::vector<BrickedVolumeData> levels;
+
+		/*
+		* 函数: fingerprintOf
+		* 功能: 第0级的指纹，由文件头（尺寸、值域等）、块索引表（各块的偏移、大小与统计量）与文件的修改时间混合得到。
+		*       文件被复制而修改时间改变时，各级会被视为过期而重新生成
+		*/
+		static uint64_t fingerprintOf(const BrickedVolumeData& lvl0, const std::string& filePath)
+		{
+			auto hdr = lvl0.GetHeader();
+			hdr.srcFingerprint = 0;
+			const auto& infos = lvl0.GetBrickInfos();
+			PreprocessCache::Key key;
+			key.Add(&hdr, sizeof(hdr)).Add(infos.data(), sizeof(BrickedVolumeData::BrickInfo) * infos.size())
+				.Add(modifiedTimeOf(filePath));
+			return key.val;
+		}
+		static uint64_t modifiedTimeOf(const std::string& filePath)
+		{
+#ifdef _WIN32
+			struct _stat64 st;
+			if (_stat64(filePath.c_str(), &st) != 0)
+				return 0;
+#else
+			struct stat st;
+			if (stat(filePath.c_str(), &st) != 0)
+				return 0;
+#endif // _WIN32
+			return static_cast<uint64_t>(st.st_mtime);
+		}
+
+		template <typename T, typename GetRow>
+		static bool dumpLevel(const BrickedVolumeData::Header& hdr0, uint64_t fingerprint, uint32_t lvl,
+			const std::array<uint32_t, 3>& dim, const std::string& filePath, const GetRow& getRow, std::string* errMsg)
+		{
+			BrickedVolumeData::ToFileParameters param;
+			param.filePath = filePath;
+			param.srcFingerprint = fingerprint;
+			param.brickLen = hdr0.brickLen;
+			param.compression = static_cast<BrickedVolumeData::ECompression>(hdr0.compression);
+			param.hasNullVal = hdr0.hasNullVal != 0;
+			param.nullVal = hdr0.nullVal;
+			// 第lvl级覆盖第0级的dim * 2^lvl个体素，可能略多于第0级的尺寸
+			std::array<std::array<float, 2>, 3> rngs = { { hdr0.lonRng, hdr0.latRng, hdr0.hRng } };
+			for (uint8_t i = 0; i < 3; ++i) {
+				auto cover = static_cast<double>(static_cast<uint64_t>(dim[i]) << lvl) / hdr0.dim[i];
+				rngs[i][1] = static_cast<float>(rngs[i][0] + (static_cast<double>(rngs[i][1]) - rngs[i][0]) * cover);
+			}
+			param.lonRng = rngs[0];
+			param.latRng = rngs[1];
+			param.hRng = rngs[2];
+
+			return BrickedVolumeData::DumpToFile(static_cast<ESupportedVoxelType>(hdr0.voxTy), dim, param, getRow, errMsg);
+		}
+
+		template <typename T>
+		static bool buildLevel(const BrickedVolumeData& fine, const BrickedVolumeData::Header& hdr0,
+			uint64_t fingerprint, uint32_t lvl, const std::string& filePath, std::string* errMsg)
+		{
+			const auto& fineDim = fine.GetVoxelPerVolume();
+			std::array<uint32_t, 3> dim;
+			for (uint8_t i = 0; i < 3; ++i)
+				dim[i] = (fineDim[i] + 1) / 2;
+
+			auto brickLen = hdr0.brickLen;
+			auto hasNullVal = hdr0.hasNullVal != 0;
+			auto nullVal = hdr0.nullVal;
+			auto invalid = hasNullVal ? static_cast<T>(nullVal) :
+				std::numeric_limits<T>::has_quiet_NaN ? std::numeric_limits<T>::quiet_NaN() : T(0);
+			auto fineYxX = static_cast<size_t>(fineDim[1]) * fineDim[0];
+
+			// DumpToFile逐层组装块，同一层内的行来自第lvl-1级的同一段Z范围，按层缓存该段
+			std::mutex mtx;
+			uint32_t slabBz = std::numeric_limits<uint32_t>::max();
+			uint32_t slabZ0 = 0;
+			std::vector<T> slab;
+			auto valid = true;
+
+			auto ok = dumpLevel<T>(hdr0, fingerprint, lvl, dim, filePath, [&](uint32_t y, uint32_t z, void* dst) {
+				auto* row = static_cast<T*>(dst);
+				{
+					std::lock_guard<std::mutex> lk(mtx);
+					auto bz = z / brickLen;
+					if (bz != slabBz) {
+						slabBz = bz;
+						slabZ0 = std::min(bz * brickLen * 2, fineDim[2] - 1);
+						auto slabZ1 = std::min((bz + 1) * brickLen * 2, fineDim[2]);
+						slab.resize(fineYxX * (slabZ1 - slabZ0));
+						if (!fine.ReadRegion({ { 0, 0, slabZ0 } }, { { fineDim[0], fineDim[1], slabZ1 } }, slab.data()))
+							valid = false;
+					}
+				}
+
+				std::array<uint32_t, 2> ys = { { 2 * y, std::min(2 * y + 1, fineDim[1] - 1) } };
+				std::array<uint32_t, 2> zs = { { 2 * z - slabZ0, std::min(2 * z + 1, fineDim[2] - 1) - slabZ0 } };
+				for (uint32_t x = 0; x < dim[0]; ++x) {
+					std::array<uint32_t, 2> xs = { { 2 * x, std::min(2 * x + 1, fineDim[0] - 1) } };
+					double sum = 0.;
+					uint32_t cnt = 0;
+					for (auto fz : zs)
+						for (auto fy : ys)
+							for (auto fx : xs) {
+								auto v = static_cast<float>(slab[fz * fineYxX + static_cast<size_t>(fy) * fineDim[0] + fx]);
+								if (v != v || (hasNullVal && v == nullVal)) continue;
+								sum += v;
+								++cnt;
+							}
+
+					if (cnt == 0)
+						row[x] = invalid;
+					else if (std::is_integral<T>::value)
+						row[x] = static_cast<T>(std::round(sum / cnt));
+					else
+						row[x] = static_cast<T>(sum / cnt);
+				}
+				}, errMsg);
+
+			if (ok && !valid) {
+				if (errMsg)
+					*errMsg = "Corrupted brick in level " + std::to_string(lvl - 1) + ".";
+				return false;
+			}
+			return ok;
+		}
+	};
+}
+
+#endif // !SCIVIS_DATA_MULTIRES_BRICKED_VOL_DATA_H
@@ -0,0 +1,215 @@
+#ifndef SCIVIS_DATA_SMOOTHED_VOL_CACHE_H
+#define SCIVIS_DATA_SMOOTHED_VOL_CACHE_H
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+
+#include <array>
+#include <list>
+#include <vector>
+
+#include <scivis/data/vol_smoother.h>
+#include <scivis/data/vol_view.h>
+#include <scivis/io/preprocess_cache.h>
+
+namespace SciVis
+{
+	/*
+	* 类: SmoothedVolumeCache
+	* 功能: 平滑体数据的全局缓存。平滑体在首次被请求时才计算，对同一源体与同一滤波参数只计算一次，
+	*       由所有绘制组件共享。缓存总量超过内存预算时，按最近最少使用的顺序释放当前无人持有的平滑体
+	*/
+	class SmoothedVolumeCache
+	{
+	public:
+		static SmoothedVolumeCache& Instance()
+		{
+			static SmoothedVolumeCache cache;
+			return cache;
+		}
+
+		/*
+		* 函数: Get
+		* 功能: 获取源体的平滑体，未缓存时计算并缓存
+		* 参数:
+		* -- src: 源体数据。以其地址作为键，源体被释放后对应的缓存随之失效
+		* -- dim: 体的三维尺寸
+		* -- param: 滤波参数
+		* 返回值: 平滑体数据。调用者应仅在使用期间持有，以便缓存能够在预算不足时释放
+		*/
+		std::shared_ptr<const std::vector<float>> Get(
+			const std::shared_ptr<const std::vector<float>>& src,
+			const std::array<uint32_t, 3>& dim,
+			const VolumeSmoother::Parameters& param = VolumeSmoother::Parameters())
+		{
+			return Get(VolumeView<float>(*src, dim), src, param);
+		}
+		/*
+		* 函数: Get
+		* 功能: 获取体视图的平滑体，未缓存时计算并缓存
+		* 参数:
+		* -- src: 源体的视图
+		* -- owner: 视图数据的持有者，不可为空。与视图的地址、尺寸与步长共同作为键，owner被释放后对应的缓存随之失效
+		* -- param: 滤波参数
+		*/
+		std::shared_ptr<const std::vector<float>> Get(
+			const VolumeView<float>& src,
+			const std::shared_ptr<const void>& owner,
+			const VolumeSmoother::Parameters& param = VolumeSmoother::Parameters())
+		{
+			std::lock_guard<std::mutex> lk(mtx);
+
+			for (auto itr = entries.begin(); itr != entries.end();) {
+				if (itr->owner.expired()) {
+					memBytes -= itr->bytes;
+					itr = entries.erase(itr);
+					continue;
+				}
+				if (itr->ownerPtr == owner.get() && itr->srcPtr == src.dat && itr->dim == src.dim
+					&& itr->strides == src.strides && isSameParameters(itr->param, param)) {
+					++hitCnt;
+					entries.splice(entries.begin(), entries, itr);
+					auto ret = entries.front().smoothed;
+					evict(); // 之前被持有而未能回收的平滑体，可能已被释放
+					return ret;
+				}
+				++itr;
+			}
+
+			++missCnt;
+			Entry entry;
+			entry.owner = owner;
+			entry.ownerPtr = owner.get();
+			entry.srcPtr = src.dat;
+			entry.dim = src.dim;
+			entry.strides = src.strides;
+			entry.param = param;
+			entry.smoothed = smooth(src, param);
+			entry.bytes = entry.smoothed->size() * sizeof(float);
+			memBytes += entry.bytes;
+			entries.emplace_front(std::move(entry));
+
+			auto ret = entries.front().smoothed;
+			evict();
+			return ret;
+		}
+
+		/*
+		* 函数: SetMemoryBudget
+		* 功能: 设置缓存的内存预算（字节），超出时立即尝试释放
+		*/
+		void SetMemoryBudget(size_t bytes)
+		{
+			std::lock_guard<std::mutex> lk(mtx);
+			memBudget = bytes;
+			evict();
+		}
+		size_t GetMemoryBudget() const
+		{
+			std::lock_guard<std::mutex> lk(mtx);
+			return memBudget;
+		}
+		size_t GetMemoryBytes() const
+		{
+			std::lock_guard<std::mutex> lk(mtx);
+			return memBytes;
+		}
+		size_t GetHitCount() const
+		{
+			std::lock_guard<std::mutex> lk(mtx);
+			return hitCnt;
+		}
+		size_t GetMissCount() const
+		{
+			std::lock_guard<std::mutex> lk(mtx);
+			return missCnt;
+		}
+		/*
+		* 函数: Clear
+		* 功能: 移除所有缓存项。已被持有的平滑体在持有者释放后才会被回收
+		*/
+		void Clear()
+		{
+			std::lock_guard<std::mutex> lk(mtx);
+			entries.clear();
+			memBytes = 0;
+		}
+
+	private:
+		struct Entry
+		{
+			std::weak_ptr<const void> owner;
+			const void* ownerPtr;
+			const float* srcPtr;
+			std::array<uint32_t, 3> dim;
+			std::array<size_t, 3> strides;
+			VolumeSmoother::Parameters param;
+			std::shared_ptr<const std::vector<float>> smoothed;
+			size_t bytes;
+		};
+
+		mutable std::mutex mtx;
+		std::list<Entry> entries; // 越靠前越近被使用
+		size_t memBudget;
+		size_t memBytes;
+		size_t hitCnt;
+		size_t missCnt;
+
+		SmoothedVolumeCache() : memBudget(static_cast<size_t>(512) << 20), memBytes(0), hitCnt(0), missCnt(0) {}
+		SmoothedVolumeCache(const SmoothedVolumeCache&) = delete;
+		SmoothedVolumeCache& operator=(const SmoothedVolumeCache&) = delete;
+
+		static bool isSameParameters(const VolumeSmoother::Parameters& a, const VolumeSmoother::Parameters& b)
+		{
+			return a.kernel == b.kernel && a.radius == b.radius
+				&& (a.kernel == VolumeSmoother::EKernel::Box || a.sigma == b.sigma);
+		}
+
+		/*
+		* 函数: smooth
+		* 功能: 计算平滑体。设置了持久化缓存时，以源体内容与滤波参数为键，跨进程重启复用之前的计算结果
+		*/
+		static std::shared_ptr<const std::vector<float>> smooth(
+			const VolumeView<float>& src, const VolumeSmoother::Parameters& param)
+		{
+			// 平滑需要紧密排列的输入，非连续的视图（如裁剪出的子体）先拷贝为连续数组
+			std::vector<float> packed;
+			auto srcDat = src.dat;
+			if (!src.IsContiguous()) {
+				packed = src.ToVector();
+				srcDat = packed.data();
+			}
+
+			auto& preCache = PreprocessCache::Instance();
+			if (!preCache.IsEnabled())
+				return std::make_shared<const std::vector<float>>(VolumeSmoother::Smooth(srcDat, src.dim, param));
+
+			PreprocessCache::Key key;
+			key.Add("VolumeSmoother").Add(PreprocessCache::Hash(srcDat, src.GetVoxelNum() * sizeof(float)))
+				.Add(src.dim).Add(param.kernel).Add(param.radius);
+			if (param.kernel != VolumeSmoother::EKernel::Box)
+				key.Add(param.sigma);
+			auto smoothed = preCache.GetOrCompute<float>(key, src.GetVoxelNum(), [&]() -> ReteurnOrError<std::vector<float>> {
+				return VolumeSmoother::Smooth(srcDat, src.dim, param);
+				});
+			if (!smoothed.ok)
+				return std::make_shared<const std::vector<float>>(VolumeSmoother::Smooth(srcDat, src.dim, param));
+			return std::make_shared<const std::vector<float>>(smoothed.result.dat.ToVector());
+		}
+
+		void evict()
+		{
+			for (auto itr = entries.end(); memBytes > memBudget && itr != entries.begin();) {
+				--itr;
+				// 仍被持有的平滑体无法被回收，移除只会导致重复计算，因此跳过
+				if (itr->smoothed.use_count() > 1)
+					continue;
+				memBytes -= itr->bytes;
+				itr = entries.erase(itr);
+			}
+		}
+	};
+}
+
+#endif // !SCIVIS_DATA_SMOOTHED_VOL_CACHE_H
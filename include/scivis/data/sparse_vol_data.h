@@ -0,0 +1,283 @@
+#ifndef SCIVIS_DATA_SPARSE_VOL_DATA_H
+#define SCIVIS_DATA_SPARSE_VOL_DATA_H
+
+#include <algorithm>
+#include <cstdint>
+
+#include <array>
+#include <unordered_map>
+#include <vector>
+
+namespace SciVis
+{
+	/*
+	* 类: SparseVolumeData
+	* 功能: 稀疏体数据。体被划分为BlockLen^3的块，仅存储含有体素的块。
+	*       块通过哈希表索引，每块用占用位图记录哪些体素有值，体素值按位图中的次序紧凑存储，
+	*       因此内存占用与有值体素的数量成正比，而与包围盒大小无关
+	*/
+	class SparseVolumeData
+	{
+	public:
+		static constexpr uint32_t BlockLenLog2 = 3;
+		static constexpr uint32_t BlockLen = 1 << BlockLenLog2;
+		static constexpr uint32_t BlockVoxNum = BlockLen * BlockLen * BlockLen;
+
+		struct Voxel
+		{
+			std::array<uint32_t, 3> pos;
+			float val;
+		};
+
+		/*
+		* 函数: FromVoxels
+		* 功能: 由有值体素构建稀疏体。同一位置出现多次时，保留最后出现的值
+		* 参数:
+		* -- dim: 体的三维尺寸
+		* -- voxs: 有值体素，位置需位于dim内
+		*/
+		static SparseVolumeData FromVoxels(const std::array<uint32_t, 3>& dim, const std::vector<Voxel>& voxs)
+		{
+			SparseVolumeData vol;
+			vol.dim = dim;
+
+			struct Entry
+			{
+				uint64_t blockKey;
+				uint16_t localIdx;
+				float val;
+			};
+			std::vector<Entry> entries;
+			entries.reserve(voxs.size());
+			for (auto& vox : voxs)
+				entries.emplace_back(Entry{
+					toBlockKey(vox.pos[0] >> BlockLenLog2, vox.pos[1] >> BlockLenLog2, vox.pos[2] >> BlockLenLog2),
+					toLocalIdx(vox.pos[0], vox.pos[1], vox.pos[2]), vox.val });
+			std::stable_sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) {
+				return a.blockKey < b.blockKey || (a.blockKey == b.blockKey && a.localIdx < b.localIdx);
+				});
+
+			vol.vals.reserve(entries.size());
+			for (size_t i = 0; i < entries.size(); ++i) {
+				if (i + 1 < entries.size() && entries[i + 1].blockKey == entries[i].blockKey
+					&& entries[i + 1].localIdx == entries[i].localIdx)
+					continue;
+
+				if (vol.blocks.empty() || vol.blocks.back().key != entries[i].blockKey) {
+					Block blk;
+					blk.key = entries[i].blockKey;
+					blk.valBeg = static_cast<uint32_t>(vol.vals.size());
+					blk.occupancy.fill(0);
+					vol.blockIndices.emplace(blk.key, static_cast<uint32_t>(vol.blocks.size()));
+					vol.blocks.emplace_back(blk);
+				}
+
+				auto& blk = vol.blocks.back();
+				blk.occupancy[entries[i].localIdx >> 6] |= uint64_t(1) << (entries[i].localIdx & 63);
+				vol.vals.emplace_back(entries[i].val);
+			}
+
+			for (auto& blk : vol.blocks) {
+				uint16_t cnt = 0;
+				for (uint8_t w = 0; w < blk.occupancy.size(); ++w) {
+					blk.prefixCnts[w] = cnt;
+					cnt += popCount(blk.occupancy[w]);
+				}
+			}
+
+			return vol;
+		}
+
+		/*
+		* 函数: TrySample
+		* 功能: 查询体素的值
+		* 返回值: 体素有值时返回true，并写入val
+		*/
+		bool TrySample(uint32_t x, uint32_t y, uint32_t z, float& val) const
+		{
+			if (x >= dim[0] || y >= dim[1] || z >= dim[2])
+				return false;
+
+			auto itr = blockIndices.find(toBlockKey(x >> BlockLenLog2, y >> BlockLenLog2, z >> BlockLenLog2));
+			if (itr == blockIndices.end())
+				return false;
+
+			auto& blk = blocks[itr->second];
+			auto localIdx = toLocalIdx(x, y, z);
+			auto word = blk.occupancy[localIdx >> 6];
+			auto bit = uint64_t(1) << (localIdx & 63);
+			if ((word & bit) == 0)
+				return false;
+
+			val = vals[blk.valBeg + blk.prefixCnts[localIdx >> 6] + popCount(word & (bit - 1))];
+			return true;
+		}
+		float Sample(uint32_t x, uint32_t y, uint32_t z, float emptyVal) const
+		{
+			float val;
+			return TrySample(x, y, z, val) ? val : emptyVal;
+		}
+
+		/*
+		* 函数: DensifyBrick
+		* 功能: 将体中的一个长方体区域转换为稠密数据，一般用于按需生成纹理
+		* 参数:
+		* -- brickMin: 区域的最小角点
+		* -- brickDim: 区域的三维尺寸，超出体的部分以emptyVal填充
+		* -- emptyVal: 无值体素的填充值
+		* 返回值: 以X为最快变化维度排列的稠密数据
+		*/
+		std::vector<float> DensifyBrick(
+			const std::array<uint32_t, 3>& brickMin, const std::array<uint32_t, 3>& brickDim,
+			float emptyVal) const
+		{
+			std::vector<float> dense(static_cast<size_t>(brickDim[0]) * brickDim[1] * brickDim[2], emptyVal);
+			auto dimYxX = static_cast<size_t>(brickDim[1]) * brickDim[0];
+
+			std::array<uint32_t, 3> blkMin, blkMax;
+			for (uint8_t a = 0; a < 3; ++a) {
+				blkMin[a] = brickMin[a] >> BlockLenLog2;
+				blkMax[a] = (std::min(brickMin[a] + brickDim[a], dim[a]) + BlockLen - 1) >> BlockLenLog2;
+			}
+
+			auto visit = [&](const Block& blk, uint32_t bx, uint32_t by, uint32_t bz) {
+				auto valIdx = blk.valBeg;
+				for (uint16_t localIdx = 0; localIdx < BlockVoxNum; ++localIdx) {
+					if ((blk.occupancy[localIdx >> 6] & (uint64_t(1) << (localIdx & 63))) == 0)
+						continue;
+
+					auto val = vals[valIdx++];
+					uint32_t x = (bx << BlockLenLog2) + (localIdx & (BlockLen - 1));
+					uint32_t y = (by << BlockLenLog2) + ((localIdx >> BlockLenLog2) & (BlockLen - 1));
+					uint32_t z = (bz << BlockLenLog2) + (localIdx >> (2 * BlockLenLog2));
+					if (x < brickMin[0] || y < brickMin[1] || z < brickMin[2]
+						|| x >= brickMin[0] + brickDim[0] || y >= brickMin[1] + brickDim[1]
+						|| z >= brickMin[2] + brickDim[2])
+						continue;
+					dense[(z - brickMin[2]) * dimYxX + (y - brickMin[1]) * brickDim[0] + (x - brickMin[0])] = val;
+				}
+			};
+
+			auto blkNumInBrick = static_cast<size_t>(blkMax[0] - blkMin[0]) * (blkMax[1] - blkMin[1])
+				* (blkMax[2] - blkMin[2]);
+			if (blkNumInBrick > blocks.size()) {
+				for (auto& blk : blocks) {
+					auto bx = static_cast<uint32_t>(blk.key & 0x1fffff);
+					auto by = static_cast<uint32_t>((blk.key >> 21) & 0x1fffff);
+					auto bz = static_cast<uint32_t>(blk.key >> 42);
+					if (bx >= blkMin[0] && by >= blkMin[1] && bz >= blkMin[2]
+						&& bx < blkMax[0] && by < blkMax[1] && bz < blkMax[2])
+						visit(blk, bx, by, bz);
+				}
+			}
+			else
+				for (auto bz = blkMin[2]; bz < blkMax[2]; ++bz)
+					for (auto by = blkMin[1]; by < blkMax[1]; ++by)
+						for (auto bx = blkMin[0]; bx < blkMax[0]; ++bx) {
+							auto itr = blockIndices.find(toBlockKey(bx, by, bz));
+							if (itr != blockIndices.end())
+								visit(blocks[itr->second], bx, by, bz);
+						}
+
+			return dense;
+		}
+		std::vector<float> Densify(float emptyVal) const
+		{
+			return DensifyBrick(std::array<uint32_t, 3>{ 0, 0, 0 }, dim, emptyVal);
+		}
+		/*
+		* 函数: GetVoxels
+		* 功能: 获取所有有值体素，为FromVoxels的逆操作。体素按块的存储顺序排列，不具有全局的空间顺序
+		*/
+		std::vector<Voxel> GetVoxels() const
+		{
+			std::vector<Voxel> voxs;
+			voxs.reserve(vals.size());
+			for (auto& blk : blocks) {
+				auto bx = static_cast<uint32_t>(blk.key & 0x1fffff);
+				auto by = static_cast<uint32_t>((blk.key >> 21) & 0x1fffff);
+				auto bz = static_cast<uint32_t>(blk.key >> 42);
+				auto valIdx = blk.valBeg;
+				for (uint16_t localIdx = 0; localIdx < BlockVoxNum; ++localIdx) {
+					if ((blk.occupancy[localIdx >> 6] & (uint64_t(1) << (localIdx & 63))) == 0)
+						continue;
+
+					voxs.emplace_back(Voxel{ {
+						(bx << BlockLenLog2) + (localIdx & (BlockLen - 1)),
+						(by << BlockLenLog2) + ((localIdx >> BlockLenLog2) & (BlockLen - 1)),
+						(bz << BlockLenLog2) + (localIdx >> (2 * BlockLenLog2)) }, vals[valIdx++] });
+				}
+			}
+			return voxs;
+		}
+
+		const std::array<uint32_t, 3>& GetVoxelPerVolume() const
+		{
+			return dim;
+		}
+		size_t GetPopulatedVoxelNum() const
+		{
+			return vals.size();
+		}
+		size_t GetBlockNum() const
+		{
+			return blocks.size();
+		}
+		size_t GetMemoryBytes() const
+		{
+			return vals.capacity() * sizeof(float) + blocks.capacity() * sizeof(Block)
+				+ blockIndices.size() * (sizeof(uint64_t) + sizeof(uint32_t) + 2 * sizeof(void*));
+		}
+		/*
+		* 函数: GetValues
+		* 功能: 获取所有有值体素的值，可用于逐值变换（如归一化），顺序不具有空间含义
+		*/
+		std::vector<float>& GetValues()
+		{
+			return vals;
+		}
+		const std::vector<float>& GetValues() const
+		{
+			return vals;
+		}
+
+	private:
+		struct Block
+		{
+			uint64_t key;
+			uint32_t valBeg;
+			std::array<uint64_t, BlockVoxNum / 64> occupancy;
+			std::array<uint16_t, BlockVoxNum / 64> prefixCnts;
+		};
+
+		std::array<uint32_t, 3> dim;
+		std::unordered_map<uint64_t, uint32_t> blockIndices;
+		std::vector<Block> blocks;
+		std::vector<float> vals;
+
+		SparseVolumeData()
+		{
+			dim[0] = dim[1] = dim[2] = 0;
+		}
+
+		static uint64_t toBlockKey(uint32_t bx, uint32_t by, uint32_t bz)
+		{
+			return static_cast<uint64_t>(bx) | (static_cast<uint64_t>(by) << 21)
+				| (static_cast<uint64_t>(bz) << 42);
+		}
+		static uint16_t toLocalIdx(uint32_t x, uint32_t y, uint32_t z)
+		{
+			return static_cast<uint16_t>(((z & (BlockLen - 1)) << (2 * BlockLenLog2))
+				| ((y & (BlockLen - 1)) << BlockLenLog2) | (x & (BlockLen - 1)));
+		}
+		static uint16_t popCount(uint64_t v)
+		{
+			v = v - ((v >> 1) & 0x5555555555555555ull);
+			v = (v & 0x3333333333333333ull) + ((v >> 2) & 0x3333333333333333ull);
+			v = (v + (v >> 4)) & 0x0f0f0f0f0f0f0f0full;
+			return static_cast<uint16_t>((v * 0x0101010101010101ull) >> 56);
+		}
+	};
+}
+
+#endif // !SCIVIS_DATA_SPARSE_VOL_DATA_H
@@ -1,8 +1,12 @@
 #ifndef SCIVIS_IO_VOL_DATA_H
 #define SCIVIS_IO_VOL_DATA_H
 
+#include <algorithm>
+#include <cmath>
+#include <cstring>
 #include <fstream>
 #include <limits>
+#include <memory>
 #include <string>
 
 #include <array>
@@ -11,13 +15,70 @@
 
 #include <osg/Texture3D>
 
+#include <scivis/common/parallel.h>
 #include <scivis/common/util.h>
+#include <scivis/common/vol_tex.h>
+#include <scivis/data/vol_region.h>
+#include <scivis/data/vol_resampler.h>
+#include <scivis/data/vol_stats.h>
+#include <scivis/data/vol_view.h>
+#include <scivis/io/gzip_stream.h>
+#include <scivis/io/mapped_file.h>
+
+#ifndef GL_R8
+#define GL_R8 0x8229
+#endif // !GL_R8
+#ifndef GL_R16
+#define GL_R16 0x822A
+#endif // !GL_R16
+#ifndef GL_R32F
+#define GL_R32F 0x822E
+#endif // !GL_R32F
 
 namespace SciVis
 {
 	enum class ESupportedVoxelType
 	{
-		UInt8 = 0
+		UInt8 = 0,
+		UInt16,
+		Int16,
+		Float32
+	};
+
+	/*
+	* 结构体: VoxelTypeTraits
+	* 功能: 体素类型在编译期对应的C++类型与OpenGL纹理格式
+	*/
+	template <ESupportedVoxelType VoxTy>
+	struct VoxelTypeTraits;
+	template <>
+	struct VoxelTypeTraits<ESupportedVoxelType::UInt8>
+	{
+		using Type = uint8_t;
+		static constexpr GLenum DataType = GL_UNSIGNED_BYTE;
+		static constexpr GLint InternalFormat = GL_R8;
+	};
+	template <>
+	struct VoxelTypeTraits<ESupportedVoxelType::UInt16>
+	{
+		using Type = uint16_t;
+		static constexpr GLenum DataType = GL_UNSIGNED_SHORT;
+		static constexpr GLint InternalFormat = GL_R16;
+	};
+	template <>
+	struct VoxelTypeTraits<ESupportedVoxelType::Int16>
+	{
+		using Type = int16_t;
+		// 上传时加上32768存为无符号16位数据（见VolumeTexture::ToTexels），着色器中采样值与UInt16一样位于[0, 1]
+		static constexpr GLenum DataType = GL_UNSIGNED_SHORT;
+		static constexpr GLint InternalFormat = GL_R16;
+	};
+	template <>
+	struct VoxelTypeTraits<ESupportedVoxelType::Float32>
+	{
+		using Type = float;
+		static constexpr GLenum DataType = GL_FLOAT;
+		static constexpr GLint InternalFormat = GL_R32F;
 	};
 
 	class RAWVolumeData
@@ -28,20 +89,49 @@ namespace SciVis
 			std::array<uint32_t, 3> voxPerVol;
 			ESupportedVoxelType voxTy;
 			std::string filePath;
+			bool useMemoryMap = false;
+			MappedFile::EAccessHint accessHint = MappedFile::EAccessHint::Normal;
+			VolumeRegion region; // 只加载该子区域（见VolumeRegion::FromGeographic），默认加载整个体
 		};
+		/*
+		* 函数: LoadFromFile
+		* 功能: 从RAW文件加载体。指定了子区域时，只读取子区域所含的行，得到的体的尺寸为子区域的尺寸，
+		*       加载的时间与内存随子区域的大小而非整个体的大小变化。
+		*       文件为gzip压缩时（由文件头识别）边解压边复制，不产生临时文件，见loadGZipFromFile
+		*/
 		static ReteurnOrError<RAWVolumeData> LoadFromFile(const FromFileParameters& param)
 		{
 			if (param.voxPerVol[0] == 0 || param.voxPerVol[1] == 0 || param.voxPerVol[2] == 0)
 				return "Invalid voxPerVol.";
+			if (!param.region.IsInside(param.voxPerVol))
+				return "Invalid region, which exceeds voxPerVol.";
+			if (isGZipFile(param.filePath))
+				return loadGZipFromFile(param);
+			if (!param.region.IsWholeOf(param.voxPerVol))
+				return loadRegionFromFile(param);
+
 			RAWVolumeData vol;
 			vol.voxTy = param.voxTy;
 			vol.voxPerVol = param.voxPerVol;
 			vol.voxPerVolYxX = static_cast<decltype(vol.voxPerVolYxX)>(vol.voxPerVol[0]) * vol.voxPerVol[1];
 
+			auto readSz = GetVoxelSize(vol.voxTy) * vol.voxPerVol[0] * vol.voxPerVol[1] * vol.voxPerVol[2];
+			if (param.useMemoryMap) {
+				auto mapped = MappedFile::Open(param.filePath, param.accessHint);
+				if (!mapped)
+					return "Invalid filePath.";
+				if (mapped->GetSize() < readSz)
+					return "Invalid file content, which is not enough for voxPerVol.";
+
+				vol.dat = mapped->GetData();
+				vol.datSz = readSz;
+				vol.datOwner = mapped;
+				return vol;
+			}
+
 			std::ifstream is(param.filePath, std::ios::binary | std::ios::in | std::ios::ate);
 			if (!is.is_open())
 				return "Invalid filePath.";
-			auto readSz = GetVoxelSize(vol.voxTy) * vol.voxPerVol[0] * vol.voxPerVol[1] * vol.voxPerVol[2];
 			{
 				auto pos = is.tellg();
 				is.seekg(0, std::ios::beg);
@@ -49,103 +139,84 @@ namespace SciVis
 					return "Invalid file content, which is not enough for voxPerVol.";
 			}
 
-			vol.dat.resize(readSz);
-			is.read(reinterpret_cast<char*>(vol.dat.data()), readSz);
+			auto buf = std::make_shared<std::vector<uint8_t>>(readSz);
+			is.read(reinterpret_cast<char*>(buf->data()), readSz);
+			vol.dat = buf->data();
+			vol.datSz = readSz;
+			vol.datOwner = buf;
+
+			return vol;
+		}
+		/*
+		* 函数: FromBuffer
+		* 功能: 以内存中已有的体素构造体，体与buf共享数据，不发生拷贝。用于由其他格式（如NetCDF）解码得到的体
+		* 参数:
+		* -- buf: 以X为最快变化维度排列的体素，大小不小于voxPerVol对应的字节数
+		*/
+		static ReteurnOrError<RAWVolumeData> FromBuffer(
+			const std::array<uint32_t, 3>& voxPerVol, ESupportedVoxelType voxTy,
+			std::shared_ptr<const std::vector<uint8_t>> buf)
+		{
+			if (voxPerVol[0] == 0 || voxPerVol[1] == 0 || voxPerVol[2] == 0)
+				return "Invalid voxPerVol.";
+			auto datSz = GetVoxelSize(voxTy) * voxPerVol[0] * voxPerVol[1] * voxPerVol[2];
+			if (!buf || buf->size() < datSz)
+				return "Invalid buf, which is not enough for voxPerVol.";
 
+			RAWVolumeData vol;
+			vol.voxTy = voxTy;
+			vol.voxPerVol = voxPerVol;
+			vol.voxPerVolYxX = static_cast<decltype(vol.voxPerVolYxX)>(vol.voxPerVol[0]) * vol.voxPerVol[1];
+			vol.dat = buf->data();
+			vol.datSz = datSz;
+			vol.datOwner = buf;
 			return vol;
 		}
 
 		enum class EFilterType
 		{
-			Linear = 0
+			Linear = 0,
+			Box,
+			Lanczos2
 		};
 		struct ResizeParameters
 		{
 			EFilterType filterType = EFilterType::Linear;
 			std::array<uint32_t, 3> targetVoxPerVol;
 		};
+		/*
+		* 函数: GetResized
+		* 功能: 以可分离的多线程重采样（见VolumeResampler）得到指定尺寸的体，支持任意倍数的放大与缩小
+		*/
 		ReteurnOrError<RAWVolumeData> GetResized(const ResizeParameters& param) const
 		{
-			if (dat.empty())
+			if (datSz == 0)
 				return "Invalid vol.";
-			if (param.targetVoxPerVol[0] == 0 || param.targetVoxPerVol[1] == 0 || param.targetVoxPerVol[2] == 0
-				|| param.targetVoxPerVol[0] > 2 * voxPerVol[0]
-				|| param.targetVoxPerVol[1] > 2 * voxPerVol[1]
-				|| param.targetVoxPerVol[2] > 2 * voxPerVol[2])
+			if (param.targetVoxPerVol[0] == 0 || param.targetVoxPerVol[1] == 0 || param.targetVoxPerVol[2] == 0)
 				return "Invalid targetVoxPerVol.";
 
-			RAWVolumeData volOut;
-			volOut.voxTy = voxTy;
-			volOut.voxPerVol = param.targetVoxPerVol;
-			volOut.voxPerVolYxX = static_cast<decltype(volOut.voxPerVolYxX)>(volOut.voxPerVol[0]) * volOut.voxPerVol[1];
-
-			std::array<float, 3> scale = {
-				1.f * voxPerVol[0] / volOut.voxPerVol[0],
-				1.f * voxPerVol[1] / volOut.voxPerVol[1],
-				1.f * voxPerVol[2] / volOut.voxPerVol[2]
-			};
-
-			volOut.dat.resize(volOut.GetVoxelSize() * volOut.voxPerVolYxX * volOut.voxPerVol[2]);
-			auto append = [&](uint32_t x, uint32_t y, uint32_t z) {
-				auto offsOut = z * volOut.voxPerVolYxX + y * volOut.voxPerVol[0] + x;
-
-				std::array<float, 3> posIn = {
-					scale[0] * x, scale[1] * y, scale[2] * z
-				};
-
-				std::array<std::array<uint32_t, 2>, 3> posInRng = {
-					std::array<uint32_t, 2>{ static_cast<uint32_t>(std::floorf(posIn[0])),
-						static_cast<uint32_t>(std::ceilf(posIn[0])) },
-					std::array<uint32_t, 2>{ static_cast<uint32_t>(std::floorf(posIn[1])),
-						static_cast<uint32_t>(std::ceilf(posIn[1])) },
-					std::array<uint32_t, 2>{ static_cast<uint32_t>(std::floorf(posIn[2])),
-						static_cast<uint32_t>(std::ceilf(posIn[2])) }
-				};
-
-				std::array<float, 3> omegas = {
-					posInRng[0][1] - posInRng[0][0],
-					posInRng[1][1] - posInRng[1][0],
-					posInRng[2][1] - posInRng[2][0]
-				};
-				omegas[0] = omegas[0] == 0.f ? 0.f : (posIn[0] - posInRng[0][0]) / omegas[0];
-				omegas[1] = omegas[1] == 0.f ? 0.f : (posIn[1] - posInRng[1][0]) / omegas[1];
-				omegas[2] = omegas[2] == 0.f ? 0.f : (posIn[2] - posInRng[2][0]) / omegas[2];
-
-
-				auto valIn = 0.f;
-				for (uint8_t zi = 0; zi < 2; ++zi)
-					for (uint8_t yi = 0; yi < 2; ++yi)
-						for (uint8_t xi = 0; xi < 2; ++xi)
-							switch (voxTy)
-							{
-							case SciVis::ESupportedVoxelType::UInt8:
-								valIn += (zi == 0 ? 1.f - omegas[2] : omegas[2])
-									* (yi == 0 ? 1.f - omegas[1] : omegas[1])
-									* (xi == 0 ? 1.f - omegas[0] : omegas[0])
-									* Sample<uint8_t>(posInRng[0][xi], posInRng[1][yi], posInRng[2][zi]);
-								break;
-							}
-
-				switch (voxTy)
-				{
-				case SciVis::ESupportedVoxelType::UInt8:
-					volOut.dat[offsOut] = static_cast<uint8_t>(valIn);
-					break;
-				}
-				};
-
-			for (uint32_t z = 0; z < volOut.voxPerVol[2]; ++z)
-				for (uint32_t y = 0; y < volOut.voxPerVol[1]; ++y)
-					for (uint32_t x = 0; x < volOut.voxPerVol[0]; ++x)
-						append(x, y, z);
-
-			return volOut;
+			switch (voxTy)
+			{
+			case ESupportedVoxelType::UInt8:
+				return getResized<ESupportedVoxelType::UInt8>(param);
+			case ESupportedVoxelType::UInt16:
+				return getResized<ESupportedVoxelType::UInt16>(param);
+			case ESupportedVoxelType::Int16:
+				return getResized<ESupportedVoxelType::Int16>(param);
+			case ESupportedVoxelType::Float32:
+				return getResized<ESupportedVoxelType::Float32>(param);
+			}
+			return "Invalid voxTy.";
 		}
 
-		const std::vector<uint8_t>& GetData() const
+		const uint8_t* GetData() const
 		{
 			return dat;
 		}
+		size_t GetDataSize() const
+		{
+			return datSz;
+		}
 		const std::array<uint32_t, 3> GetVoxelPerVolume() const
 		{
 			return voxPerVol;
@@ -164,16 +235,45 @@ namespace SciVis
 			x = std::min(x, voxPerVol[0] - 1);
 			y = std::min(y, voxPerVol[1] - 1);
 			z = std::min(z, voxPerVol[2] - 1);
-			return *(reinterpret_cast<const VoxTy*>(dat.data()) + z * voxPerVolYxX +
+			return *(reinterpret_cast<const VoxTy*>(dat) + z * voxPerVolYxX +
 				y * voxPerVol[0] + x);
 		}
 
+		std::shared_ptr<const VolumeStatistics::Result> GetStatistics() const
+		{
+			return GetStatistics(VolumeStatistics::Parameters());
+		}
+		/*
+		* 函数: GetStatistics
+		* 功能: 获取体的统计量（见VolumeStatistics）。结果随体缓存，参数不变时不会重复遍历体，拷贝得到的体共享同一份缓存
+		*/
+		std::shared_ptr<const VolumeStatistics::Result> GetStatistics(const VolumeStatistics::Parameters& param) const
+		{
+			switch (voxTy)
+			{
+			case ESupportedVoxelType::UInt8:
+				return getStatistics<ESupportedVoxelType::UInt8>(param);
+			case ESupportedVoxelType::UInt16:
+				return getStatistics<ESupportedVoxelType::UInt16>(param);
+			case ESupportedVoxelType::Int16:
+				return getStatistics<ESupportedVoxelType::Int16>(param);
+			case ESupportedVoxelType::Float32:
+				return getStatistics<ESupportedVoxelType::Float32>(param);
+			}
+			return nullptr;
+		}
+
 		static size_t GetVoxelSize(ESupportedVoxelType Type)
 		{
 			switch (Type) {
 			case ESupportedVoxelType::UInt8:
-				return sizeof(uint8_t);
-				break;
+				return sizeof(VoxelTypeTraits<ESupportedVoxelType::UInt8>::Type);
+			case ESupportedVoxelType::UInt16:
+				return sizeof(VoxelTypeTraits<ESupportedVoxelType::UInt16>::Type);
+			case ESupportedVoxelType::Int16:
+				return sizeof(VoxelTypeTraits<ESupportedVoxelType::Int16>::Type);
+			case ESupportedVoxelType::Float32:
+				return sizeof(VoxelTypeTraits<ESupportedVoxelType::Float32>::Type);
 			}
 			return 0;
 		}
@@ -182,52 +282,252 @@ namespace SciVis
 		{
 			switch (Type) {
 			case ESupportedVoxelType::UInt8:
-				return std::make_tuple(0.f, static_cast<float>(std::numeric_limits<uint8_t>::max()),
-					static_cast<float>(std::numeric_limits<uint8_t>::max()));
+				return getVoxelMinMaxExtent<uint8_t>();
+			case ESupportedVoxelType::UInt16:
+				return getVoxelMinMaxExtent<uint16_t>();
+			case ESupportedVoxelType::Int16:
+				return getVoxelMinMaxExtent<int16_t>();
 			default:
 				break;
 			}
-			return std::make_tuple(0.f, 0.f, 1.f);
+			return std::make_tuple(0.f, 1.f, 1.f);
 		}
 
-		osg::ref_ptr<osg::Texture3D> ToOSGTexture3D() const
+		/*
+		* 函数: ToOSGTexture3D
+		* 功能: 将体上传为OSG三维纹理
+		* 参数:
+		* -- policy: 纹理尺寸策略，默认保持原始分辨率，见ETextureSizePolicy
+		*/
+		osg::ref_ptr<osg::Texture3D> ToOSGTexture3D(
+			ETextureSizePolicy policy = ETextureSizePolicy::Native) const
 		{
-			std::array<uint32_t, 3> targetVoxPerVol = { 1,1,1 };
-			for (int i = 0; i < 3; ++i)
-				while (targetVoxPerVol[i] < voxPerVol[i])
-					targetVoxPerVol[i] *= 2;
-
-			auto volResized = GetResized(ResizeParameters{ EFilterType::Linear, targetVoxPerVol });
-
-			osg::ref_ptr<osg::Image> img = new osg::Image;
 			switch (voxTy)
 			{
-			case SciVis::ESupportedVoxelType::UInt8:
-				img->allocateImage(targetVoxPerVol[0], targetVoxPerVol[1], targetVoxPerVol[2],
-					GL_RED, GL_UNSIGNED_BYTE);
-				break;
+			case ESupportedVoxelType::UInt8:
+				return toOSGTexture3D<ESupportedVoxelType::UInt8>(policy);
+			case ESupportedVoxelType::UInt16:
+				return toOSGTexture3D<ESupportedVoxelType::UInt16>(policy);
+			case ESupportedVoxelType::Int16:
+				return toOSGTexture3D<ESupportedVoxelType::Int16>(policy);
+			case ESupportedVoxelType::Float32:
+				return toOSGTexture3D<ESupportedVoxelType::Float32>(policy);
 			}
-			img->setInternalTextureFormat(GL_RED);
-			std::memcpy(img->data(), volResized.result.dat.GetData().data(),
-				GetVoxelSize() * targetVoxPerVol[2] * targetVoxPerVol[1] * targetVoxPerVol[0]);
-
-			osg::ref_ptr<osg::Texture3D> tex = new osg::Texture3D;
-			tex->setFilter(osg::Texture::MAG_FILTER, osg::Texture::FilterMode::LINEAR);
-			tex->setFilter(osg::Texture::MIN_FILTER, osg::Texture::FilterMode::LINEAR);
-			tex->setWrap(osg::Texture::WRAP_S, osg::Texture::WrapMode::CLAMP_TO_EDGE);
-			tex->setWrap(osg::Texture::WRAP_T, osg::Texture::WrapMode::CLAMP_TO_EDGE);
-			tex->setWrap(osg::Texture::WRAP_R, osg::Texture::WrapMode::CLAMP_TO_EDGE);
-			tex->setInternalFormatMode(osg::Texture::InternalFormatMode::USE_IMAGE_DATA_FORMAT);
-			tex->setImage(img);
-
-			return tex;
+			return nullptr;
 		}
 
 	private:
 		std::array<uint32_t, 3> voxPerVol;
 		size_t voxPerVolYxX;
 		ESupportedVoxelType voxTy;
-		std::vector<uint8_t> dat;
+		const uint8_t* dat = nullptr;
+		size_t datSz = 0;
+		std::shared_ptr<const void> datOwner; // 持有堆上数据或文件映射，拷贝时共享同一份只读数据
+		std::shared_ptr<VolumeStatisticsCache> statsCache = std::make_shared<VolumeStatisticsCache>();
+
+		/*
+		* 函数: loadRegionFromFile
+		* 功能: 只读取子区域所含的行。X方向覆盖整个体时，子区域在每个切片中连续，按切片读取；
+		*       Y方向也覆盖整个体时，整个子区域连续，一次读取。使用文件映射时，只有子区域所在的页会被读入
+		*/
+		static ReteurnOrError<RAWVolumeData> loadRegionFromFile(const FromFileParameters& param)
+		{
+			const auto& rgn = param.region;
+			auto voxSz = GetVoxelSize(param.voxTy);
+			auto fullSz = voxSz * param.voxPerVol[0] * param.voxPerVol[1] * param.voxPerVol[2];
+			auto srcRowSz = voxSz * param.voxPerVol[0];
+			auto srcSliceSz = srcRowSz * param.voxPerVol[1];
+
+			RAWVolumeData vol;
+			vol.voxTy = param.voxTy;
+			vol.voxPerVol = rgn.dim;
+			vol.voxPerVolYxX = static_cast<decltype(vol.voxPerVolYxX)>(vol.voxPerVol[0]) * vol.voxPerVol[1];
+
+			auto rowSz = voxSz * rgn.dim[0];
+			auto rowNum = static_cast<size_t>(rgn.dim[1]) * rgn.dim[2];
+			auto buf = std::make_shared<std::vector<uint8_t>>(rowSz * rowNum);
+			auto srcOffsetOf = [&](size_t row) {
+				auto y = rgn.beg[1] + row % rgn.dim[1];
+				auto z = rgn.beg[2] + row / rgn.dim[1];
+				return z * srcSliceSz + y * srcRowSz + voxSz * rgn.beg[0];
+			};
+
+			if (param.useMemoryMap) {
+				auto mapped = MappedFile::Open(param.filePath, param.accessHint);
+				if (!mapped)
+					return "Invalid filePath.";
+				if (mapped->GetSize() < fullSz)
+					return "Invalid file content, which is not enough for voxPerVol.";
+
+				ParallelFor(rowNum, [&](uint32_t, size_t beg, size_t end) {
+					for (auto r = beg; r < end; ++r)
+						std::memcpy(buf->data() + r * rowSz, mapped->GetData() + srcOffsetOf(r), rowSz);
+					});
+			}
+			else {
+				std::ifstream is(param.filePath, std::ios::binary | std::ios::in | std::ios::ate);
+				if (!is.is_open())
+					return "Invalid filePath.";
+				if (static_cast<size_t>(is.tellg()) < fullSz)
+					return "Invalid file content, which is not enough for voxPerVol.";
+
+				// 连续的行合并为一次读取
+				size_t rowsPerRead = 1;
+				if (rgn.dim[0] == param.voxPerVol[0])
+					rowsPerRead = rgn.dim[1] == param.voxPerVol[1] ? rowNum : rgn.dim[1];
+				for (size_t r = 0; r < rowNum; r += rowsPerRead) {
+					is.seekg(srcOffsetOf(r), std::ios::beg);
+					is.read(reinterpret_cast<char*>(buf->data() + r * rowSz), rowSz * rowsPerRead);
+				}
+				if (!is.good())
+					return "Failed to read the region.";
+			}
+
+			vol.dat = buf->data();
+			vol.datSz = buf->size();
+			vol.datOwner = buf;
+			return vol;
+		}
+
+		static bool isGZipFile(const std::string& filePath)
+		{
+			std::ifstream is(filePath, std::ios::binary | std::ios::in);
+			uint8_t magic[3] = { 0, 0, 0 };
+			is.read(reinterpret_cast<char*>(magic), sizeof(magic));
+			return is.good() && GZipInflater::IsGZip(magic, sizeof(magic));
+		}
+		/*
+		* 函数: loadGZipFromFile
+		* 功能: 边解压边将子区域所含的行复制到体中，连续的行合并为一次复制，得到子区域的最后一行后即停止解压。
+		*       解压后的数据无法映射，useMemoryMap被忽略
+		*/
+		static ReteurnOrError<RAWVolumeData> loadGZipFromFile(const FromFileParameters& param)
+		{
+			auto mapped = MappedFile::Open(param.filePath, MappedFile::EAccessHint::Sequential);
+			if (!mapped)
+				return "Invalid filePath.";
+
+			VolumeRegion rgn = param.region;
+			if (rgn.IsWhole()) {
+				rgn.beg = { { 0, 0, 0 } };
+				rgn.dim = param.voxPerVol;
+			}
+			auto voxSz = GetVoxelSize(param.voxTy);
+			auto srcRowSz = voxSz * param.voxPerVol[0];
+			auto srcSliceSz = srcRowSz * param.voxPerVol[1];
+
+			RAWVolumeData vol;
+			vol.voxTy = param.voxTy;
+			vol.voxPerVol = rgn.dim;
+			vol.voxPerVolYxX = static_cast<decltype(vol.voxPerVolYxX)>(vol.voxPerVol[0]) * vol.voxPerVol[1];
+
+			auto rowSz = voxSz * rgn.dim[0];
+			auto rowNum = static_cast<size_t>(rgn.dim[1]) * rgn.dim[2];
+			size_t rowsPerRun = 1;
+			if (rgn.dim[0] == param.voxPerVol[0])
+				rowsPerRun = rgn.dim[1] == param.voxPerVol[1] ? rowNum : rgn.dim[1];
+			auto runSz = rowSz * rowsPerRun;
+			auto runNum = rowNum / rowsPerRun;
+			auto buf = std::make_shared<std::vector<uint8_t>>(rowSz * rowNum);
+			auto srcOffsetOf = [&](size_t run) {
+				auto row = run * rowsPerRun;
+				auto y = rgn.beg[1] + row % rgn.dim[1];
+				auto z = rgn.beg[2] + row / rgn.dim[1];
+				return z * srcSliceSz + y * srcRowSz + voxSz * rgn.beg[0];
+			};
+
+			size_t run = 0;
+			size_t outOffs = 0;
+			std::string errMsg;
+			auto ok = GZipInflater::Inflate(mapped->GetData(), mapped->GetSize(), static_cast<size_t>(4) << 20,
+				[&](const uint8_t* dat, size_t sz) {
+					auto outEnd = outOffs + sz;
+					for (; run < runNum; ++run) {
+						auto src = srcOffsetOf(run);
+						if (src >= outEnd)
+							break;
+						auto beg = std::max(src, outOffs);
+						auto end = std::min(src + runSz, outEnd);
+						if (beg < end)
+							std::memcpy(buf->data() + run * runSz + (beg - src), dat + (beg - outOffs), end - beg);
+						if (src + runSz > outEnd)
+							break;
+					}
+					outOffs = outEnd;
+					return run < runNum;
+				}, &errMsg);
+			if (!ok)
+				return errMsg.c_str();
+			if (run < runNum)
+				return "Invalid file content, which is not enough for voxPerVol.";
+
+			vol.dat = buf->data();
+			vol.datSz = buf->size();
+			vol.datOwner = buf;
+			return vol;
+		}
+
+		template <typename T>
+		static std::tuple<float, float, float> getVoxelMinMaxExtent()
+		{
+			auto minVal = static_cast<float>(std::numeric_limits<T>::lowest());
+			auto maxVal = static_cast<float>(std::numeric_limits<T>::max());
+			return std::make_tuple(minVal, maxVal, maxVal - minVal);
+		}
+
+		template <ESupportedVoxelType VoxTy>
+		ReteurnOrError<RAWVolumeData> getResized(const ResizeParameters& param) const
+		{
+			using T = typename VoxelTypeTraits<VoxTy>::Type;
+
+			RAWVolumeData volOut;
+			volOut.voxTy = voxTy;
+			volOut.voxPerVol = param.targetVoxPerVol;
+			volOut.voxPerVolYxX = static_cast<decltype(volOut.voxPerVolYxX)>(volOut.voxPerVol[0]) * volOut.voxPerVol[1];
+
+			auto buf = std::make_shared<std::vector<uint8_t>>(
+				sizeof(T) * volOut.voxPerVolYxX * volOut.voxPerVol[2]);
+			volOut.dat = buf->data();
+			volOut.datSz = buf->size();
+			volOut.datOwner = buf;
+
+			VolumeResampler::Parameters resampleParam;
+			switch (param.filterType)
+			{
+			case EFilterType::Box:
+				resampleParam.kernel = VolumeResampler::EKernel::Box;
+				break;
+			case EFilterType::Lanczos2:
+				resampleParam.kernel = VolumeResampler::EKernel::Lanczos2;
+				break;
+			default:
+				resampleParam.kernel = VolumeResampler::EKernel::Tent;
+				break;
+			}
+			VolumeResampler::Resample(reinterpret_cast<const T*>(dat), voxPerVol,
+				reinterpret_cast<T*>(buf->data()), volOut.voxPerVol, resampleParam);
+
+			return volOut;
+		}
+
+		template <ESupportedVoxelType VoxTy>
+		std::shared_ptr<const VolumeStatistics::Result> getStatistics(const VolumeStatistics::Parameters& param) const
+		{
+			using T = typename VoxelTypeTraits<VoxTy>::Type;
+
+			if (datSz == 0)
+				return nullptr;
+			return statsCache->Get(VolumeView<T>(reinterpret_cast<const T*>(dat), voxPerVol), param);
+		}
+
+		template <ESupportedVoxelType VoxTy>
+		osg::ref_ptr<osg::Texture3D> toOSGTexture3D(ETextureSizePolicy policy) const
+		{
+			using Traits = VoxelTypeTraits<VoxTy>;
+
+			return VolumeTexture::Create(reinterpret_cast<const typename Traits::Type*>(dat), voxPerVol,
+				Traits::DataType, Traits::InternalFormat, policy);
+		}
 	};
 }
 
@@ -0,0 +1,267 @@
+#ifndef SCIVIS_DATA_VOL_QUANTIZER_H
+#define SCIVIS_DATA_VOL_QUANTIZER_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+
+#include <array>
+#include <vector>
+
+#include <scivis/common/parallel.h>
+
+namespace SciVis
+{
+	/*
+	* 类: VolumeQuantizer
+	* 功能: 将归一化的体数据量化为更紧凑的体素格式，以减少纹理的显存占用与采样带宽。
+	*       可选有序抖动，并可统计量化误差。量化按Z切片划分到多个线程上执行
+	*/
+	class VolumeQuantizer
+	{
+	public:
+		enum class EFormat
+		{
+			Float32 = 0, // 不量化
+			UNorm8, // [0, 1]映射到[0, 255]
+			UNorm16, // [0, 1]映射到[0, 65535]
+			Float16 // IEEE 754半精度浮点，就近舍入
+		};
+
+		struct Parameters
+		{
+			EFormat format = EFormat::UNorm8;
+			bool dither = false; // 为真时，在舍入前叠加4x4x4的有序抖动。仅对UNorm8与UNorm16有效
+			uint32_t thrdNum = 0; // 为0时使用硬件并发数
+		};
+
+		/*
+		* 结构体: ErrorReport
+		* 功能: 量化误差的统计。误差为反量化值与原值之差，不计NaN
+		*/
+		struct ErrorReport
+		{
+			float maxAbsErr = 0.f;
+			double meanAbsErr = 0.;
+			double rmsErr = 0.;
+			size_t clampedNum = 0; // 超出格式可表示范围的体素数。Float16溢出为无穷的体素不计入误差
+		};
+
+		static size_t BytesPerVoxel(EFormat format)
+		{
+			switch (format)
+			{
+			case EFormat::UNorm8:
+				return 1;
+			case EFormat::UNorm16:
+			case EFormat::Float16:
+				return 2;
+			default:
+				return 4;
+			}
+		}
+
+		/*
+		* 函数: Quantize
+		* 功能: 量化归一化的体数据
+		* 参数:
+		* -- src: 以X为最快变化维度排列的归一化体数据
+		* -- dim: 体的三维尺寸
+		* -- param: 量化参数
+		* -- report: 不为空时，写入量化误差的统计
+		* 返回值: 量化后的体素，按param.format排列，共BytesPerVoxel(param.format)乘以体素数个字节
+		*/
+		static std::vector<uint8_t> Quantize(
+			const float* src, const std::array<uint32_t, 3>& dim,
+			const Parameters& param, ErrorReport* report = nullptr)
+		{
+			auto voxNum = static_cast<size_t>(dim[0]) * dim[1] * dim[2];
+			std::vector<uint8_t> dst(voxNum * BytesPerVoxel(param.format));
+			if (report)
+				*report = ErrorReport();
+			if (voxNum == 0)
+				return dst;
+
+			switch (param.format)
+			{
+			case EFormat::UNorm8:
+				quantize(src, dim, dst.data(), param, report,
+					[](float v, float offset) { return toUNorm<uint8_t>(v, offset); },
+					[](uint8_t q) { return q / 255.f; });
+				break;
+			case EFormat::UNorm16:
+				quantize(src, dim, reinterpret_cast<uint16_t*>(dst.data()), param, report,
+					[](float v, float offset) { return toUNorm<uint16_t>(v, offset); },
+					[](uint16_t q) { return q / 65535.f; });
+				break;
+			case EFormat::Float16:
+			{
+				auto noDither = param;
+				noDither.dither = false;
+				quantize(src, dim, reinterpret_cast<uint16_t*>(dst.data()), noDither, report,
+					[](float v, float) { return FloatToHalf(v); },
+					[](uint16_t q) { return HalfToFloat(q); });
+				break;
+			}
+			default:
+				std::memcpy(dst.data(), src, voxNum * sizeof(float));
+				break;
+			}
+
+			return dst;
+		}
+		static std::vector<uint8_t> Quantize(
+			const std::vector<float>& src, const std::array<uint32_t, 3>& dim,
+			const Parameters& param, ErrorReport* report = nullptr)
+		{
+			return Quantize(src.data(), dim, param, report);
+		}
+
+		/*
+		* 函数: FloatToHalf
+		* 功能: 单精度浮点转为半精度浮点，就近舍入（平局时取偶），溢出时为无穷，保留NaN
+		*/
+		static uint16_t FloatToHalf(float f)
+		{
+			uint32_t x;
+			std::memcpy(&x, &f, sizeof(x));
+			auto sign = static_cast<uint16_t>((x >> 16) & 0x8000);
+			auto absX = x & 0x7fffffff;
+
+			if (absX >= 0x7f800000) // 无穷或NaN
+				return sign | 0x7c00 | (absX > 0x7f800000 ? 0x200 : 0);
+			if (absX >= 0x477ff000) // 不小于65520时舍入为无穷
+				return sign | 0x7c00;
+			if (absX < 0x38800000) { // 小于2^-14时为非规格化数
+				if (absX < 0x33000000) // 不大于2^-25时舍入为0
+					return sign;
+				auto mant = (absX & 0x7fffff) | 0x800000;
+				auto shift = 126 - (absX >> 23);
+				auto h = mant >> shift;
+				auto rem = mant & ((1u << shift) - 1);
+				auto halfway = 1u << (shift - 1);
+				if (rem > halfway || (rem == halfway && (h & 1)))
+					++h;
+				return sign | static_cast<uint16_t>(h);
+			}
+
+			auto h = (absX - 0x38000000) >> 13; // 指数的偏置由127变为15
+			auto rem = absX & 0x1fff;
+			if (rem > 0x1000 || (rem == 0x1000 && (h & 1)))
+				++h;
+			return sign | static_cast<uint16_t>(h);
+		}
+		static float HalfToFloat(uint16_t h)
+		{
+			auto sign = static_cast<uint32_t>(h & 0x8000) << 16;
+			auto exp = (h >> 10) & 0x1f;
+			auto mant = static_cast<uint32_t>(h & 0x3ff);
+
+			if (exp == 0) {
+				auto v = mant * 5.9604644775390625e-8f; // 2^-24
+				return sign ? -v : v;
+			}
+
+			uint32_t x = exp == 0x1f ? sign | 0x7f800000 | (mant << 13)
+				: sign | ((exp + 112) << 23) | (mant << 13);
+			float f;
+			std::memcpy(&f, &x, sizeof(f));
+			return f;
+		}
+
+	private:
+		struct ErrorAccumulator
+		{
+			float maxAbsErr = 0.f;
+			double absErrSum = 0.;
+			double sqrErrSum = 0.;
+			size_t validNum = 0;
+			size_t clampedNum = 0;
+		};
+
+		template <typename T>
+		static T toUNorm(float v, float offset)
+		{
+			const auto MaxQ = static_cast<float>(std::numeric_limits<T>::max());
+			auto q = std::floor(v * MaxQ + .5f + offset);
+			// NaN不满足以下任何比较，映射为0
+			return q >= MaxQ ? static_cast<T>(MaxQ) : q > 0.f ? static_cast<T>(q) : 0;
+		}
+
+		/*
+		* 函数: ditherOffset
+		* 功能: 4x4x4有序抖动的阈值偏移，位于(-0.5, 0.5)。
+		*       由2x2x2基本矩阵递归展开，相邻的阈值分布在相距最远的体素上
+		*/
+		static float ditherOffset(uint32_t x, uint32_t y, uint32_t z)
+		{
+			static const uint8_t Base[8] = { 0, 4, 6, 2, 3, 7, 5, 1 };
+			auto lo = Base[(x & 1) | ((y & 1) << 1) | ((z & 1) << 2)];
+			auto hi = Base[((x >> 1) & 1) | (((y >> 1) & 1) << 1) | (((z >> 1) & 1) << 2)];
+			return (lo * 8 + hi + .5f) / 64.f - .5f;
+		}
+
+		template <typename T, typename QuantizeFunc, typename DequantizeFunc>
+		static void quantize(const float* src, const std::array<uint32_t, 3>& dim, T* dst,
+			const Parameters& param, ErrorReport* report,
+			const QuantizeFunc& quantizeFunc, const DequantizeFunc& dequantizeFunc)
+		{
+			auto dimYxX = static_cast<size_t>(dim[1]) * dim[0];
+			auto thrdNum = param.thrdNum == 0 ? GetWorkerThreadNum() : param.thrdNum;
+			std::vector<ErrorAccumulator> accs(thrdNum);
+
+			ParallelFor(dim[2], [&](uint32_t thrdIdx, size_t zBeg, size_t zEnd) {
+				ErrorAccumulator acc;
+				for (auto z = static_cast<uint32_t>(zBeg); z < zEnd; ++z)
+					for (uint32_t y = 0; y < dim[1]; ++y) {
+						auto offset = z * dimYxX + static_cast<size_t>(y) * dim[0];
+						auto srcRow = src + offset;
+						auto dstRow = dst + offset;
+						for (uint32_t x = 0; x < dim[0]; ++x)
+							dstRow[x] = quantizeFunc(srcRow[x], param.dither ? ditherOffset(x, y, z) : 0.f);
+
+						if (!report) continue;
+						for (uint32_t x = 0; x < dim[0]; ++x) {
+							auto v = srcRow[x];
+							if (v != v) continue;
+							auto err = dequantizeFunc(dstRow[x]) - v;
+							if (std::isinf(err)) {
+								++acc.clampedNum;
+								continue;
+							}
+							if (param.format != EFormat::Float16 && (v < 0.f || v > 1.f))
+								++acc.clampedNum;
+
+							auto absErr = std::abs(err);
+							if (absErr > acc.maxAbsErr)
+								acc.maxAbsErr = absErr;
+							acc.absErrSum += absErr;
+							acc.sqrErrSum += static_cast<double>(err) * err;
+							++acc.validNum;
+						}
+					}
+				accs[thrdIdx] = acc;
+				}, thrdNum);
+
+			if (!report) return;
+			ErrorAccumulator total;
+			for (auto& acc : accs) {
+				total.maxAbsErr = std::max(total.maxAbsErr, acc.maxAbsErr);
+				total.absErrSum += acc.absErrSum;
+				total.sqrErrSum += acc.sqrErrSum;
+				total.validNum += acc.validNum;
+				total.clampedNum += acc.clampedNum;
+			}
+			report->maxAbsErr = total.maxAbsErr;
+			if (total.validNum != 0) {
+				report->meanAbsErr = total.absErrSum / total.validNum;
+				report->rmsErr = std::sqrt(total.sqrErrSum / total.validNum);
+			}
+			report->clampedNum = total.clampedNum;
+		}
+	};
+}
+
+#endif // !SCIVIS_DATA_VOL_QUANTIZER_H
@@ -0,0 +1,120 @@
+#ifndef SCIVIS_DATA_VOL_REGION_H
+#define SCIVIS_DATA_VOL_REGION_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+#include <array>
+
+#include <osg/Math>
+
+#include <scivis/common/util.h>
+
+namespace SciVis
+{
+	/*
+	* 结构体: GeographicExtent
+	* 功能: 体在经度、纬度、高度上覆盖的范围，依次对应体的X、Y、Z轴。
+	*       经纬度的单位为角度，高度的单位由调用者决定，只需与体的高度范围一致
+	*/
+	struct GeographicExtent
+	{
+		std::array<float, 2> lonRng = { { 0.f, 0.f } };
+		std::array<float, 2> latRng = { { 0.f, 0.f } };
+		std::array<float, 2> hRng = { { 0.f, 0.f } };
+
+		GeographicExtent() {}
+		GeographicExtent(
+			const std::array<float, 2>& lonRng, const std::array<float, 2>& latRng, const std::array<float, 2>& hRng)
+			: lonRng(lonRng), latRng(latRng), hRng(hRng)
+		{}
+
+		std::array<float, 2>& operator[](uint8_t axis)
+		{
+			return axis == 0 ? lonRng : axis == 1 ? latRng : hRng;
+		}
+		const std::array<float, 2>& operator[](uint8_t axis) const
+		{
+			return axis == 0 ? lonRng : axis == 1 ? latRng : hRng;
+		}
+	};
+
+	/*
+	* 结构体: VolumeRegion
+	* 功能: 体中轴对齐的子区域（感兴趣区域），由最小角点的体素下标与子区域的尺寸组成。
+	*       尺寸中有0时表示整个体，这也是默认值
+	*/
+	struct VolumeRegion
+	{
+		std::array<uint32_t, 3> beg = { { 0, 0, 0 } };
+		std::array<uint32_t, 3> dim = { { 0, 0, 0 } };
+		GeographicExtent ext; // 子区域的地理范围，已对齐到体素的边界，可直接用于绘制组件的Set*Range
+
+		bool IsWhole() const
+		{
+			return dim[0] == 0 || dim[1] == 0 || dim[2] == 0;
+		}
+		bool IsWholeOf(const std::array<uint32_t, 3>& volDim) const
+		{
+			return IsWhole() || (beg[0] == 0 && beg[1] == 0 && beg[2] == 0 && dim == volDim);
+		}
+		bool IsInside(const std::array<uint32_t, 3>& volDim) const
+		{
+			if (IsWhole())
+				return true;
+			for (uint8_t i = 0; i < 3; ++i)
+				if (beg[i] >= volDim[i] || dim[i] > volDim[i] - beg[i])
+					return false;
+			return true;
+		}
+		/*
+		* 函数: GetDimension
+		* 功能: 获取子区域在尺寸为volDim的体中的实际尺寸
+		*/
+		std::array<uint32_t, 3> GetDimension(const std::array<uint32_t, 3>& volDim) const
+		{
+			return IsWhole() ? volDim : dim;
+		}
+
+		/*
+		* 函数: FromGeographic
+		* 功能: 将地理范围映射为体素下标范围。体素i在各轴上覆盖[lo + i * w, lo + (i + 1) * w)，
+		*       w为体的范围除以该轴的体素数，与绘制时纹理坐标到经纬高的映射一致。
+		*       子区域包含与roiExt相交的所有体素，其范围ext向外对齐到体素的边界
+		* 参数:
+		* -- volDim: 整个体的三维尺寸
+		* -- volExt: 整个体的地理范围
+		* -- roiExt: 感兴趣的地理范围
+		*/
+		static ReteurnOrError<VolumeRegion> FromGeographic(
+			const std::array<uint32_t, 3>& volDim, const GeographicExtent& volExt, const GeographicExtent& roiExt)
+		{
+			VolumeRegion ret;
+			for (uint8_t i = 0; i < 3; ++i) {
+				const auto& rng = volExt[i];
+				const auto& roiRng = roiExt[i];
+				if (volDim[i] == 0 || !(rng[0] < rng[1]))
+					return "Invalid volume extent.";
+				if (!(roiRng[0] < roiRng[1]))
+					return "Invalid ROI extent.";
+
+				auto wid = (static_cast<double>(rng[1]) - rng[0]) / volDim[i];
+				auto lo = std::floor((roiRng[0] - rng[0]) / wid);
+				auto hi = std::ceil((roiRng[1] - rng[0]) / wid);
+				lo = std::max(lo, 0.);
+				hi = std::min(hi, static_cast<double>(volDim[i]));
+				if (lo >= hi)
+					return "ROI does not intersect the volume.";
+
+				ret.beg[i] = static_cast<uint32_t>(lo);
+				ret.dim[i] = static_cast<uint32_t>(hi) - ret.beg[i];
+				ret.ext[i][0] = static_cast<float>(rng[0] + lo * wid);
+				ret.ext[i][1] = static_cast<float>(rng[0] + hi * wid);
+			}
+			return ret;
+		}
+	};
+}
+
+#endif // !SCIVIS_DATA_VOL_REGION_H
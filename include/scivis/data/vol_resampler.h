@@ -0,0 +1,309 @@
+#ifndef SCIVIS_DATA_VOL_RESAMPLER_H
+#define SCIVIS_DATA_VOL_RESAMPLER_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+
+#include <array>
+#include <vector>
+
+#include <scivis/common/parallel.h>
+
+namespace SciVis
+{
+	/*
+	* 类: VolumeResampler
+	* 功能: 体数据重采样。按轴依次进行一维卷积（可分离），每个轴上的滤波权重只计算一次，
+	*       缩小时核按缩放倍数展宽以避免走样，放大时核保持原宽度。体素视为位于格子中心，边界按最近体素延拓
+	*/
+	class VolumeResampler
+	{
+	public:
+		enum class EKernel
+		{
+			Box = 0, // 缩小时为区域平均，放大时为最近邻
+			Tent, // 线性插值
+			Lanczos2
+		};
+
+		struct Parameters
+		{
+			EKernel kernel = EKernel::Tent;
+			uint32_t thrdNum = 0; // 为0时使用硬件并发数
+		};
+
+		template <typename T>
+		struct MipLevel
+		{
+			std::array<uint32_t, 3> dim;
+			std::vector<T> dat;
+		};
+
+		/*
+		* 函数: Resample
+		* 功能: 将src重采样为dstDim大小，写入dst。整数类型的输出四舍五入并饱和到该类型的取值范围
+		* 参数:
+		* -- src: 以X为最快变化维度排列的体数据
+		* -- srcDim: 输入体的三维尺寸
+		* -- dst: 输出缓冲，大小需不小于dstDim三个分量的乘积
+		* -- dstDim: 输出体的三维尺寸
+		*/
+		template <typename T, typename U>
+		static void Resample(
+			const T* src, const std::array<uint32_t, 3>& srcDim,
+			U* dst, const std::array<uint32_t, 3>& dstDim,
+			const Parameters& param = Parameters())
+		{
+			// 先处理缩小倍数最大的轴，使后续各轴处理的数据量最小
+			std::vector<uint8_t> axes;
+			for (uint8_t a = 0; a < 3; ++a)
+				if (srcDim[a] != dstDim[a])
+					axes.emplace_back(a);
+			std::sort(axes.begin(), axes.end(), [&](uint8_t a, uint8_t b) {
+				return static_cast<double>(dstDim[a]) / srcDim[a] < static_cast<double>(dstDim[b]) / srcDim[b];
+				});
+
+			if (axes.empty()) {
+				auto voxNum = voxelNum(srcDim);
+				ParallelFor(voxNum, [&](uint32_t, size_t beg, size_t end) {
+					for (auto i = beg; i < end; ++i)
+						dst[i] = fromFloat<U>(static_cast<float>(src[i]));
+					}, param.thrdNum);
+				return;
+			}
+
+			std::array<std::vector<float>, 2> bufs;
+			const float* curr = nullptr;
+			auto currDim = srcDim;
+			for (size_t i = 0; i < axes.size(); ++i) {
+				auto a = axes[i];
+				auto nextDim = currDim;
+				nextDim[a] = dstDim[a];
+				auto contrib = makeContributions(currDim[a], dstDim[a], param.kernel);
+
+				auto isFirst = i == 0;
+				auto isLast = i + 1 == axes.size();
+				if (isFirst && isLast)
+					resampleAxis(src, currDim, dst, a, contrib, param.thrdNum);
+				else if (isLast)
+					resampleAxis(curr, currDim, dst, a, contrib, param.thrdNum);
+				else {
+					auto& buf = bufs[i % 2];
+					buf.resize(voxelNum(nextDim));
+					if (isFirst)
+						resampleAxis(src, currDim, buf.data(), a, contrib, param.thrdNum);
+					else
+						resampleAxis(curr, currDim, buf.data(), a, contrib, param.thrdNum);
+					curr = buf.data();
+				}
+				currDim = nextDim;
+			}
+		}
+		template <typename T>
+		static std::vector<T> Resample(
+			const std::vector<T>& src, const std::array<uint32_t, 3>& srcDim,
+			const std::array<uint32_t, 3>& dstDim,
+			const Parameters& param = Parameters())
+		{
+			std::vector<T> dst(voxelNum(dstDim));
+			Resample(src.data(), srcDim, dst.data(), dstDim, param);
+			return dst;
+		}
+
+		/*
+		* 函数: BuildMipPyramid
+		* 功能: 生成完整的多级渐远体，第0级为输入本身，之后每级各轴尺寸减半（不小于1），直至1x1x1
+		*/
+		template <typename T>
+		static std::vector<MipLevel<T>> BuildMipPyramid(
+			const T* src, const std::array<uint32_t, 3>& dim,
+			const Parameters& param = Parameters())
+		{
+			std::vector<MipLevel<T>> levels;
+			levels.emplace_back();
+			levels.back().dim = dim;
+			levels.back().dat.assign(src, src + voxelNum(dim));
+
+			while (levels.back().dim[0] > 1 || levels.back().dim[1] > 1 || levels.back().dim[2] > 1) {
+				auto& prev = levels.back();
+				MipLevel<T> lvl;
+				for (uint8_t a = 0; a < 3; ++a)
+					lvl.dim[a] = std::max(prev.dim[a] >> 1, static_cast<uint32_t>(1));
+				lvl.dat.resize(voxelNum(lvl.dim));
+				Resample(prev.dat.data(), prev.dim, lvl.dat.data(), lvl.dim, param);
+				levels.emplace_back(std::move(lvl));
+			}
+
+			return levels;
+		}
+
+	private:
+		struct Contributions
+		{
+			std::vector<uint32_t> begs; // 第i个输出的权重位于[begs[i], begs[i + 1])
+			std::vector<uint32_t> srcIdxs;
+			std::vector<float> weights;
+		};
+
+		static size_t voxelNum(const std::array<uint32_t, 3>& dim)
+		{
+			return static_cast<size_t>(dim[0]) * dim[1] * dim[2];
+		}
+
+		template <typename U>
+		static typename std::enable_if<std::is_floating_point<U>::value, U>::type fromFloat(float v)
+		{
+			return static_cast<U>(v);
+		}
+		template <typename U>
+		static typename std::enable_if<!std::is_floating_point<U>::value, U>::type fromFloat(float v)
+		{
+			v = std::floor(v + .5f);
+			v = std::min(std::max(v, static_cast<float>(std::numeric_limits<U>::lowest())),
+				static_cast<float>(std::numeric_limits<U>::max()));
+			return static_cast<U>(v);
+		}
+
+		static float kernelSupport(EKernel kernel)
+		{
+			switch (kernel)
+			{
+			case EKernel::Box:
+				return .5f;
+			case EKernel::Tent:
+				return 1.f;
+			default:
+				return 2.f;
+			}
+		}
+		static float kernelWeight(EKernel kernel, float x)
+		{
+			switch (kernel)
+			{
+			case EKernel::Box:
+				return x >= -.5f && x < .5f ? 1.f : 0.f;
+			case EKernel::Tent:
+				x = std::abs(x);
+				return x < 1.f ? 1.f - x : 0.f;
+			default:
+			{
+				x = std::abs(x);
+				if (x >= 2.f) return 0.f;
+				if (x < 1e-6f) return 1.f;
+				const auto Pi = 3.14159265358979323846;
+				auto pix = Pi * x;
+				return static_cast<float>(2. * std::sin(pix) * std::sin(pix * .5) / (pix * pix));
+			}
+			}
+		}
+
+		static Contributions makeContributions(uint32_t srcLen, uint32_t dstLen, EKernel kernel)
+		{
+			Contributions contrib;
+			contrib.begs.reserve(dstLen + 1);
+
+			auto scale = static_cast<double>(srcLen) / dstLen;
+			auto filterScale = std::max(scale, 1.);
+			auto support = kernelSupport(kernel) * filterScale;
+			for (uint32_t i = 0; i < dstLen; ++i) {
+				auto beg = static_cast<uint32_t>(contrib.weights.size());
+				contrib.begs.emplace_back(beg);
+
+				auto center = (i + .5) * scale - .5;
+				auto lo = static_cast<int64_t>(std::ceil(center - support));
+				auto hi = static_cast<int64_t>(std::floor(center + support));
+				auto sum = 0.f;
+				for (auto j = lo; j <= hi; ++j) {
+					auto w = kernelWeight(kernel, static_cast<float>((j - center) / filterScale));
+					if (w == 0.f) continue;
+
+					auto idx = static_cast<uint32_t>(j < 0 ? 0 : j >= srcLen ? srcLen - 1 : j);
+					// 被钳制到同一体素的权重合并为一项
+					if (contrib.srcIdxs.size() > beg && contrib.srcIdxs.back() == idx)
+						contrib.weights.back() += w;
+					else {
+						contrib.srcIdxs.emplace_back(idx);
+						contrib.weights.emplace_back(w);
+					}
+					sum += w;
+				}
+
+				if (contrib.weights.size() == beg || std::abs(sum) < 1e-6f) {
+					contrib.srcIdxs.resize(beg);
+					contrib.weights.resize(beg);
+					auto nearest = static_cast<int64_t>(std::floor(center + .5));
+					contrib.srcIdxs.emplace_back(static_cast<uint32_t>(
+						nearest < 0 ? 0 : nearest >= srcLen ? srcLen - 1 : nearest));
+					contrib.weights.emplace_back(1.f);
+				}
+				else
+					for (auto k = beg; k < contrib.weights.size(); ++k)
+						contrib.weights[k] /= sum;
+			}
+			contrib.begs.emplace_back(static_cast<uint32_t>(contrib.weights.size()));
+
+			return contrib;
+		}
+
+		/*
+		* 函数: resampleAxis
+		* 功能: 沿axis轴重采样，其余两轴尺寸不变。沿Y、Z轴时以整行、整片为单位加权累加，内循环连续访存
+		*/
+		template <typename In, typename Out>
+		static void resampleAxis(
+			const In* src, const std::array<uint32_t, 3>& srcDim, Out* dst,
+			uint8_t axis, const Contributions& contrib, uint32_t thrdNum)
+		{
+			auto dstLen = static_cast<uint32_t>(contrib.begs.size() - 1);
+			auto srcYxX = static_cast<size_t>(srcDim[1]) * srcDim[0];
+
+			if (axis == 0) {
+				auto rowNum = static_cast<size_t>(srcDim[1]) * srcDim[2];
+				ParallelFor(rowNum, [&](uint32_t, size_t beg, size_t end) {
+					for (auto r = beg; r < end; ++r) {
+						auto srcRow = src + r * srcDim[0];
+						auto dstRow = dst + r * dstLen;
+						for (uint32_t x = 0; x < dstLen; ++x) {
+							auto val = 0.f;
+							for (auto k = contrib.begs[x]; k < contrib.begs[x + 1]; ++k)
+								val += contrib.weights[k] * static_cast<float>(srcRow[contrib.srcIdxs[k]]);
+							dstRow[x] = fromFloat<Out>(val);
+						}
+					}
+					}, thrdNum);
+				return;
+			}
+
+			// 沿Y轴时，每个Z切片内按行累加；沿Z轴时，按整个切片累加
+			auto lineLen = axis == 1 ? static_cast<size_t>(srcDim[0]) : srcYxX;
+			auto outerNum = axis == 1 ? static_cast<size_t>(srcDim[2]) : static_cast<size_t>(dstLen);
+			auto innerNum = axis == 1 ? dstLen : static_cast<uint32_t>(1);
+			auto srcOuterStride = axis == 1 ? srcYxX : 0;
+			auto dstOuterStride = axis == 1 ? static_cast<size_t>(dstLen) * srcDim[0] : srcYxX;
+
+			ParallelFor(outerNum, [&](uint32_t, size_t beg, size_t end) {
+				std::vector<float> acc(lineLen);
+				for (auto o = beg; o < end; ++o)
+					for (uint32_t in = 0; in < innerNum; ++in) {
+						auto i = axis == 1 ? in : static_cast<uint32_t>(o);
+						std::fill(acc.begin(), acc.end(), 0.f);
+						for (auto k = contrib.begs[i]; k < contrib.begs[i + 1]; ++k) {
+							auto w = contrib.weights[k];
+							auto srcLine = src + o * srcOuterStride + contrib.srcIdxs[k] * lineLen;
+							for (size_t j = 0; j < lineLen; ++j)
+								acc[j] += w * static_cast<float>(srcLine[j]);
+						}
+
+						auto dstLine = dst + o * dstOuterStride + (axis == 1 ? in * lineLen : 0);
+						for (size_t j = 0; j < lineLen; ++j)
+							dstLine[j] = fromFloat<Out>(acc[j]);
+					}
+				}, thrdNum);
+		}
+	};
+}
+
+#endif // !SCIVIS_DATA_VOL_RESAMPLER_H
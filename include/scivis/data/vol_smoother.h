@@ -0,0 +1,200 @@
+#ifndef SCIVIS_DATA_VOL_SMOOTHER_H
+#define SCIVIS_DATA_VOL_SMOOTHER_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+#include <array>
+#include <vector>
+
+#include <scivis/common/parallel.h>
+
+namespace SciVis
+{
+	/*
+	* 类: VolumeSmoother
+	* 功能: 体数据平滑滤波。边界按最近体素延拓，边界处理在行/切片级别完成，卷积内循环中不做逐次采样的钳制。
+	*       各轴的处理按Z切片划分到多个线程上执行
+	*/
+	class VolumeSmoother
+	{
+	public:
+		enum class EKernel
+		{
+			Box = 0,
+			Gaussian
+		};
+
+		struct Parameters
+		{
+			EKernel kernel = EKernel::Box;
+			uint32_t radius = 1; // 核在每个轴上的半径，核宽为2 * radius + 1
+			float sigma = 0.f; // 高斯核的标准差，不大于0时取radius / 2
+			uint32_t thrdNum = 0; // 为0时使用硬件并发数
+		};
+
+		/*
+		* 函数: Smooth
+		* 功能: 对体数据进行平滑。
+		*       半径为1的盒式核按原3x3x3均值滤波的累加次序直接求和，结果与其逐位一致；
+		*       其余情况使用可分离的三次一维卷积
+		* 参数:
+		* -- src: 以X为最快变化维度排列的体数据
+		* -- dim: 体的三维尺寸
+		* -- param: 滤波参数
+		*/
+		static std::vector<float> Smooth(
+			const float* src, const std::array<uint32_t, 3>& dim, const Parameters& param)
+		{
+			auto voxNum = static_cast<size_t>(dim[0]) * dim[1] * dim[2];
+			std::vector<float> dst(voxNum);
+			if (voxNum == 0)
+				return dst;
+			if (param.radius == 0) {
+				std::memcpy(dst.data(), src, voxNum * sizeof(float));
+				return dst;
+			}
+
+			if (param.kernel == EKernel::Box && param.radius == 1) {
+				box3x3x3(src, dst.data(), dim, param.thrdNum);
+				return dst;
+			}
+
+			auto weights = kernelWeights(param);
+			std::vector<float> tmp(voxNum);
+			convolveX(src, tmp.data(), dim, weights, param.thrdNum);
+			convolveYZ(tmp.data(), dst.data(), dim, weights, 1, param.thrdNum);
+			convolveYZ(dst.data(), tmp.data(), dim, weights, 2, param.thrdNum);
+			return tmp;
+		}
+		static std::vector<float> Smooth(
+			const std::vector<float>& src, const std::array<uint32_t, 3>& dim, const Parameters& param)
+		{
+			return Smooth(src.data(), dim, param);
+		}
+
+	private:
+		static std::vector<float> kernelWeights(const Parameters& param)
+		{
+			auto r = static_cast<int32_t>(param.radius);
+			std::vector<float> weights(2 * r + 1);
+			if (param.kernel == EKernel::Box) {
+				std::fill(weights.begin(), weights.end(), 1.f / weights.size());
+				return weights;
+			}
+
+			auto sigma = param.sigma > 0.f ? param.sigma : .5f * r;
+			auto sum = 0.;
+			for (int32_t k = -r; k <= r; ++k) {
+				auto w = std::exp(-.5 * k * k / (static_cast<double>(sigma) * sigma));
+				weights[k + r] = static_cast<float>(w);
+				sum += w;
+			}
+			for (auto& w : weights)
+				w = static_cast<float>(w / sum);
+			return weights;
+		}
+
+		static uint32_t clampIdx(int64_t i, uint32_t len)
+		{
+			return static_cast<uint32_t>(i < 0 ? 0 : i >= len ? len - 1 : i);
+		}
+
+		static void box3x3x3(const float* src, float* dst, const std::array<uint32_t, 3>& dim, uint32_t thrdNum)
+		{
+			auto dimYxX = static_cast<size_t>(dim[1]) * dim[0];
+			// 预先计算X方向钳制后的邻居下标
+			std::vector<std::array<uint32_t, 3>> xNbrs(dim[0]);
+			for (uint32_t x = 0; x < dim[0]; ++x)
+				for (int8_t dx = -1; dx < 2; ++dx)
+					xNbrs[x][dx + 1] = clampIdx(static_cast<int64_t>(x) + dx, dim[0]);
+
+			ParallelFor(dim[2], [&](uint32_t, size_t zBeg, size_t zEnd) {
+				std::array<const float*, 9> rows;
+				for (auto z = static_cast<uint32_t>(zBeg); z < zEnd; ++z)
+					for (uint32_t y = 0; y < dim[1]; ++y) {
+						for (int8_t dz = -1; dz < 2; ++dz)
+							for (int8_t dy = -1; dy < 2; ++dy)
+								rows[(dz + 1) * 3 + (dy + 1)] = src
+								+ clampIdx(static_cast<int64_t>(z) + dz, dim[2]) * dimYxX
+								+ static_cast<size_t>(clampIdx(static_cast<int64_t>(y) + dy, dim[1])) * dim[0];
+
+						auto dstRow = dst + z * dimYxX + static_cast<size_t>(y) * dim[0];
+						for (uint32_t x = 0; x < dim[0]; ++x) {
+							auto& nbr = xNbrs[x];
+							// 保持与原实现相同的累加次序，以保证结果逐位一致
+							auto val = 0.f;
+							for (uint8_t r = 0; r < 9; ++r) {
+								val += rows[r][nbr[0]];
+								val += rows[r][nbr[1]];
+								val += rows[r][nbr[2]];
+							}
+							dstRow[x] = val / 27.f;
+						}
+					}
+				}, thrdNum);
+		}
+
+		static void convolveX(const float* src, float* dst, const std::array<uint32_t, 3>& dim,
+			const std::vector<float>& weights, uint32_t thrdNum)
+		{
+			auto dimYxX = static_cast<size_t>(dim[1]) * dim[0];
+			auto r = static_cast<uint32_t>(weights.size() / 2);
+
+			ParallelFor(dim[2], [&](uint32_t, size_t zBeg, size_t zEnd) {
+				// 行两端按边界值延拓后，卷积无需钳制下标
+				std::vector<float> padded(dim[0] + 2 * r);
+				for (auto z = zBeg; z < zEnd; ++z)
+					for (uint32_t y = 0; y < dim[1]; ++y) {
+						auto srcRow = src + z * dimYxX + static_cast<size_t>(y) * dim[0];
+						auto dstRow = dst + z * dimYxX + static_cast<size_t>(y) * dim[0];
+						std::fill(padded.begin(), padded.begin() + r, srcRow[0]);
+						std::memcpy(padded.data() + r, srcRow, dim[0] * sizeof(float));
+						std::fill(padded.begin() + r + dim[0], padded.end(), srcRow[dim[0] - 1]);
+
+						for (uint32_t x = 0; x < dim[0]; ++x) {
+							auto val = 0.f;
+							for (size_t k = 0; k < weights.size(); ++k)
+								val += weights[k] * padded[x + k];
+							dstRow[x] = val;
+						}
+					}
+				}, thrdNum);
+		}
+
+		/*
+		* 函数: convolveYZ
+		* 功能: 沿Y（axis = 1）或Z（axis = 2）轴卷积。以整行为单位加权累加，内循环沿X连续访存
+		*/
+		static void convolveYZ(const float* src, float* dst, const std::array<uint32_t, 3>& dim,
+			const std::vector<float>& weights, uint8_t axis, uint32_t thrdNum)
+		{
+			auto dimYxX = static_cast<size_t>(dim[1]) * dim[0];
+			auto r = static_cast<int64_t>(weights.size() / 2);
+			auto stride = axis == 1 ? static_cast<size_t>(dim[0]) : dimYxX;
+			auto len = dim[axis];
+
+			ParallelFor(dim[2], [&](uint32_t, size_t zBeg, size_t zEnd) {
+				std::vector<const float*> taps(weights.size());
+				for (auto z = zBeg; z < zEnd; ++z)
+					for (uint32_t y = 0; y < dim[1]; ++y) {
+						auto i = static_cast<int64_t>(axis == 1 ? y : z);
+						auto base = src + z * dimYxX + static_cast<size_t>(y) * dim[0] - i * stride;
+						for (int64_t k = -r; k <= r; ++k)
+							taps[k + r] = base + clampIdx(i + k, len) * stride;
+
+						auto dstRow = dst + z * dimYxX + static_cast<size_t>(y) * dim[0];
+						for (uint32_t x = 0; x < dim[0]; ++x)
+							dstRow[x] = weights[0] * taps[0][x];
+						for (size_t k = 1; k < weights.size(); ++k)
+							for (uint32_t x = 0; x < dim[0]; ++x)
+								dstRow[x] += weights[k] * taps[k][x];
+					}
+				}, thrdNum);
+		}
+	};
+}
+
+#endif // !SCIVIS_DATA_VOL_SMOOTHER_H
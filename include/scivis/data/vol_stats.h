@@ -0,0 +1,296 @@
+#ifndef SCIVIS_DATA_VOL_STATS_H
+#define SCIVIS_DATA_VOL_STATS_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <mutex>
+
+#include <array>
+#include <vector>
+
+#include <scivis/common/parallel.h>
+#include <scivis/data/vol_view.h>
+
+namespace SciVis
+{
+	/*
+	* 类: VolumeStatistics
+	* 功能: 体数据的统计量，包括全局值域、均值、直方图、百分位数、各Z切片与各砖块的极值。
+	*       体沿Z轴被划分为若干层（有砖块时每层为一层砖块），各层在多个线程上一次遍历完成所有统计。
+	*       统计时跳过NaN与nullVal
+	*/
+	class VolumeStatistics
+	{
+	public:
+		struct Parameters
+		{
+			uint32_t binNum = 256;
+			// 直方图的值域，值域外的值计入两端的箱。下界不小于上界时取体的值域，此时直方图需第二次遍历
+			std::array<float, 2> histRng = { { 0.f, 0.f } };
+			float nullVal = std::numeric_limits<float>::quiet_NaN();
+			uint32_t brickLen = 0; // 砖块的边长，为0时不统计砖块的极值
+			// 为真时，每个砖块的极值还包含其后（X、Y、Z正方向上）相邻砖块的极值，
+			// 从而覆盖以该砖块内体素为起点的所有单元，可用于Marching Cubes跳过不含等值面的砖块
+			bool brickApron = false;
+			uint32_t thrdNum = 0; // 为0时使用硬件并发数
+		};
+
+		struct Result
+		{
+			std::array<float, 2> valRng = { {
+				std::numeric_limits<float>::max(), std::numeric_limits<float>::lowest() } }; // 无有效体素时下界大于上界
+			size_t validNum = 0;
+			double mean = 0.;
+			std::array<float, 2> histRng = { { 0.f, 0.f } };
+			std::vector<uint64_t> hist;
+			std::vector<std::array<float, 2>> sliceRngs; // 各Z切片的极值
+			uint32_t brickLen = 0;
+			std::array<uint32_t, 3> brickNum = { { 0, 0, 0 } };
+			std::vector<std::array<float, 2>> brickRngs; // 各砖块的极值，以X为最快变化维度排列
+
+			/*
+			* 函数: GetPercentile
+			* 功能: 由直方图估计百分位数，在所在的箱内线性插值
+			* 参数:
+			* -- p: 位于[0, 1]的分位
+			*/
+			float GetPercentile(float p) const
+			{
+				if (validNum == 0)
+					return 0.f;
+				if (hist.empty())
+					return valRng[0] + std::min(std::max(p, 0.f), 1.f) * (valRng[1] - valRng[0]);
+
+				auto target = static_cast<double>(std::min(std::max(p, 0.f), 1.f)) * validNum;
+				auto binWid = static_cast<double>(histRng[1] - histRng[0]) / hist.size();
+				double cum = 0.;
+				for (size_t i = 0; i < hist.size(); ++i) {
+					if (hist[i] != 0 && cum + hist[i] >= target) {
+						auto t = (target - cum) / hist[i];
+						auto val = static_cast<float>(histRng[0] + (i + t) * binWid);
+						return std::min(std::max(val, valRng[0]), valRng[1]);
+					}
+					cum += hist[i];
+				}
+				return valRng[1];
+			}
+			const std::array<float, 2>& GetBrickRange(uint32_t bx, uint32_t by, uint32_t bz) const
+			{
+				return brickRngs[(static_cast<size_t>(bz) * brickNum[1] + by) * brickNum[0] + bx];
+			}
+		};
+
+		template <typename T>
+		static Result Compute(const VolumeView<T>& vol)
+		{
+			return Compute(vol, Parameters());
+		}
+		/*
+		* 函数: Compute
+		* 功能: 计算体视图的统计量
+		*/
+		template <typename T>
+		static Result Compute(const VolumeView<T>& vol, const Parameters& param)
+		{
+			Result ret;
+			if (vol.IsEmpty())
+				return ret;
+
+			auto thrdNum = param.thrdNum == 0 ? GetWorkerThreadNum() : param.thrdNum;
+			auto layerLen = param.brickLen == 0 ? 1 : param.brickLen;
+			auto layerNum = (vol.dim[2] + layerLen - 1) / layerLen;
+			auto hasHistRng = param.binNum != 0 && param.histRng[0] < param.histRng[1];
+
+			ret.sliceRngs.assign(vol.dim[2], ret.valRng);
+			if (param.brickLen != 0) {
+				ret.brickLen = param.brickLen;
+				for (uint8_t i = 0; i < 3; ++i)
+					ret.brickNum[i] = (vol.dim[i] + param.brickLen - 1) / param.brickLen;
+				ret.brickRngs.assign(
+					static_cast<size_t>(ret.brickNum[0]) * ret.brickNum[1] * ret.brickNum[2], ret.valRng);
+			}
+
+			struct Accumulator
+			{
+				std::array<float, 2> rng;
+				size_t num = 0;
+				double sum = 0.;
+				std::vector<uint64_t> hist;
+			};
+			std::vector<Accumulator> accs(thrdNum);
+			for (auto& acc : accs) {
+				acc.rng = ret.valRng;
+				if (hasHistRng)
+					acc.hist.assign(param.binNum, 0);
+			}
+			auto binScale = hasHistRng ? param.binNum / (param.histRng[1] - param.histRng[0]) : 0.f;
+
+			ParallelFor(layerNum, [&](uint32_t thrdIdx, size_t lBeg, size_t lEnd) {
+				auto& acc = accs[thrdIdx];
+				for (auto l = lBeg; l < lEnd; ++l) {
+					auto zBeg = static_cast<uint32_t>(l * layerLen);
+					auto zEnd = std::min(zBeg + layerLen, vol.dim[2]);
+					for (auto z = zBeg; z < zEnd; ++z) {
+						auto& sliceRng = ret.sliceRngs[z];
+						for (uint32_t y = 0; y < vol.dim[1]; ++y) {
+							auto row = vol.Row(y, z);
+							auto brickRow = param.brickLen == 0 ? nullptr : &ret.brickRngs[
+								(static_cast<size_t>(l) * ret.brickNum[1] + y / param.brickLen) * ret.brickNum[0]];
+							for (uint32_t x = 0; x < vol.dim[0]; ++x) {
+								auto v = static_cast<float>(row[x * vol.strides[0]]);
+								if (std::isnan(v) || v == param.nullVal)
+									continue;
+
+								sliceRng[0] = std::min(sliceRng[0], v);
+								sliceRng[1] = std::max(sliceRng[1], v);
+								if (brickRow) {
+									auto& brickRng = brickRow[x / param.brickLen];
+									brickRng[0] = std::min(brickRng[0], v);
+									brickRng[1] = std::max(brickRng[1], v);
+								}
+								++acc.num;
+								acc.sum += v;
+								if (hasHistRng)
+									++acc.hist[binOf(v, param.histRng[0], binScale, param.binNum)];
+							}
+						}
+						acc.rng[0] = std::min(acc.rng[0], sliceRng[0]);
+						acc.rng[1] = std::max(acc.rng[1], sliceRng[1]);
+					}
+				}
+				}, thrdNum);
+
+			double sum = 0.;
+			for (auto& acc : accs) {
+				ret.valRng[0] = std::min(ret.valRng[0], acc.rng[0]);
+				ret.valRng[1] = std::max(ret.valRng[1], acc.rng[1]);
+				ret.validNum += acc.num;
+				sum += acc.sum;
+			}
+			if (ret.validNum != 0)
+				ret.mean = sum / ret.validNum;
+
+			if (param.brickApron && param.brickLen != 0)
+				extendBricksToNeighbors(ret);
+
+			if (param.binNum == 0 || ret.validNum == 0)
+				return ret;
+			if (hasHistRng) {
+				ret.histRng = param.histRng;
+				ret.hist.assign(param.binNum, 0);
+				for (auto& acc : accs)
+					for (uint32_t i = 0; i < param.binNum; ++i)
+						ret.hist[i] += acc.hist[i];
+				return ret;
+			}
+
+			// 值域在第一次遍历后才确定，直方图在第二次遍历中统计
+			ret.histRng = ret.valRng;
+			if (ret.histRng[0] == ret.histRng[1])
+				ret.histRng[1] = ret.histRng[0] + 1.f;
+			binScale = param.binNum / (ret.histRng[1] - ret.histRng[0]);
+			for (auto& acc : accs)
+				acc.hist.assign(param.binNum, 0);
+			ParallelFor(vol.dim[2], [&](uint32_t thrdIdx, size_t zBeg, size_t zEnd) {
+				auto& hist = accs[thrdIdx].hist;
+				for (auto z = zBeg; z < zEnd; ++z)
+					for (uint32_t y = 0; y < vol.dim[1]; ++y) {
+						auto row = vol.Row(y, static_cast<uint32_t>(z));
+						for (uint32_t x = 0; x < vol.dim[0]; ++x) {
+							auto v = static_cast<float>(row[x * vol.strides[0]]);
+							if (std::isnan(v) || v == param.nullVal)
+								continue;
+							++hist[binOf(v, ret.histRng[0], binScale, param.binNum)];
+						}
+					}
+				}, thrdNum);
+			ret.hist.assign(param.binNum, 0);
+			for (auto& acc : accs)
+				for (uint32_t i = 0; i < param.binNum; ++i)
+					ret.hist[i] += acc.hist[i];
+			return ret;
+		}
+
+	private:
+		static uint32_t binOf(float v, float lo, float binScale, uint32_t binNum)
+		{
+			auto b = (v - lo) * binScale;
+			if (!(b > 0.f))
+				return 0;
+			return std::min(static_cast<uint32_t>(b), binNum - 1);
+		}
+
+		static void extendBricksToNeighbors(Result& ret)
+		{
+			auto& bn = ret.brickNum;
+			auto rngs = ret.brickRngs;
+			for (uint32_t bz = 0; bz < bn[2]; ++bz)
+				for (uint32_t by = 0; by < bn[1]; ++by)
+					for (uint32_t bx = 0; bx < bn[0]; ++bx) {
+						auto& dst = ret.brickRngs[(static_cast<size_t>(bz) * bn[1] + by) * bn[0] + bx];
+						for (uint32_t dz = 0; dz < 2 && bz + dz < bn[2]; ++dz)
+							for (uint32_t dy = 0; dy < 2 && by + dy < bn[1]; ++dy)
+								for (uint32_t dx = 0; dx < 2 && bx + dx < bn[0]; ++dx) {
+									auto& src = rngs[(static_cast<size_t>(bz + dz) * bn[1] + by + dy) * bn[0] + bx + dx];
+									dst[0] = std::min(dst[0], src[0]);
+									dst[1] = std::max(dst[1], src[1]);
+								}
+					}
+		}
+	};
+
+	/*
+	* 类: VolumeStatisticsCache
+	* 功能: 随体保存的统计结果。以体视图（地址、尺寸与步长）与统计参数为键，二者不变时直接返回上次的结果。
+	*       原地修改了体数据后应调用Invalidate。可在多个线程上同时调用
+	*/
+	class VolumeStatisticsCache
+	{
+	public:
+		template <typename T>
+		std::shared_ptr<const VolumeStatistics::Result> Get(const VolumeView<T>& vol)
+		{
+			return Get(vol, VolumeStatistics::Parameters());
+		}
+		template <typename T>
+		std::shared_ptr<const VolumeStatistics::Result> Get(
+			const VolumeView<T>& vol, const VolumeStatistics::Parameters& param)
+		{
+			std::lock_guard<std::mutex> lk(mtx);
+			if (result && datPtr == vol.dat && dim == vol.dim && strides == vol.strides && isSameParameters(param))
+				return result;
+
+			result = std::make_shared<const VolumeStatistics::Result>(VolumeStatistics::Compute(vol, param));
+			datPtr = vol.dat;
+			dim = vol.dim;
+			strides = vol.strides;
+			this->param = param;
+			return result;
+		}
+		void Invalidate()
+		{
+			std::lock_guard<std::mutex> lk(mtx);
+			result = nullptr;
+		}
+
+	private:
+		std::mutex mtx;
+		std::shared_ptr<const VolumeStatistics::Result> result;
+		const void* datPtr = nullptr;
+		std::array<uint32_t, 3> dim;
+		std::array<size_t, 3> strides;
+		VolumeStatistics::Parameters param;
+
+		bool isSameParameters(const VolumeStatistics::Parameters& other) const
+		{
+			auto sameNull = (std::isnan(param.nullVal) && std::isnan(other.nullVal)) || param.nullVal == other.nullVal;
+			return param.binNum == other.binNum && param.histRng == other.histRng && sameNull
+				&& param.brickLen == other.brickLen && param.brickApron == other.brickApron;
+		}
+	};
+}
+
+#endif // !SCIVIS_DATA_VOL_STATS_H
@@ -0,0 +1,310 @@
+#ifndef SCIVIS_DATA_VOL_TIME_SERIES_H
+#define SCIVIS_DATA_VOL_TIME_SERIES_H
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <future>
+#include <memory>
+
+#include <array>
+#include <vector>
+
+#include <scivis/common/parallel.h>
+#include <scivis/data/vol_data.h>
+#include <scivis/io/vol_codec.h>
+
+namespace SciVis
+{
+	/*
+	* 类: VolumeTimeSeries
+	* 功能: 体时间序列的紧凑存储。相邻时间步通常只有少量体素不同，因此每隔若干步存放一个关键帧，
+	*       其余时间步只存放相对前一步的差分：
+	*       -- 关键帧：按Z切片经VolumeCodec无损压缩，解码时各切片在多个线程上并行
+	*       -- 差分帧：发生变化的体素区段（起始下标与长度）及其新值。相距很近的区段被合并，以减少区段的开销
+	*       若某一步变化的体素过多，该步也存为关键帧。
+	*       体素数需小于2^32。AppendStep不可与其他成员函数同时调用，其余成员函数可在多个线程上同时调用
+	*/
+	class VolumeTimeSeries
+	{
+	public:
+		struct Parameters
+		{
+			uint32_t keyframeInterval = 16; // 相邻关键帧之间至多相隔的时间步数
+			float maxDeltaRatio = .25f; // 变化的体素占比超过该值时，存为关键帧
+			uint32_t thrdNum = 0; // 为0时使用硬件并发数
+		};
+
+		VolumeTimeSeries(ESupportedVoxelType voxTy, const std::array<uint32_t, 3>& dim)
+			: VolumeTimeSeries(voxTy, dim, Parameters())
+		{}
+		VolumeTimeSeries(
+			ESupportedVoxelType voxTy, const std::array<uint32_t, 3>& dim, const Parameters& param)
+			: voxTy(voxTy), dim(dim), param(param)
+		{
+			voxSz = RAWVolumeData::GetVoxelSize(voxTy);
+			voxNum = static_cast<size_t>(dim[0]) * dim[1] * dim[2];
+			if (this->param.keyframeInterval == 0)
+				this->param.keyframeInterval = 1;
+		}
+
+		/*
+		* 函数: AppendStep
+		* 功能: 在序列末尾追加一个时间步
+		* 参数:
+		* -- dat: 以X为最快变化维度排列的体数据，共GetStepBytes()字节
+		*/
+		void AppendStep(const void* dat)
+		{
+			auto src = static_cast<const uint8_t*>(dat);
+			steps.emplace_back();
+			auto& step = steps.back();
+
+			auto sinceKeyframe = steps.size() == 1 ? 0 : steps.size() - 1 - GetKeyframeOf(steps.size() - 2);
+			if (steps.size() == 1 || sinceKeyframe >= param.keyframeInterval || !computeDelta(src, step))
+				encodeKeyframe(src, step);
+
+			last.assign(src, src + GetStepBytes());
+		}
+
+		ESupportedVoxelType GetVoxelType() const
+		{
+			return voxTy;
+		}
+		const std::array<uint32_t, 3>& GetVoxelPerVolume() const
+		{
+			return dim;
+		}
+		size_t GetStepNum() const
+		{
+			return steps.size();
+		}
+		size_t GetStepBytes() const
+		{
+			return voxNum * voxSz;
+		}
+		bool IsKeyframe(size_t step) const
+		{
+			return steps[step].isKeyframe;
+		}
+		/*
+		* 函数: GetKeyframeOf
+		* 功能: 获取不晚于step的最近关键帧
+		*/
+		size_t GetKeyframeOf(size_t step) const
+		{
+			while (!steps[step].isKeyframe)
+				--step;
+			return step;
+		}
+		/*
+		* 函数: GetMemoryBytes
+		* 功能: 获取序列占用的内存（不含最近追加的一步的原始数据）
+		*/
+		size_t GetMemoryBytes() const
+		{
+			size_t bytes = 0;
+			for (auto& step : steps) {
+				for (auto& chunk : step.chunks)
+					bytes += chunk.size();
+				bytes += step.runs.size() * sizeof(uint32_t) + step.vals.size();
+			}
+			return bytes;
+		}
+
+		/*
+		* 函数: Reconstruct
+		* 功能: 重建时间步step的体数据到dst，dst的大小需不小于GetStepBytes()
+		*/
+		void Reconstruct(size_t step, void* dst) const
+		{
+			auto key = GetKeyframeOf(step);
+			decodeKeyframe(steps[key], static_cast<uint8_t*>(dst));
+			for (auto s = key + 1; s <= step; ++s)
+				applyDelta(steps[s], static_cast<uint8_t*>(dst));
+		}
+		/*
+		* 函数: ReconstructAsync
+		* 功能: 在后台线程上重建时间步step。序列需在返回的future就绪前保持有效
+		*/
+		std::future<std::shared_ptr<std::vector<uint8_t>>> ReconstructAsync(size_t step) const
+		{
+			return std::async(std::launch::async, [this, step]() {
+				auto buf = std::make_shared<std::vector<uint8_t>>(GetStepBytes());
+				Reconstruct(step, buf->data());
+				return buf;
+				});
+		}
+
+		/*
+		* 函数: CanUpdateIncrementally
+		* 功能: 判断时间步from的体数据能否只经差分更新为时间步to，即二者之间没有关键帧
+		*/
+		bool CanUpdateIncrementally(size_t from, size_t to) const
+		{
+			return from <= to && from >= GetKeyframeOf(to);
+		}
+		/*
+		* 函数: Update
+		* 功能: 将buf中时间步from的体数据更新为时间步to。可增量更新时只改写发生变化的体素，否则完整重建
+		* 返回值: 被改写的体素数
+		*/
+		size_t Update(size_t from, size_t to, void* buf) const
+		{
+			return Update(from, to, buf, [](uint8_t*, size_t) {});
+		}
+		/*
+		* 函数: Update
+		* 功能: 同上，并对每段新写入的体素调用onRun(起始地址, 体素数)，可用于就地转换新写入的体素（如转为纹理数据）
+		*/
+		template <typename OnRun>
+		size_t Update(size_t from, size_t to, void* buf, const OnRun& onRun) const
+		{
+			auto dst = static_cast<uint8_t*>(buf);
+			if (!CanUpdateIncrementally(from, to)) {
+				Reconstruct(to, buf);
+				onRun(dst, voxNum);
+				return voxNum;
+			}
+
+			size_t touched = 0;
+			for (auto s = from + 1; s <= to; ++s)
+				touched += applyDelta(steps[s], dst, onRun);
+			return touched;
+		}
+		/*
+		* 函数: GetChangedSliceRange
+		* 功能: 获取由时间步from增量更新为时间步to时，被改写的体素所在的Z切片范围，需CanUpdateIncrementally(from, to)
+		* 返回值: 切片范围[起始, 结束)，没有体素被改写时二者相等
+		*/
+		std::array<uint32_t, 2> GetChangedSliceRange(size_t from, size_t to) const
+		{
+			auto sliceVoxNum = static_cast<size_t>(dim[0]) * dim[1];
+			size_t beg = voxNum, end = 0;
+			for (auto s = from + 1; s <= to; ++s) {
+				auto& runs = steps[s].runs;
+				if (runs.empty())
+					continue;
+				beg = std::min(beg, static_cast<size_t>(runs.front()));
+				end = std::max(end, static_cast<size_t>(runs[runs.size() - 2]) + runs.back());
+			}
+			if (beg >= end)
+				return std::array<uint32_t, 2>{ 0, 0 };
+			return std::array<uint32_t, 2>{
+				static_cast<uint32_t>(beg / sliceVoxNum),
+				static_cast<uint32_t>((end + sliceVoxNum - 1) / sliceVoxNum) };
+		}
+
+	private:
+		struct Step
+		{
+			bool isKeyframe = false;
+			std::vector<std::vector<uint8_t>> chunks; // 关键帧：各Z切片的编码流
+			std::vector<uint32_t> runs; // 差分帧：依次为各区段的起始体素下标与长度
+			std::vector<uint8_t> vals; // 差分帧：各区段内体素的新值
+		};
+
+		static constexpr uint32_t RunMergeGap = 8; // 间隔小于该体素数的区段被合并
+
+		ESupportedVoxelType voxTy;
+		std::array<uint32_t, 3> dim;
+		Parameters param;
+		size_t voxSz;
+		size_t voxNum;
+		std::vector<Step> steps;
+		std::vector<uint8_t> last; // 最近追加的一步的原始数据，用于计算差分
+
+		void encodeKeyframe(const uint8_t* src, Step& step) const
+		{
+			auto sliceVoxNum = static_cast<size_t>(dim[0]) * dim[1];
+			step.isKeyframe = true;
+			step.runs.clear();
+			step.vals.clear();
+			step.chunks.resize(dim[2]);
+			ParallelFor(dim[2], [&](uint32_t, size_t zBeg, size_t zEnd) {
+				for (auto z = zBeg; z < zEnd; ++z)
+					step.chunks[z] = VolumeCodec::Encode(src + z * sliceVoxNum * voxSz, sliceVoxNum, voxSz);
+				}, param.thrdNum);
+		}
+		void decodeKeyframe(const Step& step, uint8_t* dst) const
+		{
+			auto sliceVoxNum = static_cast<size_t>(dim[0]) * dim[1];
+			ParallelFor(dim[2], [&](uint32_t, size_t zBeg, size_t zEnd) {
+				for (auto z = zBeg; z < zEnd; ++z)
+					VolumeCodec::Decode(step.chunks[z].data(), step.chunks[z].size(),
+						dst + z * sliceVoxNum * voxSz, sliceVoxNum, voxSz);
+				}, param.thrdNum);
+		}
+
+		/*
+		* 函数: computeDelta
+		* 功能: 计算src相对最近追加的一步的差分。各Z切片在多个线程上分别查找变化的区段，再按顺序拼接
+		* 返回值: 变化的体素过多而不宜存为差分时返回false
+		*/
+		bool computeDelta(const uint8_t* src, Step& step) const
+		{
+			auto sliceVoxNum = static_cast<size_t>(dim[0]) * dim[1];
+			std::vector<std::vector<uint32_t>> sliceRuns(dim[2]);
+			ParallelFor(dim[2], [&](uint32_t, size_t zBeg, size_t zEnd) {
+				for (auto z = zBeg; z < zEnd; ++z) {
+					auto& runs = sliceRuns[z];
+					auto beg = z * sliceVoxNum;
+					auto end = beg + sliceVoxNum;
+					for (auto i = beg; i < end; ++i) {
+						if (std::memcmp(src + i * voxSz, last.data() + i * voxSz, voxSz) == 0)
+							continue;
+						if (!runs.empty() && i - (runs[runs.size() - 2] + runs.back()) < RunMergeGap)
+							runs.back() = static_cast<uint32_t>(i + 1 - runs[runs.size() - 2]);
+						else {
+							runs.push_back(static_cast<uint32_t>(i));
+							runs.push_back(1);
+						}
+					}
+				}
+				}, param.thrdNum);
+
+			size_t changedNum = 0;
+			size_t runNum = 0;
+			for (auto& runs : sliceRuns) {
+				for (size_t r = 1; r < runs.size(); r += 2)
+					changedNum += runs[r];
+				runNum += runs.size();
+			}
+			if (changedNum > param.maxDeltaRatio * voxNum)
+				return false;
+
+			step.isKeyframe = false;
+			step.runs.reserve(runNum);
+			step.vals.reserve(changedNum * voxSz);
+			for (auto& runs : sliceRuns)
+				for (size_t r = 0; r < runs.size(); r += 2) {
+					step.runs.push_back(runs[r]);
+					step.runs.push_back(runs[r + 1]);
+					auto runBeg = src + static_cast<size_t>(runs[r]) * voxSz;
+					step.vals.insert(step.vals.end(), runBeg, runBeg + static_cast<size_t>(runs[r + 1]) * voxSz);
+				}
+			return true;
+		}
+		size_t applyDelta(const Step& step, uint8_t* dst) const
+		{
+			return applyDelta(step, dst, [](uint8_t*, size_t) {});
+		}
+		template <typename OnRun>
+		size_t applyDelta(const Step& step, uint8_t* dst, const OnRun& onRun) const
+		{
+			auto val = step.vals.data();
+			size_t touched = 0;
+			for (size_t r = 0; r < step.runs.size(); r += 2) {
+				auto len = static_cast<size_t>(step.runs[r + 1]) * voxSz;
+				auto runBeg = dst + static_cast<size_t>(step.runs[r]) * voxSz;
+				std::memcpy(runBeg, val, len);
+				onRun(runBeg, step.runs[r + 1]);
+				val += len;
+				touched += step.runs[r + 1];
+			}
+			return touched;
+		}
+	};
+}
+
+#endif // !SCIVIS_DATA_VOL_TIME_SERIES_H
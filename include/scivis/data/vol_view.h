@@ -0,0 +1,133 @@
+#ifndef SCIVIS_DATA_VOL_VIEW_H
+#define SCIVIS_DATA_VOL_VIEW_H
+
+#include <cstdint>
+#include <cstring>
+
+#include <array>
+#include <vector>
+
+namespace SciVis
+{
+	/*
+	* 结构体: VolumeView
+	* 功能: 体数据的非拥有视图，由首体素指针、三维尺寸、三个轴上的步长（以体素计）与值域组成。
+	*       切片、裁剪出的子体或时间序列中的某一步都可以表示为视图，无需另行拷贝出新的数组。
+	*       视图不管理数据的生存期，数据需在视图的使用期间保持有效
+	*/
+	template <typename T>
+	struct VolumeView
+	{
+		const T* dat = nullptr;
+		std::array<uint32_t, 3> dim = { { 0, 0, 0 } };
+		std::array<size_t, 3> strides = { { 0, 0, 0 } };
+		std::array<float, 2> valRng = { { 0.f, 1.f } }; // 体素的值域，默认为归一化的[0, 1]
+
+		VolumeView() {}
+		/*
+		* 函数: VolumeView
+		* 功能: 以X为最快变化维度紧密排列的体的视图
+		*/
+		VolumeView(const T* dat, const std::array<uint32_t, 3>& dim)
+			: dat(dat), dim(dim)
+		{
+			strides[0] = 1;
+			strides[1] = dim[0];
+			strides[2] = static_cast<size_t>(dim[0]) * dim[1];
+		}
+		VolumeView(const T* dat, const std::array<uint32_t, 3>& dim, const std::array<size_t, 3>& strides)
+			: dat(dat), dim(dim), strides(strides)
+		{}
+		VolumeView(const std::vector<T>& dat, const std::array<uint32_t, 3>& dim)
+			: VolumeView(dat.data(), dim)
+		{}
+
+		bool IsEmpty() const
+		{
+			return dat == nullptr || dim[0] == 0 || dim[1] == 0 || dim[2] == 0;
+		}
+		/*
+		* 函数: IsContiguous
+		* 功能: 判断视图内的体素是否以X为最快变化维度紧密排列，此时可直接作为连续数组使用
+		*/
+		bool IsContiguous() const
+		{
+			return strides[0] == 1 && (dim[1] == 1 || strides[1] == dim[0])
+				&& (dim[2] == 1 || strides[2] == static_cast<size_t>(dim[0]) * dim[1]);
+		}
+		size_t GetVoxelNum() const
+		{
+			return static_cast<size_t>(dim[0]) * dim[1] * dim[2];
+		}
+
+		const T& operator()(uint32_t x, uint32_t y, uint32_t z) const
+		{
+			return dat[z * strides[2] + y * strides[1] + x * strides[0]];
+		}
+		/*
+		* 函数: Row
+		* 功能: 获取第z个切片第y行的首体素。strides[0]为1时该行连续
+		*/
+		const T* Row(uint32_t y, uint32_t z) const
+		{
+			return dat + z * strides[2] + y * strides[1];
+		}
+
+		/*
+		* 函数: Crop
+		* 功能: 获取以min为最小角点、尺寸为cropDim的子体的视图，与原视图共享数据
+		*/
+		VolumeView Crop(const std::array<uint32_t, 3>& min, const std::array<uint32_t, 3>& cropDim) const
+		{
+			VolumeView ret(*this);
+			ret.dat = &(*this)(min[0], min[1], min[2]);
+			ret.dim = cropDim;
+			return ret;
+		}
+		/*
+		* 函数: Slice
+		* 功能: 获取第z个切片的视图
+		*/
+		VolumeView Slice(uint32_t z) const
+		{
+			return Crop({ { 0, 0, z } }, { { dim[0], dim[1], 1 } });
+		}
+		VolumeView WithValueRange(const std::array<float, 2>& rng) const
+		{
+			VolumeView ret(*this);
+			ret.valRng = rng;
+			return ret;
+		}
+
+		/*
+		* 函数: CopyTo
+		* 功能: 将视图内的体素以X为最快变化维度紧密排列地拷贝到dst，dst的大小需不小于GetVoxelNum()
+		*/
+		void CopyTo(T* dst) const
+		{
+			if (IsContiguous()) {
+				std::memcpy(dst, dat, sizeof(T) * GetVoxelNum());
+				return;
+			}
+			for (uint32_t z = 0; z < dim[2]; ++z)
+				for (uint32_t y = 0; y < dim[1]; ++y) {
+					auto row = Row(y, z);
+					if (strides[0] == 1) {
+						std::memcpy(dst, row, sizeof(T) * dim[0]);
+						dst += dim[0];
+					}
+					else
+						for (uint32_t x = 0; x < dim[0]; ++x)
+							*dst++ = row[x * strides[0]];
+				}
+		}
+		std::vector<T> ToVector() const
+		{
+			std::vector<T> ret(GetVoxelNum());
+			CopyTo(ret.data());
+			return ret;
+		}
+	};
+}
+
+#endif // !SCIVIS_DATA_VOL_VIEW_H
@@ -269,9 +269,9 @@ namespace SciVis
 			GraphRenderer() {}
 
 			/*
-			* : GetGroup
-			* : ȡûOSGڵ
-			* ֵ: OSGڵ
+			* 函数: GetGroup
+			* 功能: 获取该绘制组件的OSG节点
+			* 返回值: OSG节点
 			*/
 			osg::Group* GetGroup() { return param.grp.get(); }
 			void AddGraph(
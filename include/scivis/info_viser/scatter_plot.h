@@ -130,12 +130,12 @@ namespace SciVis
 					states->setAttributeAndModes(ploter->program, osg::StateAttribute::ON);
 				}
 				/*
-				* : SetLongtituteRange
-				* : øʱľȷΧλΪǶȣ
-				* :
-				* -- minLonDeg: Сֵ
-				* -- maxLonDeg: ֵ
-				* ֵ: ĲϷfalseóɹtrue
+				* 函数: SetLongtituteRange
+				* 功能: 设置该体绘制时的经度范围（单位为角度）
+				* 参数:
+				* -- minLonDeg: 经度最小值
+				* -- maxLonDeg: 经度最大值
+				* 返回值: 若输入的参数不合法，返回false。若设置成功，返回true
 				*/
 				bool SetLongtituteRange(float minLonDeg, float maxLonDeg)
 				{
@@ -148,12 +148,12 @@ namespace SciVis
 					return true;
 				}
 				/*
-				* : SetLatituteRange
-				* : øʱγȷΧλΪǶȣ
-				* :
-				* -- minLatDeg: γСֵ
-				* -- maxLatDeg: γֵ
-				* ֵ: ĲϷfalseóɹtrue
+				* 函数: SetLatituteRange
+				* 功能: 设置该体绘制时的纬度范围（单位为角度）
+				* 参数:
+				* -- minLatDeg: 纬度最小值
+				* -- maxLatDeg: 纬度最大值
+				* 返回值: 若输入的参数不合法，返回false。若设置成功，返回true
 				*/
 				bool SetLatituteRange(float minLatDeg, float maxLatDeg)
 				{
@@ -166,12 +166,12 @@ namespace SciVis
 					return true;
 				}
 				/*
-				* : SetHeightFromCenterRange
-				* : øʱĸ߶ȣģΧ
-				* :
-				* -- minH: ߶Сֵ
-				* -- maxH: ߶ֵ
-				* ֵ: ĲϷfalseóɹtrue
+				* 函数: SetHeightFromCenterRange
+				* 功能: 设置该体绘制时的高度（距球心）范围
+				* 参数:
+				* -- minH: 高度最小值
+				* -- maxH: 高度最大值
+				* 返回值: 若输入的参数不合法，返回false。若设置成功，返回true
 				*/
 				bool SetHeightFromCenterRange(float minH, float maxH)
 				{
@@ -183,10 +183,10 @@ namespace SciVis
 					return true;
 				}
 				/*
-				* : SetVolumeStartFromLongtituteZero
-				* : ȫX=0ӦľΪ0ȣҪù
-				* :
-				* -- flag: ΪtrueʱùܡΪfalseʱرոù
+				* 函数: SetVolumeStartFromLongtituteZero
+				* 功能: 若全球体数据X=0对应的经度为0度，需要开启该功能
+				* 参数:
+				* -- flag: 为true时，开启该功能。为false时，关闭该功能
 				*/
 				void SetVolumeStartFromLongtituteZero(bool flag)
 				{
@@ -194,17 +194,17 @@ namespace SciVis
 				}
 
 				/*	
-				* : DrawPlot
-				* : ɢͼ
-				* :
-				* -- vec: άɢ꼯
+				* 函数: DrawPlot
+				* 功能: 绘制散点图
+				* 参数:
+				* -- vec: 三维散点坐标集合
 				*/
 
 				void DrawPlot(std::vector<osg::Vec3f>& vec)
 				{	
-					//ϸ
+					//精细度
     				osg::TessellationHints* hints1 = new osg::TessellationHints();
-    				//þϸ
+    				//设置精细度
     				hints1->setDetailRatio(0.3f);
 
 					auto vec3ToSphere = [&](const osg::Vec3& v3) -> osg::Vec3 {
@@ -239,11 +239,11 @@ namespace SciVis
 				}
 
 				/*
-				* : GetDiscreteVec
-				* : õɢݵɢά
-				* :
-				* -- eps : 
-				* -- base : ׼ֵ
+				* 函数: GetDiscreteVec
+				* 功能: 得到离散数据的散点的三维球坐标
+				* 参数:
+				* -- eps : 误差
+				* -- base : 基准值
 				*/
 				std::vector<osg::Vec3f> GetDiscreteVec(
 					const std::array<int32_t, 3>& cooDimMax, const std::array<int32_t, 3>& cooDimMin,
@@ -267,11 +267,11 @@ namespace SciVis
 				}
 
 				/*	
-				* : GetConsecutiveVec
-				* : õݵɢά
-				* :
-				* -- eps : 
-				* -- base : ׼ֵ
+				* 函数: GetConsecutiveVec
+				* 功能: 得到连续数据的散点的三维球坐标
+				* 参数:
+				* -- eps : 误差
+				* -- base : 基准值
 				*/
 				std::vector<osg::Vec3f> GetConsecutiveVec(
 					std::array<uint32_t, 3> graphDim, std::array<uint8_t, 3> logDstDim,
@@ -397,8 +397,8 @@ namespace SciVis
 	            	return std::vector<osg::Vec3f>();
             	}
 				/*	
-				* : MakeCoordinate
-				* : 
+				* 函数: MakeCoordinate
+				* 功能: 绘制坐标轴
 				*/
 				osg::Geode* MakeCoordinate(const wchar_t* nameX = L"x", const wchar_t* nameY = L"y", const wchar_t* nameZ = L"z", float fontSize = osg::WGS_84_RADIUS_EQUATOR / 20)
 				{	
@@ -421,12 +421,12 @@ namespace SciVis
 						return ret;
 					};
 
-					// ƻ
+					// 绘制弧线
 					osg::ref_ptr<osg::Geometry> zGeom = new osg::Geometry();
-					// ԭ
+					// 原点
 
 					osg::Vec3f axisOrigin = vec3ToSphere(osg::Vec3f(0.0f, 0.0f, 0.0f));
-					// z
+					// z轴
 					osg::ref_ptr<osg::Vec3Array> zVer = new osg::Vec3Array();
 					zVer->push_back(axisOrigin);
 					zVer->push_back(vec3ToSphere(osg::Vec3f(0.0f, 0.0f, 1.0f)));
@@ -439,7 +439,7 @@ namespace SciVis
 					zGeom->setColorBinding(osg::Geometry::BIND_PER_VERTEX);
 					zGeom->addPrimitiveSet(new osg::DrawArrays(osg::PrimitiveSet::LINES, 0, 2));
 
-					// y
+					// y轴
 					osg::ref_ptr<osg::Geometry> yGeom = new osg::Geometry();
 					osg::ref_ptr<osg::Vec3Array> yVer = new osg::Vec3Array();
 					for (float i = 0.0f; i <= 1.0f; i += 0.01f) {
@@ -454,7 +454,7 @@ namespace SciVis
 					yGeom->setColorBinding(osg::Geometry::BIND_PER_VERTEX);
 					yGeom->addPrimitiveSet(new osg::DrawArrays(osg::PrimitiveSet::LINE_STRIP, 0, yVer->size()));
 
-					// x
+					// x轴
 					osg::ref_ptr<osg::Geometry> xGeom = new osg::Geometry();
 					osg::ref_ptr<osg::Vec3Array> xVer = new osg::Vec3Array();
 					for (float i = 0.0f; i <= 1.0f; i += 0.01f) {
@@ -479,7 +479,7 @@ namespace SciVis
 					axisGeode->addDrawable(yGeom.get());
 					axisGeode->addDrawable(xGeom.get());
 
-					// 
+					// 添加文字
 					osg::ref_ptr<osgText::Text> pTextXAuxis1 = new osgText::Text;
 					pTextXAuxis1->setText(nameY);
 
@@ -525,18 +525,18 @@ namespace SciVis
 
 			
 			/*
-			* : GetGroup
-			* : ȡûOSGڵ
-			* ֵ: OSGڵ
+			* 函数: GetGroup
+			* 功能: 获取该绘制组件的OSG节点
+			* 返回值: OSG节点
 			*/
 			osg::Group* GetGroup() { return param.grp.get(); }
 			/*
-			* : AddVolume
-			* : ûһ
-			* :
-			* -- name: ơͬ費ͬ
-			* -- volDat: ݣ谴Z-Y-X˳
-			* -- dim: ݵάߴ磨XYZ˳
+			* 函数: AddVolume
+			* 功能: 向该绘制组件添加一个体
+			* 参数:
+			* -- name: 添加体的名称。不同体的名称需不同，用于区分
+			* -- volDat: 体数据，需按Z-Y-X的顺序存放体素
+			* -- dim: 体数据的三维尺寸（XYZ顺序）
 			*/
 			void AddVolume(const std::string& name, std::shared_ptr<std::vector<float>> volDat,
 				const std::array<uint32_t, 3>& volDim)
@@ -552,11 +552,11 @@ namespace SciVis
 			}
 
 			/*
-			* : AddDiscreteVolume
-			* : ûһɢ
-			* :
-			* -- name: ơͬ費ͬ
-			* -- volDat: ݣ谴Z-Y-X˳
+			* 函数: AddDiscreteVolume
+			* 功能: 向该绘制组件添加一个离散数据体
+			* 参数:
+			* -- name: 添加体的名称。不同体的名称需不同，用于区分
+			* -- volDat: 体数据，需按Z-Y-X的顺序存放体素
 			*/
 			void AddDiscreteVolume(const std::string& name, std::shared_ptr<std::vector<osg::Vec3f>> volDiscreteDat)
 			{
@@ -570,19 +570,19 @@ namespace SciVis
 				param.grp->addChild(vols.at(name).geode);
 			}
 			/*
-			* : GetVolumes
-			* : ȡУڻʱ
+			* 函数: GetVolumes
+			* 功能: 获取该组件中，体在绘制时所需的所有数据
 			*/
 			std::map<std::string, PerVolParam>& GetVolumes()
 			{
 				return vols;
 			}
 			/*
-			* : GetVolume
-			* : ȡУڻʱ
-			* :
-			* -- name: 
-			* ֵ: Ļ
+			* 函数: GetVolume
+			* 功能: 获取该组件中，体在绘制时所需的数据
+			* 参数:
+			* -- name: 体的名称
+			* 返回值: 体的绘制数据
 			*/
 			PerVolParam* GetVolume(const std::string& name)
 			{
@@ -592,9 +592,9 @@ namespace SciVis
 				return &(itr->second);
 			}
 			/*
-			* : GetVolumeNum
-			* : ȡû
-			* ֵ: 
+			* 函数: GetVolumeNum
+			* 功能: 获取该绘制组件中体的数量
+			* 返回值: 体的数量
 			*/
 			size_t GetVolumeNum() const
 			{
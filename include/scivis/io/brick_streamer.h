@@ -0,0 +1,267 @@
+#ifndef SCIVIS_IO_BRICK_STREAMER_H
+#define SCIVIS_IO_BRICK_STREAMER_H
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#include <array>
+#include <vector>
+
+#include <scivis/common/lock_free_queue.h>
+#include <scivis/data/multires_bricked_vol_data.h>
+
+namespace SciVis
+{
+	/*
+	* 类: BrickStreamer
+	* 功能: 多分辨率分块体（见MultiresolutionBrickedVolumeData）的异步块加载器。
+	*       绘制线程每帧以Request提交所需而未驻留的块（按优先级排列），工作线程按顺序认领并从磁盘读取，
+	*       转换为带1个体素边框的归一化16位数据后经无锁队列交给绘制线程，绘制线程不会因I/O而阻塞。
+	*       边框取自同一级的相邻块，使块在纹理中三线性插值时与相邻块连续。
+	*       除构造与析构外，成员函数只应在绘制线程上调用
+	*/
+	class BrickStreamer
+	{
+	public:
+		static constexpr uint32_t Apron = 1;
+
+		struct Parameters
+		{
+			uint32_t workerNum = 2;
+			uint32_t readyCap = 64; // 已加载而未被绘制线程取走的块数上限
+		};
+
+		/*
+		* 结构体: NodeID
+		* 功能: 八叉树中的节点，即第lvl级中下标为idx的块（见BrickedVolumeData::GetBrickIndex）
+		*/
+		struct NodeID
+		{
+			uint32_t lvl = 0;
+			size_t idx = 0;
+
+			NodeID() {}
+			NodeID(uint32_t lvl, size_t idx) : lvl(lvl), idx(idx) {}
+		};
+
+		enum class EState : uint8_t
+		{
+			None = 0,
+			Loading, // 正在加载或已在队列中
+			Resident, // 已由Poll取走
+			Failed
+		};
+
+		struct Brick
+		{
+			NodeID id;
+			bool ok = false;
+			std::vector<uint16_t> dat; // GetSlotLength()^3个体素，以X为最快变化维度排列
+		};
+
+		BrickStreamer(std::shared_ptr<const MultiresolutionBrickedVolumeData> vol)
+			: BrickStreamer(vol, Parameters())
+		{}
+		BrickStreamer(std::shared_ptr<const MultiresolutionBrickedVolumeData> vol, const Parameters& param)
+			: vol(vol), param(param), readyQueue(param.readyCap)
+		{
+			states.resize(vol->GetLevelNum());
+			for (uint32_t lvl = 0; lvl < vol->GetLevelNum(); ++lvl) {
+				auto num = vol->GetLevel(lvl).GetBrickNum();
+				states[lvl].reset(new std::atomic<uint8_t>[num]);
+				for (size_t i = 0; i < num; ++i)
+					states[lvl][i].store(static_cast<uint8_t>(EState::None), std::memory_order_relaxed);
+			}
+			stop.store(false);
+
+			for (uint32_t i = 0; i < std::max(param.workerNum, 1u); ++i)
+				workers.emplace_back([this]() { work(); });
+		}
+		~BrickStreamer()
+		{
+			stop.store(true);
+			cv.notify_all();
+			for (auto& worker : workers)
+				worker.join();
+		}
+		BrickStreamer(const BrickStreamer&) = delete;
+		BrickStreamer& operator=(const BrickStreamer&) = delete;
+
+		uint32_t GetSlotLength() const
+		{
+			return vol->GetBrickLength() + 2 * Apron;
+		}
+		EState GetState(const NodeID& id) const
+		{
+			return static_cast<EState>(states[id.lvl][id.idx].load());
+		}
+
+		/*
+		* 函数: Request
+		* 功能: 以ids替换待加载的块，ids中靠前的块先被认领。已在加载或已驻留的块会被工作线程跳过
+		*/
+		void Request(std::vector<NodeID>&& ids)
+		{
+			{
+				std::lock_guard<std::mutex> lk(mtx);
+				requests = std::move(ids);
+				nextRequest = 0;
+			}
+			cv.notify_all();
+		}
+		/*
+		* 函数: Poll
+		* 功能: 取走一个已加载的块，其状态随之变为Resident（加载失败时为Failed，不会再被加载）
+		* 返回值: 没有已加载的块时返回false
+		*/
+		bool Poll(Brick& brick)
+		{
+			if (!readyQueue.TryPop(brick))
+				return false;
+			states[brick.id.lvl][brick.id.idx].store(static_cast<uint8_t>(brick.ok ? EState::Resident : EState::Failed));
+			return true;
+		}
+		/*
+		* 函数: Release
+		* 功能: 块被移出驻留集（或取走后未被使用）时调用，之后可被再次请求
+		*/
+		void Release(const NodeID& id)
+		{
+			states[id.lvl][id.idx].store(static_cast<uint8_t>(EState::None));
+		}
+
+		/*
+		* 函数: LoadBrick
+		* 功能: 在调用线程上读取块，转换为带边框的归一化16位数据。体素以第0级的值域归一化，空值与NaN记为0。
+		*       可在多个线程上同时调用
+		* 返回值: 块数据损坏时返回false
+		*/
+		bool LoadBrick(const NodeID& id, std::vector<uint16_t>& dst) const
+		{
+			switch (vol->GetVoxelType())
+			{
+			case ESupportedVoxelType::UInt8:
+				return loadBrick<uint8_t>(id, dst);
+			case ESupportedVoxelType::UInt16:
+				return loadBrick<uint16_t>(id, dst);
+			case ESupportedVoxelType::Int16:
+				return loadBrick<int16_t>(id, dst);
+			case ESupportedVoxelType::Float32:
+				return loadBrick<float>(id, dst);
+			}
+			return false;
+		}
+
+	private:
+		std::shared_ptr<const MultiresolutionBrickedVolumeData> vol;
+		Parameters param;
+		std::vector<std::unique_ptr<std::atomic<uint8_t>[]>> states;
+		LockFreeQueue<Brick> readyQueue;
+
+		std::vector<NodeID> requests;
+		size_t nextRequest = 0;
+		std::atomic<bool> stop;
+		std::mutex mtx;
+		std::condition_variable cv;
+		std::vector<std::thread> workers;
+
+		bool claimNext(NodeID& id)
+		{
+			std::lock_guard<std::mutex> lk(mtx);
+			while (nextRequest < requests.size()) {
+				auto& req = requests[nextRequest++];
+				auto expected = static_cast<uint8_t>(EState::None);
+				if (states[req.lvl][req.idx].compare_exchange_strong(expected, static_cast<uint8_t>(EState::Loading))) {
+					id = req;
+					return true;
+				}
+			}
+			return false;
+		}
+
+		void work()
+		{
+			while (!stop.load()) {
+				NodeID id;
+				if (!claimNext(id)) {
+					std::unique_lock<std::mutex> lk(mtx);
+					cv.wait_for(lk, std::chrono::milliseconds(20));
+					continue;
+				}
+
+				Brick brick;
+				brick.id = id;
+				brick.ok = LoadBrick(id, brick.dat);
+				while (!readyQueue.TryPush(std::move(brick))) {
+					if (stop.load())
+						return;
+					std::this_thread::yield();
+				}
+			}
+		}
+
+		template <typename T>
+		bool loadBrick(const NodeID& id, std::vector<uint16_t>& dst) const
+		{
+			const auto& lvl = vol->GetLevel(id.lvl);
+			const auto& dim = lvl.GetVoxelPerVolume();
+			const auto& brickPerVol = lvl.GetBrickPerVolume();
+			const auto& hdr = vol->GetHeader();
+			auto brickLen = lvl.GetBrickLength();
+			auto slotLen = brickLen + 2 * Apron;
+
+			std::array<uint32_t, 3> b = { {
+				static_cast<uint32_t>(id.idx % brickPerVol[0]),
+				static_cast<uint32_t>(id.idx / brickPerVol[0] % brickPerVol[1]),
+				static_cast<uint32_t>(id.idx / brickPerVol[0] / brickPerVol[1]) } };
+			// 块连同边框在该级中的体素范围，超出体的部分以边界体素填充
+			std::array<int64_t, 3> org;
+			std::array<uint32_t, 3> beg, end;
+			for (uint8_t i = 0; i < 3; ++i) {
+				org[i] = static_cast<int64_t>(b[i]) * brickLen - Apron;
+				beg[i] = static_cast<uint32_t>(std::max(org[i], static_cast<int64_t>(0)));
+				end[i] = static_cast<uint32_t>(std::min(org[i] + slotLen, static_cast<int64_t>(dim[i])));
+			}
+			std::array<uint32_t, 3> regionDim = { { end[0] - beg[0], end[1] - beg[1], end[2] - beg[2] } };
+			std::vector<T> region(static_cast<size_t>(regionDim[0]) * regionDim[1] * regionDim[2]);
+			if (!lvl.ReadRegion(beg, end, region.data(), 1))
+				return false;
+
+			auto lo = hdr.valRng[0];
+			auto scale = hdr.valRng[1] > hdr.valRng[0] ? 65535.f / (hdr.valRng[1] - hdr.valRng[0]) : 0.f;
+			auto hasNullVal = hdr.hasNullVal != 0;
+			std::array<std::vector<uint32_t>, 3> srcIdx;
+			for (uint8_t i = 0; i < 3; ++i) {
+				srcIdx[i].resize(slotLen);
+				for (uint32_t s = 0; s < slotLen; ++s) {
+					auto v = std::min(std::max(org[i] + s, static_cast<int64_t>(beg[i])), static_cast<int64_t>(end[i]) - 1);
+					srcIdx[i][s] = static_cast<uint32_t>(v - beg[i]);
+				}
+			}
+
+			dst.resize(static_cast<size_t>(slotLen) * slotLen * slotLen);
+			auto out = dst.data();
+			for (uint32_t z = 0; z < slotLen; ++z)
+				for (uint32_t y = 0; y < slotLen; ++y) {
+					auto row = region.data() + (static_cast<size_t>(srcIdx[2][z]) * regionDim[1] + srcIdx[1][y]) * regionDim[0];
+					for (uint32_t x = 0; x < slotLen; ++x) {
+						auto v = static_cast<float>(row[srcIdx[0][x]]);
+						if (v != v || (hasNullVal && v == hdr.nullVal))
+							*out++ = 0;
+						else
+							*out++ = static_cast<uint16_t>(std::min(std::max((v - lo) * scale + .5f, 0.f), 65535.f));
+					}
+				}
+			return true;
+		}
+	};
+}
+
+#endif // !SCIVIS_IO_BRICK_STREAMER_H
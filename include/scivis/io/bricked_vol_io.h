@@ -0,0 +1,85 @@
+#ifndef SCIVIS_IO_BRICKED_VOL_IO_H
+#define SCIVIS_IO_BRICKED_VOL_IO_H
+
+#include <limits>
+
+#include <array>
+#include <vector>
+
+#include <scivis/data/bricked_vol_data.h>
+#include <scivis/io/vol_io.h>
+
+namespace SciVis
+{
+	namespace Convertor
+	{
+		/*
+		* 类: BrickedVolume
+		* 功能: 将已有格式的体数据转换为分块体文件（见BrickedVolumeData）
+		*/
+		class BrickedVolume
+		{
+		public:
+			/*
+			* 函数: FromRAWVolume
+			* 功能: 转换RAW体。体素类型保持不变，经纬高范围与空值由param指定
+			*/
+			static bool FromRAWVolume(
+				const RAWVolumeData& vol,
+				const BrickedVolumeData::ToFileParameters& param,
+				std::string* errMsg = nullptr)
+			{
+				return BrickedVolumeData::DumpToFile(
+					vol.GetData(), vol.GetVoxelType(), vol.GetVoxelPerVolume(), param, errMsg);
+			}
+
+			/*
+			* 函数: FromTXTVolume
+			* 功能: 转换文本体，体素类型为Float32。空值应与加载时使用的空值一致
+			*/
+			static bool FromTXTVolume(
+				const Loader::TXTVolume& vol, const std::array<uint32_t, 3>& dim,
+				const BrickedVolumeData::ToFileParameters& param,
+				std::string* errMsg = nullptr)
+			{
+				if (vol.dat.size() < static_cast<size_t>(dim[0]) * dim[1] * dim[2]) {
+					if (errMsg)
+						*errMsg = "Volume Size is Smaller than dim";
+					return false;
+				}
+				return BrickedVolumeData::DumpToFile(
+					vol.dat.data(), ESupportedVoxelType::Float32, dim, param, errMsg);
+			}
+
+			/*
+			* 函数: FromLabeledTXTVolume
+			* 功能: 转换带经纬高标签的文本体，体素类型为Float32，经纬高范围取自体本身。
+			*       缺失的体素（包括稀疏体中无值的体素）存为NaN
+			*/
+			static bool FromLabeledTXTVolume(
+				const Loader::LabeledTXTVolume& vol,
+				BrickedVolumeData::ToFileParameters param,
+				std::string* errMsg = nullptr)
+			{
+				param.lonRng = vol.lonRng;
+				param.latRng = vol.latRng;
+				param.hRng = vol.hRng;
+
+				if (!vol.sparse)
+					return BrickedVolumeData::DumpToFile(
+						vol.dat.data(), ESupportedVoxelType::Float32, vol.dim, param, errMsg);
+
+				auto& sparse = *vol.sparse;
+				auto dimX = vol.dim[0];
+				return BrickedVolumeData::DumpToFile(
+					ESupportedVoxelType::Float32, vol.dim, param, [&](uint32_t y, uint32_t z, void* dst) {
+						auto* row = static_cast<float*>(dst);
+						for (uint32_t x = 0; x < dimX; ++x)
+							row[x] = sparse.Sample(x, y, z, std::numeric_limits<float>::quiet_NaN());
+					}, errMsg);
+			}
+		};
+	}
+}
+
+#endif // !SCIVIS_IO_BRICKED_VOL_IO_H
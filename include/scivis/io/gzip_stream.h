@@ -0,0 +1,633 @@
+#ifndef SCIVIS_IO_GZIP_STREAM_H
+#define SCIVIS_IO_GZIP_STREAM_H
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include <array>
+#include <vector>
+
+#include <scivis/common/lock_free_queue.h>
+#include <scivis/common/parallel.h>
+#include <scivis/io/txt_scanner.h>
+
+namespace SciVis
+{
+	/*
+	* 类: GZipInflater
+	* 功能: 不依赖外部库的gzip（RFC 1952）与DEFLATE（RFC 1951）解压器。输入须完整位于内存中（通常为文件映射），
+	*       输出以固定大小的块流式交出，除32KiB的回溯窗口外不保留已交出的数据，内存占用与解压后的大小无关
+	*/
+	class GZipInflater
+	{
+	public:
+		static bool IsGZip(const uint8_t* dat, size_t sz)
+		{
+			return sz >= 3 && dat[0] == 0x1f && dat[1] == 0x8b && dat[2] == 8;
+		}
+
+		/*
+		* 函数: Inflate
+		* 功能: 在调用线程上解压gzip数据（可为多个成员的串联），每得到约chunkSz字节的输出即以onOutput(dat, sz)交出，
+		*       交出的数据只在该次调用中有效。各成员的CRC32与长度均被校验
+		* 参数:
+		* -- onOutput: 返回false时停止解压
+		* -- errMsg: 若不为空，失败时写入错误信息
+		* 返回值: 数据损坏或被截断时返回false，由onOutput停止时返回true
+		*/
+		template <typename Func>
+		static bool Inflate(const uint8_t* gz, size_t sz, size_t chunkSz, const Func& onOutput,
+			std::string* errMsg = nullptr)
+		{
+			inflateState state(gz, sz, std::max(chunkSz, static_cast<size_t>(1)));
+			auto err = state.Run(onOutput);
+			if (err && errMsg)
+				*errMsg = err;
+			return err == nullptr;
+		}
+
+		/*
+		* 函数: UpdateCRC32
+		* 功能: 以切片查表（每次8字节）更新gzip所用的CRC32
+		*/
+		static uint32_t UpdateCRC32(uint32_t crc, const uint8_t* dat, size_t sz)
+		{
+			static const std::vector<std::array<uint32_t, 256>> tables = buildCRC32Tables();
+			const auto& t = tables;
+			crc = ~crc;
+			for (; sz >= 8; sz -= 8, dat += 8) {
+				auto lo = crc ^ (static_cast<uint32_t>(dat[0]) | static_cast<uint32_t>(dat[1]) << 8
+					| static_cast<uint32_t>(dat[2]) << 16 | static_cast<uint32_t>(dat[3]) << 24);
+				crc = t[7][lo & 0xff] ^ t[6][(lo >> 8) & 0xff] ^ t[5][(lo >> 16) & 0xff] ^ t[4][lo >> 24]
+					^ t[3][dat[4]] ^ t[2][dat[5]] ^ t[1][dat[6]] ^ t[0][dat[7]];
+			}
+			for (; sz > 0; --sz, ++dat)
+				crc = t[0][(crc ^ *dat) & 0xff] ^ (crc >> 8);
+			return ~crc;
+		}
+
+	private:
+		static constexpr size_t WindowSize = 32768;
+		static constexpr size_t MaxMatchLength = 258;
+		static constexpr uint32_t FastBits = 10;
+
+		static std::vector<std::array<uint32_t, 256>> buildCRC32Tables()
+		{
+			std::vector<std::array<uint32_t, 256>> t(8);
+			for (uint32_t i = 0; i < 256; ++i) {
+				auto c = i;
+				for (uint8_t k = 0; k < 8; ++k)
+					c = c & 1 ? 0xedb88320u ^ (c >> 1) : c >> 1;
+				t[0][i] = c;
+			}
+			for (uint32_t i = 0; i < 256; ++i)
+				for (uint8_t s = 1; s < 8; ++s)
+					t[s][i] = t[0][t[s - 1][i] & 0xff] ^ (t[s - 1][i] >> 8);
+			return t;
+		}
+
+		/*
+		* 结构体: huffman
+		* 功能: 规范哈夫曼码。码长不超过FastBits的码由fast直接查得，其余的码逐位解码
+		*/
+		struct huffman
+		{
+			std::array<uint16_t, 16> counts;
+			std::array<uint16_t, 288> syms;
+			std::array<uint16_t, 1 << FastBits> fast; // (符号 << 4) | 码长，码长为0时需逐位解码
+
+			bool Build(const uint8_t* lens, uint32_t num)
+			{
+				counts.fill(0);
+				for (uint32_t i = 0; i < num; ++i)
+					++counts[lens[i]];
+				counts[0] = 0;
+				int32_t left = 1;
+				for (uint8_t len = 1; len < 16; ++len) {
+					left = (left << 1) - counts[len];
+					if (left < 0)
+						return false; // 码过多
+				}
+
+				std::array<uint16_t, 16> offs;
+				offs[1] = 0;
+				for (uint8_t len = 1; len < 15; ++len)
+					offs[len + 1] = offs[len] + counts[len];
+				for (uint32_t i = 0; i < num; ++i)
+					if (lens[i] != 0)
+						syms[offs[lens[i]]++] = static_cast<uint16_t>(i);
+
+				fast.fill(0);
+				uint32_t code = 0;
+				size_t k = 0;
+				for (uint32_t len = 1; len <= FastBits; ++len) {
+					for (uint32_t i = 0; i < counts[len]; ++i, ++k, ++code) {
+						uint32_t rev = 0;
+						for (uint32_t b = 0; b < len; ++b)
+							rev |= ((code >> b) & 1) << (len - 1 - b);
+						auto entry = static_cast<uint16_t>(syms[k] << 4 | len);
+						for (auto j = rev; j < (1u << FastBits); j += 1u << len)
+							fast[j] = entry;
+					}
+					code <<= 1;
+				}
+				return true;
+			}
+		};
+
+		class inflateState
+		{
+		public:
+			inflateState(const uint8_t* gz, size_t sz, size_t chunkSz)
+				: in(gz), inEnd(gz + sz), win(WindowSize + chunkSz + MaxMatchLength)
+			{}
+
+			template <typename Func>
+			const char* Run(const Func& onOutput)
+			{
+				if (!IsGZip(in, inEnd - in))
+					return "Invalid gzip header.";
+
+				while (in != inEnd && !stopped) {
+					if (!IsGZip(in, inEnd - in))
+						break; // 成员之后的填充
+					auto err = readMemberHeader();
+					if (err)
+						return err;
+
+					crc = 0;
+					memberSz = 0;
+					crcPos = pos;
+					bool isFinal = false;
+					while (!isFinal && !stopped) {
+						isFinal = getBits(1) != 0;
+						auto type = getBits(2);
+						if (type == 0)
+							err = inflateStored(onOutput);
+						else if (type == 1)
+							err = inflateHuffman(fixedLit(), fixedDist(), onOutput);
+						else if (type == 2)
+							err = inflateDynamic(onOutput);
+						else
+							err = "Invalid deflate block type.";
+						if (!err && truncated)
+							err = "Truncated gzip data.";
+						if (err)
+							return err;
+					}
+					if (stopped)
+						break;
+
+					// 成员末尾按字节对齐，随后为CRC32与长度（各4字节，小端）
+					getBits(bitCnt & 7);
+					auto expectedCRC = getBits(32);
+					auto expectedSz = getBits(32);
+					if (truncated)
+						return "Truncated gzip data.";
+					crc = UpdateCRC32(crc, win.data() + crcPos, pos - crcPos);
+					memberSz += pos - crcPos;
+					crcPos = pos;
+					if (crc != expectedCRC || static_cast<uint32_t>(memberSz) != expectedSz)
+						return "Corrupted gzip data, whose CRC32 or length does not match.";
+
+					// 退回位缓冲中未使用的字节，下一个成员从字节边界开始
+					in -= bitCnt / 8;
+					bitBuf = 0;
+					bitCnt = 0;
+				}
+
+				if (!stopped)
+					flush(onOutput);
+				return nullptr;
+			}
+
+		private:
+			const uint8_t* in;
+			const uint8_t* inEnd;
+			uint64_t bitBuf = 0;
+			uint32_t bitCnt = 0;
+			bool truncated = false;
+
+			size_t chunkSz;
+			std::vector<uint8_t> win; // 回溯窗口与待交出的输出
+			size_t pos = 0;
+			size_t emitPos = 0;
+			size_t crcPos = 0;
+			uint32_t crc = 0;
+			uint64_t memberSz = 0;
+			bool stopped = false;
+
+			static const huffman& fixedLit()
+			{
+				static const huffman h = []() {
+					std::array<uint8_t, 288> lens;
+					std::fill(lens.begin(), lens.begin() + 144, 8);
+					std::fill(lens.begin() + 144, lens.begin() + 256, 9);
+					std::fill(lens.begin() + 256, lens.begin() + 280, 7);
+					std::fill(lens.begin() + 280, lens.end(), 8);
+					huffman ret;
+					ret.Build(lens.data(), 288);
+					return ret;
+				}();
+				return h;
+			}
+			static const huffman& fixedDist()
+			{
+				static const huffman h = []() {
+					std::array<uint8_t, 30> lens;
+					lens.fill(5);
+					huffman ret;
+					ret.Build(lens.data(), 30);
+					return ret;
+				}();
+				return h;
+			}
+
+			void refill()
+			{
+				while (bitCnt <= 56 && in != inEnd) {
+					bitBuf |= static_cast<uint64_t>(*in++) << bitCnt;
+					bitCnt += 8;
+				}
+			}
+			uint32_t getBits(uint32_t n)
+			{
+				if (n == 0)
+					return 0;
+				if (bitCnt < n) {
+					refill();
+					if (bitCnt < n) {
+						truncated = true;
+						bitBuf = 0;
+						bitCnt = 0;
+						return 0;
+					}
+				}
+				auto v = static_cast<uint32_t>(bitBuf & ((static_cast<uint64_t>(1) << n) - 1));
+				bitBuf >>= n;
+				bitCnt -= n;
+				return v;
+			}
+			int32_t decode(const huffman& h)
+			{
+				if (bitCnt < 15)
+					refill();
+				auto entry = h.fast[bitBuf & ((1u << FastBits) - 1)];
+				auto len = static_cast<uint32_t>(entry & 15);
+				if (len != 0 && len <= bitCnt) {
+					bitBuf >>= len;
+					bitCnt -= len;
+					return entry >> 4;
+				}
+
+				int32_t code = 0, first = 0, idx = 0;
+				for (uint8_t l = 1; l < 16; ++l) {
+					if (bitCnt == 0) {
+						truncated = true;
+						return -1;
+					}
+					code |= static_cast<int32_t>(bitBuf & 1);
+					bitBuf >>= 1;
+					--bitCnt;
+					int32_t cnt = h.counts[l];
+					if (code - cnt < first)
+						return h.syms[idx + (code - first)];
+					idx += cnt;
+					first = (first + cnt) << 1;
+					code <<= 1;
+				}
+				return -1;
+			}
+
+			const char* readMemberHeader()
+			{
+				enum : uint8_t { FHCRC = 2, FEXTRA = 4, FNAME = 8, FCOMMENT = 16 };
+				if (inEnd - in < 10)
+					return "Truncated gzip header.";
+				auto flags = in[3];
+				in += 10;
+				if (flags & FEXTRA) {
+					if (inEnd - in < 2)
+						return "Truncated gzip header.";
+					size_t len = in[0] | in[1] << 8;
+					in += 2;
+					if (static_cast<size_t>(inEnd - in) < len)
+						return "Truncated gzip header.";
+					in += len;
+				}
+				const uint8_t strFlags[] = { FNAME, FCOMMENT }; // 以'\0'结尾的文件名与注释
+				for (auto flag : strFlags)
+					if (flags & flag) {
+						while (in != inEnd && *in != 0)
+							++in;
+						if (in == inEnd)
+							return "Truncated gzip header.";
+						++in;
+					}
+				if (flags & FHCRC) {
+					if (inEnd - in < 2)
+						return "Truncated gzip header.";
+					in += 2;
+				}
+				return nullptr;
+			}
+
+			/*
+			* 函数: flush
+			* 功能: 交出尚未交出的输出，只保留最后32KiB作为回溯窗口
+			*/
+			template <typename Func>
+			void flush(const Func& onOutput)
+			{
+				if (pos > emitPos && !onOutput(win.data() + emitPos, pos - emitPos))
+					stopped = true;
+				crc = UpdateCRC32(crc, win.data() + crcPos, pos - crcPos);
+				memberSz += pos - crcPos;
+
+				auto keep = std::min<size_t>(pos, static_cast<size_t>(WindowSize));
+				std::memmove(win.data(), win.data() + pos - keep, keep);
+				pos = emitPos = crcPos = keep;
+			}
+			template <typename Func>
+			void reserve(const Func& onOutput)
+			{
+				if (pos + MaxMatchLength > win.size())
+					flush(onOutput);
+			}
+
+			template <typename Func>
+			const char* inflateStored(const Func& onOutput)
+			{
+				getBits(bitCnt & 7);
+				auto len = getBits(16);
+				auto nlen = getBits(16);
+				if (truncated)
+					return nullptr;
+				if (len != (~nlen & 0xffff))
+					return "Invalid stored block length.";
+
+				// 先取出位缓冲中已读入的字节，其余直接从输入复制
+				for (; len > 0 && bitCnt >= 8 && !stopped; --len) {
+					reserve(onOutput);
+					win[pos++] = static_cast<uint8_t>(getBits(8));
+				}
+				if (static_cast<size_t>(inEnd - in) < len) {
+					truncated = true;
+					return nullptr;
+				}
+				while (len > 0 && !stopped) {
+					reserve(onOutput);
+					auto n = std::min(static_cast<size_t>(len), win.size() - pos);
+					std::memcpy(win.data() + pos, in, n);
+					pos += n;
+					in += n;
+					len -= static_cast<uint32_t>(n);
+				}
+				return nullptr;
+			}
+
+			template <typename Func>
+			const char* inflateHuffman(const huffman& lit, const huffman& dist, const Func& onOutput)
+			{
+				static const uint16_t LenBase[] = {
+					3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+					35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258 };
+				static const uint8_t LenExtra[] = {
+					0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0 };
+				static const uint16_t DistBase[] = {
+					1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+					257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577 };
+				static const uint8_t DistExtra[] = {
+					0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13 };
+
+				while (!stopped) {
+					reserve(onOutput);
+					auto sym = decode(lit);
+					if (sym < 0)
+						return truncated ? nullptr : "Invalid literal/length code.";
+					if (sym < 256) {
+						win[pos++] = static_cast<uint8_t>(sym);
+						continue;
+					}
+					if (sym == 256)
+						return nullptr;
+
+					sym -= 257;
+					if (sym >= 29)
+						return "Invalid length symbol.";
+					auto len = LenBase[sym] + getBits(LenExtra[sym]);
+					auto dsym = decode(dist);
+					if (dsym < 0 || dsym >= 30)
+						return truncated ? nullptr : "Invalid distance code.";
+					auto d = DistBase[dsym] + getBits(DistExtra[dsym]);
+					if (truncated)
+						return nullptr;
+					if (d > pos)
+						return "Invalid distance, which exceeds the output.";
+
+					auto src = win.data() + pos - d;
+					auto dst = win.data() + pos;
+					if (d >= len)
+						std::memcpy(dst, src, len);
+					else
+						for (uint32_t i = 0; i < len; ++i)
+							dst[i] = src[i];
+					pos += len;
+				}
+				return nullptr;
+			}
+
+			template <typename Func>
+			const char* inflateDynamic(const Func& onOutput)
+			{
+				static const uint8_t Order[19] = { 16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15 };
+
+				auto litNum = getBits(5) + 257;
+				auto distNum = getBits(5) + 1;
+				auto codeLenNum = getBits(4) + 4;
+				if (litNum > 286 || distNum > 30)
+					return "Invalid dynamic block header.";
+
+				std::array<uint8_t, 19> codeLenLens;
+				codeLenLens.fill(0);
+				for (uint32_t i = 0; i < codeLenNum; ++i)
+					codeLenLens[Order[i]] = static_cast<uint8_t>(getBits(3));
+				huffman codeLen;
+				if (!codeLen.Build(codeLenLens.data(), 19))
+					return "Invalid code length code.";
+
+				std::array<uint8_t, 286 + 30> lens;
+				uint32_t i = 0;
+				while (i < litNum + distNum) {
+					auto sym = decode(codeLen);
+					if (sym < 0)
+						return truncated ? nullptr : "Invalid code length code.";
+					if (sym < 16) {
+						lens[i++] = static_cast<uint8_t>(sym);
+						continue;
+					}
+
+					uint8_t val = 0;
+					uint32_t rep;
+					if (sym == 16) {
+						if (i == 0)
+							return "Invalid repeat of code lengths.";
+						val = lens[i - 1];
+						rep = 3 + getBits(2);
+					}
+					else if (sym == 17)
+						rep = 3 + getBits(3);
+					else
+						rep = 11 + getBits(7);
+					if (i + rep > litNum + distNum)
+						return "Invalid repeat of code lengths.";
+					std::fill(lens.begin() + i, lens.begin() + i + rep, val);
+					i += rep;
+				}
+				if (truncated)
+					return nullptr;
+				if (lens[256] == 0)
+					return "Missing end-of-block code.";
+
+				huffman lit, dist;
+				if (!lit.Build(lens.data(), litNum) || !dist.Build(lens.data() + litNum, distNum))
+					return "Invalid literal/length or distance code.";
+				return inflateHuffman(lit, dist, onOutput);
+			}
+		};
+	};
+
+	/*
+	* 类: GZipTextPipeline
+	* 功能: 以流水线解压并解析gzip压缩的文本。调用线程解压，并将输出在分界处（空白或换行）切分为块，
+	*       块经有界无锁队列交给工作线程解析。解压与解析同时进行，不产生临时文件，内存占用只与队列中的块数有关
+	*/
+	class GZipTextPipeline
+	{
+	public:
+		struct Parameters
+		{
+			size_t chunkSize = static_cast<size_t>(4) << 20;
+			uint32_t workerNum = 0; // 为0时取GetWorkerThreadNum() - 1（至少为1）
+			bool splitOnLine = false; // 为true时在换行处切分，否则在空白处切分
+			bool countTokens = false; // 为true时统计各块的记号数与第一个记号的序号
+			// countTokens为true时，切分出的记号数达到该值后停止解压，其后的内容不被需要
+			size_t tokLimit = std::numeric_limits<size_t>::max();
+		};
+		struct Chunk
+		{
+			size_t idx = 0; // 块在文本中的序号
+			size_t tokBeg = 0; // 块中第一个记号在整个文本中的序号
+			size_t tokNum = 0;
+			std::vector<char> txt;
+		};
+
+		static uint32_t GetWorkerNumber(const Parameters& param)
+		{
+			if (param.workerNum != 0)
+				return param.workerNum;
+			return std::max(GetWorkerThreadNum(), 2u) - 1;
+		}
+
+		/*
+		* 函数: Run
+		* 功能: 解压gz并在GetWorkerNumber(param)个工作线程上以parse(thrdIdx, chunk)解析各块。
+		*       块按文本顺序切分，但可能以任意顺序、在任意工作线程上被解析
+		* 参数:
+		* -- parse: 返回false表示解析失败，此时停止解压与解析，由调用者记录失败的原因。
+		*           其余情况下，已交出的块都会被解析
+		* -- errMsg: 若不为空，解压失败时写入错误信息
+		* 返回值: 数据损坏或被截断时返回false
+		*/
+		template <typename Func>
+		static bool Run(const uint8_t* gz, size_t sz, const Parameters& param, const Func& parse,
+			std::string* errMsg = nullptr)
+		{
+			auto workerNum = GetWorkerNumber(param);
+			LockFreeQueue<Chunk> queue(2 * workerNum);
+			std::atomic<bool> done(false);
+			std::atomic<bool> aborted(false);
+			std::mutex mtx;
+			std::condition_variable cv;
+
+			std::vector<std::thread> workers;
+			for (uint32_t i = 0; i < workerNum; ++i)
+				workers.emplace_back([&, i]() {
+					Chunk chunk;
+					while (true) {
+						// 须在出队前读取done：出队失败后才读取时，生产者可能恰在其间入队最后一块并置done
+						auto fin = done.load();
+						if (queue.TryPop(chunk)) {
+							if (!aborted.load() && !parse(i, static_cast<const Chunk&>(chunk)))
+								aborted.store(true);
+							continue;
+						}
+						if (fin)
+							break;
+						std::unique_lock<std::mutex> lk(mtx);
+						cv.wait_for(lk, std::chrono::milliseconds(1));
+					}
+					});
+
+			size_t chunkIdx = 0;
+			size_t tokNum = 0;
+			auto push = [&](std::vector<char>&& txt) {
+				Chunk chunk;
+				chunk.idx = chunkIdx++;
+				chunk.txt = std::move(txt);
+				if (param.countTokens) {
+					chunk.tokBeg = tokNum;
+					chunk.tokNum = TXTScanner::CountTokens(chunk.txt.data(), chunk.txt.data() + chunk.txt.size());
+					tokNum += chunk.tokNum;
+				}
+				while (!queue.TryPush(std::move(chunk))) {
+					if (aborted.load())
+						return false;
+					std::this_thread::yield();
+				}
+				cv.notify_one();
+				return !aborted.load();
+			};
+
+			std::vector<char> pending;
+			pending.reserve(param.chunkSize + param.chunkSize / 8);
+			auto ok = GZipInflater::Inflate(gz, sz, param.chunkSize, [&](const uint8_t* dat, size_t n) {
+				pending.insert(pending.end(), reinterpret_cast<const char*>(dat), reinterpret_cast<const char*>(dat) + n);
+				if (pending.size() < param.chunkSize)
+					return true;
+
+				auto cut = pending.size();
+				while (cut > 0 && !(param.splitOnLine ? pending[cut - 1] == '\n' : TXTScanner::IsSpace(pending[cut - 1])))
+					--cut;
+				if (cut == 0)
+					return true; // 块中没有分界，继续累积
+
+				std::vector<char> rest;
+				rest.reserve(param.chunkSize + param.chunkSize / 8);
+				rest.assign(pending.begin() + cut, pending.end());
+				pending.resize(cut);
+				auto pushed = push(std::move(pending));
+				pending = std::move(rest);
+				return pushed && !(param.countTokens && tokNum >= param.tokLimit);
+				}, errMsg);
+			if (ok && !pending.empty() && !aborted.load() && !(param.countTokens && tokNum >= param.tokLimit))
+				push(std::move(pending));
+
+			done.store(true);
+			cv.notify_all();
+			for (auto& worker : workers)
+				worker.join();
+			return ok;
+		}
+	};
+}
+
+#endif // !SCIVIS_IO_GZIP_STREAM_H
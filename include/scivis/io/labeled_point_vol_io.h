@@ -0,0 +1,63 @@
+#ifndef SCIVIS_IO_LABELED_POINT_VOL_IO_H
+#define SCIVIS_IO_LABELED_POINT_VOL_IO_H
+
+#include <algorithm>
+
+#include <array>
+#include <vector>
+
+#include <scivis/data/labeled_point_vol_data.h>
+#include <scivis/io/vol_io.h>
+
+namespace SciVis
+{
+	namespace Convertor
+	{
+		/*
+		* 类: LabeledPointVolume
+		* 功能: 将带经纬高标签的文本体转换为列式二进制文件（见LabeledPointVolumeData），
+		*       之后可直接以Loader::LabeledTXTVolume::LoadFromFile加载，跳过文本解析
+		*/
+		class LabeledPointVolume
+		{
+		public:
+			/*
+			* 函数: FromLabeledTXTVolume
+			* 功能: 转换已加载的文本体，各轴的取值作为坐标字典。记录按网格下标排列，因此总是有序：
+			*       稠密体的每个体素为一条记录（缺失的为NaN），加载时值列可直接拷贝为网格；
+			*       稀疏体的每个有值体素为一条记录。体被归一化过时，写出的是归一化后的值
+			*/
+			static bool FromLabeledTXTVolume(
+				const Loader::LabeledTXTVolume& vol, const std::string& filePath,
+				std::string* errMsg = nullptr)
+			{
+				std::array<const std::vector<float>*, 3> axes = { { &vol.lons, &vol.lats, &vol.hs } };
+
+				if (!vol.sparse) {
+					auto dimX = vol.dim[0];
+					auto dimYxX = static_cast<size_t>(vol.dim[1]) * vol.dim[0];
+					return LabeledPointVolumeData::DumpToFile(filePath, axes, vol.dat.size(),
+						[&](size_t recIdx, std::array<uint32_t, 3>& coord, float& val) {
+							coord[0] = static_cast<uint32_t>(recIdx % dimX);
+							coord[1] = static_cast<uint32_t>(recIdx % dimYxX / dimX);
+							coord[2] = static_cast<uint32_t>(recIdx / dimYxX);
+							val = vol.dat[recIdx];
+						}, errMsg);
+				}
+
+				auto voxs = vol.sparse->GetVoxels();
+				std::sort(voxs.begin(), voxs.end(), [](const SparseVolumeData::Voxel& a, const SparseVolumeData::Voxel& b) {
+					return a.pos[2] < b.pos[2] || (a.pos[2] == b.pos[2]
+						&& (a.pos[1] < b.pos[1] || (a.pos[1] == b.pos[1] && a.pos[0] < b.pos[0])));
+					});
+				return LabeledPointVolumeData::DumpToFile(filePath, axes, voxs.size(),
+					[&](size_t recIdx, std::array<uint32_t, 3>& coord, float& val) {
+						coord = voxs[recIdx].pos;
+						val = voxs[recIdx].val;
+					}, errMsg);
+			}
+		};
+	}
+}
+
+#endif // !SCIVIS_IO_LABELED_POINT_VOL_IO_H
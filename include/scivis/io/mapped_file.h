@@ -0,0 +1,196 @@
+#ifndef SCIVIS_IO_MAPPED_FILE_H
+#define SCIVIS_IO_MAPPED_FILE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif // !NOMINMAX
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif // !WIN32_LEAN_AND_MEAN
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif // _WIN32
+
+namespace SciVis
+{
+	/*
+	* 类: MappedFile
+	* 功能: 以只读方式将文件映射到内存，数据直接由操作系统页缓存提供，避免读取与堆拷贝
+	*/
+	class MappedFile
+	{
+	public:
+		enum class EAccessHint
+		{
+			Normal = 0,
+			Sequential,
+			Random
+		};
+
+		/*
+		* 函数: Open
+		* 功能: 以只读方式映射文件
+		* 参数:
+		* -- filePath: 文件路径
+		* -- hint: 访问模式提示，用于指导操作系统的预读策略
+		* -- errMsg: 若不为空，映射失败时写入错误信息
+		* 返回值: 映射成功时返回映射句柄，否则返回空指针
+		*/
+		static std::shared_ptr<MappedFile> Open(
+			const std::string& filePath, EAccessHint hint = EAccessHint::Normal,
+			std::string* errMsg = nullptr)
+		{
+			auto setErr = [&](const char* msg) {
+				if (errMsg) {
+					*errMsg = msg;
+					errMsg->append(filePath);
+				}
+			};
+
+			std::shared_ptr<MappedFile> ret(new MappedFile);
+#ifdef _WIN32
+			DWORD flags = FILE_ATTRIBUTE_NORMAL;
+			if (hint == EAccessHint::Sequential)
+				flags |= FILE_FLAG_SEQUENTIAL_SCAN;
+			else if (hint == EAccessHint::Random)
+				flags |= FILE_FLAG_RANDOM_ACCESS;
+
+			ret->file = CreateFileA(filePath.c_str(), GENERIC_READ, FILE_SHARE_READ,
+				nullptr, OPEN_EXISTING, flags, nullptr);
+			if (ret->file == INVALID_HANDLE_VALUE) {
+				setErr("Invalid File Path: ");
+				return nullptr;
+			}
+
+			LARGE_INTEGER sz;
+			if (!GetFileSizeEx(ret->file, &sz)) {
+				setErr("Failed to Get File Size: ");
+				return nullptr;
+			}
+			ret->sz = static_cast<size_t>(sz.QuadPart);
+			if (ret->sz == 0)
+				return ret;
+
+			ret->mapping = CreateFileMappingA(ret->file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+			if (!ret->mapping) {
+				setErr("Failed to Map File: ");
+				return nullptr;
+			}
+			ret->dat = static_cast<const uint8_t*>(
+				MapViewOfFile(ret->mapping, FILE_MAP_READ, 0, 0, 0));
+			if (!ret->dat) {
+				setErr("Failed to Map File: ");
+				return nullptr;
+			}
+#else
+			ret->fd = open(filePath.c_str(), O_RDONLY);
+			if (ret->fd < 0) {
+				setErr("Invalid File Path: ");
+				return nullptr;
+			}
+
+			struct stat st;
+			if (fstat(ret->fd, &st) != 0) {
+				setErr("Failed to Get File Size: ");
+				return nullptr;
+			}
+			ret->sz = static_cast<size_t>(st.st_size);
+			if (ret->sz == 0)
+				return ret;
+
+			auto* ptr = mmap(nullptr, ret->sz, PROT_READ, MAP_SHARED, ret->fd, 0);
+			if (ptr == MAP_FAILED) {
+				setErr("Failed to Map File: ");
+				return nullptr;
+			}
+			ret->dat = static_cast<const uint8_t*>(ptr);
+			ret->Advise(hint);
+#endif // _WIN32
+
+			return ret;
+		}
+
+		~MappedFile()
+		{
+#ifdef _WIN32
+			if (dat)
+				UnmapViewOfFile(dat);
+			if (mapping)
+				CloseHandle(mapping);
+			if (file != INVALID_HANDLE_VALUE)
+				CloseHandle(file);
+#else
+			if (dat)
+				munmap(const_cast<uint8_t*>(dat), sz);
+			if (fd >= 0)
+				close(fd);
+#endif // _WIN32
+		}
+
+		/*
+		* 函数: Advise
+		* 功能: 更新映射区域的访问模式提示。Windows下提示仅在打开文件时生效，此函数不做处理
+		*/
+		void Advise(EAccessHint hint) const
+		{
+#ifndef _WIN32
+			if (!dat) return;
+
+			switch (hint)
+			{
+			case EAccessHint::Sequential:
+				madvise(const_cast<uint8_t*>(dat), sz, MADV_SEQUENTIAL);
+				madvise(const_cast<uint8_t*>(dat), sz, MADV_WILLNEED);
+				break;
+			case EAccessHint::Random:
+				madvise(const_cast<uint8_t*>(dat), sz, MADV_RANDOM);
+				break;
+			default:
+				madvise(const_cast<uint8_t*>(dat), sz, MADV_NORMAL);
+				break;
+			}
+#endif // !_WIN32
+		}
+
+		const uint8_t* GetData() const
+		{
+			return dat;
+		}
+		size_t GetSize() const
+		{
+			return sz;
+		}
+
+	private:
+		const uint8_t* dat;
+		size_t sz;
+#ifdef _WIN32
+		HANDLE file;
+		HANDLE mapping;
+#else
+		int fd;
+#endif // _WIN32
+
+		MappedFile() : dat(nullptr), sz(0)
+#ifdef _WIN32
+			, file(INVALID_HANDLE_VALUE), mapping(nullptr)
+#else
+			, fd(-1)
+#endif // _WIN32
+		{}
+		MappedFile(const MappedFile&) = delete;
+		MappedFile& operator=(const MappedFile&) = delete;
+	};
+}
+
+#endif // !SCIVIS_IO_MAPPED_FILE_H
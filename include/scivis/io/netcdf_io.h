@@ -0,0 +1,892 @@
+#ifndef SCIVIS_IO_NETCDF_IO_H
+#define SCIVIS_IO_NETCDF_IO_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <string>
+#include <type_traits>
+
+#include <array>
+#include <vector>
+
+#include <scivis/common/parallel.h>
+#include <scivis/common/util.h>
+#include <scivis/data/vol_data.h>
+#include <scivis/data/vol_region.h>
+#include <scivis/io/mapped_file.h>
+
+namespace SciVis
+{
+	/*
+	* 类: NetCDFFile
+	* 功能: 不依赖外部库的NetCDF经典格式（CDF-1）与64位偏移格式（CDF-2）读取器。
+	*       打开时只解析文件头，数据经文件映射访问，读取变量的超块（由各维的下标范围选出的子块）时只有其所在的页被读入，
+	*       结果直接成为RAWVolumeData或浮点体，无需先转换为TXT或RAW文件。
+	*       超块中长度大于1的维度依次（最快变化维在前）成为体的X、Y、Z轴，与之同名的一维坐标变量（如lon、lat、depth）
+	*       给出体的地理范围，可直接用于绘制组件的Set*Range。不支持CDF-5与NetCDF-4（HDF5）格式
+	*/
+	class NetCDFFile
+	{
+	public:
+		enum class EType : uint32_t
+		{
+			Byte = 1,
+			Char,
+			Short,
+			Int,
+			Float,
+			Double
+		};
+
+		struct Dimension
+		{
+			std::string name;
+			uint64_t len = 0; // 记录维度的长度为记录数
+			bool isRecord = false;
+		};
+		struct Attribute
+		{
+			std::string name;
+			EType type = EType::Char;
+			std::string text; // type为Char时的值
+			std::vector<double> vals; // 其余类型的值
+		};
+		struct Variable
+		{
+			std::string name;
+			std::vector<uint32_t> dimIDs; // 最慢变化维在前，记录变量的第0维为记录维度
+			std::vector<Attribute> atts;
+			EType type = EType::Float;
+			uint64_t begin = 0; // 数据在文件中的偏移，记录变量为其在第0个记录中的偏移
+			bool isRecord = false;
+
+			const Attribute* GetAttribute(const std::string& attName) const
+			{
+				for (auto& att : atts)
+					if (att.name == attName)
+						return &att;
+				return nullptr;
+			}
+		};
+
+		struct ReadParameters
+		{
+			std::string varName;
+			// 各维的下标范围[beg, end)，按变量的维度顺序排列。为空时读取整个变量，某维的end为0时读取该维从beg起的全部
+			std::vector<std::array<uint64_t, 2>> slab;
+			bool flipDescending = true; // 坐标沿某轴递减（如纬度自北向南）时翻转该轴，使体的地理范围递增
+			float nullVal = std::numeric_limits<float>::quiet_NaN(); // 浮点结果中，填充值与缺测值被替换为该值
+			uint32_t thrdNum = 0;
+		};
+		/*
+		* 结构体: VolumeInfo
+		* 功能: 超块作为体时的尺寸、各轴对应的维度与地理范围
+		*/
+		struct VolumeInfo
+		{
+			std::array<uint32_t, 3> voxPerVol = { { 1, 1, 1 } };
+			std::array<std::string, 3> dimNames; // X、Y、Z轴对应的维度名，超块不足3维时为空
+			std::array<bool, 3> hasCoordinate = { { false, false, false } }; // 该轴是否有坐标变量，有时ext中该轴的范围有效
+			std::array<bool, 3> flipped = { { false, false, false } };
+			// 对齐到体素边界的地理范围。坐标变量的positive属性为down（如深度）时取负值作为高度
+			GeographicExtent ext;
+			bool hasNullVal = false;
+			float nullVal = 0.f; // 体中的空值。浮点体为ReadParameters::nullVal，保留整数类型的体为原始的填充值
+		};
+
+		/*
+		* 函数: Open
+		* 功能: 映射并解析NetCDF文件的文件头
+		* 参数:
+		* -- filePath: 文件路径
+		* -- errMsg: 若不为空，失败时写入错误信息
+		* 返回值: 成功时返回文件，否则返回空指针
+		*/
+		static std::shared_ptr<NetCDFFile> Open(const std::string& filePath, std::string* errMsg = nullptr)
+		{
+			auto mapped = MappedFile::Open(filePath, MappedFile::EAccessHint::Random, errMsg);
+			if (!mapped)
+				return nullptr;
+
+			std::shared_ptr<NetCDFFile> ret(new NetCDFFile);
+			ret->mapped = mapped;
+			std::string err = ret->parseHeader();
+			if (!err.empty()) {
+				if (errMsg) {
+					*errMsg = err;
+					errMsg->append(" ");
+					errMsg->append(filePath);
+				}
+				return nullptr;
+			}
+			return ret;
+		}
+
+		const std::vector<Dimension>& GetDimensions() const
+		{
+			return dims;
+		}
+		const std::vector<Variable>& GetVariables() const
+		{
+			return vars;
+		}
+		const std::vector<Attribute>& GetGlobalAttributes() const
+		{
+			return gatts;
+		}
+		uint64_t GetRecordNumber() const
+		{
+			return recNum;
+		}
+		const Variable* GetVariable(const std::string& varName) const
+		{
+			for (auto& var : vars)
+				if (var.name == varName)
+					return &var;
+			return nullptr;
+		}
+
+		/*
+		* 函数: GetVolumeInfo
+		* 功能: 不读取数据，只获取超块作为体时的尺寸与地理范围，可用于先确定感兴趣区域再读取
+		*/
+		ReteurnOrError<VolumeInfo> GetVolumeInfo(const ReadParameters& param) const
+		{
+			SlabLayout lay;
+			auto err = resolveSlab(param, lay);
+			if (!err.empty())
+				return err.c_str();
+			return lay.info;
+		}
+
+		/*
+		* 函数: ReadFloatVolume
+		* 功能: 读取超块为浮点体。值已按scale_factor与add_offset换算，_FillValue、missing_value与NaN被替换为param.nullVal
+		* 参数:
+		* -- info: 若不为空，写入体的尺寸与地理范围
+		*/
+		ReteurnOrError<std::vector<float>> ReadFloatVolume(const ReadParameters& param, VolumeInfo* info = nullptr) const
+		{
+			SlabLayout lay;
+			auto err = resolveSlab(param, lay);
+			if (!err.empty())
+				return err.c_str();
+
+			std::vector<float> dat(voxelNumberOf(lay.info.voxPerVol));
+			readFloat(lay, param, dat.data());
+			lay.info.hasNullVal = true;
+			lay.info.nullVal = param.nullVal;
+			if (info)
+				*info = lay.info;
+			return dat;
+		}
+		/*
+		* 函数: ReadRAWVolume
+		* 功能: 读取超块为RAWVolumeData。未经压缩打包（无scale_factor与add_offset）的short变量保留为Int16，
+		*       带_Unsigned的byte与short变量保留为UInt8与UInt16，此时填充值保持原样并写入info.nullVal；
+		*       其余变量同ReadFloatVolume，换算为Float32
+		* 参数:
+		* -- info: 若不为空，写入体的尺寸与地理范围
+		*/
+		ReteurnOrError<RAWVolumeData> ReadRAWVolume(const ReadParameters& param, VolumeInfo* info = nullptr) const
+		{
+			SlabLayout lay;
+			auto err = resolveSlab(param, lay);
+			if (!err.empty())
+				return err.c_str();
+
+			const auto& var = *lay.var;
+			auto isUnsigned = isUnsignedVariable(var);
+			auto isPacked = var.GetAttribute("scale_factor") || var.GetAttribute("add_offset");
+			auto voxTy = ESupportedVoxelType::Float32;
+			if (!isPacked) {
+				if (var.type == EType::Short)
+					voxTy = isUnsigned ? ESupportedVoxelType::UInt16 : ESupportedVoxelType::Int16;
+				else if (var.type == EType::Byte && isUnsigned)
+					voxTy = ESupportedVoxelType::UInt8;
+			}
+
+			auto voxNum = voxelNumberOf(lay.info.voxPerVol);
+			auto buf = std::make_shared<std::vector<uint8_t>>(voxNum * RAWVolumeData::GetVoxelSize(voxTy));
+			switch (voxTy)
+			{
+			case ESupportedVoxelType::UInt8:
+				readNative<uint8_t>(lay, param, buf->data());
+				break;
+			case ESupportedVoxelType::UInt16:
+				readNative<uint16_t>(lay, param, reinterpret_cast<uint16_t*>(buf->data()));
+				break;
+			case ESupportedVoxelType::Int16:
+				readNative<int16_t>(lay, param, reinterpret_cast<int16_t*>(buf->data()));
+				break;
+			default:
+				readFloat(lay, param, reinterpret_cast<float*>(buf->data()));
+				break;
+			}
+
+			if (voxTy == ESupportedVoxelType::Float32) {
+				lay.info.hasNullVal = true;
+				lay.info.nullVal = param.nullVal;
+			}
+			else {
+				auto nulls = nullValuesOf(var);
+				lay.info.hasNullVal = !nulls.empty();
+				lay.info.nullVal = nulls.empty() ? 0.f : static_cast<float>(nulls.front());
+			}
+			if (info)
+				*info = lay.info;
+			return RAWVolumeData::FromBuffer(lay.info.voxPerVol, voxTy, buf);
+		}
+
+		/*
+		* 函数: ReadCoordinate
+		* 功能: 读取维度dimName的坐标变量（与维度同名的一维变量）的全部值
+		* 返回值: 维度没有坐标变量时返回错误
+		*/
+		ReteurnOrError<std::vector<double>> ReadCoordinate(const std::string& dimName) const
+		{
+			for (uint32_t d = 0; d < dims.size(); ++d)
+				if (dims[d].name == dimName) {
+					auto coord = findCoordinate(d);
+					if (!coord)
+						break;
+					return readCoordinate(*coord);
+				}
+			return "No coordinate variable for the dimension.";
+		}
+
+	private:
+		static constexpr uint32_t Tag_Dimension = 0x0A;
+		static constexpr uint32_t Tag_Variable = 0x0B;
+		static constexpr uint32_t Tag_Attribute = 0x0C;
+		static constexpr uint32_t StreamingRecordNumber = 0xFFFFFFFF;
+
+		struct SlabLayout
+		{
+			const Variable* var = nullptr;
+			std::vector<uint64_t> beg;
+			std::vector<uint64_t> cnt;
+			std::vector<int64_t> dstStride; // 各维下标加1时体中下标的变化，翻转的轴为负
+			int64_t dstBase = 0;
+			VolumeInfo info;
+		};
+
+		std::shared_ptr<MappedFile> mapped;
+		uint8_t version = 1;
+		uint64_t recNum = 0;
+		uint64_t recSize = 0; // 一个记录中所有记录变量的字节数
+		std::vector<Dimension> dims;
+		std::vector<Attribute> gatts;
+		std::vector<Variable> vars;
+
+		NetCDFFile() {}
+
+		template <typename T>
+		static T loadBigEndian(const uint8_t* p)
+		{
+			using U = typename std::conditional<sizeof(T) == 1, uint8_t,
+				typename std::conditional<sizeof(T) == 2, uint16_t,
+				typename std::conditional<sizeof(T) == 4, uint32_t, uint64_t>::type>::type>::type;
+			U u = 0;
+			for (size_t i = 0; i < sizeof(T); ++i)
+				u = static_cast<U>((static_cast<uint64_t>(u) << 8) | p[i]);
+			T v;
+			std::memcpy(&v, &u, sizeof(T));
+			return v;
+		}
+
+		static size_t typeSizeOf(EType type)
+		{
+			switch (type)
+			{
+			case EType::Byte:
+			case EType::Char:
+				return 1;
+			case EType::Short:
+				return 2;
+			case EType::Int:
+			case EType::Float:
+				return 4;
+			case EType::Double:
+				return 8;
+			}
+			return 0;
+		}
+		static size_t voxelNumberOf(const std::array<uint32_t, 3>& voxPerVol)
+		{
+			return static_cast<size_t>(voxPerVol[0]) * voxPerVol[1] * voxPerVol[2];
+		}
+
+		/*
+		* 类: headerReader
+		* 功能: 按NetCDF文件头的语法顺序读取大端存储的字段，越界时置ok为false并返回0
+		*/
+		class headerReader
+		{
+		public:
+			bool ok = true;
+
+			headerReader(const uint8_t* dat, size_t sz) : dat(dat), sz(sz) {}
+
+			uint32_t U32()
+			{
+				if (!has(4))
+					return 0;
+				pos += 4;
+				return loadBigEndian<uint32_t>(dat + pos - 4);
+			}
+			uint64_t U64()
+			{
+				if (!has(8))
+					return 0;
+				pos += 8;
+				return loadBigEndian<uint64_t>(dat + pos - 8);
+			}
+			std::string Name()
+			{
+				auto len = U32();
+				if (!has(padded(len)))
+					return std::string();
+				std::string ret(reinterpret_cast<const char*>(dat + pos), len);
+				pos += padded(len);
+				return ret;
+			}
+			const uint8_t* Skip(uint64_t n)
+			{
+				if (!has(padded(n)))
+					return nullptr;
+				auto ret = dat + pos;
+				pos += padded(n);
+				return ret;
+			}
+
+			static uint64_t padded(uint64_t n)
+			{
+				return (n + 3) & ~static_cast<uint64_t>(3);
+			}
+
+		private:
+			const uint8_t* dat;
+			size_t sz;
+			size_t pos = 0;
+
+			bool has(uint64_t n)
+			{
+				if (ok && n <= sz - pos)
+					return true;
+				ok = false;
+				return false;
+			}
+		};
+
+		static std::vector<Attribute> parseAttributes(headerReader& rd)
+		{
+			std::vector<Attribute> ret;
+			auto tag = rd.U32();
+			auto num = rd.U32();
+			if (tag != Tag_Attribute) {
+				if (tag != 0 || num != 0)
+					rd.ok = false;
+				return ret;
+			}
+
+			for (uint32_t i = 0; i < num && rd.ok; ++i) {
+				Attribute att;
+				att.name = rd.Name();
+				att.type = static_cast<EType>(rd.U32());
+				auto valNum = rd.U32();
+				auto typeSz = typeSizeOf(att.type);
+				if (typeSz == 0) {
+					rd.ok = false;
+					break;
+				}
+
+				auto vals = rd.Skip(static_cast<uint64_t>(valNum) * typeSz);
+				if (!vals)
+					break;
+				if (att.type == EType::Char) {
+					att.text.assign(reinterpret_cast<const char*>(vals), valNum);
+					// 部分写入程序以'\0'结尾
+					while (!att.text.empty() && att.text.back() == '\0')
+						att.text.pop_back();
+				}
+				else {
+					att.vals.resize(valNum);
+					for (uint32_t j = 0; j < valNum; ++j)
+						att.vals[j] = decode(vals + j * typeSz, att.type, false);
+				}
+				ret.emplace_back(std::move(att));
+			}
+			return ret;
+		}
+
+		std::string parseHeader()
+		{
+			const auto* dat = mapped->GetData();
+			auto sz = mapped->GetSize();
+			if (sz >= 4 && dat[0] == 0x89 && dat[1] == 'H' && dat[2] == 'D' && dat[3] == 'F')
+				return "NetCDF-4 (HDF5) format is not supported:";
+			if (sz < 4 || dat[0] != 'C' || dat[1] != 'D' || dat[2] != 'F')
+				return "Not a NetCDF file:";
+			version = dat[3];
+			if (version == 5)
+				return "CDF-5 format is not supported:";
+			if (version != 1 && version != 2)
+				return "Unknown NetCDF version:";
+
+			headerReader rd(dat, sz);
+			rd.Skip(4);
+			auto numRecs = rd.U32();
+
+			auto tag = rd.U32();
+			auto num = rd.U32();
+			if (tag == Tag_Dimension)
+				for (uint32_t i = 0; i < num && rd.ok; ++i) {
+					Dimension dim;
+					dim.name = rd.Name();
+					dim.len = rd.U32();
+					dim.isRecord = dim.len == 0;
+					dims.emplace_back(std::move(dim));
+				}
+			else if (tag != 0 || num != 0)
+				return "Invalid dimension list in:";
+
+			gatts = parseAttributes(rd);
+
+			tag = rd.U32();
+			num = rd.U32();
+			if (tag == Tag_Variable)
+				for (uint32_t i = 0; i < num && rd.ok; ++i) {
+					Variable var;
+					var.name = rd.Name();
+					auto dimNum = rd.U32();
+					for (uint32_t j = 0; j < dimNum && rd.ok; ++j) {
+						auto dimID = rd.U32();
+						if (dimID >= dims.size())
+							return "Invalid dimension ID in:";
+						if (j != 0 && dims[dimID].isRecord)
+							return "Record dimension must be the first dimension in:";
+						var.dimIDs.emplace_back(dimID);
+					}
+					var.isRecord = !var.dimIDs.empty() && dims[var.dimIDs[0]].isRecord;
+					var.atts = parseAttributes(rd);
+					var.type = static_cast<EType>(rd.U32());
+					if (typeSizeOf(var.type) == 0)
+						return "Invalid variable type in:";
+					rd.U32(); // vsize，超过4GiB时被截断，由维度重新计算
+					var.begin = version == 1 ? rd.U32() : rd.U64();
+					if (rd.ok && var.begin > sz)
+						return "Invalid variable offset, which exceeds the file, in:";
+					vars.emplace_back(std::move(var));
+				}
+			else if (tag != 0 || num != 0)
+				return "Invalid variable list in:";
+			if (!rd.ok)
+				return "Truncated header in:";
+
+			// 每个记录依次存放所有记录变量，只有一个记录变量时不补齐到4字节
+			uint32_t recVarNum = 0;
+			uint64_t minRecBegin = std::numeric_limits<uint64_t>::max();
+			for (auto& var : vars) {
+				uint64_t bytes;
+				if (!recordBytesOf(var, bytes))
+					return "Variable size overflows in:";
+				if (!var.isRecord)
+					continue;
+
+				++recVarNum;
+				if (bytes > std::numeric_limits<uint64_t>::max() - 3
+					|| !checkedAdd(recSize, headerReader::padded(bytes), recSize))
+					return "Record size overflows in:";
+				minRecBegin = std::min(minRecBegin, var.begin);
+			}
+			if (recVarNum == 1)
+				for (auto& var : vars)
+					if (var.isRecord)
+						recordBytesOf(var, recSize);
+
+			recNum = numRecs;
+			if (numRecs == StreamingRecordNumber)
+				recNum = recVarNum == 0 || recSize == 0 || sz < minRecBegin ? 0 : (sz - minRecBegin) / recSize;
+			for (auto& dim : dims)
+				if (dim.isRecord)
+					dim.len = recNum;
+
+			return std::string();
+		}
+
+		static bool checkedMul(uint64_t a, uint64_t b, uint64_t& ret)
+		{
+			if (a != 0 && b > std::numeric_limits<uint64_t>::max() / a)
+				return false;
+			ret = a * b;
+			return true;
+		}
+		static bool checkedAdd(uint64_t a, uint64_t b, uint64_t& ret)
+		{
+			if (b > std::numeric_limits<uint64_t>::max() - a)
+				return false;
+			ret = a + b;
+			return true;
+		}
+
+		/*
+		* 函数: recordBytesOf
+		* 功能: 计算变量（记录变量为其一个记录）的字节数
+		* 返回值: 字节数溢出时返回false
+		*/
+		bool recordBytesOf(const Variable& var, uint64_t& bytes) const
+		{
+			bytes = typeSizeOf(var.type);
+			for (size_t d = var.isRecord ? 1 : 0; d < var.dimIDs.size(); ++d)
+				if (!checkedMul(bytes, dims[var.dimIDs[d]].len, bytes))
+					return false;
+			return true;
+		}
+		/*
+		* 函数: offsetOf
+		* 功能: 计算元素在文件中的偏移。文件头中的偏移与维度长度不可信，各步均检查溢出
+		* 返回值: 偏移溢出时返回false
+		*/
+		bool offsetOf(const Variable& var, const uint64_t* idx, uint64_t& off) const
+		{
+			off = 0;
+			for (size_t d = var.isRecord ? 1 : 0; d < var.dimIDs.size(); ++d)
+				if (!checkedMul(off, dims[var.dimIDs[d]].len, off) || !checkedAdd(off, idx[d], off))
+					return false;
+			if (!checkedMul(off, typeSizeOf(var.type), off) || !checkedAdd(off, var.begin, off))
+				return false;
+			if (var.isRecord) {
+				uint64_t recOff;
+				if (!checkedMul(idx[0], recSize, recOff) || !checkedAdd(off, recOff, off))
+					return false;
+			}
+			return true;
+		}
+		/*
+		* 函数: isInFile
+		* 功能: 检查元素是否完整地位于文件中。超块中各元素的偏移不超过其最后一个元素的偏移，
+		*       因此只需检查最后一个元素，之后以uncheckedOffsetOf计算各元素的偏移
+		*/
+		bool isInFile(const Variable& var, const uint64_t* idx) const
+		{
+			uint64_t off;
+			return offsetOf(var, idx, off) && off <= mapped->GetSize()
+				&& mapped->GetSize() - off >= typeSizeOf(var.type);
+		}
+		uint64_t uncheckedOffsetOf(const Variable& var, const uint64_t* idx) const
+		{
+			uint64_t off = 0;
+			for (size_t d = var.isRecord ? 1 : 0; d < var.dimIDs.size(); ++d)
+				off = off * dims[var.dimIDs[d]].len + idx[d];
+			off = var.begin + off * typeSizeOf(var.type);
+			if (var.isRecord)
+				off += idx[0] * recSize;
+			return off;
+		}
+
+		static bool isUnsignedVariable(const Variable& var)
+		{
+			auto att = var.GetAttribute("_Unsigned");
+			return att && (att->text == "true" || att->text == "TRUE" || att->text == "True");
+		}
+		static double decode(const uint8_t* p, EType type, bool isUnsigned)
+		{
+			switch (type)
+			{
+			case EType::Byte:
+				return isUnsigned ? loadBigEndian<uint8_t>(p) : loadBigEndian<int8_t>(p);
+			case EType::Short:
+				return isUnsigned ? loadBigEndian<uint16_t>(p) : loadBigEndian<int16_t>(p);
+			case EType::Int:
+				return isUnsigned ? loadBigEndian<uint32_t>(p) : loadBigEndian<int32_t>(p);
+			case EType::Float:
+				return loadBigEndian<float>(p);
+			case EType::Double:
+				return loadBigEndian<double>(p);
+			default:
+				break;
+			}
+			return 0.;
+		}
+		/*
+		* 函数: nullValuesOf
+		* 功能: 获取变量的空值（未经换算），依次为_FillValue（缺省时为NetCDF的默认填充值，byte变量没有默认值）与missing_value
+		*/
+		static std::vector<double> nullValuesOf(const Variable& var)
+		{
+			std::vector<double> ret;
+			auto isUnsigned = isUnsignedVariable(var);
+			auto bits = 8 * typeSizeOf(var.type);
+			auto append = [&](double v) {
+				// _Unsigned变量的属性仍以有符号类型存储
+				if (isUnsigned && v < 0.)
+					v += std::ldexp(1., static_cast<int>(bits));
+				ret.emplace_back(v);
+			};
+
+			auto fill = var.GetAttribute("_FillValue");
+			if (fill && !fill->vals.empty())
+				append(fill->vals[0]);
+			else
+				switch (var.type)
+				{
+				case EType::Short:
+					append(-32767.);
+					break;
+				case EType::Int:
+					append(-2147483647.);
+					break;
+				case EType::Float:
+					append(static_cast<double>(9.9692099683868690e+36f));
+					break;
+				case EType::Double:
+					append(9.9692099683868690e+36);
+					break;
+				default:
+					break;
+				}
+
+			auto missing = var.GetAttribute("missing_value");
+			if (missing)
+				for (auto v : missing->vals)
+					append(v);
+			return ret;
+		}
+
+		const Variable* findCoordinate(uint32_t dimID) const
+		{
+			for (auto& var : vars)
+				if (var.name == dims[dimID].name && var.dimIDs.size() == 1 && var.dimIDs[0] == dimID
+					&& var.type != EType::Char)
+					return &var;
+			return nullptr;
+		}
+		ReteurnOrError<std::vector<double>> readCoordinate(const Variable& var) const
+		{
+			auto len = dims[var.dimIDs[0]].len;
+			if (len != 0) {
+				uint64_t last = len - 1;
+				if (!isInFile(var, &last))
+					return "Coordinate variable exceeds the file.";
+			}
+
+			auto isUnsigned = isUnsignedVariable(var);
+			auto scaleAtt = var.GetAttribute("scale_factor");
+			auto offsetAtt = var.GetAttribute("add_offset");
+			auto scale = scaleAtt && !scaleAtt->vals.empty() ? scaleAtt->vals[0] : 1.;
+			auto offset = offsetAtt && !offsetAtt->vals.empty() ? offsetAtt->vals[0] : 0.;
+
+			std::vector<double> ret(len);
+			for (uint64_t i = 0; i < len; ++i)
+				ret[i] = decode(mapped->GetData() + uncheckedOffsetOf(var, &i), var.type, isUnsigned) * scale + offset;
+			return ret;
+		}
+
+		/*
+		* 函数: resolveSlab
+		* 功能: 检查超块，确定各维在体中的轴、步长与翻转，并由坐标变量计算地理范围
+		* 返回值: 失败时返回错误信息，否则返回空字符串
+		*/
+		std::string resolveSlab(const ReadParameters& param, SlabLayout& lay) const
+		{
+			auto var = GetVariable(param.varName);
+			if (!var)
+				return "No such variable.";
+			if (var->type == EType::Char)
+				return "Variable of char type cannot be read as a volume.";
+			auto dimNum = var->dimIDs.size();
+			if (!param.slab.empty() && param.slab.size() != dimNum)
+				return "Invalid slab, whose size does not match the variable's dimension number.";
+
+			lay.var = var;
+			lay.beg.resize(dimNum);
+			lay.cnt.resize(dimNum);
+			lay.dstStride.assign(dimNum, 0);
+			for (size_t d = 0; d < dimNum; ++d) {
+				auto len = dims[var->dimIDs[d]].len;
+				uint64_t beg = 0, end = len;
+				if (!param.slab.empty()) {
+					beg = param.slab[d][0];
+					end = param.slab[d][1] == 0 ? len : param.slab[d][1];
+				}
+				if (beg >= end || end > len)
+					return "Invalid slab, which is empty or exceeds the variable.";
+				lay.beg[d] = beg;
+				lay.cnt[d] = end - beg;
+			}
+
+			// 长度大于1的维度按最快变化维在前依次成为X、Y、Z轴
+			std::vector<size_t> axisDims;
+			for (size_t d = dimNum; d-- > 0;)
+				if (lay.cnt[d] > 1)
+					axisDims.emplace_back(d);
+			if (axisDims.size() > 3)
+				return "Invalid slab, which has more than 3 dimensions longer than 1.";
+			for (size_t a = 0; a < axisDims.size(); ++a) {
+				if (lay.cnt[axisDims[a]] > std::numeric_limits<uint32_t>::max())
+					return "Invalid slab, which is too large.";
+				lay.info.voxPerVol[a] = static_cast<uint32_t>(lay.cnt[axisDims[a]]);
+				lay.info.dimNames[a] = dims[var->dimIDs[axisDims[a]]].name;
+			}
+
+			// 标量变量的下标为空，同样检查其唯一的元素
+			std::vector<uint64_t> last(dimNum);
+			for (size_t d = 0; d < dimNum; ++d)
+				last[d] = lay.beg[d] + lay.cnt[d] - 1;
+			if (!isInFile(*var, last.data()))
+				return "Variable data exceeds the file.";
+
+			int64_t stride = 1;
+			for (size_t a = 0; a < axisDims.size(); ++a) {
+				auto d = axisDims[a];
+				lay.dstStride[d] = stride;
+
+				auto coord = findCoordinate(var->dimIDs[d]);
+				if (coord) {
+					auto vals = readCoordinate(*coord);
+					if (!vals.ok)
+						return vals.result.errMsg;
+					auto rng = cellBoundsOf(vals.result.dat, lay.beg[d], lay.beg[d] + lay.cnt[d]);
+					auto positive = coord->GetAttribute("positive");
+					if (positive && (positive->text == "down" || positive->text == "DOWN")) {
+						rng[0] = 0. - rng[0];
+						rng[1] = 0. - rng[1];
+					}
+					if (rng[0] > rng[1] && param.flipDescending) {
+						std::swap(rng[0], rng[1]);
+						lay.info.flipped[a] = true;
+						lay.dstBase += static_cast<int64_t>(lay.cnt[d] - 1) * stride;
+						lay.dstStride[d] = -stride;
+					}
+					lay.info.ext[static_cast<uint8_t>(a)] = { {
+						static_cast<float>(rng[0]), static_cast<float>(rng[1]) } };
+					lay.info.hasCoordinate[a] = true;
+				}
+
+				stride *= static_cast<int64_t>(lay.cnt[d]);
+			}
+
+			return std::string();
+		}
+		/*
+		* 函数: cellBoundsOf
+		* 功能: 坐标给出体素中心，下标范围[beg, end)的体素的边界取相邻坐标的中点，两端按相邻间距外推
+		*/
+		static std::array<double, 2> cellBoundsOf(const std::vector<double>& c, uint64_t beg, uint64_t end)
+		{
+			auto n = c.size();
+			std::array<double, 2> ret;
+			if (n < 2)
+				ret[0] = ret[1] = c.empty() ? 0. : c[0];
+			else {
+				ret[0] = beg > 0 ? .5 * (c[beg - 1] + c[beg]) : c[0] - .5 * (c[1] - c[0]);
+				ret[1] = end < n ? .5 * (c[end - 1] + c[end]) : c[n - 1] + .5 * (c[n - 1] - c[n - 2]);
+			}
+			return ret;
+		}
+
+		/*
+		* 函数: forEachRow
+		* 功能: 超块按文件中连续的行并行遍历，每行调用func(src, num, dst, dstStep)
+		*/
+		template <typename T, typename Func>
+		void forEachRow(const SlabLayout& lay, uint32_t thrdNum, T* dst, const Func& func) const
+		{
+			const auto& var = *lay.var;
+			auto dimNum = lay.cnt.size();
+			// 只有记录维度的变量，相邻元素位于不同记录中，每行只有一个元素
+			auto rowDim = dimNum == 0 || (var.isRecord && dimNum == 1) ? dimNum : dimNum - 1;
+			auto rowLen = rowDim < dimNum ? lay.cnt[rowDim] : 1;
+			auto rowStep = rowDim < dimNum ? lay.dstStride[rowDim] : 0;
+			size_t rowNum = 1;
+			for (size_t d = 0; d < rowDim; ++d)
+				rowNum *= lay.cnt[d];
+
+			ParallelFor(rowNum, [&](uint32_t, size_t beg, size_t end) {
+				std::vector<uint64_t> idx(lay.beg);
+				for (auto r = beg; r < end; ++r) {
+					auto rem = r;
+					auto dstOff = lay.dstBase;
+					for (size_t d = rowDim; d-- > 0;) {
+						auto i = rem % lay.cnt[d];
+						rem /= lay.cnt[d];
+						idx[d] = lay.beg[d] + i;
+						dstOff += static_cast<int64_t>(i) * lay.dstStride[d];
+					}
+					func(mapped->GetData() + uncheckedOffsetOf(var, idx.data()), static_cast<size_t>(rowLen),
+						dst + dstOff, rowStep);
+				}
+				}, thrdNum);
+		}
+
+		template <typename Src>
+		void readFloatAs(const SlabLayout& lay, const ReadParameters& param, float* dst) const
+		{
+			const auto& var = *lay.var;
+			auto scaleAtt = var.GetAttribute("scale_factor");
+			auto offsetAtt = var.GetAttribute("add_offset");
+			auto scale = scaleAtt && !scaleAtt->vals.empty() ? scaleAtt->vals[0] : 1.;
+			auto offset = offsetAtt && !offsetAtt->vals.empty() ? offsetAtt->vals[0] : 0.;
+			auto nulls = nullValuesOf(var);
+			auto nullVal = param.nullVal;
+
+			forEachRow(lay, param.thrdNum, dst, [&](const uint8_t* src, size_t num, float* out, int64_t step) {
+				for (size_t i = 0; i < num; ++i, src += sizeof(Src), out += step) {
+					auto raw = static_cast<double>(loadBigEndian<Src>(src));
+					auto isNull = raw != raw;
+					for (auto v : nulls)
+						isNull |= raw == v;
+					*out = isNull ? nullVal : static_cast<float>(raw * scale + offset);
+				}
+				});
+		}
+		void readFloat(const SlabLayout& lay, const ReadParameters& param, float* dst) const
+		{
+			auto isUnsigned = isUnsignedVariable(*lay.var);
+			switch (lay.var->type)
+			{
+			case EType::Byte:
+				if (isUnsigned)
+					readFloatAs<uint8_t>(lay, param, dst);
+				else
+					readFloatAs<int8_t>(lay, param, dst);
+				break;
+			case EType::Short:
+				if (isUnsigned)
+					readFloatAs<uint16_t>(lay, param, dst);
+				else
+					readFloatAs<int16_t>(lay, param, dst);
+				break;
+			case EType::Int:
+				if (isUnsigned)
+					readFloatAs<uint32_t>(lay, param, dst);
+				else
+					readFloatAs<int32_t>(lay, param, dst);
+				break;
+			case EType::Float:
+				readFloatAs<float>(lay, param, dst);
+				break;
+			case EType::Double:
+				readFloatAs<double>(lay, param, dst);
+				break;
+			default:
+				break;
+			}
+		}
+		template <typename T>
+		void readNative(const SlabLayout& lay, const ReadParameters& param, T* dst) const
+		{
+			forEachRow(lay, param.thrdNum, dst, [&](const uint8_t* src, size_t num, T* out, int64_t step) {
+				for (size_t i = 0; i < num; ++i, src += sizeof(T), out += step)
+					*out = loadBigEndian<T>(src);
+				});
+		}
+	};
+}
+
+#endif // !SCIVIS_IO_NETCDF_IO_H
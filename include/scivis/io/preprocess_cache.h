@@ -0,0 +1,448 @@
+#ifndef SCIVIS_IO_PREPROCESS_CACHE_H
+#define SCIVIS_IO_PREPROCESS_CACHE_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <type_traits>
+
+#include <vector>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif // !NOMINMAX
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif // !WIN32_LEAN_AND_MEAN
+#include <Windows.h>
+#else
+#include <dirent.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+#endif // _WIN32
+
+#include <scivis/common/util.h>
+#include <scivis/io/mapped_file.h>
+
+namespace SciVis
+{
+	/*
+	* 类: PreprocessCache
+	* 功能: 预处理结果（平滑体、重采样体、解析并归一化后的体等）的持久化磁盘缓存，跨进程重启有效。
+	*       缓存项以内容寻址：键由源数据内容的哈希与处理参数共同决定，源数据或参数改变时自然失效。
+	*       每项为一个文件，文件头之后即为以本机字节序存放的结果数组，命中时直接映射，无需任何解析或计算。
+	*       未设置缓存目录时缓存不生效，GetOrCompute直接计算。
+	*       缓存目录的总大小受SetMaxBytes限制，每次写入缓存项后按写入时间由早到晚删除超出上限的缓存项
+	*/
+	class PreprocessCache
+	{
+	public:
+		static constexpr uint32_t Version = 1;
+
+		/*
+		* 结构体: Key
+		* 功能: 缓存键的构造器，依次混入各组成部分
+		*/
+		struct Key
+		{
+			uint64_t val = 0x9e3779b97f4a7c15ull;
+
+			Key& Add(const void* dat, size_t sz)
+			{
+				val = Hash(dat, sz, val);
+				return *this;
+			}
+			Key& Add(const std::string& str)
+			{
+				return Add(str.data(), str.size());
+			}
+			Key& Add(const char* str)
+			{
+				return Add(str, std::strlen(str));
+			}
+			/*
+			* 函数: Add
+			* 功能: 混入一个标量或标量数组（如std::array）。结构体可能含有未初始化的填充字节，应逐成员混入
+			*/
+			template <typename T>
+			Key& Add(const T& v)
+			{
+				static_assert(std::is_trivially_copyable<T>::value, "T must be trivially copyable");
+				return Add(&v, sizeof(T));
+			}
+		};
+
+		/*
+		* 结构体: CachedArray
+		* 功能: 缓存结果的只读视图。命中时指向文件映射，未命中时指向新计算的数组，由owner保持有效
+		*/
+		template <typename T>
+		struct CachedArray
+		{
+			const T* data = nullptr;
+			size_t size = 0;
+			bool hit = false;
+			std::shared_ptr<const void> owner;
+
+			std::vector<T> ToVector() const
+			{
+				return std::vector<T>(data, data + size);
+			}
+		};
+
+		static PreprocessCache& Instance()
+		{
+			static PreprocessCache cache;
+			return cache;
+		}
+
+		/*
+		* 函数: SetDirectory
+		* 功能: 设置缓存目录，不存在时创建。为空时关闭缓存
+		*/
+		void SetDirectory(const std::string& dirPath)
+		{
+			std::lock_guard<std::mutex> lk(mtx);
+			dir = dirPath;
+			if (dir.empty()) return;
+			if (dir.back() != '/' && dir.back() != '\\')
+				dir.push_back('/');
+#ifdef _WIN32
+			CreateDirectoryA(dir.c_str(), nullptr);
+#else
+			mkdir(dir.c_str(), 0755);
+#endif // _WIN32
+		}
+		std::string GetDirectory() const
+		{
+			std::lock_guard<std::mutex> lk(mtx);
+			return dir;
+		}
+		bool IsEnabled() const
+		{
+			return !GetDirectory().empty();
+		}
+
+		/*
+		* 函数: SetMaxBytes
+		* 功能: 设置缓存目录中缓存项总大小的上限（字节），默认为4GB。为0时不限制
+		*/
+		void SetMaxBytes(uint64_t bytes)
+		{
+			maxBytes = bytes;
+		}
+		uint64_t GetMaxBytes() const
+		{
+			return maxBytes;
+		}
+
+		/*
+		* 函数: Trim
+		* 功能: 按写入时间由早到晚删除缓存项（包括异常退出的进程遗留的临时文件），直到缓存目录中缓存项的总大小不超过maxBytes。
+		*       为0时清空缓存目录。在Windows上，正被映射的缓存项无法删除，将被跳过
+		* 返回值: 删除的字节数
+		*/
+		uint64_t Trim(uint64_t maxBytes)
+		{
+			auto dir = GetDirectory();
+			if (dir.empty())
+				return 0;
+
+			auto entries = listEntries(dir);
+			uint64_t totBytes = 0;
+			for (auto& entry : entries)
+				totBytes += entry.bytes;
+			std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) {
+				return a.writeTime < b.writeTime;
+				});
+
+			uint64_t removedBytes = 0;
+			for (auto& entry : entries) {
+				if (totBytes <= maxBytes)
+					break;
+				if (std::remove(entry.path.c_str()) != 0)
+					continue;
+				totBytes -= entry.bytes;
+				removedBytes += entry.bytes;
+			}
+			return removedBytes;
+		}
+
+		/*
+		* 函数: GetOrCompute
+		* 功能: 查找键对应的缓存项，命中时直接映射返回；否则调用compute计算，成功时写入缓存后返回。
+		*       计算失败时不写入缓存，下次仍会重新计算
+		* 参数:
+		* -- key: 缓存键
+		* -- expectedSize: 结果数组的元素数。大小与之不符的缓存项视为未命中，计算结果与之不符时视为失败
+		* -- compute: 形如compute()的可调用对象，返回ReteurnOrError<std::vector<T>>
+		*/
+		template <typename T, typename Compute>
+		ReteurnOrError<CachedArray<T>> GetOrCompute(const Key& key, size_t expectedSize, const Compute& compute)
+		{
+			static_assert(std::is_trivially_copyable<T>::value, "T must be trivially copyable");
+
+			CachedArray<T> ret;
+			auto filePath = getFilePath(key);
+			if (!filePath.empty()) {
+				auto mapped = open(filePath, key);
+				if (mapped && mapped->GetSize() - sizeof(Header) == sizeof(T) * expectedSize) {
+					++hitCnt;
+					bytesSaved += mapped->GetSize() - sizeof(Header);
+					ret.data = reinterpret_cast<const T*>(mapped->GetData() + sizeof(Header));
+					ret.size = expectedSize;
+					ret.hit = true;
+					ret.owner = mapped;
+					return ret;
+				}
+			}
+
+			++missCnt;
+			auto computed = compute();
+			if (!computed.ok)
+				return computed.result.errMsg.c_str();
+			if (computed.result.dat.size() != expectedSize)
+				return "Invalid computed result, whose size is not expectedSize.";
+
+			auto dat = std::make_shared<std::vector<T>>(std::move(computed.result.dat));
+			if (!filePath.empty())
+				store(filePath, key, dat->data(), dat->size() * sizeof(T));
+			ret.data = dat->data();
+			ret.size = dat->size();
+			ret.owner = dat;
+			return ret;
+		}
+
+		size_t GetHitCount() const
+		{
+			return hitCnt;
+		}
+		size_t GetMissCount() const
+		{
+			return missCnt;
+		}
+		/*
+		* 函数: GetBytesSaved
+		* 功能: 获取命中的缓存项的总字节数，即免于重新计算的结果大小
+		*/
+		size_t GetBytesSaved() const
+		{
+			return bytesSaved;
+		}
+
+		/*
+		* 函数: Hash
+		* 功能: 64位非加密哈希。以4路并行的乘法-循环移位混合8字节字，吞吐量接近内存带宽
+		*/
+		static uint64_t Hash(const void* dat, size_t sz, uint64_t seed = 0)
+		{
+			const uint64_t P1 = 0x9e3779b185ebca87ull;
+			const uint64_t P2 = 0xc2b2ae3d27d4eb4full;
+			auto round = [&](uint64_t acc, uint64_t v) {
+				acc += v * P2;
+				acc = (acc << 31) | (acc >> 33);
+				return acc * P1;
+			};
+
+			auto p = static_cast<const uint8_t*>(dat);
+			auto end = p + sz;
+			uint64_t lanes[4] = { seed + P1 + P2, seed + P2, seed, seed - P1 };
+			for (; p + 32 <= end; p += 32)
+				for (int i = 0; i < 4; ++i) {
+					uint64_t v;
+					std::memcpy(&v, p + 8 * i, 8);
+					lanes[i] = round(lanes[i], v);
+				}
+
+			uint64_t h = sz;
+			for (int i = 0; i < 4; ++i)
+				h = round(h ^ lanes[i], lanes[i]);
+			for (; p + 8 <= end; p += 8) {
+				uint64_t v;
+				std::memcpy(&v, p, 8);
+				h = round(h, v);
+			}
+			for (; p < end; ++p)
+				h = round(h, *p);
+
+			h ^= h >> 33;
+			h *= P2;
+			h ^= h >> 29;
+			return h;
+		}
+		/*
+		* 函数: HashFile
+		* 功能: 计算文件内容的哈希
+		* 返回值: 文件无法打开时返回false
+		*/
+		static bool HashFile(const std::string& filePath, uint64_t& hash)
+		{
+			auto mapped = MappedFile::Open(filePath, MappedFile::EAccessHint::Sequential);
+			if (!mapped)
+				return false;
+			hash = Hash(mapped->GetData(), mapped->GetSize());
+			return true;
+		}
+
+	private:
+		struct Header
+		{
+			char magic[4];
+			uint32_t version;
+			uint64_t key;
+			uint64_t payloadSz;
+			uint64_t payloadHash; // 用于发现被截断或损坏的缓存文件
+			uint8_t reserved[32]; // 使结果数组按64字节对齐
+		};
+		static_assert(sizeof(Header) == 64, "Header must have no padding");
+
+		struct Entry
+		{
+			std::string path;
+			uint64_t bytes;
+			uint64_t writeTime;
+		};
+
+		mutable std::mutex mtx;
+		std::string dir;
+		std::atomic<uint64_t> maxBytes;
+		std::atomic<size_t> hitCnt;
+		std::atomic<size_t> missCnt;
+		std::atomic<size_t> bytesSaved;
+		std::atomic<uint32_t> tmpCnt;
+
+		PreprocessCache()
+		{
+			hitCnt = 0;
+			missCnt = 0;
+			bytesSaved = 0;
+			tmpCnt = 0;
+			maxBytes = static_cast<uint64_t>(4) << 30;
+		}
+
+		static const char* Magic()
+		{
+			return "SVPC";
+		}
+
+		std::string getFilePath(const Key& key) const
+		{
+			auto dir = GetDirectory();
+			if (dir.empty())
+				return dir;
+
+			char name[17];
+			std::snprintf(name, sizeof(name), "%016llx", static_cast<unsigned long long>(key.val));
+			return dir + name + ".svpc";
+		}
+
+		/*
+		* 函数: listEntries
+		* 功能: 列出目录中的缓存项与临时文件（文件名含.svpc）
+		*/
+		static std::vector<Entry> listEntries(const std::string& dir)
+		{
+			std::vector<Entry> entries;
+#ifdef _WIN32
+			WIN32_FIND_DATAA fd;
+			auto hFind = FindFirstFileA((dir + "*.svpc*").c_str(), &fd);
+			if (hFind == INVALID_HANDLE_VALUE)
+				return entries;
+			do {
+				if (fd.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) continue;
+				Entry entry;
+				entry.path = dir + fd.cFileName;
+				entry.bytes = (static_cast<uint64_t>(fd.nFileSizeHigh) << 32) | fd.nFileSizeLow;
+				entry.writeTime = (static_cast<uint64_t>(fd.ftLastWriteTime.dwHighDateTime) << 32)
+					| fd.ftLastWriteTime.dwLowDateTime;
+				entries.emplace_back(std::move(entry));
+			} while (FindNextFileA(hFind, &fd));
+			FindClose(hFind);
+#else
+			auto dirp = opendir(dir.c_str());
+			if (!dirp)
+				return entries;
+			while (auto ent = readdir(dirp)) {
+				if (std::strstr(ent->d_name, ".svpc") == nullptr) continue;
+				Entry entry;
+				entry.path = dir + ent->d_name;
+				struct stat st;
+				if (stat(entry.path.c_str(), &st) != 0 || !S_ISREG(st.st_mode)) continue;
+				entry.bytes = static_cast<uint64_t>(st.st_size);
+				entry.writeTime = static_cast<uint64_t>(st.st_mtime);
+				entries.emplace_back(std::move(entry));
+			}
+			closedir(dirp);
+#endif // _WIN32
+			return entries;
+		}
+
+		static std::shared_ptr<MappedFile> open(const std::string& filePath, const Key& key)
+		{
+			auto mapped = MappedFile::Open(filePath, MappedFile::EAccessHint::Sequential);
+			if (!mapped || mapped->GetSize() < sizeof(Header))
+				return nullptr;
+
+			Header hdr;
+			std::memcpy(&hdr, mapped->GetData(), sizeof(Header));
+			if (std::memcmp(hdr.magic, Magic(), 4) != 0 || hdr.version != Version || hdr.key != key.val
+				|| hdr.payloadSz != mapped->GetSize() - sizeof(Header)
+				|| hdr.payloadHash != Hash(mapped->GetData() + sizeof(Header), static_cast<size_t>(hdr.payloadSz)))
+				return nullptr;
+			return mapped;
+		}
+
+		/*
+		* 函数: store
+		* 功能: 先写入临时文件再重命名，使其他进程不会读到写了一半的缓存项。写入失败时不影响计算结果
+		*/
+		void store(const std::string& filePath, const Key& key, const void* dat, size_t sz)
+		{
+			Header hdr;
+			std::memset(&hdr, 0, sizeof(Header));
+			std::memcpy(hdr.magic, Magic(), 4);
+			hdr.version = Version;
+			hdr.key = key.val;
+			hdr.payloadSz = sz;
+			hdr.payloadHash = Hash(dat, sz);
+
+			// 临时文件名含进程号，共用缓存目录的多个进程不会写入同一临时文件
+#ifdef _WIN32
+			auto pid = static_cast<unsigned long>(GetCurrentProcessId());
+#else
+			auto pid = static_cast<unsigned long>(getpid());
+#endif // _WIN32
+			auto tmpPath = filePath + ".tmp" + std::to_string(pid) + "_" + std::to_string(tmpCnt++);
+			{
+				std::ofstream os(tmpPath, std::ios::out | std::ios::binary);
+				if (!os.is_open())
+					return;
+				os.write(reinterpret_cast<const char*>(&hdr), sizeof(Header));
+				os.write(static_cast<const char*>(dat), sz);
+				if (!os.good()) {
+					os.close();
+					std::remove(tmpPath.c_str());
+					return;
+				}
+			}
+
+			std::remove(filePath.c_str());
+			if (std::rename(tmpPath.c_str(), filePath.c_str()) != 0)
+				std::remove(tmpPath.c_str());
+
+			auto max = maxBytes.load();
+			if (max != 0)
+				Trim(max);
+		}
+	};
+}
+
+#endif // !SCIVIS_IO_PREPROCESS_CACHE_H
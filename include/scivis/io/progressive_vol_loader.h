@@ -0,0 +1,199 @@
+#ifndef SCIVIS_IO_PROGRESSIVE_VOL_LOADER_H
+#define SCIVIS_IO_PROGRESSIVE_VOL_LOADER_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <thread>
+
+#include <array>
+#include <vector>
+
+#include <osg/Texture3D>
+
+#include <scivis/common/lock_free_queue.h>
+#include <scivis/common/parallel.h>
+#include <scivis/common/vol_tex.h>
+#include <scivis/data/vol_data.h>
+#include <scivis/data/vol_resampler.h>
+#include <scivis/data/vol_view.h>
+
+namespace SciVis
+{
+	/*
+	* 类: ProgressiveVolumeLoader
+	* 功能: 由粗到细的渐进式体加载器。工作线程先生成各轴不超过previewLen个体素的预览级，
+	*       之后每级各轴分辨率加倍，直至原始分辨率，经无锁队列交给绘制线程。
+	*       绘制线程以Poll接收最新的一级并就地替换同一个纹理的图像，纹理对象在各级之间保持不变，
+	*       因此首帧只需等待预览级，与体的大小无关。
+	*       体应以文件映射的方式加载（RAWVolumeData::FromFileParameters::useMemoryMap），
+	*       以步长抽取的预览级只会读入被抽取的行所在的页。
+	*       除构造与析构外，成员函数只应在绘制线程（如更新回调）上调用
+	*/
+	class ProgressiveVolumeLoader
+	{
+	public:
+		enum class EReduction
+		{
+			Stride = 0, // 按步长抽取体素，只读取被抽取的体素
+			Box // 区域平均，预览没有走样，但每一级都需遍历整个体
+		};
+
+		struct Parameters
+		{
+			uint32_t previewLen = 64; // 预览级各轴的体素数上限
+			EReduction reduction = EReduction::Stride;
+			ETextureSizePolicy policy = ETextureSizePolicy::Native;
+		};
+
+		struct Level
+		{
+			uint32_t level = 0; // 各轴相对原始分辨率缩小2^level倍，为0时即原始分辨率
+			std::array<uint32_t, 3> dim = { { 0, 0, 0 } };
+			osg::ref_ptr<osg::Texture3D> tex;
+		};
+
+		explicit ProgressiveVolumeLoader(const RAWVolumeData& vol)
+			: ProgressiveVolumeLoader(vol, Parameters())
+		{}
+		ProgressiveVolumeLoader(const RAWVolumeData& vol, const Parameters& param)
+			: vol(vol), param(param),
+			levelNum(vol.GetDataSize() == 0 ? 0 : computeLevelNum(vol.GetVoxelPerVolume(), param.previewLen)),
+			readyQueue(levelNum)
+		{
+			stop.store(false);
+			if (levelNum == 0)
+				return;
+			worker = std::thread([this]() { work(); });
+		}
+		~ProgressiveVolumeLoader()
+		{
+			stop.store(true);
+			if (worker.joinable())
+				worker.join();
+		}
+		ProgressiveVolumeLoader(const ProgressiveVolumeLoader&) = delete;
+		ProgressiveVolumeLoader& operator=(const ProgressiveVolumeLoader&) = delete;
+
+		/*
+		* 函数: Poll
+		* 功能: 接收已生成的级，将其中最细的一级的图像替换到纹理中
+		* 参数:
+		* -- lvl: 有新的级时，写入该级。其纹理总是同一个对象，首次返回时应将其加入绘制组件，
+		*         之后需以新的尺寸更新绘制组件（如DirectVolumeRenderer的SetVolumeTexture）
+		* 返回值: 没有新的级时返回false
+		*/
+		bool Poll(Level& lvl)
+		{
+			Level ready;
+			auto hasNew = false;
+			while (readyQueue.TryPop(ready)) {
+				hasNew = true;
+				curr.level = ready.level;
+				curr.dim = ready.dim;
+				if (!curr.tex)
+					curr.tex = ready.tex;
+				else {
+					curr.tex->setImage(ready.tex->getImage());
+					VolumeTexture::SetTextureCoordinateScale(
+						curr.tex, VolumeTexture::GetTextureCoordinateScale(ready.tex));
+				}
+			}
+			if (hasNew)
+				lvl = curr;
+			return hasNew;
+		}
+		/*
+		* 函数: IsComplete
+		* 功能: 原始分辨率的一级是否已由Poll替换到纹理中
+		*/
+		bool IsComplete() const
+		{
+			return curr.tex && curr.level == 0;
+		}
+		uint32_t GetLevelNum() const
+		{
+			return levelNum;
+		}
+
+	private:
+		RAWVolumeData vol;
+		Parameters param;
+		uint32_t levelNum;
+		Level curr; // 只由绘制线程访问
+		LockFreeQueue<Level> readyQueue;
+		std::atomic<bool> stop;
+		std::thread worker;
+
+		static uint32_t computeLevelNum(const std::array<uint32_t, 3>& dim, uint32_t previewLen)
+		{
+			auto maxLen = std::max({ dim[0], dim[1], dim[2] });
+			previewLen = std::max(previewLen, 1u);
+			uint32_t num = 1;
+			while (((maxLen - 1) >> (num - 1)) + 1 > previewLen)
+				++num;
+			return num;
+		}
+
+		void work()
+		{
+			for (auto lvl = levelNum; lvl-- > 0;) {
+				if (stop.load())
+					return;
+
+				Level ready;
+				ready.level = lvl;
+				switch (vol.GetVoxelType())
+				{
+				case ESupportedVoxelType::UInt8:
+					ready.tex = buildLevel<ESupportedVoxelType::UInt8>(lvl, ready.dim);
+					break;
+				case ESupportedVoxelType::UInt16:
+					ready.tex = buildLevel<ESupportedVoxelType::UInt16>(lvl, ready.dim);
+					break;
+				case ESupportedVoxelType::Int16:
+					ready.tex = buildLevel<ESupportedVoxelType::Int16>(lvl, ready.dim);
+					break;
+				case ESupportedVoxelType::Float32:
+					ready.tex = buildLevel<ESupportedVoxelType::Float32>(lvl, ready.dim);
+					break;
+				}
+				// 每一级只入队一次，队列不会满
+				readyQueue.TryPush(std::move(ready));
+			}
+		}
+
+		template <ESupportedVoxelType VoxTy>
+		osg::ref_ptr<osg::Texture3D> buildLevel(uint32_t lvl, std::array<uint32_t, 3>& lvlDim)
+		{
+			using Traits = VoxelTypeTraits<VoxTy>;
+			using T = typename Traits::Type;
+
+			auto dim = vol.GetVoxelPerVolume();
+			auto src = reinterpret_cast<const T*>(vol.GetData());
+			size_t stride = static_cast<size_t>(1) << lvl;
+			for (uint8_t i = 0; i < 3; ++i)
+				lvlDim[i] = static_cast<uint32_t>((dim[i] + stride - 1) / stride);
+
+			std::vector<T> dat(static_cast<size_t>(lvlDim[0]) * lvlDim[1] * lvlDim[2]);
+			if (lvl == 0 || param.reduction == EReduction::Stride) {
+				VolumeView<T> view(src, lvlDim,
+					{ { stride, stride * dim[0], stride * dim[0] * dim[1] } });
+				auto sliceVoxNum = static_cast<size_t>(lvlDim[0]) * lvlDim[1];
+				ParallelFor(lvlDim[2], [&](uint32_t, size_t beg, size_t end) {
+					for (auto z = beg; z < end; ++z)
+						view.Slice(static_cast<uint32_t>(z)).CopyTo(dat.data() + z * sliceVoxNum);
+					});
+			}
+			else {
+				VolumeResampler::Parameters resampleParam;
+				resampleParam.kernel = VolumeResampler::EKernel::Box;
+				VolumeResampler::Resample(src, dim, dat.data(), lvlDim, resampleParam);
+			}
+
+			return VolumeTexture::Create(std::move(dat), lvlDim, Traits::DataType, Traits::InternalFormat, param.policy);
+		}
+	};
+}
+
+#endif // !SCIVIS_IO_PROGRESSIVE_VOL_LOADER_H
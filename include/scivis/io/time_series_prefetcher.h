@@ -0,0 +1,255 @@
+#ifndef SCIVIS_IO_TIME_SERIES_PREFETCHER_H
+#define SCIVIS_IO_TIME_SERIES_PREFETCHER_H
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#include <vector>
+
+#include <osg/Texture3D>
+
+#include <scivis/common/lock_free_queue.h>
+
+namespace SciVis
+{
+	/*
+	* 类: TimeSeriesPrefetcher
+	* 功能: 时间序列播放时的异步加载器。工作线程池沿播放方向预取当前时间步之后的若干步，
+	*       由加载函数完成读取与转换得到纹理，经无锁队列交给绘制线程，绘制线程不会因I/O而阻塞。
+	*       已加载的纹理总量超过内存上限时，工作线程暂停预取，绘制线程按离播放位置由远到近的顺序释放预取窗口外的时间步，
+	*       因此驻留的时间步构成一个随播放位置移动的环。
+	*       除构造与析构外，成员函数只应在绘制线程上调用
+	*/
+	class TimeSeriesPrefetcher
+	{
+	public:
+		/*
+		* 类型: LoadFunc
+		* 功能: 形如loadFunc(step)的加载函数，返回时间步step的纹理，失败时返回空指针。会被多个工作线程同时调用
+		*/
+		using LoadFunc = std::function<osg::ref_ptr<osg::Texture3D>(size_t)>;
+
+		struct Parameters
+		{
+			uint32_t workerNum = 2;
+			uint32_t prefetchNum = 4; // 预取窗口的大小，包括当前时间步
+			size_t memoryCap = static_cast<size_t>(512) << 20; // 已加载纹理的内存上限（字节）
+			bool loop = true; // 为真时，播放到序列一端后回到另一端
+		};
+
+		TimeSeriesPrefetcher(size_t stepNum, LoadFunc loadFunc)
+			: TimeSeriesPrefetcher(stepNum, loadFunc, Parameters())
+		{}
+		TimeSeriesPrefetcher(size_t stepNum, LoadFunc loadFunc, const Parameters& param)
+			: stepNum(stepNum), loadFunc(loadFunc), param(param),
+			states(new std::atomic<uint8_t>[stepNum]), texs(stepNum), texBytes(stepNum, 0),
+			readyQueue(stepNum) // 每个时间步至多有一项在队列中，因此队列不会满
+		{
+			if (this->param.prefetchNum == 0)
+				this->param.prefetchNum = 1;
+			for (size_t i = 0; i < stepNum; ++i)
+				states[i].store(static_cast<uint8_t>(EState::None), std::memory_order_relaxed);
+			playhead.store(0);
+			direction.store(1);
+			residentBytes.store(0);
+			stepBytesHint.store(0);
+			stop.store(false);
+			displayedStep = stepNum;
+
+			if (stepNum == 0) return;
+			for (uint32_t i = 0; i < std::max(this->param.workerNum, 1u); ++i)
+				workers.emplace_back([this]() { work(); });
+		}
+		~TimeSeriesPrefetcher()
+		{
+			stop.store(true);
+			cv.notify_all();
+			for (auto& worker : workers)
+				worker.join();
+		}
+		TimeSeriesPrefetcher(const TimeSeriesPrefetcher&) = delete;
+		TimeSeriesPrefetcher& operator=(const TimeSeriesPrefetcher&) = delete;
+
+		/*
+		* 函数: Acquire
+		* 功能: 将播放位置移到step，接收已完成加载的时间步，必要时释放窗口外的时间步，并唤醒工作线程
+		* 参数:
+		* -- step: 要显示的时间步
+		* -- dir: 播放方向，为1或-1
+		* 返回值: 时间步step的纹理。尚未加载完成（或加载失败）时返回空指针，调用者应继续显示之前的时间步。
+		*         最近一次返回的非空纹理在下一次返回非空纹理之前不会被释放
+		*/
+		osg::ref_ptr<osg::Texture3D> Acquire(size_t step, int dir = 1)
+		{
+			if (step >= stepNum)
+				return nullptr;
+
+			playhead.store(step);
+			direction.store(dir < 0 ? -1 : 1);
+
+			ReadyStep ready;
+			while (readyQueue.TryPop(ready)) {
+				texs[ready.step] = ready.tex;
+				texBytes[ready.step] = ready.bytes;
+				states[ready.step].store(static_cast<uint8_t>(ready.tex ? EState::Ready : EState::Failed));
+			}
+			if (texs[step])
+				displayedStep = step;
+			evict(step, dir < 0 ? -1 : 1);
+			cv.notify_all();
+
+			return texs[step];
+		}
+
+		bool HasFailed(size_t step) const
+		{
+			return states[step].load() == static_cast<uint8_t>(EState::Failed);
+		}
+		size_t GetStepNum() const
+		{
+			return stepNum;
+		}
+		/*
+		* 函数: GetResidentBytes
+		* 功能: 获取已加载（包括尚在队列中）的纹理占用的内存
+		*/
+		size_t GetResidentBytes() const
+		{
+			return residentBytes.load();
+		}
+
+	private:
+		enum class EState : uint8_t
+		{
+			None = 0,
+			Loading, // 正在加载或已在队列中
+			Ready,
+			Failed
+		};
+
+		struct ReadyStep
+		{
+			size_t step = 0;
+			osg::ref_ptr<osg::Texture3D> tex;
+			size_t bytes = 0;
+		};
+
+		size_t stepNum;
+		LoadFunc loadFunc;
+		Parameters param;
+		std::unique_ptr<std::atomic<uint8_t>[]> states;
+		// 以下三项只由绘制线程访问
+		std::vector<osg::ref_ptr<osg::Texture3D>> texs;
+		std::vector<size_t> texBytes;
+		size_t displayedStep; // Acquire最近一次返回非空纹理的时间步，调用者仍在显示，不可释放
+		LockFreeQueue<ReadyStep> readyQueue;
+
+		std::atomic<size_t> playhead;
+		std::atomic<int> direction;
+		std::atomic<size_t> residentBytes;
+		std::atomic<size_t> stepBytesHint; // 最近加载的一步的大小，用于在加载前估计内存是否足够
+		std::atomic<bool> stop;
+		std::mutex mtx;
+		std::condition_variable cv;
+		std::vector<std::thread> workers;
+
+		/*
+		* 函数: offsetOf
+		* 功能: 时间步step位于播放位置之后第几步（沿播放方向）。不循环播放时，位于播放位置之后的时间步之外的，
+		*       返回不小于stepNum的值，离播放位置越远越大
+		*/
+		size_t offsetOf(size_t step, size_t head, int dir) const
+		{
+			auto fwd = dir > 0 ? (step + stepNum - head) % stepNum : (head + stepNum - step) % stepNum;
+			if (param.loop)
+				return fwd;
+			auto isAhead = dir > 0 ? step >= head : step <= head;
+			return isAhead ? fwd : stepNum + stepNum - fwd;
+		}
+
+		/*
+		* 函数: claimNext
+		* 功能: 在预取窗口内按离播放位置由近到远的顺序认领一个未加载的时间步。当前时间步不受内存上限约束
+		*/
+		bool claimNext(size_t& step)
+		{
+			auto head = playhead.load();
+			auto dir = direction.load();
+			auto winSz = std::min(static_cast<size_t>(param.prefetchNum), stepNum);
+			for (size_t k = 0; k < winSz; ++k) {
+				if (!param.loop && (dir > 0 ? head + k >= stepNum : k > head))
+					break;
+				if (k != 0 && residentBytes.load() + stepBytesHint.load() > param.memoryCap)
+					break;
+
+				auto s = dir > 0 ? (head + k) % stepNum : (head + stepNum - k) % stepNum;
+				auto expected = static_cast<uint8_t>(EState::None);
+				if (states[s].compare_exchange_strong(expected, static_cast<uint8_t>(EState::Loading))) {
+					step = s;
+					return true;
+				}
+			}
+			return false;
+		}
+
+		void work()
+		{
+			while (!stop.load()) {
+				size_t step;
+				if (!claimNext(step)) {
+					std::unique_lock<std::mutex> lk(mtx);
+					cv.wait_for(lk, std::chrono::milliseconds(20));
+					continue;
+				}
+
+				ReadyStep ready;
+				ready.step = step;
+				ready.tex = loadFunc(step);
+				if (ready.tex && ready.tex->getImage()) {
+					ready.bytes = ready.tex->getImage()->getTotalSizeInBytes();
+					residentBytes.fetch_add(ready.bytes);
+					stepBytesHint.store(ready.bytes);
+				}
+				while (!readyQueue.TryPush(std::move(ready)))
+					std::this_thread::yield();
+			}
+		}
+
+		/*
+		* 函数: evict
+		* 功能: 内存不足以再加载一步时，释放预取窗口外离播放位置最远的时间步，直到内存足够或窗口外已无可释放的时间步。
+		*       正在显示的时间步不会被释放
+		*/
+		void evict(size_t head, int dir)
+		{
+			while (residentBytes.load() + stepBytesHint.load() > param.memoryCap) {
+				size_t farthest = stepNum;
+				size_t farthestOffset = 0;
+				for (size_t s = 0; s < stepNum; ++s) {
+					if (!texs[s] || s == displayedStep) continue;
+					auto offset = offsetOf(s, head, dir);
+					if (offset >= param.prefetchNum && offset >= farthestOffset) {
+						farthest = s;
+						farthestOffset = offset;
+					}
+				}
+				if (farthest == stepNum)
+					return;
+
+				texs[farthest] = nullptr;
+				residentBytes.fetch_sub(texBytes[farthest]);
+				texBytes[farthest] = 0;
+				states[farthest].store(static_cast<uint8_t>(EState::None));
+			}
+		}
+	};
+}
+
+#endif // !SCIVIS_IO_TIME_SERIES_PREFETCHER_H
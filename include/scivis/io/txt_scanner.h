@@ -0,0 +1,187 @@
+#ifndef SCIVIS_IO_TXT_SCANNER_H
+#define SCIVIS_IO_TXT_SCANNER_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+
+#include <vector>
+
+namespace SciVis
+{
+	/*
+	* 类: TXTScanner
+	* 功能: 文本体数据的解析工具。不分配内存、不依赖locale，可在多个线程上并行使用
+	*/
+	class TXTScanner
+	{
+	public:
+		static bool IsSpace(char c)
+		{
+			return c == ' ' || c == '\n' || c == '\r' || c == '\t' || c == '\v' || c == '\f';
+		}
+		static bool IsDigit(char c)
+		{
+			return c >= '0' && c <= '9';
+		}
+
+		static const char* SkipSpace(const char* p, const char* end)
+		{
+			while (p != end && IsSpace(*p))
+				++p;
+			return p;
+		}
+		static const char* SkipToken(const char* p, const char* end)
+		{
+			while (p != end && !IsSpace(*p))
+				++p;
+			return p;
+		}
+		static const char* SkipLine(const char* p, const char* end)
+		{
+			while (p != end && *p != '\n')
+				++p;
+			return p == end ? p : p + 1;
+		}
+
+		static size_t CountTokens(const char* p, const char* end)
+		{
+			size_t cnt = 0;
+			while (true) {
+				p = SkipSpace(p, end);
+				if (p == end) break;
+				++cnt;
+				p = SkipToken(p, end);
+			}
+			return cnt;
+		}
+
+		/*
+		* 函数: ScanFloat
+		* 功能: 从p开始解析一个浮点数，支持符号、小数、指数以及nan/inf
+		* 返回值: 解析成功时返回数值之后的位置，失败时返回p
+		*/
+		static const char* ScanFloat(const char* p, const char* end, float& val)
+		{
+			auto beg = p;
+			auto neg = false;
+			if (p != end && (*p == '-' || *p == '+')) {
+				neg = *p == '-';
+				++p;
+			}
+
+			uint64_t mant = 0;
+			int32_t exp10 = 0;
+			uint8_t sigDigitNum = 0;
+			auto hasDigit = false;
+			auto append = [&](char c, bool isFrac) {
+				hasDigit = true;
+				if (sigDigitNum < 19) {
+					mant = mant * 10 + (c - '0');
+					if (mant != 0)
+						++sigDigitNum;
+					if (isFrac)
+						--exp10;
+				}
+				else if (!isFrac)
+					++exp10;
+			};
+			while (p != end && IsDigit(*p))
+				append(*p++, false);
+			if (p != end && *p == '.') {
+				++p;
+				while (p != end && IsDigit(*p))
+					append(*p++, true);
+			}
+
+			if (!hasDigit) {
+				auto matchWord = [&](const char* word) {
+					auto q = p;
+					for (; *word; ++word, ++q)
+						if (q == end || (*q | 0x20) != *word)
+							return false;
+					p = q;
+					return true;
+				};
+				if (matchWord("nan"))
+					val = std::numeric_limits<float>::quiet_NaN();
+				else if (matchWord("inf")) {
+					matchWord("inity");
+					val = neg ? -std::numeric_limits<float>::infinity()
+						: std::numeric_limits<float>::infinity();
+				}
+				else
+					return beg;
+				return p;
+			}
+
+			if (p != end && (*p == 'e' || *p == 'E')) {
+				auto q = p + 1;
+				auto expNeg = false;
+				if (q != end && (*q == '-' || *q == '+')) {
+					expNeg = *q == '-';
+					++q;
+				}
+				if (q != end && IsDigit(*q)) {
+					int32_t e = 0;
+					for (; q != end && IsDigit(*q); ++q)
+						if (e < 100000)
+							e = e * 10 + (*q - '0');
+					exp10 += expNeg ? -e : e;
+					p = q;
+				}
+			}
+
+			auto v = static_cast<double>(mant);
+			if (mant != 0 && exp10 != 0)
+				v = exp10 < 0 ? v / pow10(-exp10) : v * pow10(exp10);
+			val = static_cast<float>(neg ? -v : v);
+			return p;
+		}
+
+		/*
+		* 函数: Split
+		* 功能: 将[dat, dat + sz)近似均分为chunkNum段，每个分界点向后移动到isBoundary为真的字符之后
+		* 返回值: chunkNum + 1个分界点（相对dat的偏移），第i段为[ret[i], ret[i + 1])
+		*/
+		template <typename Pred>
+		static std::vector<size_t> Split(const char* dat, size_t sz, uint32_t chunkNum, const Pred& isBoundary)
+		{
+			if (chunkNum == 0)
+				chunkNum = 1;
+			std::vector<size_t> ret(chunkNum + 1);
+			ret[0] = 0;
+			ret[chunkNum] = sz;
+			for (uint32_t i = 1; i < chunkNum; ++i) {
+				auto offs = std::max(ret[i - 1], sz / chunkNum * i);
+				while (offs < sz && !isBoundary(dat[offs]))
+					++offs;
+				ret[i] = offs == sz ? sz : offs + 1;
+			}
+			return ret;
+		}
+		static std::vector<size_t> SplitOnSpace(const char* dat, size_t sz, uint32_t chunkNum)
+		{
+			return Split(dat, sz, chunkNum, [](char c) { return IsSpace(c); });
+		}
+		static std::vector<size_t> SplitOnLine(const char* dat, size_t sz, uint32_t chunkNum)
+		{
+			return Split(dat, sz, chunkNum, [](char c) { return c == '\n'; });
+		}
+
+	private:
+		static double pow10(int32_t e)
+		{
+			static const double Exact[] = {
+				1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+				1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+			};
+			if (e <= 22)
+				return Exact[e];
+			return std::pow(10., e);
+		}
+	};
+}
+
+#endif // !SCIVIS_IO_TXT_SCANNER_H
@@ -0,0 +1,283 @@
+#ifndef SCIVIS_IO_VOL_CODEC_H
+#define SCIVIS_IO_VOL_CODEC_H
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+#include <vector>
+
+#include <scivis/common/simd.h>
+
+namespace SciVis
+{
+	/*
+	* 类: VolumeCodec
+	* 功能: 无依赖的体数据无损编解码。多字节体素先拆分为字节平面（第k个平面为各体素的第k个字节），
+	*       每个平面沿存储顺序做差分并以zigzag映射为无符号数，再按每组32个值进行位打包：
+	*       -- 组内最大值需要w（1至8）位时，以1字节写出w，随后写出32 * w / 8字节的打包数据
+	*       -- 连续的全零组（平滑或常值区域）合并为1字节，最多记录128组
+	*       编码流的开头为各平面编码长度（uint32），各平面可独立解码。
+	*       每次编解码只处理一段数据（一般为一个块），多线程由调用者按块划分
+	*/
+	class VolumeCodec
+	{
+	public:
+		static constexpr uint32_t GroupLen = 32;
+
+		/*
+		* 函数: GetMaxEncodedSize
+		* 功能: 获取编码结果大小的上界
+		*/
+		static size_t GetMaxEncodedSize(size_t voxNum, size_t voxSz)
+		{
+			auto groupNum = (voxNum + GroupLen - 1) / GroupLen;
+			return voxSz * (sizeof(uint32_t) + groupNum * (1 + GroupLen));
+		}
+
+		/*
+		* 函数: Encode
+		* 功能: 编码voxNum个大小为voxSz字节的体素
+		*/
+		static std::vector<uint8_t> Encode(const void* src, size_t voxNum, size_t voxSz)
+		{
+			std::vector<uint8_t> dst(GetMaxEncodedSize(voxNum, voxSz));
+			auto planeSzs = dst.data();
+			auto out = dst.data() + voxSz * sizeof(uint32_t);
+
+			std::vector<uint8_t> zz(voxNum + GroupLen, 0);
+			for (size_t k = 0; k < voxSz; ++k) {
+				// 差分并zigzag映射，使小幅的正负变化都映射为小的无符号数
+				auto in = static_cast<const uint8_t*>(src) + k;
+				uint8_t prev = 0;
+				for (size_t i = 0; i < voxNum; ++i) {
+					auto d = static_cast<uint8_t>(in[i * voxSz] - prev);
+					prev = in[i * voxSz];
+					zz[i] = static_cast<uint8_t>((d << 1) ^ (d & 0x80 ? 0xff : 0x00));
+				}
+				std::fill(zz.begin() + voxNum, zz.end(), 0);
+
+				auto planeBeg = out;
+				auto groupNum = (voxNum + GroupLen - 1) / GroupLen;
+				for (size_t g = 0; g < groupNum;) {
+					auto w = bitWidth(zz.data() + g * GroupLen);
+					if (w == 0) {
+						size_t run = 1;
+						while (run < 128 && g + run < groupNum && bitWidth(zz.data() + (g + run) * GroupLen) == 0)
+							++run;
+						*out++ = static_cast<uint8_t>(0x80 | (run - 1));
+						g += run;
+						continue;
+					}
+
+					*out++ = w;
+					out = pack(zz.data() + g * GroupLen, w, out);
+					++g;
+				}
+
+				auto planeSz = static_cast<uint32_t>(out - planeBeg);
+				std::memcpy(planeSzs + k * sizeof(uint32_t), &planeSz, sizeof(uint32_t));
+			}
+
+			dst.resize(out - dst.data());
+			return dst;
+		}
+
+		/*
+		* 函数: Decode
+		* 功能: 解码voxNum个大小为voxSz字节的体素到dst
+		* 返回值: 编码流不完整或已损坏时返回false
+		*/
+		static bool Decode(const uint8_t* src, size_t srcSz, void* dst, size_t voxNum, size_t voxSz)
+		{
+			if (srcSz < voxSz * sizeof(uint32_t))
+				return false;
+
+			// 单字节体素直接解码到输出，否则先解码各平面再交错写出
+			auto planeStride = voxNum + GroupLen;
+			std::vector<uint8_t> planes(voxSz == 1 ? 0 : voxSz * planeStride);
+			auto in = src + voxSz * sizeof(uint32_t);
+			auto inEnd = src + srcSz;
+			for (size_t k = 0; k < voxSz; ++k) {
+				uint32_t planeSz;
+				std::memcpy(&planeSz, src + k * sizeof(uint32_t), sizeof(uint32_t));
+				if (planeSz > static_cast<size_t>(inEnd - in))
+					return false;
+
+				auto out = voxSz == 1 ? static_cast<uint8_t*>(dst) : planes.data() + k * planeStride;
+				if (!decodePlane(in, in + planeSz, out, voxNum))
+					return false;
+				in += planeSz;
+			}
+
+			if (voxSz != 1)
+				interleave(planes.data(), planeStride, static_cast<uint8_t*>(dst), voxNum, voxSz);
+			return true;
+		}
+
+	private:
+		static uint8_t bitWidth(const uint8_t* group)
+		{
+			uint8_t bits = 0;
+			for (uint32_t i = 0; i < GroupLen; ++i)
+				bits |= group[i];
+			uint8_t w = 0;
+			while (bits) {
+				++w;
+				bits >>= 1;
+			}
+			return w;
+		}
+
+		/*
+		* 函数: interleave
+		* 功能: 将voxSz个字节平面交错为体素
+		*/
+		static void interleave(const uint8_t* planes, size_t planeStride, uint8_t* dst, size_t voxNum, size_t voxSz)
+		{
+			size_t i = 0;
+#ifdef SCIVIS_SIMD_SSE2
+			if (voxSz == 2)
+				for (; i + 16 <= voxNum; i += 16) {
+					auto p0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(planes + i));
+					auto p1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(planes + planeStride + i));
+					_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 2 * i), _mm_unpacklo_epi8(p0, p1));
+					_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 2 * i + 16), _mm_unpackhi_epi8(p0, p1));
+				}
+			else if (voxSz == 4)
+				for (; i + 16 <= voxNum; i += 16) {
+					auto p0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(planes + i));
+					auto p1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(planes + planeStride + i));
+					auto p2 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(planes + 2 * planeStride + i));
+					auto p3 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(planes + 3 * planeStride + i));
+					auto lo01 = _mm_unpacklo_epi8(p0, p1);
+					auto hi01 = _mm_unpackhi_epi8(p0, p1);
+					auto lo23 = _mm_unpacklo_epi8(p2, p3);
+					auto hi23 = _mm_unpackhi_epi8(p2, p3);
+					auto out = reinterpret_cast<__m128i*>(dst + 4 * i);
+					_mm_storeu_si128(out, _mm_unpacklo_epi16(lo01, lo23));
+					_mm_storeu_si128(out + 1, _mm_unpackhi_epi16(lo01, lo23));
+					_mm_storeu_si128(out + 2, _mm_unpacklo_epi16(hi01, hi23));
+					_mm_storeu_si128(out + 3, _mm_unpackhi_epi16(hi01, hi23));
+				}
+#endif
+			for (; i < voxNum; ++i)
+				for (size_t k = 0; k < voxSz; ++k)
+					dst[i * voxSz + k] = planes[k * planeStride + i];
+		}
+
+		/*
+		* 函数: pack
+		* 功能: 每8个w位的值拼接为w字节（低位在前）
+		*/
+		static uint8_t* pack(const uint8_t* group, uint8_t w, uint8_t* out)
+		{
+			for (uint32_t i = 0; i < GroupLen; i += 8) {
+				uint64_t bits = 0;
+				for (uint8_t j = 0; j < 8; ++j)
+					bits |= static_cast<uint64_t>(group[i + j]) << (j * w);
+				for (uint8_t b = 0; b < w; ++b)
+					*out++ = static_cast<uint8_t>(bits >> (8 * b));
+			}
+			return out;
+		}
+
+		/*
+		* 函数: unpack
+		* 功能: pack的逆过程。位宽作为模板参数，使内层循环可被编译器完全展开
+		*/
+		template <uint8_t W>
+		static void unpack(const uint8_t* in, uint8_t* group)
+		{
+			const uint64_t Mask = (1u << W) - 1;
+			for (uint32_t i = 0; i < GroupLen; i += 8) {
+				uint64_t bits = 0;
+				for (uint8_t b = 0; b < W; ++b)
+					bits |= static_cast<uint64_t>(in[b]) << (8 * b);
+				in += W;
+				for (uint8_t j = 0; j < 8; ++j)
+					group[i + j] = static_cast<uint8_t>((bits >> (j * W)) & Mask);
+			}
+		}
+
+#ifdef SCIVIS_SIMD_SSE2
+		/*
+		* 函数: prefixSum16
+		* 功能: 对16个zigzag差分值逆映射后求前缀和（模256），结果与标量实现一致
+		* 返回值: 最后一个输出值
+		*/
+		static uint8_t prefixSum16(const uint8_t* zz, uint8_t* out, uint8_t prev)
+		{
+			auto one = _mm_set1_epi8(1);
+			auto v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(zz));
+			auto half = _mm_and_si128(_mm_srli_epi16(v, 1), _mm_set1_epi8(0x7f));
+			auto odd = _mm_cmpeq_epi8(_mm_and_si128(v, one), one);
+			auto d = _mm_xor_si128(half, odd);
+			d = _mm_add_epi8(d, _mm_slli_si128(d, 1));
+			d = _mm_add_epi8(d, _mm_slli_si128(d, 2));
+			d = _mm_add_epi8(d, _mm_slli_si128(d, 4));
+			d = _mm_add_epi8(d, _mm_slli_si128(d, 8));
+			d = _mm_add_epi8(d, _mm_set1_epi8(static_cast<char>(prev)));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(out), d);
+			return out[15];
+		}
+#endif
+
+		/*
+		* 函数: decodePlane
+		* 功能: 解码一个字节平面。先解包出zigzag差分值，再逆映射并前缀求和
+		*/
+		static bool decodePlane(const uint8_t* in, const uint8_t* inEnd, uint8_t* out, size_t voxNum)
+		{
+			uint8_t prev = 0;
+			uint8_t zz[GroupLen];
+			for (size_t i = 0; i < voxNum;) {
+				if (in == inEnd)
+					return false;
+
+				auto h = *in++;
+				if (h & 0x80) {
+					// 全零差分，即重复前一个值
+					auto num = std::min(static_cast<size_t>((h & 0x7f) + 1) * GroupLen, voxNum - i);
+					std::memset(out + i, prev, num);
+					i += num;
+					continue;
+				}
+				if (h == 0 || h > 8 || static_cast<size_t>(inEnd - in) < 4 * static_cast<size_t>(h))
+					return false;
+
+				switch (h)
+				{
+				case 1: unpack<1>(in, zz); break;
+				case 2: unpack<2>(in, zz); break;
+				case 3: unpack<3>(in, zz); break;
+				case 4: unpack<4>(in, zz); break;
+				case 5: unpack<5>(in, zz); break;
+				case 6: unpack<6>(in, zz); break;
+				case 7: unpack<7>(in, zz); break;
+				default: std::memcpy(zz, in, GroupLen); break;
+				}
+				in += 4 * h;
+
+				auto num = std::min(static_cast<size_t>(GroupLen), voxNum - i);
+#ifdef SCIVIS_SIMD_SSE2
+				if (num == GroupLen) {
+					prev = prefixSum16(zz, out + i, prev);
+					prev = prefixSum16(zz + 16, out + i + 16, prev);
+					i += num;
+					continue;
+				}
+#endif
+				for (size_t j = 0; j < num; ++j) {
+					prev = static_cast<uint8_t>(prev + ((zz[j] >> 1) ^ -(zz[j] & 1)));
+					out[i + j] = prev;
+				}
+				i += num;
+			}
+
+			return in == inEnd;
+		}
+	};
+}
+
+#endif // !SCIVIS_IO_VOL_CODEC_H
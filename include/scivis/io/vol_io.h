@@ -1,12 +1,28 @@
 #ifndef SCIVIS_IO_VOL_IO_H
 #define SCIVIS_IO_VOL_IO_H
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
 #include <fstream>
+#include <iterator>
 #include <limits>
 
 #include <array>
 #include <vector>
-#include <unordered_set>
+
+#include <scivis/common/parallel.h>
+#include <scivis/common/simd.h>
+#include <scivis/data/labeled_point_vol_data.h>
+#include <scivis/data/sparse_vol_data.h>
+#include <scivis/data/vol_region.h>
+#include <scivis/data/vol_stats.h>
+#include <scivis/data/vol_view.h>
+#include <scivis/data/vol_smoother.h>
+#include <scivis/io/gzip_stream.h>
+#include <scivis/io/mapped_file.h>
+#include <scivis/io/txt_scanner.h>
 
 namespace SciVis
 {
@@ -48,6 +64,34 @@ namespace SciVis
 				return dat;
 			}
 
+			/*
+			* 函数: MapU8FromFile
+			* 功能: 以内存映射方式加载体数据，返回的映射句柄只读，数据由页缓存提供，不发生堆拷贝
+			* 参数:
+			* -- filePath: 文件路径
+			* -- dim: 体的三维尺寸
+			* -- hint: 访问模式提示
+			* -- errMsg: 若不为空，加载失败时写入错误信息
+			* 返回值: 加载成功时返回映射句柄，否则返回空指针
+			*/
+			static std::shared_ptr<MappedFile> MapU8FromFile(
+				const std::string& filePath, const std::array<uint32_t, 3>& dim,
+				MappedFile::EAccessHint hint = MappedFile::EAccessHint::Sequential,
+				std::string* errMsg = nullptr)
+			{
+				auto mapped = MappedFile::Open(filePath, hint, errMsg);
+				if (!mapped)
+					return nullptr;
+
+				if (mapped->GetSize() / sizeof(uint8_t) < (size_t)dim[0] * dim[1] * dim[2]) {
+					if (errMsg)
+						*errMsg = "File Size is Smaller than Volume Size";
+					return nullptr;
+				}
+
+				return mapped;
+			}
+
 			static bool DumpToFile(
 				const std::string& filePath, const std::vector<uint8_t>& dat,
 				std::string* errMsg = nullptr)
@@ -73,56 +117,252 @@ namespace SciVis
 		public:
 			std::array<float, 2> valRng;
 			std::vector<float> dat;
+			double parseMBPerSec; // 解析吞吐量（MB/s），用于跟踪加载性能
 
 		public:
 			static TXTVolume LoadFromFile(
 				const std::string& filePath, const std::array<uint32_t, 3>& dim,
 				float nullVal, bool flipZ = false,
 				std::string* errMsg = nullptr)
+			{
+				return LoadFromFile(filePath, dim, VolumeRegion(), nullVal, flipZ, errMsg);
+			}
+			/*
+			* 函数: LoadFromFile
+			* 功能: 多线程解析以空白字符分隔的文本体数据。文件按空白处切分为若干段并行解析，
+			*       数值直接写入（翻转后的）目标位置，同时归约得到值域。
+			*       指定了子区域时，只解析并存储子区域内的数值，其余的记号只被跳过（不检查是否为数值），
+			*       不含子区域所在切片的段整段跳过，得到的体的尺寸为子区域的尺寸。
+			*       文件为gzip压缩时（由文件头识别）边解压边解析（见GZipTextPipeline），不产生临时文件
+			* 参数:
+			* -- filePath: 文件路径
+			* -- dim: 整个体的三维尺寸
+			* -- region: 要加载的子区域，下标为翻转后的体中的下标
+			* -- nullVal: 空值，不参与值域的计算
+			* -- flipZ: 为true时，沿Z轴翻转体
+			* -- errMsg: 若不为空，加载失败时写入错误信息
+			*/
+			static TXTVolume LoadFromFile(
+				const std::string& filePath, const std::array<uint32_t, 3>& dim,
+				const VolumeRegion& region, float nullVal, bool flipZ = false,
+				std::string* errMsg = nullptr)
 			{
 				TXTVolume ret;
 
-				FILE* fp = fopen(filePath.c_str(), "r");
-				if (!fp) {
-					if (errMsg) {
-						*errMsg = "Invalid File Path: ";
-						errMsg->append(filePath);
-					}
+				if (!region.IsInside(dim)) {
+					if (errMsg)
+						*errMsg = "Region Exceeds Volume Size";
 					return ret;
 				}
 
+				auto startTime = std::chrono::steady_clock::now();
+				auto mapped = MappedFile::Open(filePath, MappedFile::EAccessHint::Sequential, errMsg);
+				if (!mapped)
+					return ret;
+
 				auto voxNum = static_cast<size_t>(dim[0]) * dim[1] * dim[2];
-				ret.dat.resize(voxNum);
-				for (size_t i = 0; i < voxNum; ++i)
-					fscanf(fp, "%f", &ret.dat[i]);
-				fclose(fp);
-
-				if (flipZ) {
-					auto dimYxX = static_cast<size_t>(dim[1]) * dim[0];
-					for (size_t z = 0; z < dim[2] / 2; ++z) {
-						auto z1 = dim[2] - 1 - z;
-						if (z == z1) continue;
-
-						auto zBeg = ret.dat.begin() + z * dimYxX;
-						auto zEnd = ret.dat.begin() + (z + 1) * dimYxX;
-						auto z1Beg = ret.dat.begin() + z1 * dimYxX;
-						std::swap_ranges(zBeg, zEnd, z1Beg);
+				auto dimYxX = static_cast<size_t>(dim[1]) * dim[0];
+				auto rgnBeg = region.IsWhole() ? std::array<uint32_t, 3>{ { 0, 0, 0 } } : region.beg;
+				auto rgnDim = region.GetDimension(dim);
+				// 子区域在文件中（翻转前）所占的切片
+				auto zInBeg = flipZ ? dim[2] - rgnBeg[2] - rgnDim[2] : rgnBeg[2];
+
+				ret.dat.resize(static_cast<size_t>(rgnDim[0]) * rgnDim[1] * rgnDim[2]);
+				chunkParser parser;
+				parser.dim = dim;
+				parser.dimYxX = dimYxX;
+				parser.rgnBeg = rgnBeg;
+				parser.rgnDim = rgnDim;
+				parser.tokBeg = zInBeg * dimYxX;
+				parser.tokEnd = (zInBeg + rgnDim[2]) * dimYxX;
+				parser.nullVal = nullVal;
+				parser.flipZ = flipZ;
+				parser.dst = ret.dat.data();
+
+				std::vector<std::array<float, 2>> chunkValRngs;
+				std::vector<uint8_t> chunkValids;
+				auto txtSz = mapped->GetSize();
+				if (GZipInflater::IsGZip(mapped->GetData(), mapped->GetSize())) {
+					if (!parseGZip(*mapped, parser, ret.valRng, chunkValRngs, chunkValids, txtSz, errMsg)) {
+						ret.dat.clear();
+						return ret;
+					}
+				}
+				else {
+					auto txt = reinterpret_cast<const char*>(mapped->GetData());
+					auto chunks = TXTScanner::SplitOnSpace(txt, mapped->GetSize(), GetWorkerThreadNum());
+					auto chunkNum = chunks.size() - 1;
+
+					std::vector<size_t> tokenOffsets(chunkNum + 1, 0);
+					ParallelFor(chunkNum, [&](uint32_t, size_t beg, size_t end) {
+						for (auto i = beg; i < end; ++i)
+							tokenOffsets[i + 1] = TXTScanner::CountTokens(txt + chunks[i], txt + chunks[i + 1]);
+						});
+					for (size_t i = 0; i < chunkNum; ++i)
+						tokenOffsets[i + 1] += tokenOffsets[i];
+					if (tokenOffsets[chunkNum] < voxNum) {
+						if (errMsg)
+							*errMsg = "File Content is Less than Volume Size";
+						ret.dat.clear();
+						return ret;
 					}
+
+					chunkValRngs.assign(chunkNum, ret.valRng);
+					chunkValids.assign(chunkNum, 1);
+					ParallelFor(chunkNum, [&](uint32_t, size_t beg, size_t end) {
+						for (auto i = beg; i < end; ++i) {
+							if (tokenOffsets[i] >= parser.tokEnd) break;
+							if (tokenOffsets[i + 1] <= parser.tokBeg) continue;
+
+							if (!parser(txt + chunks[i], txt + chunks[i + 1], tokenOffsets[i], chunkValRngs[i])) {
+								chunkValids[i] = 0;
+								return;
+							}
+						}
+						});
 				}
 
-				for (auto v : ret.dat) {
-					if (v == nullVal) continue;
-					if (ret.valRng[0] > v)
-						ret.valRng[0] = v;
-					if (ret.valRng[1] < v)
-						ret.valRng[1] = v;
+				for (size_t i = 0; i < chunkValRngs.size(); ++i) {
+					if (!chunkValids[i]) {
+						if (errMsg)
+							*errMsg = "Invalid File Content, which Contains Non-Numeric Token";
+						ret.dat.clear();
+						return ret;
+					}
+					if (ret.valRng[0] > chunkValRngs[i][0])
+						ret.valRng[0] = chunkValRngs[i][0];
+					if (ret.valRng[1] < chunkValRngs[i][1])
+						ret.valRng[1] = chunkValRngs[i][1];
 				}
 
+				auto sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+				ret.parseMBPerSec = sec == 0. ? 0. : txtSz / (1024. * 1024.) / sec;
+
 				return ret;
 			}
 
 		private:
-			TXTVolume()
+			/*
+			* 结构体: chunkParser
+			* 功能: 解析从第idx个记号开始的一段文本，将子区域内的数值写入（翻转后的）目标位置并归约值域，
+			*       文件映射与gzip流式解压两条路径共用
+			*/
+			struct chunkParser
+			{
+				std::array<uint32_t, 3> dim;
+				size_t dimYxX;
+				std::array<uint32_t, 3> rgnBeg;
+				std::array<uint32_t, 3> rgnDim;
+				size_t tokBeg; // 子区域在文件中所占的记号范围
+				size_t tokEnd;
+				float nullVal;
+				bool flipZ;
+				float* dst;
+
+				/*
+				* 返回值: 子区域内有非数值的记号时返回false
+				*/
+				bool operator()(const char* p, const char* pEnd, size_t idx, std::array<float, 2>& rng) const
+				{
+					uint32_t x = idx % dim[0];
+					uint32_t y = idx / dim[0] % dim[1];
+					uint32_t z = idx / dimYxX;
+					// 当前行在子区域中的起始位置，行不在子区域中时为nullptr
+					float* rowDst = nullptr;
+					auto locateRow = [&]() {
+						auto zOut = flipZ ? dim[2] - 1 - z : z;
+						rowDst = y - rgnBeg[1] < rgnDim[1] && zOut - rgnBeg[2] < rgnDim[2] ?
+							dst + ((zOut - rgnBeg[2]) * rgnDim[1] + y - rgnBeg[1]) * rgnDim[0] : nullptr;
+					};
+					locateRow();
+
+					for (; idx < tokEnd; ++idx) {
+						p = TXTScanner::SkipSpace(p, pEnd);
+						if (p == pEnd) break;
+
+						if (rowDst && x - rgnBeg[0] < rgnDim[0]) {
+							float v;
+							auto q = TXTScanner::ScanFloat(p, pEnd, v);
+							if (q == p || (q != pEnd && !TXTScanner::IsSpace(*q)))
+								return false;
+							p = q;
+
+							rowDst[x - rgnBeg[0]] = v;
+							if (v != nullVal) {
+								if (rng[0] > v)
+									rng[0] = v;
+								if (rng[1] < v)
+									rng[1] = v;
+							}
+						}
+						else
+							p = TXTScanner::SkipToken(p, pEnd);
+
+						if (++x == dim[0]) {
+							x = 0;
+							if (++y == dim[1]) {
+								y = 0;
+								++z;
+							}
+							locateRow();
+						}
+					}
+					return true;
+				}
+			};
+
+			/*
+			* 函数: parseGZip
+			* 功能: 以GZipTextPipeline边解压边解析。块在空白处切分并带有其第一个记号的序号，
+			*       工作线程直接写入目标位置，值域与有效性按工作线程归约。切分出的记号覆盖子区域后即停止解压
+			*/
+			static bool parseGZip(const MappedFile& mapped, const chunkParser& parser,
+				const std::array<float, 2>& initValRng, std::vector<std::array<float, 2>>& thrdValRngs,
+				std::vector<uint8_t>& thrdValids, size_t& txtSz, std::string* errMsg)
+			{
+				GZipTextPipeline::Parameters param;
+				param.countTokens = true;
+				param.tokLimit = parser.tokEnd;
+				auto workerNum = GZipTextPipeline::GetWorkerNumber(param);
+				thrdValRngs.assign(workerNum, initValRng);
+				thrdValids.assign(workerNum, 1);
+				std::vector<size_t> thrdTokNums(workerNum, 0);
+				std::vector<size_t> thrdTxtSzs(workerNum, 0);
+
+				auto ok = GZipTextPipeline::Run(mapped.GetData(), mapped.GetSize(), param,
+					[&](uint32_t thrdIdx, const GZipTextPipeline::Chunk& chunk) {
+						thrdTokNums[thrdIdx] += chunk.tokNum;
+						thrdTxtSzs[thrdIdx] += chunk.txt.size();
+						if (chunk.tokBeg >= parser.tokEnd || chunk.tokBeg + chunk.tokNum <= parser.tokBeg)
+							return true;
+
+						auto txt = chunk.txt.data();
+						if (!parser(txt, txt + chunk.txt.size(), chunk.tokBeg, thrdValRngs[thrdIdx])) {
+							thrdValids[thrdIdx] = 0;
+							return false;
+						}
+						return true;
+					}, errMsg);
+				if (!ok)
+					return false;
+
+				size_t tokNum = 0;
+				txtSz = 0;
+				for (uint32_t i = 0; i < workerNum; ++i) {
+					tokNum += thrdTokNums[i];
+					txtSz += thrdTxtSzs[i];
+				}
+				// 整个体时tokEnd即为voxNum；子区域时只要求文件覆盖子区域，其后的内容未被解压
+				if (tokNum < parser.tokEnd
+					&& std::find(thrdValids.begin(), thrdValids.end(), 0) == thrdValids.end()) {
+					if (errMsg)
+						*errMsg = "File Content is Less than Volume Size";
+					return false;
+				}
+				return true;
+			}
+
+			TXTVolume() : parseMBPerSec(0.)
 			{
 				valRng[0] = std::numeric_limits <float>::max();
 				valRng[1] = std::numeric_limits <float>::lowest();
@@ -138,7 +378,11 @@ namespace SciVis
 			std::array<float, 2> lonRng;
 			std::array<float, 2> latRng;
 			std::array<float, 2> hRng;
+			std::vector<float> lons; // 各轴升序排列的坐标取值
+			std::vector<float> lats;
+			std::vector<float> hs;
 			std::vector<float> dat;
+			std::shared_ptr<SparseVolumeData> sparse; // 体非稠密时，数据存于此处，dat为空
 
 			void Normalize(const std::array<float, 2>* valRng = nullptr)
 			{
@@ -146,6 +390,7 @@ namespace SciVis
 					this->valRng = *valRng;
 
 				auto rngWid = this->valRng[1] - this->valRng[0];
+				auto& dat = sparse ? sparse->GetValues() : this->dat;
 				for (auto itr = dat.begin(); itr != dat.end(); ++itr) {
 					if (isnan(*itr))
 						*itr = this->valRng[0];
@@ -159,65 +404,318 @@ namespace SciVis
 
 				this->valRng[0] = 0.f;
 				this->valRng[1] = 1.f;
+				statsCache->Invalidate();
+			}
+
+			std::shared_ptr<const VolumeStatistics::Result> GetStatistics() const
+			{
+				return GetStatistics(VolumeStatistics::Parameters());
+			}
+			/*
+			* 函数: GetStatistics
+			* 功能: 获取体的统计量（见VolumeStatistics），结果随体缓存。体非稠密时只统计各非空体素，
+			*       结果中的切片与砖块极值不具有空间意义。直接修改了dat或sparse后应调用InvalidateStatistics
+			*/
+			std::shared_ptr<const VolumeStatistics::Result> GetStatistics(
+				const VolumeStatistics::Parameters& param) const
+			{
+				if (sparse) {
+					const auto& vals = sparse->GetValues();
+					return statsCache->Get(VolumeView<float>(
+						vals.data(), { { static_cast<uint32_t>(vals.size()), 1, 1 } }), param);
+				}
+				return statsCache->Get(VolumeView<float>(dat, dim), param);
+			}
+			void InvalidateStatistics()
+			{
+				statsCache->Invalidate();
 			}
 
 		public:
+			/*
+			* 函数: LoadFromFile
+			* 功能: 多线程加载带经纬高标签的文本体数据。文件按行切分为若干块并行解析，
+			*       各轴的取值由排序去重得到，每个体素按其(经度, 纬度, 高度)映射到网格下标，
+			*       因此记录的顺序不影响结果。文件为gzip压缩时（由文件头识别）边解压边解析（见GZipTextPipeline）。
+			*       文件为列式二进制文件时（由文件头识别，见LabeledPointVolumeData与Convertor::LabeledPointVolume），
+			*       不经文本解析，直接由各列构建
+			* 参数:
+			* -- filePath: 文件路径
+			* -- errMsg: 若不为空，加载失败时写入错误信息
+			*/
 			static LabeledTXTVolume LoadFromFile(
 				const std::string& filePath, std::string* errMsg = nullptr)
 			{
 				LabeledTXTVolume ret;
 
-				std::ifstream is(filePath, std::ios::in);
-				if (!is.is_open()) {
-					if (errMsg) {
-						*errMsg = "Invalid File Path: ";
-						errMsg->append(filePath);
+				auto mapped = MappedFile::Open(filePath, MappedFile::EAccessHint::Sequential, errMsg);
+				if (!mapped)
+					return ret;
+
+				if (LabeledPointVolumeData::IsLabeledPointVolume(mapped->GetData(), mapped->GetSize())) {
+					loadColumnar(std::move(mapped), ret, errMsg);
+					return ret;
+				}
+
+				std::vector<std::vector<Record>> chunkRecs;
+				std::vector<std::array<float, 2>> chunkValRngs;
+				std::vector<std::array<std::vector<float>, 3>> chunkAxes;
+				if (GZipInflater::IsGZip(mapped->GetData(), mapped->GetSize())) {
+					if (!parseGZip(*mapped, ret.valRng, chunkRecs, chunkValRngs, chunkAxes, errMsg))
+						return ret;
+				}
+				else {
+					auto txt = reinterpret_cast<const char*>(mapped->GetData());
+					auto txtEnd = txt + mapped->GetSize();
+					auto body = TXTScanner::SkipLine(txt, txtEnd); // 跳过第一行
+					auto chunks = TXTScanner::SplitOnLine(body, txtEnd - body, GetWorkerThreadNum());
+					auto chunkNum = chunks.size() - 1;
+
+					chunkRecs.resize(chunkNum);
+					chunkValRngs.assign(chunkNum, ret.valRng);
+					chunkAxes.resize(chunkNum);
+					ParallelFor(chunkNum, [&](uint32_t, size_t beg, size_t end) {
+						for (auto i = beg; i < end; ++i)
+							parseRecords(body + chunks[i], body + chunks[i + 1], chunkRecs[i], chunkValRngs[i], chunkAxes[i]);
+						});
+				}
+				auto chunkNum = chunkRecs.size();
+
+				size_t recNum = 0;
+				std::array<std::vector<float>*, 3> axes = { &ret.lons, &ret.lats, &ret.hs };
+				for (size_t i = 0; i < chunkNum; ++i) {
+					recNum += chunkRecs[i].size();
+					if (ret.valRng[0] > chunkValRngs[i][0])
+						ret.valRng[0] = chunkValRngs[i][0];
+					if (ret.valRng[1] < chunkValRngs[i][1])
+						ret.valRng[1] = chunkValRngs[i][1];
+					for (uint8_t a = 0; a < 3; ++a)
+						axes[a]->insert(axes[a]->end(), chunkAxes[i][a].begin(), chunkAxes[i][a].end());
+				}
+				if (recNum == 0) {
+					if (errMsg)
+						*errMsg = "Invalid File Content, which Contains No Record";
+					return ret;
+				}
+
+				std::array<std::array<float, 2>*, 3> rngs = { &ret.lonRng, &ret.latRng, &ret.hRng };
+				for (uint8_t a = 0; a < 3; ++a) {
+					sortUnique(*axes[a]);
+					ret.dim[a] = static_cast<uint32_t>(axes[a]->size());
+					(*rngs[a])[0] = axes[a]->front();
+					(*rngs[a])[1] = axes[a]->back();
+				}
+
+				auto voxNum = static_cast<size_t>(ret.dim[2]) * ret.dim[1] * ret.dim[0];
+				auto dimYxX = static_cast<size_t>(ret.dim[1]) * ret.dim[0];
+				std::vector<std::vector<size_t>> chunkIdxs(chunkNum); // 各记录所在网格单元的下标
+				ParallelFor(chunkNum, [&](uint32_t, size_t beg, size_t end) {
+					for (auto i = beg; i < end; ++i) {
+						chunkIdxs[i].reserve(chunkRecs[i].size());
+						for (auto& rec : chunkRecs[i]) {
+							auto x = ret.GetAxisIndex(0, rec.coord[0]);
+							auto y = ret.GetAxisIndex(1, rec.coord[1]);
+							auto z = ret.GetAxisIndex(2, rec.coord[2]);
+							chunkIdxs[i].emplace_back(z * dimYxX + y * ret.dim[0] + x);
+						}
 					}
+					});
+
+				// 坐标相同的记录落在同一网格单元，因此以被占据的不同网格单元数判断是否稠密
+				size_t occupiedNum = 0;
+				if (recNum >= voxNum) {
+					std::vector<uint8_t> occupied(voxNum, 0);
+					for (auto& idxs : chunkIdxs)
+						for (auto idx : idxs)
+							if (!occupied[idx]) {
+								occupied[idx] = 1;
+								++occupiedNum;
+							}
+				}
+				ret.isDense = occupiedNum == voxNum;
+				if (!ret.isDense) {
+					std::vector<SparseVolumeData::Voxel> voxs;
+					voxs.reserve(recNum);
+					for (size_t i = 0; i < chunkNum; ++i) {
+						for (size_t j = 0; j < chunkRecs[i].size(); ++j) {
+							auto idx = chunkIdxs[i][j];
+							voxs.emplace_back(SparseVolumeData::Voxel{ {
+								static_cast<uint32_t>(idx % ret.dim[0]),
+								static_cast<uint32_t>(idx / ret.dim[0] % ret.dim[1]),
+								static_cast<uint32_t>(idx / dimYxX) }, chunkRecs[i][j].val });
+						}
+						std::vector<Record>().swap(chunkRecs[i]);
+						std::vector<size_t>().swap(chunkIdxs[i]);
+					}
+					ret.sparse = std::make_shared<SparseVolumeData>(
+						SparseVolumeData::FromVoxels(ret.dim, voxs));
 					return ret;
 				}
 
-				auto computeMinMax = [](std::array<float, 2>& rng, float val) {
-					if (rng[0] > val)
-						rng[0] = val;
-					if (rng[1] < val)
-						rng[1] = val;
-				};
-
-				std::unordered_set<float> hSets, latSets, lonSets;
-				std::string buf;
-				std::getline(is, buf); // һ
-				while (std::getline(is, buf)) {
-					std::array<float, 5> f5;
+				ret.dat.assign(voxNum, std::numeric_limits<float>::quiet_NaN());
+				ParallelFor(chunkNum, [&](uint32_t, size_t beg, size_t end) {
+					for (auto i = beg; i < end; ++i)
+						for (size_t j = 0; j < chunkRecs[i].size(); ++j)
+							ret.dat[chunkIdxs[i][j]] = chunkRecs[i][j].val;
+					});
 
-					auto validRead = sscanf(buf.c_str(), "%f%f%f%f%f",
-						&f5[0], &f5[1], &f5[2], &f5[3], &f5[4]);
-					if (validRead < 4) continue;
+				return ret;
+			}
+
+			/*
+			* 函数: GetAxisIndex
+			* 功能: 获取坐标在某轴（0为经度，1为纬度，2为高度）上的网格下标
+			*/
+			uint32_t GetAxisIndex(uint8_t axis, float coord) const
+			{
+				const auto& vals = axis == 0 ? lons : axis == 1 ? lats : hs;
+				return static_cast<uint32_t>(
+					std::lower_bound(vals.begin(), vals.end(), coord) - vals.begin());
+			}
+
+		private:
+			struct Record
+			{
+				std::array<float, 3> coord; // 经度，纬度，高度
+				float val;
+			};
+
+			/*
+			* 函数: parseRecords
+			* 功能: 解析由整行组成的一段文本中的记录，并在段内对各轴的取值排序去重，使合并时只需处理少量取值。
+			*       经纬高不是有限值（如nan、inf）的记录无法映射到网格，被丢弃
+			*/
+			static void parseRecords(const char* p, const char* pEnd, std::vector<Record>& recs,
+				std::array<float, 2>& rng, std::array<std::vector<float>, 3>& axes)
+			{
+				recs.reserve((pEnd - p) / 32);
+				while (p != pEnd) {
+					auto lnEnd = TXTScanner::SkipLine(p, pEnd);
 
-					hSets.emplace(f5[1]);
-					latSets.emplace(f5[2]);
-					lonSets.emplace(f5[3]);
+					std::array<float, 5> f5;
+					uint8_t validRead = 0;
+					for (; validRead < 5; ++validRead) {
+						p = TXTScanner::SkipSpace(p, lnEnd);
+						auto q = TXTScanner::ScanFloat(p, lnEnd, f5[validRead]);
+						if (q == p) break;
+						p = q;
+					}
+					p = lnEnd;
+					if (validRead < 4) continue;
+					if (!std::isfinite(f5[1]) || !std::isfinite(f5[2]) || !std::isfinite(f5[3])) continue;
 
-					computeMinMax(ret.hRng, f5[1]);
-					computeMinMax(ret.latRng, f5[2]);
-					computeMinMax(ret.lonRng, f5[3]);
-					if (validRead == 5)
-						computeMinMax(ret.valRng, f5[4]);
+					if (validRead == 5) {
+						if (rng[0] > f5[4])
+							rng[0] = f5[4];
+						if (rng[1] < f5[4])
+							rng[1] = f5[4];
+					}
 					else
 						f5[4] = std::numeric_limits<float>::quiet_NaN();
 
-					ret.dat.emplace_back(f5[4]);
+					recs.emplace_back(Record{ { f5[3], f5[2], f5[1] }, f5[4] });
 				}
 
-				ret.dim[2] = hSets.size();
-				ret.dim[1] = latSets.size();
-				ret.dim[0] = lonSets.size();
-				ret.isDense = ret.dat.size() ==
-					static_cast<size_t>(ret.dim[2]) * ret.dim[1] * ret.dim[0];
+				for (uint8_t a = 0; a < 3; ++a) {
+					axes[a].reserve(recs.size());
+					for (auto& rec : recs)
+						axes[a].emplace_back(rec.coord[a]);
+					sortUnique(axes[a]);
+				}
+			}
+			/*
+			* 函数: parseGZip
+			* 功能: 以GZipTextPipeline边解压边解析。块在换行处切分，各工作线程将其解析的块的结果依次追加到各自的列表中，
+			*       结束后合并，记录的顺序不影响结果
+			*/
+			static bool parseGZip(const MappedFile& mapped, const std::array<float, 2>& initValRng,
+				std::vector<std::vector<Record>>& chunkRecs, std::vector<std::array<float, 2>>& chunkValRngs,
+				std::vector<std::array<std::vector<float>, 3>>& chunkAxes, std::string* errMsg)
+			{
+				GZipTextPipeline::Parameters param;
+				param.splitOnLine = true;
+				auto workerNum = GZipTextPipeline::GetWorkerNumber(param);
+				std::vector<std::vector<std::vector<Record>>> thrdRecs(workerNum);
+				std::vector<std::vector<std::array<float, 2>>> thrdValRngs(workerNum);
+				std::vector<std::vector<std::array<std::vector<float>, 3>>> thrdAxes(workerNum);
+
+				auto ok = GZipTextPipeline::Run(mapped.GetData(), mapped.GetSize(), param,
+					[&](uint32_t thrdIdx, const GZipTextPipeline::Chunk& chunk) {
+						auto p = chunk.txt.data();
+						auto pEnd = p + chunk.txt.size();
+						if (chunk.idx == 0)
+							p = TXTScanner::SkipLine(p, pEnd); // 跳过第一行
+
+						thrdRecs[thrdIdx].emplace_back();
+						thrdValRngs[thrdIdx].emplace_back(initValRng);
+						thrdAxes[thrdIdx].emplace_back();
+						parseRecords(p, pEnd, thrdRecs[thrdIdx].back(), thrdValRngs[thrdIdx].back(), thrdAxes[thrdIdx].back());
+						return true;
+					}, errMsg);
+				if (!ok)
+					return false;
 
-				return ret;
+				for (uint32_t i = 0; i < workerNum; ++i) {
+					std::move(thrdRecs[i].begin(), thrdRecs[i].end(), std::back_inserter(chunkRecs));
+					chunkValRngs.insert(chunkValRngs.end(), thrdValRngs[i].begin(), thrdValRngs[i].end());
+					std::move(thrdAxes[i].begin(), thrdAxes[i].end(), std::back_inserter(chunkAxes));
+				}
+				return true;
 			}
 
-		private:
+			/*
+			* 函数: loadColumnar
+			* 功能: 由列式二进制文件构建。坐标字典即各轴的取值；稠密时直接拷贝或散射到网格，否则构建稀疏体
+			*/
+			static bool loadColumnar(std::shared_ptr<MappedFile> mapped, LabeledTXTVolume& ret, std::string* errMsg)
+			{
+				auto vol = LabeledPointVolumeData::FromMappedFile(std::move(mapped));
+				if (!vol.ok) {
+					if (errMsg)
+						*errMsg = vol.result.errMsg;
+					return false;
+				}
+
+				auto& pnts = vol.result.dat;
+				auto& hdr = pnts.GetHeader();
+				std::array<std::vector<float>*, 3> axes = { &ret.lons, &ret.lats, &ret.hs };
+				for (uint8_t a = 0; a < 3; ++a)
+					axes[a]->assign(pnts.GetAxis(a), pnts.GetAxis(a) + hdr.dim[a]);
+				ret.dim = hdr.dim;
+				ret.valRng = hdr.valRng;
+				ret.lonRng = hdr.lonRng;
+				ret.latRng = hdr.latRng;
+				ret.hRng = hdr.hRng;
+
+				ret.isDense = pnts.IsDense();
+				auto ok = true;
+				if (ret.isDense) {
+					ret.dat.resize(pnts.GetVoxelNum());
+					ok = pnts.ReadDense(ret.dat.data(), std::numeric_limits<float>::quiet_NaN());
+				}
+				else {
+					std::vector<SparseVolumeData::Voxel> voxs;
+					ok = pnts.ReadVoxels(voxs);
+					if (ok)
+						ret.sparse = std::make_shared<SparseVolumeData>(
+							SparseVolumeData::FromVoxels(ret.dim, voxs));
+				}
+				if (!ok) {
+					if (errMsg)
+						*errMsg = "Invalid File Content, which Contains Coordinates out of Axes";
+					return false;
+				}
+				return true;
+			}
+
+			static void sortUnique(std::vector<float>& vals)
+			{
+				std::sort(vals.begin(), vals.end());
+				vals.erase(std::unique(vals.begin(), vals.end()), vals.end());
+			}
+
+			std::shared_ptr<VolumeStatisticsCache> statsCache = std::make_shared<VolumeStatisticsCache>();
+
 			LabeledTXTVolume()
 			{
 				dim[0] = dim[1] = dim[2] = 0;
@@ -236,10 +734,30 @@ namespace SciVis
 		public:
 			static std::vector<float> U8ToNormalizedFloat(const std::vector<uint8_t>& u8Dat)
 			{
-				std::vector<float> dat(u8Dat.size());
-				size_t i = 0;
-				for (size_t i = 0; i < u8Dat.size(); ++i)
-					dat[i] = u8Dat[i] / 255.f;
+				return U8ToNormalizedFloat(u8Dat.data(), u8Dat.size());
+			}
+
+			static std::vector<float> U8ToNormalizedFloat(const uint8_t* u8Dat, size_t voxNum)
+			{
+				std::vector<float> dat(voxNum);
+				parallelForVoxels(voxNum, [&](size_t beg, size_t end) {
+					SIMD::U8ToFloat(u8Dat + beg, dat.data() + beg, end - beg, 255.f);
+					});
+				return dat;
+			}
+			/*
+			* 函数: U8ToNormalizedFloat
+			* 功能: 将体视图（可为切片或裁剪出的子体）转换为紧密排列的归一化浮点体
+			*/
+			static std::vector<float> U8ToNormalizedFloat(const VolumeView<uint8_t>& vol)
+			{
+				if (vol.IsContiguous())
+					return U8ToNormalizedFloat(vol.dat, vol.GetVoxelNum());
+
+				std::vector<float> dat(vol.GetVoxelNum());
+				forEachRow(vol, [&](const uint8_t* row, size_t offset) {
+					SIMD::U8ToFloat(row, dat.data() + offset, vol.dim[0], 255.f);
+					});
 				return dat;
 			}
 
@@ -249,58 +767,193 @@ namespace SciVis
 				float nullVal, float nullValMap = 0.f)
 			{
 				std::vector<float> dat(floatDat.size());
-				size_t i = 0;
-				auto dlt = valRng[1] - valRng[0];
-				for (size_t i = 0; i < floatDat.size(); ++i) {
-					if (floatDat[i] == nullVal)
-						dat[i] = nullValMap;
-					else
-						dat[i] = (floatDat[i] - valRng[0]) / dlt;
+				normalize(floatDat.data(), dat.data(), floatDat.size(), valRng, nullVal, nullValMap);
+				return dat;
+			}
+			/*
+			* 函数: FloatToNormalizedFloat
+			* 功能: 同上，但在floatDat的缓冲上原地归一化后移出，不分配新的缓冲
+			*/
+			static std::vector<float> FloatToNormalizedFloat(
+				std::vector<float>&& floatDat,
+				const std::array<float, 2>& valRng,
+				float nullVal, float nullValMap = 0.f)
+			{
+				FloatToNormalizedFloatInPlace(floatDat, valRng, nullVal, nullValMap);
+				return std::move(floatDat);
+			}
+			/*
+			* 函数: FloatToNormalizedFloat
+			* 功能: 值域未知时，先求值域再归一化，共两次遍历
+			* 参数:
+			* -- valRng: 若不为空，写入求得的值域（不含nullVal）
+			*/
+			static std::vector<float> FloatToNormalizedFloat(
+				const std::vector<float>& floatDat,
+				float nullVal, float nullValMap = 0.f,
+				std::array<float, 2>* valRng = nullptr)
+			{
+				auto rng = ComputeValueRange(floatDat.data(), floatDat.size(), nullVal);
+				if (valRng)
+					*valRng = rng;
+				return FloatToNormalizedFloat(floatDat, rng, nullVal, nullValMap);
+			}
+			static std::vector<float> FloatToNormalizedFloat(
+				std::vector<float>&& floatDat,
+				float nullVal, float nullValMap = 0.f,
+				std::array<float, 2>* valRng = nullptr)
+			{
+				FloatToNormalizedFloatInPlace(floatDat, nullVal, nullValMap, valRng);
+				return std::move(floatDat);
+			}
+			/*
+			* 函数: FloatToNormalizedFloat
+			* 功能: 以视图的值域将体视图归一化为紧密排列的浮点体
+			*/
+			static std::vector<float> FloatToNormalizedFloat(
+				const VolumeView<float>& vol, float nullVal, float nullValMap = 0.f)
+			{
+				std::vector<float> dat(vol.GetVoxelNum());
+				if (vol.IsContiguous()) {
+					normalize(vol.dat, dat.data(), dat.size(), vol.valRng, nullVal, nullValMap);
+					return dat;
 				}
+
+				auto dlt = vol.valRng[1] - vol.valRng[0];
+				forEachRow(vol, [&](const float* row, size_t offset) {
+					SIMD::Normalize(row, dat.data() + offset, vol.dim[0], vol.valRng[0], dlt, nullVal, nullValMap);
+					});
 				return dat;
 			}
+			/*
+			* 函数: FloatToNormalizedFloatInPlace
+			* 功能: 原地归一化，不分配新的缓冲
+			*/
+			static void FloatToNormalizedFloatInPlace(
+				std::vector<float>& floatDat,
+				const std::array<float, 2>& valRng,
+				float nullVal, float nullValMap = 0.f)
+			{
+				normalize(floatDat.data(), floatDat.data(), floatDat.size(), valRng, nullVal, nullValMap);
+			}
+			static void FloatToNormalizedFloatInPlace(
+				std::vector<float>& floatDat,
+				float nullVal, float nullValMap = 0.f,
+				std::array<float, 2>* valRng = nullptr)
+			{
+				auto rng = ComputeValueRange(floatDat.data(), floatDat.size(), nullVal);
+				if (valRng)
+					*valRng = rng;
+				FloatToNormalizedFloatInPlace(floatDat, rng, nullVal, nullValMap);
+			}
+
+			/*
+			* 函数: ComputeValueRange
+			* 功能: 多线程求除nullVal与NaN以外的值域
+			*/
+			static std::array<float, 2> ComputeValueRange(const float* dat, size_t voxNum, float nullVal)
+			{
+				std::array<float, 2> init = {
+					std::numeric_limits<float>::max(), std::numeric_limits<float>::lowest() };
+				std::vector<std::array<float, 2>> rngs(GetWorkerThreadNum(), init);
+				ParallelFor(voxNum, [&](uint32_t thrdIdx, size_t beg, size_t end) {
+					SIMD::MinMax(dat + beg, end - beg, nullVal, rngs[thrdIdx]);
+					}, threadNumFor(voxNum));
+
+				for (auto& rng : rngs) {
+					init[0] = std::min(init[0], rng[0]);
+					init[1] = std::max(init[1], rng[1]);
+				}
+				return init;
+			}
 
 			static std::vector<uint8_t> NormalizedFloatToU8(const std::vector<float>& fDat)
 			{
 				std::vector<uint8_t> dat(fDat.size());
-				size_t i = 0;
-				for (size_t i = 0; i < fDat.size(); ++i)
-					dat[i] = fDat[i] * 255.f;
+				parallelForVoxels(fDat.size(), [&](size_t beg, size_t end) {
+					SIMD::FloatToU8(fDat.data() + beg, dat.data() + beg, end - beg, 255.f);
+					});
+				return dat;
+			}
+			static std::vector<uint8_t> NormalizedFloatToU8(const VolumeView<float>& vol)
+			{
+				std::vector<uint8_t> dat(vol.GetVoxelNum());
+				if (vol.IsContiguous()) {
+					parallelForVoxels(dat.size(), [&](size_t beg, size_t end) {
+						SIMD::FloatToU8(vol.dat + beg, dat.data() + beg, end - beg, 255.f);
+						});
+					return dat;
+				}
+
+				forEachRow(vol, [&](const float* row, size_t offset) {
+					SIMD::FloatToU8(row, dat.data() + offset, vol.dim[0], 255.f);
+					});
 				return dat;
 			}
 
 			static std::vector<float> RoughFloatToSmooth(const std::vector<float>& fDat, const std::array<uint32_t, 3>& dim)
 			{
-				std::vector<float> smoothed(fDat.size());
-				size_t dimYxX = dim[1] * dim[0];
-				auto sample = [&](uint32_t x, uint32_t y, uint32_t z) -> float {
-					x = std::min(x, dim[0] - 1);
-					y = std::min(y, dim[1] - 1);
-					z = std::min(z, dim[2] - 1);
-					return fDat[z * dimYxX + y * dim[0] + x];
-				};
-
-				for (uint32_t z = 0; z < dim[2]; ++z)
-					for (uint32_t y = 0; y < dim[1]; ++y)
-						for (uint32_t x = 0; x < dim[0]; ++x) {
-							std::array<float, 27> field;
-							for (int8_t dz = -1; dz < 2; ++dz)
-								for (int8_t dy = -1; dy < 2; ++dy)
-									for (int8_t dx = -1; dx < 2; ++dx) {
-										auto i = (dz + 1) * 9 + (dy + 1) * 3 + (dx + 1);
-										field[i] = sample(
-											x == 0 && dx < 0 ? x : x + dx,
-											y == 0 && dy < 0 ? y : y + dy,
-											z == 0 && dz < 0 ? z : z + dz);
-									}
-							auto& val = smoothed[z * dimYxX + y * dim[0] + x];
-							val = 0.f;
-							for (uint8_t i = 0; i < 27; ++i)
-								val += field[i];
-							val /= 27.f;
-						}
+				return FloatToSmooth(fDat, dim, VolumeSmoother::Parameters());
+			}
+			/*
+			* 函数: FloatToSmooth
+			* 功能: 以指定的核（盒式或高斯）与半径平滑体数据，详见VolumeSmoother
+			*/
+			static std::vector<float> FloatToSmooth(
+				const std::vector<float>& fDat, const std::array<uint32_t, 3>& dim,
+				const VolumeSmoother::Parameters& param)
+			{
+				auto prm = param;
+				if (prm.thrdNum == 0)
+					prm.thrdNum = threadNumFor(fDat.size());
+				return VolumeSmoother::Smooth(fDat, dim, prm);
+			}
 
-				return smoothed;
+		private:
+			static uint32_t threadNumFor(size_t voxNum)
+			{
+				// 数据量较小时多线程的开销大于收益
+				const size_t MinVoxNumPerThrd = 1 << 18;
+				return static_cast<uint32_t>(std::max(
+					static_cast<size_t>(1),
+					std::min(static_cast<size_t>(GetWorkerThreadNum()), voxNum / MinVoxNumPerThrd)));
+			}
+			template <typename Func>
+			static void parallelForVoxels(size_t voxNum, const Func& func)
+			{
+				ParallelFor(voxNum, [&](uint32_t, size_t beg, size_t end) {
+					func(beg, end);
+					}, threadNumFor(voxNum));
+			}
+			/*
+			* 函数: forEachRow
+			* 功能: 在多个线程上以func(row, offset)处理体视图的各行。row为该行连续存放的体素，
+			*       offset为该行在紧密排列的体中的起始下标。X方向的步长不为1时，先将该行收集到临时缓冲
+			*/
+			template <typename T, typename Func>
+			static void forEachRow(const VolumeView<T>& vol, const Func& func)
+			{
+				auto rowNum = static_cast<size_t>(vol.dim[1]) * vol.dim[2];
+				ParallelFor(rowNum, [&](uint32_t, size_t beg, size_t end) {
+					std::vector<T> gathered(vol.strides[0] == 1 ? 0 : vol.dim[0]);
+					for (auto r = beg; r < end; ++r) {
+						auto row = vol.Row(static_cast<uint32_t>(r % vol.dim[1]), static_cast<uint32_t>(r / vol.dim[1]));
+						if (!gathered.empty()) {
+							for (uint32_t x = 0; x < vol.dim[0]; ++x)
+								gathered[x] = row[x * vol.strides[0]];
+							row = gathered.data();
+						}
+						func(row, r * vol.dim[0]);
+					}
+					}, threadNumFor(vol.GetVoxelNum()));
+			}
+			static void normalize(const float* src, float* dst, size_t voxNum,
+				const std::array<float, 2>& valRng, float nullVal, float nullValMap)
+			{
+				auto dlt = valRng[1] - valRng[0];
+				parallelForVoxels(voxNum, [&](size_t beg, size_t end) {
+					SIMD::Normalize(src + beg, dst + beg, end - beg, valRng[0], dlt, nullVal, nullValMap);
+					});
 			}
 		};
 	}
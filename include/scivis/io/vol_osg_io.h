@@ -1,11 +1,32 @@
 #ifndef SCIVIS_IO_VOL_OSG_IO_H
 #define SCIVIS_IO_VOL_OSG_IO_H
 
+#include <cstring>
+
 #include <array>
 #include <vector>
 
 #include <osg/Texture3D>
 
+#include <scivis/common/vol_tex.h>
+#include <scivis/data/sparse_vol_data.h>
+#include <scivis/data/vol_quantizer.h>
+#include <scivis/data/vol_resampler.h>
+#include <scivis/data/vol_view.h>
+
+#ifndef GL_R8
+#define GL_R8 0x8229
+#endif // !GL_R8
+#ifndef GL_R16
+#define GL_R16 0x822A
+#endif // !GL_R16
+#ifndef GL_HALF_FLOAT
+#define GL_HALF_FLOAT 0x140B
+#endif // !GL_HALF_FLOAT
+#ifndef GL_R16F
+#define GL_R16F 0x822D
+#endif // !GL_R16F
+
 namespace SciVis
 {
 	namespace OSGLoader {
@@ -48,62 +69,206 @@ namespace SciVis
 		class RAWVolume
 		{
 		public:
+			/*
+			* 函数: NormalizedFloatToTexture
+			* 功能: 将归一化的体数据重采样为2的幂尺寸，并转换为OSG三维纹理
+			* 参数:
+			* -- dat: 归一化的体数据
+			* -- srcDim: 体的三维尺寸
+			* -- logDstDim: 纹理三维尺寸以2为底的对数
+			* -- filterMode: 纹理的过滤方式
+			* -- resampleParam: 重采样参数
+			* -- genMipmap: 为true时，一并生成多级渐远纹理，并使用三线性过滤
+			*/
 			static osg::ref_ptr<osg::Texture3D> NormalizedFloatToTexture(
 				const std::vector<float>& dat,
 				const std::array<uint32_t, 3>& srcDim,
 				const std::array<uint8_t, 3>& logDstDim,
+				osg::Texture::FilterMode filterMode = osg::Texture::LINEAR,
+				const VolumeResampler::Parameters& resampleParam = VolumeResampler::Parameters(),
+				bool genMipmap = false)
+			{
+				std::array<uint32_t, 3> dstDim = { 1u << logDstDim[0], 1u << logDstDim[1], 1u << logDstDim[2] };
+
+				osg::ref_ptr<osg::Image> img = new osg::Image;
+				if (!genMipmap) {
+					img->allocateImage(dstDim[0], dstDim[1], dstDim[2], GL_RED, GL_FLOAT);
+					VolumeResampler::Resample(dat.data(), srcDim,
+						reinterpret_cast<float*>(img->data()), dstDim, resampleParam);
+				}
+				else {
+					auto base = VolumeResampler::Resample(dat, srcDim, dstDim, resampleParam);
+					auto lvls = VolumeResampler::BuildMipPyramid(base.data(), dstDim, resampleParam);
+
+					size_t totVoxNum = 0;
+					osg::Image::MipmapDataType mipOffs;
+					for (auto& lvl : lvls) {
+						if (totVoxNum != 0)
+							mipOffs.emplace_back(static_cast<unsigned int>(totVoxNum * sizeof(float)));
+						totVoxNum += lvl.dat.size();
+					}
+
+					auto* buf = new unsigned char[totVoxNum * sizeof(float)];
+					auto* pxPtr = reinterpret_cast<float*>(buf);
+					for (auto& lvl : lvls) {
+						std::memcpy(pxPtr, lvl.dat.data(), sizeof(float) * lvl.dat.size());
+						pxPtr += lvl.dat.size();
+					}
+					img->setImage(dstDim[0], dstDim[1], dstDim[2], GL_RED, GL_RED, GL_FLOAT,
+						buf, osg::Image::USE_NEW_DELETE);
+					img->setMipmapLevels(mipOffs);
+				}
+				img->setInternalTextureFormat(GL_RED);
+
+				osg::ref_ptr<osg::Texture3D> tex = new osg::Texture3D;
+				tex->setFilter(osg::Texture::MAG_FILTER, filterMode);
+				tex->setFilter(osg::Texture::MIN_FILTER, !genMipmap ? filterMode
+					: filterMode == osg::Texture::LINEAR ? osg::Texture::LINEAR_MIPMAP_LINEAR
+					: osg::Texture::NEAREST_MIPMAP_NEAREST);
+				tex->setWrap(osg::Texture::WRAP_S, osg::Texture::WrapMode::CLAMP_TO_EDGE);
+				tex->setWrap(osg::Texture::WRAP_T, osg::Texture::WrapMode::CLAMP_TO_EDGE);
+				tex->setWrap(osg::Texture::WRAP_R, osg::Texture::WrapMode::CLAMP_TO_EDGE);
+				tex->setInternalFormatMode(osg::Texture::InternalFormatMode::USE_IMAGE_DATA_FORMAT);
+				tex->setImage(img);
+
+				return tex;
+			}
+
+			/*
+			* 函数: NormalizedFloatToNativeTexture
+			* 功能: 不经重采样，按原始分辨率将归一化的体数据上传为OSG三维纹理
+			* 参数:
+			* -- dat: 归一化的体数据
+			* -- dim: 体的三维尺寸
+			* -- policy: 纹理尺寸策略。NPOT纹理不被支持时，Native退化为填充至2的幂
+			* -- filterMode: 纹理的过滤方式
+			*/
+			static osg::ref_ptr<osg::Texture3D> NormalizedFloatToNativeTexture(
+				const std::vector<float>& dat,
+				const std::array<uint32_t, 3>& dim,
+				ETextureSizePolicy policy = ETextureSizePolicy::Native,
+				osg::Texture::FilterMode filterMode = osg::Texture::LINEAR)
+			{
+				return VolumeTexture::Create(dat.data(), dim, GL_FLOAT, GL_RED, policy, filterMode);
+			}
+			/*
+			* 函数: NormalizedFloatToNativeTexture
+			* 功能: 同上，但输入为体视图。视图连续时直接由视图上传，否则先收集为连续数组
+			*/
+			static osg::ref_ptr<osg::Texture3D> NormalizedFloatToNativeTexture(
+				const VolumeView<float>& vol,
+				ETextureSizePolicy policy = ETextureSizePolicy::Native,
+				osg::Texture::FilterMode filterMode = osg::Texture::LINEAR)
+			{
+				if (vol.IsContiguous())
+					return VolumeTexture::Create(vol.dat, vol.dim, GL_FLOAT, GL_RED, policy, filterMode);
+				return VolumeTexture::Create(vol.ToVector(), vol.dim, GL_FLOAT, GL_RED, policy, filterMode);
+			}
+			/*
+			* 函数: NormalizedFloatToNativeTexture
+			* 功能: 同上，但接管dat的缓冲，按原始分辨率上传时不再拷贝体数据
+			*/
+			static osg::ref_ptr<osg::Texture3D> NormalizedFloatToNativeTexture(
+				std::vector<float>&& dat,
+				const std::array<uint32_t, 3>& dim,
+				ETextureSizePolicy policy = ETextureSizePolicy::Native,
+				osg::Texture::FilterMode filterMode = osg::Texture::LINEAR)
+			{
+				return VolumeTexture::Create(std::move(dat), dim, GL_FLOAT, GL_RED, policy, filterMode);
+			}
+
+			/*
+			* 函数: NormalizedFloatToQuantizedTexture
+			* 功能: 将归一化的体数据量化为R8、R16或R16F格式后上传为OSG三维纹理。
+			*       着色器中采样得到的仍是归一化的标量，无需修改
+			* 参数:
+			* -- dat: 归一化的体数据
+			* -- dim: 体的三维尺寸
+			* -- quantParam: 量化参数
+			* -- errReport: 不为空时，写入量化误差的统计
+			* -- policy: 纹理尺寸策略。为ResampleToPowerOfTwo时，先重采样后量化，误差相对于重采样后的体统计
+			* -- filterMode: 纹理的过滤方式
+			*/
+			static osg::ref_ptr<osg::Texture3D> NormalizedFloatToQuantizedTexture(
+				const std::vector<float>& dat,
+				const std::array<uint32_t, 3>& dim,
+				const VolumeQuantizer::Parameters& quantParam,
+				VolumeQuantizer::ErrorReport* errReport = nullptr,
+				ETextureSizePolicy policy = ETextureSizePolicy::Native,
+				osg::Texture::FilterMode filterMode = osg::Texture::LINEAR)
+			{
+				return NormalizedFloatToQuantizedTexture(
+					VolumeView<float>(dat, dim), quantParam, errReport, policy, filterMode);
+			}
+			static osg::ref_ptr<osg::Texture3D> NormalizedFloatToQuantizedTexture(
+				const VolumeView<float>& vol,
+				const VolumeQuantizer::Parameters& quantParam,
+				VolumeQuantizer::ErrorReport* errReport = nullptr,
+				ETextureSizePolicy policy = ETextureSizePolicy::Native,
+				osg::Texture::FilterMode filterMode = osg::Texture::LINEAR)
+			{
+				if (!vol.IsContiguous()) {
+					auto packed = vol.ToVector();
+					return NormalizedFloatToQuantizedTexture(
+						VolumeView<float>(packed, vol.dim), quantParam, errReport, policy, filterMode);
+				}
+
+				auto& dim = vol.dim;
+				if (VolumeTexture::ResolvePolicy(policy) == ETextureSizePolicy::ResampleToPowerOfTwo) {
+					auto texDim = VolumeTexture::GetTextureDimension(dim, policy);
+					std::vector<float> resampled(static_cast<size_t>(texDim[0]) * texDim[1] * texDim[2]);
+					VolumeResampler::Resample(vol.dat, dim, resampled.data(), texDim);
+					return NormalizedFloatToQuantizedTexture(
+						VolumeView<float>(resampled, texDim), quantParam, errReport, ETextureSizePolicy::Native, filterMode);
+				}
+
+				if (quantParam.format == VolumeQuantizer::EFormat::Float32) {
+					if (errReport)
+						*errReport = VolumeQuantizer::ErrorReport();
+					return VolumeTexture::Create(vol.dat, dim, GL_FLOAT, GL_RED, policy, filterMode);
+				}
+
+				auto quantized = VolumeQuantizer::Quantize(vol.dat, dim, quantParam, errReport);
+				switch (quantParam.format)
+				{
+				case VolumeQuantizer::EFormat::UNorm8:
+					return VolumeTexture::Create(std::move(quantized), dim,
+						GL_UNSIGNED_BYTE, GL_R8, policy, filterMode);
+				case VolumeQuantizer::EFormat::UNorm16:
+					return VolumeTexture::Create(reinterpret_cast<const uint16_t*>(quantized.data()), dim,
+						GL_UNSIGNED_SHORT, GL_R16, policy, filterMode);
+				default:
+					return VolumeTexture::Create(reinterpret_cast<const uint16_t*>(quantized.data()), dim,
+						GL_HALF_FLOAT, GL_R16F, policy, filterMode);
+				}
+			}
+		};
+
+		class SparseVolume
+		{
+		public:
+			/*
+			* 函数: BrickToTexture
+			* 功能: 按需将稀疏体中的一个长方体区域转换为OSG三维纹理，体的其余部分不被展开
+			* 参数:
+			* -- vol: 稀疏体
+			* -- brickMin: 区域的最小角点
+			* -- brickDim: 区域的三维尺寸
+			* -- emptyVal: 无值体素的填充值
+			*/
+			static osg::ref_ptr<osg::Texture3D> BrickToTexture(
+				const SparseVolumeData& vol,
+				const std::array<uint32_t, 3>& brickMin,
+				const std::array<uint32_t, 3>& brickDim,
+				float emptyVal = 0.f,
 				osg::Texture::FilterMode filterMode = osg::Texture::LINEAR)
 			{
-				std::array<uint32_t, 3> dstDim = { 1 << logDstDim[0], 1 << logDstDim[1], 1 << logDstDim[2] };
-				std::array<float, 3> scaleDst2Src = { static_cast<float>(srcDim[0] - 1) / (dstDim[0] - 1),
-										static_cast<float>(srcDim[1] - 1) / (dstDim[1] - 1),
-										static_cast<float>(srcDim[2] - 1) / (dstDim[2] - 1) };
+				auto dense = vol.DensifyBrick(brickMin, brickDim, emptyVal);
 
 				osg::ref_ptr<osg::Image> img = new osg::Image;
-				img->allocateImage(dstDim[0], dstDim[1], dstDim[2], GL_RED, GL_FLOAT);
+				img->allocateImage(brickDim[0], brickDim[1], brickDim[2], GL_RED, GL_FLOAT);
 				img->setInternalTextureFormat(GL_RED);
-				auto* pxPtr = reinterpret_cast<float*>(img->data());
-
-				for (uint32_t z = 0; z < dstDim[2]; ++z)
-					for (uint32_t y = 0; y < dstDim[1]; ++y)
-						for (uint32_t x = 0; x < dstDim[0]; ++x) {
-							auto srcZ = static_cast<uint32_t>(z * scaleDst2Src[2]);
-							auto srcY = static_cast<uint32_t>(y * scaleDst2Src[1]);
-							auto srcX = static_cast<uint32_t>(x * scaleDst2Src[0]);
-							if (srcX >= srcDim[0])
-								srcX = srcDim[0] - 1;
-							if (srcY >= srcDim[1])
-								srcY = srcDim[1] - 1;
-							if (srcZ >= srcDim[2])
-								srcZ = srcDim[2] - 1;
-
-							auto XYZ2Offs = [&](int x, int y, int z) {
-								return static_cast<size_t>(z) * srcDim[1] * srcDim[0] + y * srcDim[0] + x;
-								};
-
-							auto srcX1 = srcX == srcDim[0] - 1 ? srcX : srcX + 1;
-							auto srcY1 = srcY == srcDim[1] - 1 ? srcY : srcY + 1;
-							auto srcZ1 = srcZ == srcDim[2] - 1 ? srcZ : srcZ + 1;
-							if (srcX != 0)
-								--srcX;
-							if (srcY != 0)
-								--srcY;
-							if (srcZ != 0)
-								--srcZ;
-
-							auto avgV = 0.f;
-							uint8_t cnt = 0;
-							for (int subZ = srcZ; subZ <= srcZ1; ++subZ)
-								for (int subY = srcY; subY <= srcY1; ++subY)
-									for (int subX = srcX; subX <= srcX1; ++subX) {
-										avgV += dat[XYZ2Offs(subX, subY, subZ)];
-										++cnt;
-									}
-							avgV /= cnt;
-							*pxPtr = avgV;
-
-							++pxPtr;
-						}
+				std::memcpy(img->data(), dense.data(), sizeof(float) * dense.size());
 
 				osg::ref_ptr<osg::Texture3D> tex = new osg::Texture3D;
 				tex->setFilter(osg::Texture::MAG_FILTER, filterMode);
@@ -1,20 +1,28 @@
 #ifndef SCIVIS_SCALAR_VISER_DIRECT_VOLUME_RENDERER_H
 #define SCIVIS_SCALAR_VISER_DIRECT_VOLUME_RENDERER_H
 
+#include <chrono>
+#include <future>
+#include <memory>
+#include <mutex>
 #include <string>
 
 #include <array>
 #include <map>
+#include <vector>
 
 #include <osg/CullFace>
 #include <osg/CoordinateSystemNode>
+#include <osg/GLExtensions>
 #include <osg/ShapeDrawable>
 #include <osg/Texture1D>
 #include <osg/Texture2D>
 #include <osg/Texture3D>
 
 #include <scivis/common/callback.h>
+#include <scivis/common/vol_tex.h>
 #include <scivis/common/zhongdian15.h>
+#include <scivis/data/vol_time_series.h>
 
 namespace SciVis
 {
@@ -126,6 +134,7 @@ namespace SciVis
 				osg::ref_ptr<osg::Uniform> volStartFromZeroLon;
 				osg::ref_ptr<osg::Uniform> rotMat;
 				osg::ref_ptr<osg::Uniform> dSamplePos;
+				osg::ref_ptr<osg::Uniform> volTexScale;
 
 				osg::ref_ptr<osg::ShapeDrawable> sphere;
 				osg::ref_ptr<osg::Texture3D> volTex;
@@ -168,6 +177,7 @@ namespace SciVis
 							1.f / volDim[0],
 							1.f / volDim[1],
 							1.f / volDim[2]));
+					STATEMENT(volTexScale, VolumeTexture::GetTextureCoordinateScale(volTex));
 #undef STATEMENT
 					states->addUniform(renderer->eyePos);
 					states->addUniform(renderer->dt);
@@ -205,10 +215,31 @@ namespace SciVis
 					states->setRenderingHint(osg::StateSet::TRANSPARENT_BIN);
 				}
 				/*
-				* : SetTransferFunction
-				* : øʱĴ亯
-				* :
-				* -- tfTex: Ĵ亯OSGһά
+				* 函数: SetVolumeTexture
+				* 功能: 替换该体的纹理，如播放时间序列时切换到另一时间步。新纹理对应的体的尺寸应与原来的相同
+				*/
+				void SetVolumeTexture(osg::ref_ptr<osg::Texture3D> volTex)
+				{
+					this->volTex = volTex;
+					auto states = sphere->getOrCreateStateSet();
+					states->setTextureAttributeAndModes(0, this->volTex, osg::StateAttribute::ON);
+					volTexScale->set(VolumeTexture::GetTextureCoordinateScale(volTex));
+				}
+				/*
+				* 函数: SetVolumeTexture
+				* 功能: 替换该体的纹理，新纹理对应的体的尺寸可以与原来的不同，如渐进式加载（见ProgressiveVolumeLoader）时
+				*       由预览级细化到原始分辨率。传入同一个纹理时，只更新采样步长与纹理坐标缩放
+				*/
+				void SetVolumeTexture(osg::ref_ptr<osg::Texture3D> volTex, const std::array<uint32_t, 3>& volDim)
+				{
+					SetVolumeTexture(volTex);
+					dSamplePos->set(osg::Vec3(1.f / volDim[0], 1.f / volDim[1], 1.f / volDim[2]));
+				}
+				/*
+				* 函数: SetTransferFunction
+				* 功能: 设置该体绘制时的传输函数
+				* 参数:
+				* -- tfTex: 体的传输函数的OSG一维纹理
 				*/
 				void SetTransferFunction(osg::ref_ptr<osg::Texture1D> tfTex)
 				{
@@ -223,12 +254,12 @@ namespace SciVis
 					states->setTextureAttributeAndModes(2, this->tfTexPreInt, osg::StateAttribute::ON);
 				}
 				/*
-				* : SetLongtituteRange
-				* : øʱľȷΧλΪǶȣ
-				* :
-				* -- minLonDeg: Сֵ
-				* -- maxLonDeg: ֵ
-				* ֵ: ĲϷfalseóɹtrue
+				* 函数: SetLongtituteRange
+				* 功能: 设置该体绘制时的经度范围（单位为角度）
+				* 参数:
+				* -- minLonDeg: 经度最小值
+				* -- maxLonDeg: 经度最大值
+				* 返回值: 若输入的参数不合法，返回false。若设置成功，返回true
 				*/
 				bool SetLongtituteRange(float minLonDeg, float maxLonDeg)
 				{
@@ -250,12 +281,12 @@ namespace SciVis
 					return ret;
 				}
 				/*
-				* : SetLatituteRange
-				* : øʱγȷΧλΪǶȣ
-				* :
-				* -- minLatDeg: γСֵ
-				* -- maxLatDeg: γֵ
-				* ֵ: ĲϷfalseóɹtrue
+				* 函数: SetLatituteRange
+				* 功能: 设置该体绘制时的纬度范围（单位为角度）
+				* 参数:
+				* -- minLatDeg: 纬度最小值
+				* -- maxLatDeg: 纬度最大值
+				* 返回值: 若输入的参数不合法，返回false。若设置成功，返回true
 				*/
 				bool SetLatituteRange(float minLatDeg, float maxLatDeg)
 				{
@@ -277,12 +308,12 @@ namespace SciVis
 					return ret;
 				}
 				/*
-				* : SetHeightFromCenterRange
-				* : øʱĸ߶ȣģΧ
-				* :
-				* -- minH: ߶Сֵ
-				* -- maxH: ߶ֵ
-				* ֵ: ĲϷfalseóɹtrue
+				* 函数: SetHeightFromCenterRange
+				* 功能: 设置该体绘制时的高度（距球心）范围
+				* 参数:
+				* -- minH: 高度最小值
+				* -- maxH: 高度最大值
+				* 返回值: 若输入的参数不合法，返回false。若设置成功，返回true
 				*/
 				bool SetHeightFromCenterRange(float minH, float maxH)
 				{
@@ -304,10 +335,10 @@ namespace SciVis
 					return ret;
 				}
 				/*
-				* : SetVolumeStartFromLongtituteZero
-				* : ȫX=0ӦľΪ0ȣҪù
-				* :
-				* -- flag: ΪtrueʱùܡΪfalseʱرոù
+				* 函数: SetVolumeStartFromLongtituteZero
+				* 功能: 若全球体数据X=0对应的经度为0度，需要开启该功能
+				* 参数:
+				* -- flag: 为true时，开启该功能。为false时，关闭该功能
 				*/
 				void SetVolumeStartFromLongtituteZero(bool flag)
 				{
@@ -363,28 +394,206 @@ namespace SciVis
 			};
 			std::map<std::string, PerVolParam> vols;
 
+			/*
+			* 类: TimeSeriesSubloadCallback
+			* 功能: 以时间序列方式加入的体的纹理上传。首次应用时上传整个图像，
+			*       之后只以glTexSubImage3D上传切换时间步时改写的Z切片，而不因image的dirty重传整个纹理
+			*/
+			class TimeSeriesSubloadCallback : public osg::Texture3D::SubloadCallback
+			{
+			private:
+				struct Upload
+				{
+					uint32_t zBeg;
+					uint32_t zNum;
+					std::shared_ptr<const std::vector<uint8_t>> dat;
+				};
+
+				osg::ref_ptr<osg::Image> img;
+				mutable std::mutex mtx;
+				mutable std::vector<Upload> pending;
+
+			public:
+				TimeSeriesSubloadCallback(osg::ref_ptr<osg::Image> img)
+					: img(img)
+				{}
+
+				/*
+				* 函数: Push
+				* 功能: 提交Z切片[zBeg, zEnd)的上传，dat为这些切片的数据，在下一次应用纹理时上传
+				*/
+				void Push(uint32_t zBeg, uint32_t zEnd, std::shared_ptr<const std::vector<uint8_t>> dat)
+				{
+					std::lock_guard<std::mutex> lk(mtx);
+					pending.emplace_back();
+					pending.back().zBeg = zBeg;
+					pending.back().zNum = zEnd - zBeg;
+					pending.back().dat = dat;
+				}
+				/*
+				* 函数: PushFromImage
+				* 功能: 同上，数据从纹理的图像中拷贝，使绘制线程不读取正被改写的图像
+				*/
+				void PushFromImage(uint32_t zBeg, uint32_t zEnd)
+				{
+					auto sliceBytes = static_cast<size_t>(img->getRowSizeInBytes()) * img->t();
+					auto beg = img->data() + sliceBytes * zBeg;
+					Push(zBeg, zEnd, std::make_shared<std::vector<uint8_t>>(beg, beg + sliceBytes * (zEnd - zBeg)));
+				}
+
+				virtual void load(const osg::Texture3D& tex, osg::State& state) const override
+				{
+					{
+						std::lock_guard<std::mutex> lk(mtx);
+						pending.clear();
+					}
+					auto ext = state.get<osg::GLExtensions>();
+					glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+					ext->glTexImage3D(GL_TEXTURE_3D, 0, img->getInternalTextureFormat(), img->s(), img->t(), img->r(), 0,
+						img->getPixelFormat(), img->getDataType(), img->data());
+				}
+				virtual void subload(const osg::Texture3D&, osg::State& state) const override
+				{
+					std::vector<Upload> uploads;
+					{
+						std::lock_guard<std::mutex> lk(mtx);
+						uploads.swap(pending);
+					}
+					if (uploads.empty())
+						return;
+
+					auto ext = state.get<osg::GLExtensions>();
+					glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+					for (auto& upload : uploads)
+						ext->glTexSubImage3D(GL_TEXTURE_3D, 0, 0, 0, upload.zBeg, img->s(), img->t(), upload.zNum,
+							img->getPixelFormat(), img->getDataType(), upload.dat->data());
+				}
+			};
+
+			/*
+			* 结构体: TimeSeriesState
+			* 功能: 以时间序列方式加入的体的播放状态。该体只有一个纹理，切换时间步时就地改写纹理的图像，
+			*       并只将改写的部分提交给TimeSeriesSubloadCallback上传：
+			*       -- 目标时间步与当前时间步之间没有关键帧时，只改写发生变化的体素，只上传其所在的Z切片
+			*       -- 否则在后台线程上重建，重建完成前仍显示当前时间步。重建期间的多次切换只保留最后一次
+			*/
+			struct TimeSeriesState
+			{
+				std::shared_ptr<const VolumeTimeSeries> series;
+				osg::ref_ptr<osg::Image> img;
+				osg::ref_ptr<TimeSeriesSubloadCallback> subload;
+				size_t currStep = 0;
+				size_t requestedStep = 0;
+				size_t pendingStep = 0;
+				std::future<std::shared_ptr<std::vector<uint8_t>>> pending;
+
+				void SwitchTo(size_t step)
+				{
+					requestedStep = step;
+					if (pending.valid() || step == currStep)
+						return;
+
+					if (series->CanUpdateIncrementally(currStep, step)) {
+						auto zRng = series->GetChangedSliceRange(currStep, step);
+						series->Update(currStep, step, img->data(), [this](uint8_t* runBeg, size_t voxNum) {
+							toTexels(runBeg, voxNum);
+							});
+						currStep = step;
+						if (zRng[0] != zRng[1])
+							subload->PushFromImage(zRng[0], zRng[1]);
+						return;
+					}
+
+					pendingStep = step;
+					pending = series->ReconstructAsync(step);
+				}
+				/*
+				* 函数: Poll
+				* 功能: 若后台重建已完成，将其写入纹理的图像并提交整体上传，再继续切换到最后一次请求的时间步
+				*/
+				void Poll()
+				{
+					if (!pending.valid()
+						|| pending.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+						return;
+
+					auto dat = pending.get();
+					toTexels(dat->data(), dat->size() / RAWVolumeData::GetVoxelSize(series->GetVoxelType()));
+					std::memcpy(img->data(), dat->data(), dat->size());
+					currStep = pendingStep;
+					subload->Push(0, series->GetVoxelPerVolume()[2], dat);
+					SwitchTo(requestedStep);
+				}
+
+			private:
+				/*
+				* 函数: toTexels
+				* 功能: 将新写入图像的体素转换为纹理数据，见VolumeTexture::ToTexels
+				*/
+				void toTexels(uint8_t* dat, size_t voxNum) const
+				{
+					if (series->GetVoxelType() == ESupportedVoxelType::Int16)
+						VolumeTexture::ToTexels(reinterpret_cast<int16_t*>(dat), voxNum);
+				}
+			};
+			using TimeSeriesStates = std::map<std::string, TimeSeriesState>;
+			std::shared_ptr<TimeSeriesStates> timeSerieses;
+
+			class TimeSeriesCallback : public osg::NodeCallback
+			{
+			private:
+				std::shared_ptr<TimeSeriesStates> timeSerieses;
+
+			public:
+				TimeSeriesCallback(std::shared_ptr<TimeSeriesStates> timeSerieses)
+					: timeSerieses(timeSerieses)
+				{}
+				virtual void operator()(osg::Node* node, osg::NodeVisitor* nv)
+				{
+					for (auto& state : *timeSerieses)
+						state.second.Poll();
+
+					traverse(node, nv);
+				}
+			};
+			// 首次加入时间序列时嵌套到节点已有的更新回调之后，不替换也不被调用者的回调挡住
+			osg::ref_ptr<TimeSeriesCallback> timeSeriesCallback;
+
+			template <ESupportedVoxelType VoxTy>
+			static osg::ref_ptr<osg::Texture3D> createTimeSeriesTexture(
+				const VolumeTimeSeries& series, size_t step)
+			{
+				using Traits = VoxelTypeTraits<VoxTy>;
+
+				std::vector<uint8_t> dat(series.GetStepBytes());
+				series.Reconstruct(step, dat.data());
+				return VolumeTexture::Create(reinterpret_cast<const typename Traits::Type*>(dat.data()),
+					series.GetVoxelPerVolume(), Traits::DataType, Traits::InternalFormat);
+			}
+
 		public:
 			DirectVolumeRenderer()
+				: timeSerieses(std::make_shared<TimeSeriesStates>())
 			{}
 
 			/*
-			* : GetGroup
-			* : ȡûOSGڵ
-			* ֵ: OSGڵ
+			* 函数: GetGroup
+			* 功能: 获取该绘制组件的OSG节点
+			* 返回值: OSG节点
 			*/
 			osg::Group* GetGroup()
 			{
 				return param.grp.get();
 			}
 			/*
-			* : AddVolume
-			* : ûһ
-			* :
-			* -- name: ơͬ費ͬ
-			* -- volTex: OSGά
-			* -- tfTex: Ĵ亯OSGһά
-			* -- volDim: άߴ
-			* -- isDisplayed: Ϊtrueʱ屻ᱻơֻᱻ
+			* 函数: AddVolume
+			* 功能: 向该绘制组件添加一个体
+			* 参数:
+			* -- name: 添加体的名称。不同体的名称需不同，用于区分
+			* -- volTex: 体的OSG三维纹理
+			* -- tfTex: 体的传输函数的OSG一维纹理
+			* -- volDim: 体的三维尺寸
+			* -- isDisplayed: 为true时，体被加入后会被绘制。否则体只被加入绘制组件，但不会被绘制
 			*/
 			void AddVolume(
 				const std::string& name,
@@ -394,6 +603,7 @@ namespace SciVis
 				const std::array<uint32_t, 3>& volDim,
 				bool isDisplayed = true)
 			{
+				timeSerieses->erase(name);
 				auto itr = vols.find(name);
 				if (itr != vols.end() && itr->second.isDisplayed) {
 					param.grp->removeChild(itr->second.sphere);
@@ -409,10 +619,61 @@ namespace SciVis
 					param.grp->addChild(opt.first->second.sphere);
 			}
 			/*
-			* : DisplayVolume
-			* : Ƹûеһ壬λе彫ơһڲ嶯岻ڸʱ嶼ᱻơ
-			* :
-			* -- name: 
+			* 函数: AddTimeSeries
+			* 功能: 向该绘制组件添加一个以时间序列存储的体，初始显示第0个时间步。时间步由DisplayVolume(name, step)切换
+			* 参数:
+			* -- name: 添加体的名称
+			* -- series: 体时间序列，其中至少有一个时间步
+			* -- tfTex: 体的传输函数的OSG一维纹理
+			* -- isDisplayed: 同AddVolume
+			* 返回值: 序列为空，或尚未查询到当前环境支持非2的幂纹理（纹理需与体一一对应以便就地改写，见VolumeTexture::NonPowerOfTwoQuery）时，返回false
+			*/
+			bool AddTimeSeries(
+				const std::string& name,
+				std::shared_ptr<const VolumeTimeSeries> series,
+				osg::ref_ptr<osg::Texture1D> tfTex,
+				osg::ref_ptr<osg::Texture2D> tfTexPreInt,
+				bool isDisplayed = true)
+			{
+				if (!series || series->GetStepNum() == 0
+					|| VolumeTexture::ResolvePolicy(ETextureSizePolicy::Native) != ETextureSizePolicy::Native)
+					return false;
+
+				osg::ref_ptr<osg::Texture3D> volTex;
+				switch (series->GetVoxelType())
+				{
+				case ESupportedVoxelType::UInt8:
+					volTex = createTimeSeriesTexture<ESupportedVoxelType::UInt8>(*series, 0);
+					break;
+				case ESupportedVoxelType::UInt16:
+					volTex = createTimeSeriesTexture<ESupportedVoxelType::UInt16>(*series, 0);
+					break;
+				case ESupportedVoxelType::Int16:
+					volTex = createTimeSeriesTexture<ESupportedVoxelType::Int16>(*series, 0);
+					break;
+				case ESupportedVoxelType::Float32:
+					volTex = createTimeSeriesTexture<ESupportedVoxelType::Float32>(*series, 0);
+					break;
+				}
+				AddVolume(name, volTex, tfTex, tfTexPreInt, series->GetVoxelPerVolume(), isDisplayed);
+
+				auto& state = (*timeSerieses)[name];
+				state.series = series;
+				state.img = volTex->getImage();
+				state.subload = new TimeSeriesSubloadCallback(state.img);
+				volTex->setTextureSize(state.img->s(), state.img->t(), state.img->r());
+				volTex->setSubloadCallback(state.subload);
+				if (!timeSeriesCallback) {
+					timeSeriesCallback = new TimeSeriesCallback(timeSerieses);
+					param.grp->addUpdateCallback(timeSeriesCallback);
+				}
+				return true;
+			}
+			/*
+			* 函数: DisplayVolume
+			* 功能: 绘制该绘制组件中的一个体，位于组件中的其他体将不被绘制。一般用于产生体动画。当输入的体不在该组件中时，所有体都不会被绘制。
+			* 参数:
+			* -- name: 体的名称
 			*/
 			void DisplayVolume(const std::string& name)
 			{
@@ -428,19 +689,44 @@ namespace SciVis
 				}
 			}
 			/*
-			* : GetVolumes
-			* : ȡУڻʱ
+			* 函数: DisplayVolume
+			* 功能: 同上，并将以时间序列存储的体切换到时间步step。需与OSG的更新遍历在同一线程上调用
+			* 参数:
+			* -- name: 由AddTimeSeries添加的体的名称
+			* -- step: 时间步
+			*/
+			void DisplayVolume(const std::string& name, size_t step)
+			{
+				DisplayVolume(name);
+
+				auto itr = timeSerieses->find(name);
+				if (itr == timeSerieses->end() || step >= itr->second.series->GetStepNum())
+					return;
+				itr->second.SwitchTo(step);
+			}
+			/*
+			* 函数: GetDisplayedTimeStep
+			* 功能: 获取以时间序列存储的体当前显示的时间步。后台重建完成前，不同于最后一次请求的时间步
+			*/
+			size_t GetDisplayedTimeStep(const std::string& name) const
+			{
+				auto itr = timeSerieses->find(name);
+				return itr == timeSerieses->end() ? 0 : itr->second.currStep;
+			}
+			/*
+			* 函数: GetVolumes
+			* 功能: 获取该组件中，体在绘制时所需的所有数据
 			*/
 			std::map<std::string, PerVolParam>& GetVolumes()
 			{
 				return vols;
 			}
 			/*
-			* : GetVolume
-			* : ȡУڻʱ
-			* :
-			* -- name: 
-			* ֵ: Ļ
+			* 函数: GetVolume
+			* 功能: 获取该组件中，体在绘制时所需的数据
+			* 参数:
+			* -- name: 体的名称
+			* 返回值: 体的绘制数据
 			*/
 			PerVolParam* GetVolume(const std::string& name)
 			{
@@ -450,19 +736,19 @@ namespace SciVis
 				return &(itr->second);
 			}
 			/*
-			* : GetVolumeNum
-			* : ȡû
-			* ֵ: 
+			* 函数: GetVolumeNum
+			* 功能: 获取该绘制组件中体的数量
+			* 返回值: 体的数量
 			*/
 			size_t GetVolumeNum() const
 			{
 				return vols.size();
 			}
 			/*
-			* : SetDeltaT
-			* : ʱߴĲ
-			* :
-			* -- dt: ߴĲ
+			* 函数: SetDeltaT
+			* 功能: 设置体绘制时，光线传播的步长
+			* 参数:
+			* -- dt: 光线传播的步长
 			*/
 			void SetDeltaT(float dt)
 			{
@@ -475,10 +761,10 @@ namespace SciVis
 				return ret;
 			}
 			/*
-			* : SetMaxStepCount
-			* : ʱߴ
-			* :
-			* -- maxStepCnt: ߴ
+			* 函数: SetMaxStepCount
+			* 功能: 设置体绘制时，光线传播的最大步数
+			* 参数:
+			* -- maxStepCnt: 光线传播的最大步数
 			*/
 			void SetMaxStepCount(int maxStepCnt)
 			{
@@ -491,11 +777,11 @@ namespace SciVis
 				return ret;
 			}
 			/*
-			* : SetSlicing
-			* : е
-			* :
-			* -- cntr: ĵ㣨תʱĲο㣩λֲȡֵΧΪ[0, 1]
-			* -- dir: ĵλλֲ
+			* 函数: SetSlicing
+			* 功能: 设置体绘制中的切面
+			* 参数:
+			* -- cntr: 切面的中心点（旋转时的参考点），位于体局部，三分量取值范围为[0, 1]
+			* -- dir: 切面的单位法向量，位于球局部坐标
 			*/
 			void SetSlicing(const osg::Vec3& cntr, const osg::Vec3& dir)
 			{
@@ -508,18 +794,18 @@ namespace SciVis
 				param.useSlice->set(0);
 			}
 			/*
-			* : SetUsePreIntegratedTF
-			* : ǷʹԤֵĴ亯
+			* 函数: SetUsePreIntegratedTF
+			* 功能: 设置体绘制是否使用预积分的传输函数
 			*/
 			void SetUsePreIntegratedTF(bool use)
 			{
 				param.usePreIntTF->set(use ? 1 : 0);
 			}
 			/*
-			* : SetShading
-			* : еĹɫ
-			* :
-			* -- param: Blinn-Phongɫ
+			* 函数: SetShading
+			* 功能: 设置体绘制中的光照着色参数
+			* 参数:
+			* -- param: Blinn-Phong光照着色参数
 			*/
 			void SetShading(const ShadingParam& param)
 			{
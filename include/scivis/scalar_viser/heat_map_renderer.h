@@ -11,6 +11,7 @@
 #include <osg/Texture1D>
 #include <osg/Texture3D>
 
+#include <scivis/common/vol_tex.h>
 #include <scivis/common/zhongdian15.h>
 
 namespace SciVis
@@ -58,6 +59,7 @@ namespace SciVis
 				osg::ref_ptr<osg::Uniform> maxHeight;
 				osg::ref_ptr<osg::Uniform> height;
 				osg::ref_ptr<osg::Uniform> volStartFromZeroLon;
+				osg::ref_ptr<osg::Uniform> volTexScale;
 
 				osg::ref_ptr<osg::ShapeDrawable> sphere;
 				osg::ref_ptr<osg::Texture3D> volTex;
@@ -87,6 +89,7 @@ namespace SciVis
 					STATEMENT(maxHeight, MaxHeight);
 					STATEMENT(height, .5f * (MinHeight + MaxHeight));
 					STATEMENT(volStartFromZeroLon, 0);
+					STATEMENT(volTexScale, VolumeTexture::GetTextureCoordinateScale(volTex));
 #undef STATEMENT
 
 					states->setTextureAttributeAndModes(0, volTex, osg::StateAttribute::ON);
@@ -107,10 +110,22 @@ namespace SciVis
 					states->setRenderingHint(osg::StateSet::TRANSPARENT_BIN);
 				}
 				/*
-				* : SetColorTable
-				* : øʱɫӳ
-				* :
-				* -- colTblTex: ͼɫӳOSGһά
+				* 函数: SetVolumeTexture
+				* 功能: 替换该体的纹理，新纹理对应的体的尺寸可以与原来的不同，如渐进式加载（见ProgressiveVolumeLoader）时
+				*       由预览级细化到原始分辨率
+				*/
+				void SetVolumeTexture(osg::ref_ptr<osg::Texture3D> volTex)
+				{
+					this->volTex = volTex;
+					auto states = sphere->getOrCreateStateSet();
+					states->setTextureAttributeAndModes(0, this->volTex, osg::StateAttribute::ON);
+					volTexScale->set(VolumeTexture::GetTextureCoordinateScale(volTex));
+				}
+				/*
+				* 函数: SetColorTable
+				* 功能: 设置该体绘制时的颜色映射表
+				* 参数:
+				* -- colTblTex: 热力图颜色映射的OSG一维纹理
 				*/
 				void SetColorTable(osg::ref_ptr<osg::Texture1D> colTblTex)
 				{
@@ -119,12 +134,12 @@ namespace SciVis
 					states->setTextureAttributeAndModes(1, this->colTblTex, osg::StateAttribute::ON);
 				}
 				/*
-				* : SetLongtituteRange
-				* : øʱľȷΧλΪǶȣ
-				* :
-				* -- minLonDeg: Сֵ
-				* -- maxLonDeg: ֵ
-				* ֵ: ĲϷfalseóɹtrue
+				* 函数: SetLongtituteRange
+				* 功能: 设置该体绘制时的经度范围（单位为角度）
+				* 参数:
+				* -- minLonDeg: 经度最小值
+				* -- maxLonDeg: 经度最大值
+				* 返回值: 若输入的参数不合法，返回false。若设置成功，返回true
 				*/
 				bool SetLongtituteRange(float minLonDeg, float maxLonDeg)
 				{
@@ -137,12 +152,12 @@ namespace SciVis
 					return true;
 				}
 				/*
-				* : SetLatituteRange
-				* : øʱγȷΧλΪǶȣ
-				* :
-				* -- minLatDeg: γСֵ
-				* -- maxLatDeg: γֵ
-				* ֵ: ĲϷfalseóɹtrue
+				* 函数: SetLatituteRange
+				* 功能: 设置该体绘制时的纬度范围（单位为角度）
+				* 参数:
+				* -- minLatDeg: 纬度最小值
+				* -- maxLatDeg: 纬度最大值
+				* 返回值: 若输入的参数不合法，返回false。若设置成功，返回true
 				*/
 				bool SetLatituteRange(float minLatDeg, float maxLatDeg)
 				{
@@ -155,12 +170,12 @@ namespace SciVis
 					return true;
 				}
 				/*
-				* : SetHeightFromCenterRange
-				* : øʱĸ߶ȣģΧ
-				* :
-				* -- minH: ߶Сֵ
-				* -- maxH: ߶ֵ
-				* ֵ: ĲϷfalseóɹtrue
+				* 函数: SetHeightFromCenterRange
+				* 功能: 设置该体绘制时的高度（距球心）范围
+				* 参数:
+				* -- minH: 高度最小值
+				* -- maxH: 高度最大值
+				* 返回值: 若输入的参数不合法，返回false。若设置成功，返回true
 				*/
 				bool SetHeightFromCenterRange(float minH, float maxH)
 				{
@@ -183,11 +198,11 @@ namespace SciVis
 					return ret;
 				}
 				/*
-				* : SetHeightFromCenter
-				* : øʱĸ߶ȣģ
-				* :
-				* -- h: ߶
-				* ֵ: ĲϷfalseóɹtrue
+				* 函数: SetHeightFromCenter
+				* 功能: 设置该体绘制时的高度（距球心）
+				* 参数:
+				* -- h: 高度
+				* 返回值: 若输入的参数不合法，返回false。若设置成功，返回true
 				*/
 				bool SetHeightFromCenter(float h)
 				{
@@ -206,10 +221,10 @@ namespace SciVis
 					return ret;
 				}
 				/*
-				* : SetVolumeStartFromLongtituteZero
-				* : ȫX=0ӦľΪ0ȣҪù
-				* :
-				* -- flag: ΪtrueʱùܡΪfalseʱرոù
+				* 函数: SetVolumeStartFromLongtituteZero
+				* 功能: 若全球体数据X=0对应的经度为0度，需要开启该功能
+				* 参数:
+				* -- flag: 为true时，开启该功能。为false时，关闭该功能
 				*/
 				void SetVolumeStartFromLongtituteZero(bool flag)
 				{
@@ -231,18 +246,18 @@ namespace SciVis
 			HeatMap3DRenderer() {}
 
 			/*
-			* : GetGroup
-			* : ȡûOSGڵ
-			* ֵ: OSGڵ
+			* 函数: GetGroup
+			* 功能: 获取该绘制组件的OSG节点
+			* 返回值: OSG节点
 			*/
 			osg::Group* GetGroup() { return param.grp.get(); }
 			/*
-			* : AddVolume
-			* : ûһ
-			* :
-			* -- name: ơͬ費ͬ
-			* -- volTex: OSGά
-			* -- colTblTex: ͼɫӳOSGһά
+			* 函数: AddVolume
+			* 功能: 向该绘制组件添加一个体
+			* 参数:
+			* -- name: 添加体的名称。不同体的名称需不同，用于区分
+			* -- volTex: 体的OSG三维纹理
+			* -- colTblTex: 热力图颜色映射的OSG一维纹理
 			*/
 			void AddVolume(const std::string& name, osg::ref_ptr<osg::Texture3D> volTex,
 				osg::ref_ptr<osg::Texture1D> colTblTex)
@@ -259,19 +274,19 @@ namespace SciVis
 				param.grp->addChild(opt.first->second.sphere);
 			}
 			/*
-			* : GetVolumes
-			* : ȡУڻʱ
+			* 函数: GetVolumes
+			* 功能: 获取该组件中，体在绘制时所需的所有数据
 			*/
 			std::map<std::string, PerVolParam>& GetVolumes()
 			{
 				return vols;
 			}
 			/*
-			* : GetVolume
-			* : ȡУڻʱ
-			* :
-			* -- name: 
-			* ֵ: Ļ
+			* 函数: GetVolume
+			* 功能: 获取该组件中，体在绘制时所需的数据
+			* 参数:
+			* -- name: 体的名称
+			* 返回值: 体的绘制数据
 			*/
 			PerVolParam* GetVolume(const std::string& name)
 			{
@@ -281,9 +296,9 @@ namespace SciVis
 				return &(itr->second);
 			}
 			/*
-			* : GetVolumeNum
-			* : ȡû
-			* ֵ: 
+			* 函数: GetVolumeNum
+			* 功能: 获取该绘制组件中体的数量
+			* 返回值: 体的数量
 			*/
 			size_t GetVolumeNum() const
 			{
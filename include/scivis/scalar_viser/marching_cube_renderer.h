@@ -19,6 +19,9 @@
 
 #include <scivis/common/callback.h>
 #include <scivis/common/zhongdian15.h>
+#include <scivis/data/smoothed_vol_cache.h>
+#include <scivis/data/vol_stats.h>
+#include <scivis/data/vol_view.h>
 
 #include "marching_cube_table.h"
 #include <cassert>
@@ -121,8 +124,12 @@ namespace SciVis
 				bool useSmoothedVol;
 				MeshSmoothingType meshSmoothingType;
 
-				std::shared_ptr<std::vector<float>> volDat;
-				std::shared_ptr<std::vector<float>> volDatSmoothed;
+				VolumeView<float> volDat;
+				std::shared_ptr<const void> volOwner;
+				VolumeSmoother::Parameters smoothParam;
+				// 原始体与平滑体的分块极值，等值改变时无需重新统计
+				VolumeStatisticsCache volStats;
+				VolumeStatisticsCache smoothedVolStats;
 
 				osg::ref_ptr<osg::Geometry> geom;
 				osg::ref_ptr<osg::Geode> geode;
@@ -136,11 +143,11 @@ namespace SciVis
 
 			public:
 				PerVolParam(
-					decltype(volDat) volDat,
-					decltype(volDat) volDatSmoothed,
-					const std::array<uint32_t, 3>& volDim,
+					const VolumeView<float>& volDat,
+					std::shared_ptr<const void> volOwner,
+					const VolumeSmoother::Parameters& smoothParam,
 					PerRendererParam* renderer)
-					: volDat(volDat), volDatSmoothed(volDatSmoothed), volDim(volDim),
+					: volDat(volDat), volOwner(volOwner), smoothParam(smoothParam), volDim(volDat.dim),
 					meshSmoothingType(MeshSmoothingType::None)
 				{
 					const auto MinHeight = static_cast<float>(osg::WGS_84_RADIUS_EQUATOR) * 1.1f;
@@ -178,12 +185,12 @@ namespace SciVis
 					states->setAttributeAndModes(renderer->program, osg::StateAttribute::ON);
 				}
 				/*
-				* : SetLongtituteRange
-				* : øʱľȷΧλΪǶȣ
-				* :
-				* -- minLonDeg: Сֵ
-				* -- maxLonDeg: ֵ
-				* ֵ: ĲϷfalseóɹtrue
+				* 函数: SetLongtituteRange
+				* 功能: 设置该体绘制时的经度范围（单位为角度）
+				* 参数:
+				* -- minLonDeg: 经度最小值
+				* -- maxLonDeg: 经度最大值
+				* 返回值: 若输入的参数不合法，返回false。若设置成功，返回true
 				*/
 				bool SetLongtituteRange(float minLonDeg, float maxLonDeg)
 				{
@@ -201,12 +208,12 @@ namespace SciVis
 					return ret;
 				}
 				/*
-				* : SetLatituteRange
-				* : øʱγȷΧλΪǶȣ
-				* :
-				* -- minLatDeg: γСֵ
-				* -- maxLatDeg: γֵ
-				* ֵ: ĲϷfalseóɹtrue
+				* 函数: SetLatituteRange
+				* 功能: 设置该体绘制时的纬度范围（单位为角度）
+				* 参数:
+				* -- minLatDeg: 纬度最小值
+				* -- maxLatDeg: 纬度最大值
+				* 返回值: 若输入的参数不合法，返回false。若设置成功，返回true
 				*/
 				bool SetLatituteRange(float minLatDeg, float maxLatDeg)
 				{
@@ -224,12 +231,12 @@ namespace SciVis
 					return ret;
 				}
 				/*
-				* : SetHeightFromCenterRange
-				* : øʱĸ߶ȣģΧ
-				* :
-				* -- minH: ߶Сֵ
-				* -- maxH: ߶ֵ
-				* ֵ: ĲϷfalseóɹtrue
+				* 函数: SetHeightFromCenterRange
+				* 功能: 设置该体绘制时的高度（距球心）范围
+				* 参数:
+				* -- minH: 高度最小值
+				* -- maxH: 高度最大值
+				* 返回值: 若输入的参数不合法，返回false。若设置成功，返回true
 				*/
 				bool SetHeightFromCenterRange(float minH, float maxH)
 				{
@@ -246,21 +253,21 @@ namespace SciVis
 					return ret;
 				}
 				/*
-				* : SetVolumeStartFromLongtituteZero
-				* : ȫX=0ӦľΪ0ȣҪù
-				* :
-				* -- flag: ΪtrueʱùܡΪfalseʱرոù
+				* 函数: SetVolumeStartFromLongtituteZero
+				* 功能: 若全球体数据X=0对应的经度为0度，需要开启该功能
+				* 参数:
+				* -- flag: 为true时，开启该功能。为false时，关闭该功能
 				*/
 				void SetVolumeStartFromLongtituteZero(bool flag)
 				{
 					volStartFromLonZero = flag;
 				}
 				/*
-				* : MarchingCube
-				* : CPUִMarching Cube㷨ֵ
-				* :
-				* -- isoVal: ֵݵıֵ
-				* -- useSmoothedVol: Ϊtrueʱʹƽ
+				* 函数: MarchingCube
+				* 功能: 在CPU端执行Marching Cube算法，产生等值面
+				* 参数:
+				* -- isoVal: 产生等值面依据的标量值
+				* -- useSmoothedVol: 为true时，使用平滑的体数据。平滑体在首次使用时计算，并由SmoothedVolumeCache缓存
 				*/
 				void MarchingCube(float isoVal, bool useSmoothedVol = false)
 				{
@@ -270,12 +277,27 @@ namespace SciVis
 					this->isoVal = isoVal;
 					this->useSmoothedVol = useSmoothedVol;
 
-					auto volDimYxX = static_cast<size_t>(volDim[1]) * volDim[0];
+					// 仅在生成等值面期间持有平滑体，使缓存可以在内存预算不足时将其释放
+					auto volDatSmoothed = useSmoothedVol ?
+						SmoothedVolumeCache::Instance().Get(volDat, volOwner, smoothParam) : nullptr;
+					auto volDatUsed = useSmoothedVol ? VolumeView<float>(*volDatSmoothed, volDim) : volDat;
+
 					auto sample = [&](const osg::Vec3i& pos) -> float {
-						auto i = pos.z() * volDimYxX + pos.y() * volDim[0] + pos.x();
-						if (useSmoothedVol)
-							return (*volDatSmoothed)[i];
-						return (*volDat)[i];
+						return volDatUsed(pos.x(), pos.y(), pos.z());
+						};
+
+					// 砖块的极值包含其后相邻砖块，因此覆盖以砖块内体素为起点的所有单元。
+					// 极值表明单元的角点全部低于或全部不低于等值时，单元不产生三角形，可整块跳过
+					const uint32_t BrickLen = 8;
+					VolumeStatistics::Parameters statsParam;
+					statsParam.binNum = 0;
+					statsParam.brickLen = BrickLen;
+					statsParam.brickApron = true;
+					auto stats = (useSmoothedVol ? smoothedVolStats : volStats).Get(volDatUsed, statsParam);
+					auto hasNaN = stats->validNum != volDatUsed.GetVoxelNum(); // NaN角点被视作低于等值
+					auto canSkipBrick = [&](const osg::Vec3i& pos) -> bool {
+						const auto& rng = stats->GetBrickRange(pos.x() / BrickLen, pos.y() / BrickLen, pos.z() / BrickLen);
+						return rng[1] < isoVal || (!hasNaN && rng[0] >= isoVal);
 						};
 					auto vec3ToSphere = [&](const osg::Vec3& v3) -> osg::Vec3 {
 						float dlt = maxLongtitute - minLongtitute;
@@ -323,6 +345,11 @@ namespace SciVis
 
 						for (startPos.y() = 0; startPos.y() < volDim[1] - 1; ++startPos.y())
 							for (startPos.x() = 0; startPos.x() < volDim[0] - 1; ++startPos.x()) {
+								if (startPos.x() % BrickLen == 0 && canSkipBrick(startPos)) {
+									startPos.x() += BrickLen - 1;
+									continue;
+								}
+
 								// Voxels in CCW order form a grid
 								// +-----------------+
 								// |       3 <--- 2  |
@@ -580,26 +607,46 @@ namespace SciVis
 			MarchingCubeRenderer() {}
 
 			/*
-			* : GetGroup
-			* : ȡûOSGڵ
-			* ֵ: OSGڵ
+			* 函数: GetGroup
+			* 功能: 获取该绘制组件的OSG节点
+			* 返回值: OSG节点
 			*/
 			osg::Group* GetGroup() { return param.grp.get(); }
 			/*
-			* : AddVolume
-			* : ûһ
-			* :
-			* -- name: ơͬ費ͬ
-			* -- volDat: ݣ谴Z-Y-X˳
-			* -- volDatSmoothed: ⻬
-			* -- dim: ݵάߴ磨XYZ˳
+			* 函数: AddVolume
+			* 功能: 向该绘制组件添加一个体
+			* 参数:
+			* -- name: 添加体的名称。不同体的名称需不同，用于区分
+			* -- volDat: 体数据，需按Z-Y-X的顺序存放体素
+			* -- dim: 体数据的三维尺寸（XYZ顺序）
+			* -- smoothParam: 需要平滑的体数据时，所用的滤波参数
 			*/
 			void AddVolume(
 				const std::string& name,
 				std::shared_ptr<std::vector<float>> volDat,
-				std::shared_ptr<std::vector<float>> volDatSmoothed,
-				const std::array<uint32_t, 3>& volDim)
+				const std::array<uint32_t, 3>& volDim,
+				const VolumeSmoother::Parameters& smoothParam = VolumeSmoother::Parameters())
+			{
+				AddVolume(name, VolumeView<float>(*volDat, volDim), smoothParam, volDat);
+			}
+			/*
+			* 函数: AddVolume
+			* 功能: 以体视图向该绘制组件添加一个体，不拷贝体数据。视图可以是切片、裁剪出的子体或时间序列中的某一步
+			* 参数:
+			* -- name: 添加体的名称。不同体的名称需不同，用于区分
+			* -- volDat: 体视图
+			* -- smoothParam: 需要平滑的体数据时，所用的滤波参数
+			* -- volOwner: 视图数据的持有者，组件持有它直到体被移除。为空时，调用者需保证数据在体被移除前有效
+			*/
+			void AddVolume(
+				const std::string& name,
+				const VolumeView<float>& volDat,
+				const VolumeSmoother::Parameters& smoothParam = VolumeSmoother::Parameters(),
+				std::shared_ptr<const void> volOwner = nullptr)
 			{
+				if (!volOwner)
+					volOwner = std::make_shared<char>(); // 仅作为平滑体缓存的键，随体的移除而失效
+
 				auto itr = vols.find(name);
 				if (itr != vols.end()) {
 					param.grp->removeChild(itr->second.geode);
@@ -608,23 +655,23 @@ namespace SciVis
 				auto opt = vols.emplace(
 					std::piecewise_construct,
 					std::forward_as_tuple(name),
-					std::forward_as_tuple(volDat, volDatSmoothed, volDim, &param));
+					std::forward_as_tuple(volDat, volOwner, smoothParam, &param));
 				param.grp->addChild(opt.first->second.geode);
 			}
 			/*
-			* : GetVolumes
-			* : ȡУڻʱ
+			* 函数: GetVolumes
+			* 功能: 获取该组件中，体在绘制时所需的所有数据
 			*/
 			std::map<std::string, PerVolParam>& GetVolumes()
 			{
 				return vols;
 			}
 			/*
-			* : GetVolume
-			* : ȡУڻʱ
-			* :
-			* -- name: 
-			* ֵ: Ļ
+			* 函数: GetVolume
+			* 功能: 获取该组件中，体在绘制时所需的数据
+			* 参数:
+			* -- name: 体的名称
+			* 返回值: 体的绘制数据
 			*/
 			PerVolParam* GetVolume(const std::string& name)
 			{
@@ -634,19 +681,19 @@ namespace SciVis
 				return &(itr->second);
 			}
 			/*
-			* : GetVolumeNum
-			* : ȡû
-			* ֵ: 
+			* 函数: GetVolumeNum
+			* 功能: 获取该绘制组件中体的数量
+			* 返回值: 体的数量
 			*/
 			size_t GetVolumeNum() const
 			{
 				return vols.size();
 			}
 			/*
-			* : SetShading
-			* : ûеĹɫ
-			* :
-			* -- param: Blinn-Phongɫ
+			* 函数: SetShading
+			* 功能: 设置绘制中的光照着色参数
+			* 参数:
+			* -- param: Blinn-Phong光照着色参数
 			*/
 			void SetShading(const ShadingParam& param)
 			{
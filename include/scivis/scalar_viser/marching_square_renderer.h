@@ -17,6 +17,8 @@
 #include <osg/Texture3D>
 
 #include <scivis/common/zhongdian15.h>
+#include <scivis/data/smoothed_vol_cache.h>
+#include <scivis/data/vol_view.h>
 
 namespace SciVis
 {
@@ -70,8 +72,9 @@ namespace SciVis
 				osg::ref_ptr<osg::Uniform> maxHeightUni;
 				osg::ref_ptr<osg::Uniform> volStartFromLonZeroUni;
 
-				std::shared_ptr<std::vector<float>> volDat;
-				std::shared_ptr<std::vector<float>> volDatSmoothed;
+				VolumeView<float> volDat;
+				std::shared_ptr<const void> volOwner;
+				VolumeSmoother::Parameters smoothParam;
 
 				osg::ref_ptr<osg::Geometry> geom;
 				osg::ref_ptr<osg::Geode> geode;
@@ -81,11 +84,11 @@ namespace SciVis
 
 			public:
 				PerVolParam(
-					decltype(volDat) volDat,
-					decltype(volDat) volDatSmoothed,
-					const std::array<uint32_t, 3>& volDim,
+					const VolumeView<float>& volDat,
+					std::shared_ptr<const void> volOwner,
+					const VolumeSmoother::Parameters& smoothParam,
 					PerRendererParam* renderer)
-					: volDat(volDat), volDatSmoothed(volDatSmoothed), volDim(volDim)
+					: volDat(volDat), volOwner(volOwner), smoothParam(smoothParam), volDim(volDat.dim)
 				{
 					const auto MinHeight = static_cast<float>(osg::WGS_84_RADIUS_EQUATOR) * 1.1f;
 					const auto MaxHeight = static_cast<float>(osg::WGS_84_RADIUS_EQUATOR) * 1.3f;
@@ -126,12 +129,12 @@ namespace SciVis
 					states->setAttributeAndModes(renderer->program, osg::StateAttribute::ON);
 				}
 				/*
-				* : SetLongtituteRange
-				* : øʱľȷΧλΪǶȣ
-				* :
-				* -- minLonDeg: Сֵ
-				* -- maxLonDeg: ֵ
-				* ֵ: ĲϷfalseóɹtrue
+				* 函数: SetLongtituteRange
+				* 功能: 设置该体绘制时的经度范围（单位为角度）
+				* 参数:
+				* -- minLonDeg: 经度最小值
+				* -- maxLonDeg: 经度最大值
+				* 返回值: 若输入的参数不合法，返回false。若设置成功，返回true
 				*/
 				bool SetLongtituteRange(float minLonDeg, float maxLonDeg)
 				{
@@ -146,12 +149,12 @@ namespace SciVis
 					return true;
 				}
 				/*
-				* : SetLatituteRange
-				* : øʱγȷΧλΪǶȣ
-				* :
-				* -- minLatDeg: γСֵ
-				* -- maxLatDeg: γֵ
-				* ֵ: ĲϷfalseóɹtrue
+				* 函数: SetLatituteRange
+				* 功能: 设置该体绘制时的纬度范围（单位为角度）
+				* 参数:
+				* -- minLatDeg: 纬度最小值
+				* -- maxLatDeg: 纬度最大值
+				* 返回值: 若输入的参数不合法，返回false。若设置成功，返回true
 				*/
 				bool SetLatituteRange(float minLatDeg, float maxLatDeg)
 				{
@@ -166,12 +169,12 @@ namespace SciVis
 					return true;
 				}
 				/*
-				* : SetHeightFromCenterRange
-				* : øʱĸ߶ȣģΧ
-				* :
-				* -- minH: ߶Сֵ
-				* -- maxH: ߶ֵ
-				* ֵ: ĲϷfalseóɹtrue
+				* 函数: SetHeightFromCenterRange
+				* 功能: 设置该体绘制时的高度（距球心）范围
+				* 参数:
+				* -- minH: 高度最小值
+				* -- maxH: 高度最大值
+				* 返回值: 若输入的参数不合法，返回false。若设置成功，返回true
 				*/
 				bool SetHeightFromCenterRange(float minH, float maxH)
 				{
@@ -185,10 +188,10 @@ namespace SciVis
 					return true;
 				}
 				/*
-				* : SetVolumeStartFromLongtituteZero
-				* : ȫX=0ӦľΪ0ȣҪù
-				* :
-				* -- flag: ΪtrueʱùܡΪfalseʱرոù
+				* 函数: SetVolumeStartFromLongtituteZero
+				* 功能: 若全球体数据X=0对应的经度为0度，需要开启该功能
+				* 参数:
+				* -- flag: 为true时，开启该功能。为false时，关闭该功能
 				*/
 				void SetVolumeStartFromLongtituteZero(bool flag)
 				{
@@ -197,12 +200,12 @@ namespace SciVis
 					else volStartFromLonZeroUni->set(0);
 				}
 				/*
-				* : MarchingSquare
-				* : CPUִMarching Square㷨ֵ
-				* :
-				* -- isoVal: ֵݵıֵ
-				* -- heights: Ҫֵߵĸ߶ȣΧΪ[0, VolDim.z - 1]
-				* -- useSmoothedVol: Ϊtrueʱʹƽ
+				* 函数: MarchingSquare
+				* 功能: 在CPU端执行Marching Square算法，产生等值线
+				* 参数:
+				* -- isoVal: 产生等值线依据的标量值
+				* -- heights: 需要产生等值线的面的高度，范围为[0, VolDim.z - 1]
+				* -- useSmoothedVol: 为true时，使用平滑的体数据。平滑体在首次使用时计算，并由SmoothedVolumeCache缓存
 				*/
 				void MarchingSquare(
 					float isoVal,
@@ -211,7 +214,10 @@ namespace SciVis
 				{
 					this->isoVal = isoVal;
 
-					auto volDimYxX = static_cast<size_t>(volDim[1]) * volDim[0];
+					auto volDatSmoothed = useSmoothedVol ?
+						SmoothedVolumeCache::Instance().Get(volDat, volOwner, smoothParam) : nullptr;
+					auto volDatUsed = useSmoothedVol ? VolumeView<float>(*volDatSmoothed, volDim) : volDat;
+
 					auto vec2ToSphere = [&](const osg::Vec3& v3) -> osg::Vec3 {
 						float dlt = maxLongtitute - minLongtitute;
 						float x = volStartFromLonZero == 0 ? v3.x() :
@@ -295,14 +301,11 @@ namespace SciVis
 								// |  0 ---> 1  |
 								// +------------+
 								uint8_t cornerState = 0;
-								auto surfStart =
-									(useSmoothedVol ? volDatSmoothed->data() : volDat->data())
-									+ pos.z() * volDimYxX;
 								osg::Vec4 scalars(
-									surfStart[pos.y() * volDim[0] + pos.x()],
-									surfStart[pos.y() * volDim[0] + pos.x() + 1],
-									surfStart[(pos.y() + 1) * volDim[0] + pos.x() + 1],
-									surfStart[(pos.y() + 1) * volDim[0] + pos.x()]
+									volDatUsed(pos.x(), pos.y(), pos.z()),
+									volDatUsed(pos.x() + 1, pos.y(), pos.z()),
+									volDatUsed(pos.x() + 1, pos.y() + 1, pos.z()),
+									volDatUsed(pos.x(), pos.y() + 1, pos.z())
 								);
 								for (uint8_t i = 0; i < 4; ++i)
 									if (scalars[i] >= isoVal)
@@ -382,26 +385,46 @@ namespace SciVis
 			MarchingSquareCPURenderer() {}
 
 			/*
-			* : GetGroup
-			* : ȡûOSGڵ
-			* ֵ: OSGڵ
+			* 函数: GetGroup
+			* 功能: 获取该绘制组件的OSG节点
+			* 返回值: OSG节点
 			*/
 			osg::Group* GetGroup() { return param.grp.get(); }
 			/*
-			* : AddVolume
-			* : ûһ
-			* :
-			* -- name: ơͬ費ͬ
-			* -- volDat: ݣ谴Z-Y-X˳
-			* -- volDatSmoothed: ⻬
-			* -- dim: ݵάߴ磨XYZ˳
+			* 函数: AddVolume
+			* 功能: 向该绘制组件添加一个体
+			* 参数:
+			* -- name: 添加体的名称。不同体的名称需不同，用于区分
+			* -- volDat: 体数据，需按Z-Y-X的顺序存放体素
+			* -- dim: 体数据的三维尺寸（XYZ顺序）
+			* -- smoothParam: 需要平滑的体数据时，所用的滤波参数
 			*/
 			void AddVolume(
 				const std::string& name,
 				std::shared_ptr<std::vector<float>> volDat,
-				std::shared_ptr<std::vector<float>> volDatSmoothed,
-				const std::array<uint32_t, 3>& volDim)
+				const std::array<uint32_t, 3>& volDim,
+				const VolumeSmoother::Parameters& smoothParam = VolumeSmoother::Parameters())
+			{
+				AddVolume(name, VolumeView<float>(*volDat, volDim), smoothParam, volDat);
+			}
+			/*
+			* 函数: AddVolume
+			* 功能: 以体视图向该绘制组件添加一个体，不拷贝体数据
+			* 参数:
+			* -- name: 添加体的名称。不同体的名称需不同，用于区分
+			* -- volDat: 体视图
+			* -- smoothParam: 需要平滑的体数据时，所用的滤波参数
+			* -- volOwner: 视图数据的持有者，组件持有它直到体被移除。为空时，调用者需保证数据在体被移除前有效
+			*/
+			void AddVolume(
+				const std::string& name,
+				const VolumeView<float>& volDat,
+				const VolumeSmoother::Parameters& smoothParam = VolumeSmoother::Parameters(),
+				std::shared_ptr<const void> volOwner = nullptr)
 			{
+				if (!volOwner)
+					volOwner = std::make_shared<char>(); // 仅作为平滑体缓存的键，随体的移除而失效
+
 				auto itr = vols.find(name);
 				if (itr != vols.end()) {
 					param.grp->removeChild(itr->second.geode);
@@ -410,23 +433,23 @@ namespace SciVis
 				auto opt = vols.emplace(
 					std::piecewise_construct,
 					std::forward_as_tuple(name),
-					std::forward_as_tuple(volDat, volDatSmoothed, volDim, &param));
+					std::forward_as_tuple(volDat, volOwner, smoothParam, &param));
 				param.grp->addChild(opt.first->second.geode);
 			}
 			/*
-			* : GetVolumes
-			* : ȡУڻʱ
+			* 函数: GetVolumes
+			* 功能: 获取该组件中，体在绘制时所需的所有数据
 			*/
 			std::map<std::string, PerVolParam>& GetVolumes()
 			{
 				return vols;
 			}
 			/*
-			* : GetVolume
-			* : ȡУڻʱ
-			* :
-			* -- name: 
-			* ֵ: Ļ
+			* 函数: GetVolume
+			* 功能: 获取该组件中，体在绘制时所需的数据
+			* 参数:
+			* -- name: 体的名称
+			* 返回值: 体的绘制数据
 			*/
 			PerVolParam* GetVolume(const std::string& name)
 			{
@@ -436,9 +459,9 @@ namespace SciVis
 				return &(itr->second);
 			}
 			/*
-			* : GetVolumeNum
-			* : ȡû
-			* ֵ: 
+			* 函数: GetVolumeNum
+			* 功能: 获取该绘制组件中体的数量
+			* 返回值: 体的数量
 			*/
 			size_t GetVolumeNum() const
 			{
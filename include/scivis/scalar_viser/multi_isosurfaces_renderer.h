@@ -1,10 +1,12 @@
 #ifndef SCIVIS_SCALAR_VISER_MULTI_ISOSURFACES_RENDERER
 #define SCIVIS_SCALAR_VISER_MULTI_ISOSURFACES_RENDERER
 
+#include <memory>
 #include <string>
 
 #include <array>
 #include <map>
+#include <vector>
 
 #include <osg/CullFace>
 #include <osg/CoordinateSystemNode>
@@ -14,6 +16,9 @@
 
 #include <scivis/common/callback.h>
 #include <scivis/common/zhongdian15.h>
+#include <scivis/data/smoothed_vol_cache.h>
+#include <scivis/data/vol_view.h>
+#include <scivis/io/vol_osg_io.h>
 
 namespace SciVis
 {
@@ -134,6 +139,7 @@ namespace SciVis
 				osg::ref_ptr<osg::Uniform> volStartFromZeroLon;
 				osg::ref_ptr<osg::Uniform> rotMat;
 				osg::ref_ptr<osg::Uniform> dSamplePos;
+				osg::ref_ptr<osg::Uniform> volTexScale;
 
 				osg::ref_ptr<osg::Uniform> isosurfNum;
 				osg::ref_ptr<osg::Uniform> sortedIsoVals;
@@ -143,16 +149,23 @@ namespace SciVis
 				osg::ref_ptr<osg::ShapeDrawable> sphere;
 				osg::ref_ptr<osg::ShapeDrawable> selectSphere;
 				osg::ref_ptr<osg::Texture3D> volTex;
-				osg::ref_ptr<osg::Texture3D> volTexSmoothed;
+				osg::ref_ptr<osg::Texture3D> volTexSmoothed; // 首次使用平滑体时才创建
+
+				VolumeView<float> volDat;
+				std::shared_ptr<const void> volOwner;
+				VolumeSmoother::Parameters smoothParam;
+				std::array<uint32_t, 3> volDim;
 
 			public:
 				PerVolParam(
 					osg::ref_ptr<osg::Texture3D> volTex,
-					osg::ref_ptr<osg::Texture3D> volTexSmoothed,
+					const VolumeView<float>& volDat,
+					std::shared_ptr<const void> volOwner,
+					const VolumeSmoother::Parameters& smoothParam,
 					const std::vector<std::tuple<float, std::array<float, 4>>>& sortedIsosurfs,
 					const std::array<uint32_t, 3>& volDim,
 					PerRendererParam* renderer)
-					: volTex(volTex), volTexSmoothed(volTexSmoothed)
+					: volTex(volTex), volDat(volDat), volOwner(volOwner), smoothParam(smoothParam), volDim(volDim)
 				{
 					const auto MinHeight = static_cast<float>(osg::WGS_84_RADIUS_EQUATOR) * 1.1f;
 					const auto MaxHeight = static_cast<float>(osg::WGS_84_RADIUS_EQUATOR) * 1.3f;
@@ -180,6 +193,7 @@ namespace SciVis
 							1.f / volDim[0],
 							1.f / volDim[1],
 							1.f / volDim[2]));
+					STATEMENT(volTexScale, VolumeTexture::GetTextureCoordinateScale(volTex));
 
 					auto volTexUni = new osg::Uniform(osg::Uniform::SAMPLER_3D, "volTex");
 					volTexUni->set(0);
@@ -222,6 +236,7 @@ namespace SciVis
 
 						states->setTextureAttributeAndModes(0, volTex, osg::StateAttribute::ON);
 						states->addUniform(volTexUni);
+						states->addUniform(volTexScale);
 
 						osg::ref_ptr<osg::CullFace> cf = new osg::CullFace(osg::CullFace::BACK);
 						states->setAttributeAndModes(cf);
@@ -239,10 +254,10 @@ namespace SciVis
 					initStates(selectSphere->getOrCreateStateSet(), true);
 				}
 				/*
-				* : SetIsosurfaces
-				* : øʱĶֵ
-				* :
-				* -- sortedIsosurfs: ֵĲֵɫԪصȡֵΧΪ[0,1]ֵͬ谴ֵķǽ
+				* 函数: SetIsosurfaces
+				* 功能: 设置该体绘制时的多个等值面
+				* 参数:
+				* -- sortedIsosurfs: 多等值面的参数，包括值和颜色，所有元素的取值范围均为[0,1]。不同等值面需按值的非降序排序
 				*/
 				void SetIsosurfaces(const std::vector<std::tuple<float, std::array<float, 4>>>& sortedIsosurfs)
 				{
@@ -280,11 +295,11 @@ namespace SciVis
 					return ret;
 				}
 				/*
-				* : SelectIsosurface
-				* : ѡһֵ沢ͻʾ
-				* :
-				* -- isoVal: ֵֵ
-				* -- eps: ֵݲ
+				* 函数: SelectIsosurface
+				* 功能: 选择一个等值面并突出显示
+				* 参数:
+				* -- isoVal: 等值面的值
+				* -- eps: 值的容差
 				*/
 				void SelectIsosurface(float isoVal, float eps = 1.f / 255.f)
 				{
@@ -304,13 +319,43 @@ namespace SciVis
 					selectedIsosurfIdx->set(-1);
 				}
 				/*
-				* : SetUseSmoothedVolume
-				* : Ƿʹƽ
-				* :
-				* -- useSmoothedVol: Ϊʱʹƽ
+				* 函数: SetUseSmoothedVolume
+				* 功能: 设置是否使用平滑体数据
+				* 参数:
+				* -- useSmoothedVol: 为真时，使用平滑体数据。平滑体纹理在首次使用时，由SmoothedVolumeCache中的平滑体创建，
+				*    其尺寸与过滤方式与原纹理一致
 				*/
 				void SetUseSmoothedVolume(bool useSmoothedVol)
 				{
+					if (useSmoothedVol && !volTexSmoothed.valid()) {
+						if (volDat.IsEmpty()) return;
+
+						auto volDatSmoothed = SmoothedVolumeCache::Instance().Get(volDat, volOwner, smoothParam);
+						// 平滑体纹理与原纹理采用相同的尺寸策略，使二者共用volTexScale
+						auto* img = volTex->getImage();
+						auto scale = VolumeTexture::GetTextureCoordinateScale(volTex);
+						auto filter = volTex->getFilter(osg::Texture::MIN_FILTER);
+						if (static_cast<uint32_t>(img->s()) == volDim[0] && static_cast<uint32_t>(img->t()) == volDim[1]
+							&& static_cast<uint32_t>(img->r()) == volDim[2])
+							volTexSmoothed = OSGConvertor::RAWVolume::NormalizedFloatToNativeTexture(
+								*volDatSmoothed, volDim, ETextureSizePolicy::Native, filter);
+						else if (scale != osg::Vec3(1.f, 1.f, 1.f))
+							volTexSmoothed = OSGConvertor::RAWVolume::NormalizedFloatToNativeTexture(
+								*volDatSmoothed, volDim, ETextureSizePolicy::PadToPowerOfTwo, filter);
+						else {
+							auto log2 = [](int len) {
+								uint8_t ret = 0;
+								while ((1 << (ret + 1)) <= len)
+									++ret;
+								return ret;
+							};
+							volTexSmoothed = OSGConvertor::RAWVolume::NormalizedFloatToTexture(
+								*volDatSmoothed, volDim,
+								std::array<uint8_t, 3>{ log2(img->s()), log2(img->t()), log2(img->r()) },
+								filter);
+						}
+					}
+
 					auto set = [&](osg::StateSet* states) {
 						if (useSmoothedVol)
 							states->setTextureAttributeAndModes(0, volTexSmoothed, osg::StateAttribute::ON);
@@ -321,12 +366,12 @@ namespace SciVis
 					set(selectSphere->getOrCreateStateSet());
 				}
 				/*
-				* : SetLongtituteRange
-				* : øʱľȷΧλΪǶȣ
-				* :
-				* -- minLonDeg: Сֵ
-				* -- maxLonDeg: ֵ
-				* ֵ: ĲϷfalseóɹtrue
+				* 函数: SetLongtituteRange
+				* 功能: 设置该体绘制时的经度范围（单位为角度）
+				* 参数:
+				* -- minLonDeg: 经度最小值
+				* -- maxLonDeg: 经度最大值
+				* 返回值: 若输入的参数不合法，返回false。若设置成功，返回true
 				*/
 				bool SetLongtituteRange(float minLonDeg, float maxLonDeg)
 				{
@@ -348,12 +393,12 @@ namespace SciVis
 					return ret;
 				}
 				/*
-				* : SetLatituteRange
-				* : øʱγȷΧλΪǶȣ
-				* :
-				* -- minLatDeg: γСֵ
-				* -- maxLatDeg: γֵ
-				* ֵ: ĲϷfalseóɹtrue
+				* 函数: SetLatituteRange
+				* 功能: 设置该体绘制时的纬度范围（单位为角度）
+				* 参数:
+				* -- minLatDeg: 纬度最小值
+				* -- maxLatDeg: 纬度最大值
+				* 返回值: 若输入的参数不合法，返回false。若设置成功，返回true
 				*/
 				bool SetLatituteRange(float minLatDeg, float maxLatDeg)
 				{
@@ -375,12 +420,12 @@ namespace SciVis
 					return ret;
 				}
 				/*
-				* : SetHeightFromCenterRange
-				* : øʱĸ߶ȣģΧ
-				* :
-				* -- minH: ߶Сֵ
-				* -- maxH: ߶ֵ
-				* ֵ: ĲϷfalseóɹtrue
+				* 函数: SetHeightFromCenterRange
+				* 功能: 设置该体绘制时的高度（距球心）范围
+				* 参数:
+				* -- minH: 高度最小值
+				* -- maxH: 高度最大值
+				* 返回值: 若输入的参数不合法，返回false。若设置成功，返回true
 				*/
 				bool SetHeightFromCenterRange(float minH, float maxH)
 				{
@@ -402,10 +447,10 @@ namespace SciVis
 					return ret;
 				}
 				/*
-				* : SetVolumeStartFromLongtituteZero
-				* : ȫX=0ӦľΪ0ȣҪù
-				* :
-				* -- flag: ΪtrueʱùܡΪfalseʱرոù
+				* 函数: SetVolumeStartFromLongtituteZero
+				* 功能: 若全球体数据X=0对应的经度为0度，需要开启该功能
+				* 参数:
+				* -- flag: 为true时，开启该功能。为false时，关闭该功能
 				*/
 				void SetVolumeStartFromLongtituteZero(bool flag)
 				{
@@ -466,9 +511,9 @@ namespace SciVis
 			{}
 
 			/*
-			* : GetGroup
-			* : ȡûOSGڵ
-			* ֵ: OSGڵ
+			* 函数: GetGroup
+			* 功能: 获取该绘制组件的OSG节点
+			* 返回值: OSG节点
 			*/
 			osg::Group* GetGroup()
 			{
@@ -479,23 +524,49 @@ namespace SciVis
 				return param.selectGrp.get();
 			}
 			/*
-			* : AddVolume
-			* : ûһ
-			* :
-			* -- name: ơͬ費ͬ
-			* -- volTex: OSGά
-			* -- sortedIsosurfs: ֵĲֵɫԪصȡֵΧΪ[0,1]ֵͬ谴ֵķǽ
-			* -- volDim: άߴ
-			* -- isDisplayed: Ϊtrueʱ屻ᱻơֻᱻ
+			* 函数: AddVolume
+			* 功能: 向该绘制组件添加一个体
+			* 参数:
+			* -- name: 添加体的名称。不同体的名称需不同，用于区分
+			* -- volTex: 体的OSG三维纹理
+			* -- volDat: 体数据，用于按需生成平滑体纹理。为空时不支持使用平滑体
+			* -- sortedIsosurfs: 多等值面的参数，包括值和颜色，所有元素的取值范围均为[0,1]。不同等值面需按值的非降序排序
+			* -- volDim: 体的三维尺寸
+			* -- isDisplayed: 为true时，体被加入后会被绘制。否则体只被加入绘制组件，但不会被绘制
+			* -- smoothParam: 需要平滑的体数据时，所用的滤波参数
+			*/
+			void AddVolume(
+				const std::string& name,
+				osg::ref_ptr<osg::Texture3D> volTex,
+				std::shared_ptr<std::vector<float>> volDat,
+				const std::vector<std::tuple<float, std::array<float, 4>>>& sortedIsosurfs,
+				const std::array<uint32_t, 3>& volDim,
+				bool isDisplayed = true,
+				const VolumeSmoother::Parameters& smoothParam = VolumeSmoother::Parameters())
+			{
+				AddVolume(name, volTex, volDat ? VolumeView<float>(*volDat, volDim) : VolumeView<float>(),
+					sortedIsosurfs, volDim, isDisplayed, smoothParam, volDat);
+			}
+			/*
+			* 函数: AddVolume
+			* 功能: 同上，但以体视图提供生成平滑体纹理所需的体数据，不拷贝体数据
+			* 参数:
+			* -- volDat: 体视图。为空视图时不支持使用平滑体
+			* -- volOwner: 视图数据的持有者，组件持有它直到体被移除。为空时，调用者需保证数据在体被移除前有效
 			*/
 			void AddVolume(
 				const std::string& name,
 				osg::ref_ptr<osg::Texture3D> volTex,
-				osg::ref_ptr<osg::Texture3D> volTexSmoothed,
+				const VolumeView<float>& volDat,
 				const std::vector<std::tuple<float, std::array<float, 4>>>& sortedIsosurfs,
 				const std::array<uint32_t, 3>& volDim,
-				bool isDisplayed = true)
+				bool isDisplayed = true,
+				const VolumeSmoother::Parameters& smoothParam = VolumeSmoother::Parameters(),
+				std::shared_ptr<const void> volOwner = nullptr)
 			{
+				if (!volOwner)
+					volOwner = std::make_shared<char>(); // 仅作为平滑体缓存的键，随体的移除而失效
+
 				auto itr = vols.find(name);
 				if (itr != vols.end() && itr->second.isDisplayed) {
 					param.grp->removeChild(itr->second.sphere);
@@ -505,7 +576,7 @@ namespace SciVis
 				auto opt = vols.emplace(
 					std::piecewise_construct,
 					std::forward_as_tuple(name),
-					std::forward_as_tuple(volTex, volTexSmoothed, sortedIsosurfs, volDim, &param));
+					std::forward_as_tuple(volTex, volDat, volOwner, smoothParam, sortedIsosurfs, volDim, &param));
 
 				opt.first->second.isDisplayed = isDisplayed;
 				if (isDisplayed) {
@@ -514,10 +585,10 @@ namespace SciVis
 				}
 			}
 			/*
-			* : DisplayVolume
-			* : Ƹûеһ壬λе彫ơһڲ嶯岻ڸʱ嶼ᱻơ
-			* :
-			* -- name: 
+			* 函数: DisplayVolume
+			* 功能: 绘制该绘制组件中的一个体，位于组件中的其他体将不被绘制。一般用于产生体动画。当输入的体不在该组件中时，所有体都不会被绘制。
+			* 参数:
+			* -- name: 体的名称
 			*/
 			void DisplayVolume(const std::string& name)
 			{
@@ -535,19 +606,19 @@ namespace SciVis
 				}
 			}
 			/*
-			* : GetVolumes
-			* : ȡУڻʱ
+			* 函数: GetVolumes
+			* 功能: 获取该组件中，体在绘制时所需的所有数据
 			*/
 			std::map<std::string, PerVolParam>& GetVolumes()
 			{
 				return vols;
 			}
 			/*
-			* : GetVolume
-			* : ȡУڻʱ
-			* :
-			* -- name: 
-			* ֵ: Ļ
+			* 函数: GetVolume
+			* 功能: 获取该组件中，体在绘制时所需的数据
+			* 参数:
+			* -- name: 体的名称
+			* 返回值: 体的绘制数据
 			*/
 			PerVolParam* GetVolume(const std::string& name)
 			{
@@ -557,19 +628,19 @@ namespace SciVis
 				return &(itr->second);
 			}
 			/*
-			* : GetVolumeNum
-			* : ȡû
-			* ֵ: 
+			* 函数: GetVolumeNum
+			* 功能: 获取该绘制组件中体的数量
+			* 返回值: 体的数量
 			*/
 			size_t GetVolumeNum() const
 			{
 				return vols.size();
 			}
 			/*
-			* : SetDeltaT
-			* : ʱߴĲ
-			* :
-			* -- dt: ߴĲ
+			* 函数: SetDeltaT
+			* 功能: 设置体绘制时，光线传播的步长
+			* 参数:
+			* -- dt: 光线传播的步长
 			*/
 			void SetDeltaT(float dt)
 			{
@@ -582,10 +653,10 @@ namespace SciVis
 				return ret;
 			}
 			/*
-			* : SetMaxStepCount
-			* : ʱߴ
-			* :
-			* -- maxStepCnt: ߴ
+			* 函数: SetMaxStepCount
+			* 功能: 设置体绘制时，光线传播的最大步数
+			* 参数:
+			* -- maxStepCnt: 光线传播的最大步数
 			*/
 			void SetMaxStepCount(int maxStepCnt)
 			{
@@ -598,10 +669,10 @@ namespace SciVis
 				return ret;
 			}
 			/*
-			* : SetShading
-			* : еĹɫ
-			* :
-			* -- param: Blinn-Phongɫ
+			* 函数: SetShading
+			* 功能: 设置体绘制中的光照着色参数
+			* 参数:
+			* -- param: Blinn-Phong光照着色参数
 			*/
 			void SetShading(const ShadingParam& param)
 			{
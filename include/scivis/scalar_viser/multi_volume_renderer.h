@@ -3,6 +3,7 @@
 
 #include <scivis/common/callback.h>
 #include <scivis/common/util.h>
+#include <scivis/common/vol_tex.h>
 
 #include <osg/CullFace>
 #include <osg/Group>
@@ -60,6 +61,8 @@ namespace SciVis
 			STATEMENT(latitudeRange, osg::Vec2());
 			STATEMENT(heightRange, osg::Vec2());
 			STATEMENT(volStartFromZeroLon, false);
+			STATEMENT(volTexScale0, osg::Vec3(1.f, 1.f, 1.f));
+			STATEMENT(volTexScale1, osg::Vec3(1.f, 1.f, 1.f));
 #undef STATEMENT
 
 			auto volTexUni = new osg::Uniform(osg::Uniform::SAMPLER_3D, "volTex0");
@@ -114,6 +117,8 @@ namespace SciVis
 
 			dt->set(rndrParam.dt);
 			maxStepCnt->set(rndrParam.maxStepCnt);
+			volTexScale0->set(VolumeTexture::GetTextureCoordinateScale(rndrParam.vols[0]));
+			volTexScale1->set(VolumeTexture::GetTextureCoordinateScale(rndrParam.vols[1]));
 
 			auto states = sphere->getOrCreateStateSet();
 			states->setTextureAttributeAndModes(0, rndrParam.vols[0], osg::StateAttribute::ON);
@@ -151,6 +156,8 @@ namespace SciVis
 		osg::ref_ptr<osg::Uniform> latitudeRange;
 		osg::ref_ptr<osg::Uniform> heightRange;
 		osg::ref_ptr<osg::Uniform> volStartFromZeroLon;
+		osg::ref_ptr<osg::Uniform> volTexScale0;
+		osg::ref_ptr<osg::Uniform> volTexScale1;
 
 		osg::ref_ptr<osg::ShapeDrawable> sphere;
 	};
@@ -0,0 +1,810 @@
+#ifndef SCIVIS_SCALAR_VISER_OUT_OF_CORE_VOLUME_RENDERER_H
+#define SCIVIS_SCALAR_VISER_OUT_OF_CORE_VOLUME_RENDERER_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <string>
+
+#include <array>
+#include <vector>
+
+#include <osg/BoundingSphere>
+#include <osg/CullFace>
+#include <osg/CullStack>
+#include <osg/CoordinateSystemNode>
+#include <osg/GLExtensions>
+#include <osg/ShapeDrawable>
+#include <osg/Texture1D>
+#include <osg/Texture2D>
+#include <osg/Texture3D>
+
+#include <scivis/common/zhongdian15.h>
+#include <scivis/io/brick_streamer.h>
+#include <scivis/scalar_viser/direct_volume_renderer.h>
+
+#ifndef GL_RGBA32F
+#define GL_RGBA32F 0x8814
+#endif // !GL_RGBA32F
+
+namespace SciVis
+{
+	namespace ScalarViser
+	{
+		/*
+		* 类: OutOfCoreVolumeRenderer
+		* 功能: 多分辨率分块体（见MultiresolutionBrickedVolumeData）的核外直接体绘制，体不需要整个放入一个纹理。
+		*       -- 每帧在裁剪遍历中自最粗一级起遍历八叉树，跳过视锥外、被地球遮挡（地平线以下）以及不含有效体素的块，
+		*          块的体素在屏幕上的投影大于maxPixelPerVoxel时以其子块代替，所选块数不超过块池的容量
+		*       -- 所选的块驻留在固定大小的块池三维纹理中，每个槽位存放一个带边框的块。
+		*          间接表三维纹理的每个纹素对应第0级的一个块，记录覆盖该块且已驻留的最细一级的块所在的槽位与级别，
+		*          着色器先查间接表再采样块池，因此未加载完成的区域以更粗一级显示
+		*       -- 未驻留的块经BrickStreamer在工作线程上从磁盘读取，每帧至多上传maxUploadPerFrame个，
+		*          池满时替换最久未被选中的块。最粗一级的块在构造时同步加载并常驻
+		*       光线投射与DirectVolumeRenderer相同（不含切面），只支持单个图形上下文
+		*/
+		class OutOfCoreVolumeRenderer
+		{
+		public:
+			struct Parameters
+			{
+				std::array<uint32_t, 3> poolBrickNum = { { 8, 8, 8 } }; // 块池各轴的槽位数
+				float maxPixelPerVoxel = 1.5f;
+				uint32_t maxUploadPerFrame = 32;
+				BrickStreamer::Parameters streamParam;
+			};
+
+			/*
+			* 结构体: Statistics
+			* 功能: 最近一帧的块选择与驻留情况
+			*/
+			struct Statistics
+			{
+				size_t selectedNum = 0; // 该帧所选的块数
+				size_t missingNum = 0; // 所选的块中尚未驻留的块数
+				size_t residentNum = 0; // 块池中已占用的槽位数
+				size_t uploadedNum = 0; // 该帧上传的块数
+			};
+
+		private:
+			/*
+			* 类: PoolSubloadCallback
+			* 功能: 块池纹理的分块上传。绘制线程只以glTexSubImage3D上传新驻留的块，而不重传整个块池
+			*/
+			class PoolSubloadCallback : public osg::Texture3D::SubloadCallback
+			{
+			private:
+				struct Upload
+				{
+					std::array<uint32_t, 3> org;
+					std::vector<uint16_t> dat;
+				};
+
+				std::array<uint32_t, 3> texDim;
+				uint32_t slotLen;
+				mutable std::mutex mtx;
+				mutable std::vector<Upload> pending;
+
+			public:
+				PoolSubloadCallback(const std::array<uint32_t, 3>& texDim, uint32_t slotLen)
+					: texDim(texDim), slotLen(slotLen)
+				{}
+
+				void Push(const std::array<uint32_t, 3>& org, std::vector<uint16_t>&& dat)
+				{
+					std::lock_guard<std::mutex> lk(mtx);
+					pending.emplace_back();
+					pending.back().org = org;
+					pending.back().dat = std::move(dat);
+				}
+
+				virtual void load(const osg::Texture3D& tex, osg::State& state) const override
+				{
+					auto ext = state.get<osg::GLExtensions>();
+					ext->glTexImage3D(GL_TEXTURE_3D, 0, GL_R16, texDim[0], texDim[1], texDim[2], 0,
+						GL_RED, GL_UNSIGNED_SHORT, nullptr);
+					subload(tex, state);
+				}
+				virtual void subload(const osg::Texture3D&, osg::State& state) const override
+				{
+					std::vector<Upload> uploads;
+					{
+						std::lock_guard<std::mutex> lk(mtx);
+						uploads.swap(pending);
+					}
+					if (uploads.empty())
+						return;
+
+					auto ext = state.get<osg::GLExtensions>();
+					glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+					for (auto& upload : uploads)
+						ext->glTexSubImage3D(GL_TEXTURE_3D, 0, upload.org[0], upload.org[1], upload.org[2],
+							slotLen, slotLen, slotLen, GL_RED, GL_UNSIGNED_SHORT, upload.dat.data());
+				}
+			};
+
+			struct Slot
+			{
+				BrickStreamer::NodeID id;
+				bool isUsed = false;
+				bool isPinned = false;
+				uint64_t lastSelectedFrame = 0;
+			};
+
+			/*
+			* 结构体: BrickCache
+			* 功能: 块池、间接表与块的选择，由绘制组件与裁剪回调共享。除构造外只在裁剪遍历中访问
+			*/
+			struct BrickCache
+			{
+				std::shared_ptr<const MultiresolutionBrickedVolumeData> vol;
+				Parameters param;
+				BrickStreamer streamer;
+
+				std::vector<Slot> slots;
+				size_t pinnedNum = 0;
+				std::vector<std::vector<int32_t>> residentSlots; // 各级各块所在的槽位，未驻留时为-1
+				osg::ref_ptr<osg::Texture3D> poolTex;
+				osg::ref_ptr<PoolSubloadCallback> poolSubload;
+				osg::ref_ptr<osg::Image> pageImg;
+				osg::ref_ptr<osg::Texture3D> pageTex;
+				bool isPageDirty = true;
+
+				// 以下与着色器中的同名uniform一致，角度为弧度
+				float minLon = 0.f, maxLon = 0.f, minLat = 0.f, maxLat = 0.f, minH = 0.f, maxH = 0.f;
+				float occluderRadius = static_cast<float>(osg::WGS_84_RADIUS_POLAR);
+
+				uint64_t frame = 0;
+				Statistics stats;
+
+				BrickCache(std::shared_ptr<const MultiresolutionBrickedVolumeData> vol, const Parameters& param)
+					: vol(vol), param(param), streamer(vol, param.streamParam)
+				{
+					auto slotLen = streamer.GetSlotLength();
+					auto& poolBrickNum = this->param.poolBrickNum;
+					for (uint8_t i = 0; i < 3; ++i)
+						poolBrickNum[i] = std::max(poolBrickNum[i], 1u);
+					slots.resize(static_cast<size_t>(poolBrickNum[0]) * poolBrickNum[1] * poolBrickNum[2]);
+
+					residentSlots.resize(vol->GetLevelNum());
+					for (uint32_t lvl = 0; lvl < vol->GetLevelNum(); ++lvl)
+						residentSlots[lvl].assign(vol->GetLevel(lvl).GetBrickNum(), -1);
+
+					std::array<uint32_t, 3> texDim = { {
+						poolBrickNum[0] * slotLen, poolBrickNum[1] * slotLen, poolBrickNum[2] * slotLen } };
+					poolSubload = new PoolSubloadCallback(texDim, slotLen);
+					poolTex = new osg::Texture3D;
+					poolTex->setTextureSize(texDim[0], texDim[1], texDim[2]);
+					poolTex->setInternalFormat(GL_R16);
+					poolTex->setSourceFormat(GL_RED);
+					poolTex->setSourceType(GL_UNSIGNED_SHORT);
+					poolTex->setFilter(osg::Texture::MIN_FILTER, osg::Texture::LINEAR);
+					poolTex->setFilter(osg::Texture::MAG_FILTER, osg::Texture::LINEAR);
+					poolTex->setWrap(osg::Texture::WRAP_S, osg::Texture::CLAMP_TO_EDGE);
+					poolTex->setWrap(osg::Texture::WRAP_T, osg::Texture::CLAMP_TO_EDGE);
+					poolTex->setWrap(osg::Texture::WRAP_R, osg::Texture::CLAMP_TO_EDGE);
+					poolTex->setSubloadCallback(poolSubload);
+
+					const auto& pageDim = vol->GetLevel(0).GetBrickPerVolume();
+					pageImg = new osg::Image;
+					pageImg->allocateImage(pageDim[0], pageDim[1], pageDim[2], GL_RGBA, GL_FLOAT);
+					pageImg->setInternalTextureFormat(GL_RGBA32F);
+					pageTex = new osg::Texture3D;
+					pageTex->setFilter(osg::Texture::MIN_FILTER, osg::Texture::NEAREST);
+					pageTex->setFilter(osg::Texture::MAG_FILTER, osg::Texture::NEAREST);
+					pageTex->setWrap(osg::Texture::WRAP_S, osg::Texture::CLAMP_TO_EDGE);
+					pageTex->setWrap(osg::Texture::WRAP_T, osg::Texture::CLAMP_TO_EDGE);
+					pageTex->setWrap(osg::Texture::WRAP_R, osg::Texture::CLAMP_TO_EDGE);
+					pageTex->setResizeNonPowerOfTwoHint(false);
+					pageTex->setImage(pageImg);
+
+					// 最粗一级常驻，保证任意区域都有可显示的数据
+					auto top = vol->GetLevelNum() - 1;
+					for (size_t idx = 0; idx < vol->GetLevel(top).GetBrickNum() && idx < slots.size(); ++idx) {
+						BrickStreamer::NodeID id(top, idx);
+						std::vector<uint16_t> dat;
+						if (!streamer.LoadBrick(id, dat))
+							continue;
+						assign(idx, id, std::move(dat));
+						slots[idx].isPinned = true;
+						++pinnedNum;
+					}
+					rebuildPageTable();
+				}
+
+				/*
+				* 函数: Update
+				* 功能: 每帧在裁剪遍历中调用：选择块，请求缺失的块，将已加载的块放入块池并更新间接表
+				*/
+				void Update(osg::CullStack& cullStack)
+				{
+					++frame;
+					stats = Statistics();
+
+					std::vector<BrickStreamer::NodeID> missing;
+					selectBricks(cullStack, missing);
+					stats.missingNum = missing.size();
+					// 粗的块先加载，以尽快填补空缺
+					std::stable_sort(missing.begin(), missing.end(),
+						[](const BrickStreamer::NodeID& a, const BrickStreamer::NodeID& b) {
+						return a.lvl > b.lvl;
+						});
+					streamer.Request(std::move(missing));
+
+					BrickStreamer::Brick brick;
+					while (stats.uploadedNum < param.maxUploadPerFrame && streamer.Poll(brick)) {
+						if (!brick.ok)
+							continue;
+						auto slotIdx = findSlot();
+						if (slotIdx == slots.size()) {
+							streamer.Release(brick.id);
+							continue;
+						}
+						assign(slotIdx, brick.id, std::move(brick.dat));
+						++stats.uploadedNum;
+					}
+
+					for (auto& slot : slots)
+						if (slot.isUsed)
+							++stats.residentNum;
+					if (isPageDirty)
+						rebuildPageTable();
+				}
+
+			private:
+				struct Candidate
+				{
+					float pixelPerVoxel;
+					uint32_t lvl;
+					std::array<uint32_t, 3> b;
+
+					bool operator<(const Candidate& other) const
+					{
+						return pixelPerVoxel < other.pixelPerVoxel;
+					}
+				};
+
+				/*
+				* 函数: selectBricks
+				* 功能: 由粗到细细分投影最大的块，直到所有块的体素投影不大于maxPixelPerVoxel，或块数将超过块池的容量
+				*/
+				void selectBricks(osg::CullStack& cullStack, std::vector<BrickStreamer::NodeID>& missing)
+				{
+					auto eye = cullStack.getEyeLocal();
+					std::priority_queue<Candidate> candidates;
+					std::vector<Candidate> selected;
+
+					auto top = vol->GetLevelNum() - 1;
+					const auto& topBrickPerVol = vol->GetLevel(top).GetBrickPerVolume();
+					for (uint32_t bz = 0; bz < topBrickPerVol[2]; ++bz)
+						for (uint32_t by = 0; by < topBrickPerVol[1]; ++by)
+							for (uint32_t bx = 0; bx < topBrickPerVol[0]; ++bx) {
+								Candidate cand;
+								cand.lvl = top;
+								cand.b = { { bx, by, bz } };
+								if (isVisible(cand, cullStack, eye))
+									candidates.push(cand);
+							}
+
+					std::vector<Candidate> children;
+					while (!candidates.empty()) {
+						auto cand = candidates.top();
+						candidates.pop();
+						if (cand.lvl == 0 || cand.pixelPerVoxel <= param.maxPixelPerVoxel) {
+							selected.emplace_back(cand);
+							continue;
+						}
+
+						children.clear();
+						const auto& brickPerVol = vol->GetLevel(cand.lvl - 1).GetBrickPerVolume();
+						for (uint32_t dz = 0; dz < 2; ++dz)
+							for (uint32_t dy = 0; dy < 2; ++dy)
+								for (uint32_t dx = 0; dx < 2; ++dx) {
+									Candidate child;
+									child.lvl = cand.lvl - 1;
+									child.b = { { 2 * cand.b[0] + dx, 2 * cand.b[1] + dy, 2 * cand.b[2] + dz } };
+									if (child.b[0] >= brickPerVol[0] || child.b[1] >= brickPerVol[1] || child.b[2] >= brickPerVol[2])
+										continue;
+									if (isVisible(child, cullStack, eye))
+										children.emplace_back(child);
+								}
+						// 常驻的块始终占用槽位，其余槽位用于所选的块
+						if (selected.size() + candidates.size() + children.size() > slots.size() - pinnedNum) {
+							selected.emplace_back(cand);
+							continue;
+						}
+						for (auto& child : children)
+							candidates.push(child);
+					}
+
+					stats.selectedNum = selected.size();
+					for (auto& cand : selected) {
+						BrickStreamer::NodeID id(cand.lvl, vol->GetLevel(cand.lvl).GetBrickIndex(cand.b[0], cand.b[1], cand.b[2]));
+						auto slotIdx = residentSlots[id.lvl][id.idx];
+						if (slotIdx >= 0)
+							slots[slotIdx].lastSelectedFrame = frame;
+						else if (streamer.GetState(id) == BrickStreamer::EState::None)
+							missing.emplace_back(id);
+					}
+				}
+
+				/*
+				* 函数: isVisible
+				* 功能: 判断块是否需要绘制，并计算其体素在屏幕上的投影大小。块在地理空间中是球壳的一部分，
+				*       以其表面上的采样点（经纬方向按跨度加密）求包围球，用于视锥裁剪与投影大小；
+				*       采样点全部位于地平线以下时，块被地球遮挡
+				*/
+				bool isVisible(Candidate& cand, osg::CullStack& cullStack, const osg::Vec3& eye) const
+				{
+					const auto& lvl = vol->GetLevel(cand.lvl);
+					if (lvl.GetBrickInfo(lvl.GetBrickIndex(cand.b[0], cand.b[1], cand.b[2])).validNum == 0)
+						return false;
+
+					const auto& dim = vol->GetVoxelPerVolume();
+					auto brickLen = vol->GetBrickLength();
+					std::array<std::array<float, 2>, 3> rngs;
+					for (uint8_t i = 0; i < 3; ++i) {
+						auto span = static_cast<float>(static_cast<uint64_t>(brickLen) << cand.lvl);
+						rngs[i][0] = std::min(cand.b[i] * span / dim[i], 1.f);
+						rngs[i][1] = std::min((cand.b[i] + 1) * span / dim[i], 1.f);
+					}
+					auto lon0 = minLon + rngs[0][0] * (maxLon - minLon);
+					auto lon1 = minLon + rngs[0][1] * (maxLon - minLon);
+					auto lat0 = minLat + rngs[1][0] * (maxLat - minLat);
+					auto lat1 = minLat + rngs[1][1] * (maxLat - minLat);
+					auto h0 = minH + rngs[2][0] * (maxH - minH);
+					auto h1 = minH + rngs[2][1] * (maxH - minH);
+
+					const auto MaxAngleStep = static_cast<float>(osg::PI) / 8.f;
+					auto lonSegNum = static_cast<uint32_t>(std::ceil((lon1 - lon0) / MaxAngleStep));
+					auto latSegNum = static_cast<uint32_t>(std::ceil((lat1 - lat0) / MaxAngleStep));
+					lonSegNum = std::max(lonSegNum, 1u);
+					latSegNum = std::max(latSegNum, 1u);
+					std::vector<osg::Vec3> pnts;
+					pnts.reserve(static_cast<size_t>(lonSegNum + 1) * (latSegNum + 1) * 2);
+					osg::BoundingSphere bs;
+					for (auto h : { h0, h1 })
+						for (uint32_t j = 0; j <= latSegNum; ++j)
+							for (uint32_t i = 0; i <= lonSegNum; ++i) {
+								auto lon = lon0 + (lon1 - lon0) * i / lonSegNum;
+								auto lat = lat0 + (lat1 - lat0) * j / latSegNum;
+								pnts.emplace_back(h * std::cos(lat) * std::cos(lon), h * std::cos(lat) * std::sin(lon), h * std::sin(lat));
+								bs.expandBy(pnts.back());
+							}
+					// 相邻采样点之间的弧高于弦，按最大弧高扩大包围球
+					auto angleStep = std::max((lon1 - lon0) / lonSegNum, (lat1 - lat0) / latSegNum);
+					bs.radius() += h1 * (1.f - std::cos(.5f * angleStep));
+
+					if (cullStack.isCulled(bs))
+						return false;
+					if (std::all_of(pnts.begin(), pnts.end(), [&](const osg::Vec3& p) { return isBelowHorizon(p, eye); }))
+						return false;
+
+					cand.pixelPerVoxel = 2.f * cullStack.clampedPixelSize(bs) / (std::sqrt(3.f) * brickLen);
+					return true;
+				}
+
+				/*
+				* 函数: isBelowHorizon
+				* 功能: 判断点p是否被半径为occluderRadius的地球遮挡。坐标以地球半径归一化后，
+				*       p位于视点的地平面之后且位于地球在视点处张成的圆锥之内时被遮挡
+				*/
+				bool isBelowHorizon(const osg::Vec3& p, const osg::Vec3& eye) const
+				{
+					auto vc = eye / occluderRadius;
+					auto vhMag2 = vc.length2() - 1.f;
+					if (vhMag2 <= 0.f)
+						return false;
+					auto vt = p / occluderRadius - vc;
+					auto vtDotVc = -(vt * vc);
+					return vtDotVc > vhMag2 && vtDotVc * vtDotVc / vt.length2() > vhMag2;
+				}
+
+				/*
+				* 函数: findSlot
+				* 功能: 返回空闲的槽位，没有时返回本帧未被选中、最久未被选中且不常驻的槽位，仍没有时返回slots.size()
+				*/
+				size_t findSlot() const
+				{
+					auto lru = slots.size();
+					for (size_t i = 0; i < slots.size(); ++i) {
+						auto& slot = slots[i];
+						if (!slot.isUsed)
+							return i;
+						if (slot.isPinned || slot.lastSelectedFrame == frame)
+							continue;
+						if (lru == slots.size() || slot.lastSelectedFrame < slots[lru].lastSelectedFrame)
+							lru = i;
+					}
+					return lru;
+				}
+
+				void assign(size_t slotIdx, const BrickStreamer::NodeID& id, std::vector<uint16_t>&& dat)
+				{
+					auto& slot = slots[slotIdx];
+					if (slot.isUsed) {
+						residentSlots[slot.id.lvl][slot.id.idx] = -1;
+						streamer.Release(slot.id);
+					}
+					slot.id = id;
+					slot.isUsed = true;
+					slot.lastSelectedFrame = frame;
+					residentSlots[id.lvl][id.idx] = static_cast<int32_t>(slotIdx);
+
+					auto slotLen = streamer.GetSlotLength();
+					auto org = getSlotCoord(slotIdx);
+					for (auto& v : org)
+						v *= slotLen;
+					poolSubload->Push(org, std::move(dat));
+					isPageDirty = true;
+				}
+
+				std::array<uint32_t, 3> getSlotCoord(size_t slotIdx) const
+				{
+					const auto& poolBrickNum = param.poolBrickNum;
+					return { {
+						static_cast<uint32_t>(slotIdx % poolBrickNum[0]),
+						static_cast<uint32_t>(slotIdx / poolBrickNum[0] % poolBrickNum[1]),
+						static_cast<uint32_t>(slotIdx / poolBrickNum[0] / poolBrickNum[1]) } };
+				}
+
+				/*
+				* 函数: rebuildPageTable
+				* 功能: 对第0级的每个块，由细到粗找到覆盖它且已驻留的块，记录其槽位坐标与级别。
+				*       途中遇到不含有效体素的块时，该区域在所有更粗的级别上也按空白处理，记为-1
+				*/
+				void rebuildPageTable()
+				{
+					const auto& pageDim = vol->GetLevel(0).GetBrickPerVolume();
+					auto entry = reinterpret_cast<osg::Vec4*>(pageImg->data());
+					for (uint32_t z = 0; z < pageDim[2]; ++z)
+						for (uint32_t y = 0; y < pageDim[1]; ++y)
+							for (uint32_t x = 0; x < pageDim[0]; ++x) {
+								*entry = osg::Vec4(-1.f, -1.f, -1.f, -1.f);
+								for (uint32_t l = 0; l < vol->GetLevelNum(); ++l) {
+									const auto& lvl = vol->GetLevel(l);
+									auto idx = lvl.GetBrickIndex(x >> l, y >> l, z >> l);
+									if (lvl.GetBrickInfo(idx).validNum == 0)
+										break;
+									auto slotIdx = residentSlots[l][idx];
+									if (slotIdx < 0)
+										continue;
+
+									auto coord = getSlotCoord(slotIdx);
+									*entry = osg::Vec4(coord[0], coord[1], coord[2], l);
+									break;
+								}
+								++entry;
+							}
+					pageImg->dirty();
+					isPageDirty = false;
+				}
+			};
+
+			class Callback : public osg::NodeCallback
+			{
+			private:
+				std::shared_ptr<BrickCache> cache;
+				osg::ref_ptr<osg::Uniform> eyePosUni;
+
+			public:
+				Callback(std::shared_ptr<BrickCache> cache, osg::ref_ptr<osg::Uniform> eyePosUni)
+					: cache(cache), eyePosUni(eyePosUni)
+				{}
+				virtual void operator()(osg::Node* node, osg::NodeVisitor* nv)
+				{
+					eyePosUni->set(nv->getEyePoint());
+					auto cullStack = dynamic_cast<osg::CullStack*>(nv);
+					if (cullStack)
+						cache->Update(*cullStack);
+
+					traverse(node, nv);
+				}
+			};
+
+			std::shared_ptr<BrickCache> cache;
+
+			osg::ref_ptr<osg::Group> grp;
+			osg::ref_ptr<osg::Program> program;
+			osg::ref_ptr<osg::ShapeDrawable> sphere;
+			osg::ref_ptr<osg::Texture1D> tfTex;
+			osg::ref_ptr<osg::Texture2D> tfTexPreInt;
+
+			osg::ref_ptr<osg::Uniform> eyePos;
+			osg::ref_ptr<osg::Uniform> dt;
+			osg::ref_ptr<osg::Uniform> maxStepCnt;
+			osg::ref_ptr<osg::Uniform> usePreIntTF;
+			osg::ref_ptr<osg::Uniform> useShading;
+			osg::ref_ptr<osg::Uniform> ka;
+			osg::ref_ptr<osg::Uniform> kd;
+			osg::ref_ptr<osg::Uniform> ks;
+			osg::ref_ptr<osg::Uniform> shininess;
+			osg::ref_ptr<osg::Uniform> lightPos;
+
+			osg::ref_ptr<osg::Uniform> minLatitute;
+			osg::ref_ptr<osg::Uniform> maxLatitute;
+			osg::ref_ptr<osg::Uniform> minLongtitute;
+			osg::ref_ptr<osg::Uniform> maxLongtitute;
+			osg::ref_ptr<osg::Uniform> minHeight;
+			osg::ref_ptr<osg::Uniform> maxHeight;
+			osg::ref_ptr<osg::Uniform> rotMat;
+
+		public:
+			OutOfCoreVolumeRenderer(
+				std::shared_ptr<const MultiresolutionBrickedVolumeData> vol,
+				osg::ref_ptr<osg::Texture1D> tfTex,
+				osg::ref_ptr<osg::Texture2D> tfTexPreInt)
+				: OutOfCoreVolumeRenderer(vol, tfTex, tfTexPreInt, Parameters())
+			{}
+			/*
+			* 函数: OutOfCoreVolumeRenderer
+			* 参数:
+			* -- vol: 多分辨率分块体，经纬高范围默认取自其第0级的文件头（高度需另行以SetHeightFromCenterRange设置）
+			* -- tfTex, tfTexPreInt: 传输函数与预积分传输函数的纹理。体素以第0级的值域归一化后查表
+			* -- param: 块池与流式加载的参数
+			*/
+			OutOfCoreVolumeRenderer(
+				std::shared_ptr<const MultiresolutionBrickedVolumeData> vol,
+				osg::ref_ptr<osg::Texture1D> tfTex,
+				osg::ref_ptr<osg::Texture2D> tfTexPreInt,
+				const Parameters& param)
+				: cache(std::make_shared<BrickCache>(vol, param)), tfTex(tfTex), tfTexPreInt(tfTexPreInt)
+			{
+				const auto MinHeight = static_cast<float>(osg::WGS_84_RADIUS_EQUATOR) * 1.1f;
+				const auto MaxHeight = static_cast<float>(osg::WGS_84_RADIUS_EQUATOR) * 1.3f;
+
+				grp = new osg::Group;
+				osg::ref_ptr<osg::Shader> vertShader = osg::Shader::readShaderFile(
+					osg::Shader::VERTEX,
+					GetDataPathPrefix() +
+					SCIVIS_SHADER_PREFIX
+					"scivis/scalar_viser/dvr_vert.glsl");
+				osg::ref_ptr<osg::Shader> fragShader = osg::Shader::readShaderFile(
+					osg::Shader::FRAGMENT,
+					GetDataPathPrefix() +
+					SCIVIS_SHADER_PREFIX
+					"scivis/scalar_viser/oocdvr_frag.glsl");
+				program = new osg::Program;
+				program->addShader(vertShader);
+				program->addShader(fragShader);
+
+				auto tessl = new osg::TessellationHints;
+				tessl->setDetailRatio(10.f);
+				sphere = new osg::ShapeDrawable(new osg::Sphere(osg::Vec3(0.f, 0.f, 0.f), MaxHeight), tessl);
+				grp->addChild(sphere);
+
+				auto states = sphere->getOrCreateStateSet();
+				// 间接表与块池在裁剪遍历中被修改
+				states->setDataVariance(osg::Object::DYNAMIC);
+#define STATEMENT(name, val)                                                                       \
+    name = new osg::Uniform(#name, val);                                                           \
+    states->addUniform(name)
+				STATEMENT(eyePos, osg::Vec3());
+				STATEMENT(dt, static_cast<float>(osg::WGS_84_RADIUS_EQUATOR) * .008f);
+				STATEMENT(maxStepCnt, 100);
+				STATEMENT(usePreIntTF, 0);
+				STATEMENT(useShading, 0);
+				STATEMENT(ka, .5f);
+				STATEMENT(kd, .5f);
+				STATEMENT(ks, .5f);
+				STATEMENT(shininess, 16.f);
+				STATEMENT(lightPos, osg::Vec3());
+
+				STATEMENT(minLatitute, 0.f);
+				STATEMENT(maxLatitute, 0.f);
+				STATEMENT(minLongtitute, 0.f);
+				STATEMENT(maxLongtitute, 0.f);
+				STATEMENT(minHeight, MinHeight);
+				STATEMENT(maxHeight, MaxHeight);
+				{
+					osg::Matrix3 tmpMat;
+					tmpMat.makeIdentity();
+					STATEMENT(rotMat, tmpMat);
+				}
+#undef STATEMENT
+				{
+					const auto& dim = vol->GetVoxelPerVolume();
+					const auto& pageDim = vol->GetLevel(0).GetBrickPerVolume();
+					auto slotLen = static_cast<float>(cache->streamer.GetSlotLength());
+					const auto& poolBrickNum = cache->param.poolBrickNum;
+					states->addUniform(new osg::Uniform("voxPerVol", osg::Vec3(dim[0], dim[1], dim[2])));
+					states->addUniform(new osg::Uniform("brickPerVol", osg::Vec3(pageDim[0], pageDim[1], pageDim[2])));
+					states->addUniform(new osg::Uniform("poolVoxPerTex", osg::Vec3(
+						poolBrickNum[0] * slotLen, poolBrickNum[1] * slotLen, poolBrickNum[2] * slotLen)));
+					states->addUniform(new osg::Uniform("brickLen", static_cast<float>(vol->GetBrickLength())));
+					states->addUniform(new osg::Uniform("dSamplePos", osg::Vec3(1.f / dim[0], 1.f / dim[1], 1.f / dim[2])));
+				}
+
+				states->setTextureAttributeAndModes(0, cache->poolTex, osg::StateAttribute::ON);
+				states->setTextureAttributeAndModes(1, tfTex, osg::StateAttribute::ON);
+				states->setTextureAttributeAndModes(2, tfTexPreInt, osg::StateAttribute::ON);
+				states->setTextureAttributeAndModes(3, cache->pageTex, osg::StateAttribute::ON);
+				{
+					auto poolTexUni = new osg::Uniform(osg::Uniform::SAMPLER_3D, "poolTex");
+					poolTexUni->set(0);
+					auto tfTexUni = new osg::Uniform(osg::Uniform::SAMPLER_1D, "tfTex");
+					tfTexUni->set(1);
+					auto tfTexPreIntUni = new osg::Uniform(osg::Uniform::SAMPLER_2D, "tfTexPreInt");
+					tfTexPreIntUni->set(2);
+					auto pageTexUni = new osg::Uniform(osg::Uniform::SAMPLER_3D, "pageTex");
+					pageTexUni->set(3);
+					states->addUniform(poolTexUni);
+					states->addUniform(tfTexUni);
+					states->addUniform(tfTexPreIntUni);
+					states->addUniform(pageTexUni);
+				}
+
+				osg::ref_ptr<osg::CullFace> cf = new osg::CullFace(osg::CullFace::BACK);
+				states->setAttributeAndModes(cf);
+
+				states->setAttributeAndModes(program, osg::StateAttribute::ON);
+				states->setMode(GL_BLEND, osg::StateAttribute::ON);
+				states->setRenderingHint(osg::StateSet::TRANSPARENT_BIN);
+
+				const auto& hdr = vol->GetHeader();
+				if (!SetLongtituteRange(hdr.lonRng[0], hdr.lonRng[1]))
+					SetLongtituteRange(-20.f, +20.f);
+				if (!SetLatituteRange(hdr.latRng[0], hdr.latRng[1]))
+					SetLatituteRange(-10.f, +10.f);
+				SetHeightFromCenterRange(MinHeight, MaxHeight);
+
+				grp->setCullCallback(new Callback(cache, eyePos));
+			}
+
+			/*
+			* 函数: GetGroup
+			* 功能: 获取该绘制组件的OSG节点
+			*/
+			osg::Group* GetGroup()
+			{
+				return grp.get();
+			}
+			/*
+			* 函数: GetStatistics
+			* 功能: 获取最近一帧的块选择与驻留情况
+			*/
+			Statistics GetStatistics() const
+			{
+				return cache->stats;
+			}
+
+			void SetTransferFunction(osg::ref_ptr<osg::Texture1D> tfTex)
+			{
+				this->tfTex = tfTex;
+				sphere->getOrCreateStateSet()->setTextureAttributeAndModes(1, this->tfTex, osg::StateAttribute::ON);
+			}
+			void SetPreIntegratedTransferFunction(osg::ref_ptr<osg::Texture2D> tfTexPreInt)
+			{
+				this->tfTexPreInt = tfTexPreInt;
+				sphere->getOrCreateStateSet()->setTextureAttributeAndModes(2, this->tfTexPreInt, osg::StateAttribute::ON);
+			}
+			/*
+			* 函数: SetLongtituteRange
+			* 功能: 同DirectVolumeRenderer::PerVolParam::SetLongtituteRange
+			*/
+			bool SetLongtituteRange(float minLonDeg, float maxLonDeg)
+			{
+				if (minLonDeg < -180.f) return false;
+				if (maxLonDeg > +180.f) return false;
+				if (minLonDeg >= maxLonDeg) return false;
+
+				cache->minLon = deg2Rad(minLonDeg);
+				cache->maxLon = deg2Rad(maxLonDeg);
+				minLongtitute->set(cache->minLon);
+				maxLongtitute->set(cache->maxLon);
+
+				computeRotMat();
+				return true;
+			}
+			/*
+			* 函数: SetLatituteRange
+			* 功能: 同DirectVolumeRenderer::PerVolParam::SetLatituteRange
+			*/
+			bool SetLatituteRange(float minLatDeg, float maxLatDeg)
+			{
+				if (minLatDeg < -90.f) return false;
+				if (maxLatDeg > +90.f) return false;
+				if (minLatDeg >= maxLatDeg) return false;
+
+				cache->minLat = deg2Rad(minLatDeg);
+				cache->maxLat = deg2Rad(maxLatDeg);
+				minLatitute->set(cache->minLat);
+				maxLatitute->set(cache->maxLat);
+
+				computeRotMat();
+				return true;
+			}
+			/*
+			* 函数: SetHeightFromCenterRange
+			* 功能: 同DirectVolumeRenderer::PerVolParam::SetHeightFromCenterRange
+			*/
+			bool SetHeightFromCenterRange(float minH, float maxH)
+			{
+				if (minH < 0.f) return false;
+				if (minH >= maxH) return false;
+
+				cache->minH = minH;
+				cache->maxH = maxH;
+				minHeight->set(minH);
+				maxHeight->set(maxH);
+
+				computeRotMat();
+				sphere->setShape(new osg::Sphere(osg::Vec3(0.f, 0.f, 0.f), maxH));
+				return true;
+			}
+			/*
+			* 函数: SetOccluderRadius
+			* 功能: 设置遮挡体（地球）的半径，用于剔除地平线以下的块。默认为WGS-84极半径，与createEarth绘制的地球一致
+			*/
+			void SetOccluderRadius(float r)
+			{
+				cache->occluderRadius = r;
+			}
+			void SetDeltaT(float dt)
+			{
+				this->dt->set(dt);
+			}
+			void SetMaxStepCount(int maxStepCnt)
+			{
+				this->maxStepCnt->set(maxStepCnt);
+			}
+			void SetUsePreIntegratedTF(bool use)
+			{
+				usePreIntTF->set(use ? 1 : 0);
+			}
+			void SetShading(const DirectVolumeRenderer::ShadingParam& param)
+			{
+				if (!param.useShading)
+					useShading->set(0);
+				else {
+					useShading->set(1);
+					ka->set(param.ka);
+					kd->set(param.kd);
+					ks->set(param.ks);
+					shininess->set(param.shininess);
+					lightPos->set(param.lightPos);
+				}
+			}
+
+		private:
+			static float deg2Rad(float deg)
+			{
+				return deg * osg::PI / 180.f;
+			}
+			void computeRotMat()
+			{
+				auto lon = .5f * (cache->maxLon + cache->minLon);
+				auto lat = .5f * (cache->maxLat + cache->minLat);
+				auto h = .5f * (cache->maxH + cache->minH);
+				osg::Vec3 dir;
+				dir.z() = h * sin(lat);
+				h = h * cos(lat);
+				dir.y() = h * sin(lon);
+				dir.x() = h * cos(lon);
+				dir.normalize();
+
+				osg::Matrix3 rotMat;
+				rotMat(2, 0) = dir.x();
+				rotMat(2, 1) = dir.y();
+				rotMat(2, 2) = dir.z();
+				auto tmp = osg::Vec3(0.f, 0.f, 1.f);
+				tmp = tmp ^ dir;
+				rotMat(0, 0) = tmp.x();
+				rotMat(0, 1) = tmp.y();
+				rotMat(0, 2) = tmp.z();
+				tmp = dir ^ tmp;
+				rotMat(1, 0) = tmp.x();
+				rotMat(1, 1) = tmp.y();
+				rotMat(1, 2) = tmp.z();
+
+				this->rotMat->set(rotMat);
+			}
+		};
+
+	} // namespace ScalarViser
+} // namespace SciVis
+
+#endif // !SCIVIS_SCALAR_VISER_OUT_OF_CORE_VOLUME_RENDERER_H
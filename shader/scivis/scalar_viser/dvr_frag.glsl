@@ -4,6 +4,7 @@
 #define PI (3.14159f)
 
 uniform sampler3D volTex;
+uniform vec3 volTexScale;
 uniform sampler1D tfTex;
 uniform sampler2D tfTexPreInt;
 uniform vec3 eyePos;
@@ -31,17 +32,25 @@ uniform int usePreIntTF;
 
 varying vec3 vertex;
 
+/*
+* 函数: sampleVolume
+* 功能: 以体的归一化坐标采样体纹理。体可能只占纹理的一部分（填充至2的幂时），由volTexScale换算
+*/
+float sampleVolume(vec3 pos) {
+	return texture(volTex, pos * volTexScale).r;
+}
+
 struct Hit {
 	int isHit;
 	float tEntry;
 	float tExit;
 };
 /*
-* : intersectSphere
-* : ཻλ
-* :
-* -- d: ӵķ
-* -- r: 뾶
+* 函数: intersectSphere
+* 功能: 返回视线与球相交的位置
+* 参数:
+* -- d: 视点出发的方向
+* -- r: 球半径
 */
 Hit intersectSphere(vec3 d, float r) {
 	Hit hit = Hit(0, 0.f, 0.f);
@@ -65,8 +74,8 @@ struct SliceOnSphere {
 	vec3 dir;
 };
 /*
-* : computeSliceOnSphere
-* : صռе
+* 函数: computeSliceOnSphere
+* 功能: 返回地球空间中的切面
 */
 SliceOnSphere computeSliceOnSphere() {
 	SliceOnSphere ret;
@@ -85,11 +94,11 @@ SliceOnSphere computeSliceOnSphere() {
 }
 
 /*
-* : intersectSlice
-* : ཻλ
-* :
-* -- e2pDir: ӵָpķ
-* -- slice: ռе
+* 函数: intersectSlice
+* 功能: 返回视线与切面相交的位置
+* 参数:
+* -- e2pDir: 视点指向p的方向
+* -- slice: 地球空间中的切面
 */
 Hit intersectSlice(vec3 e2pDir, SliceOnSphere slice) {
 	Hit hit = Hit(0, 0.f, 0.f);
@@ -116,7 +125,7 @@ void main() {
 	float lat = atan(pos.z / r);
 	r = length(pos);
 	float lon = atan(pos.y, pos.x);
-	// жһ㣨λã
+	// 判断视线与外球第一个交点（即进入体的位置）所在象限
 	int entryOutOfRng = 0;
 	if (lat < minLatitute)
 		entryOutOfRng |= 1;
@@ -130,12 +139,12 @@ void main() {
 	hit = intersectSphere(d, minHeight);
 	if (hit.isHit != 0)
 		tExit = hit.tEntry;
-	// ж뿪λ
+	// 判断视线离开体的位置所在象限
 	pos = eyePos + tExit * d;
 	r = sqrt(pos.x * pos.x + pos.y * pos.y);
 	lat = atan(pos.z / r);
 	lon = atan(pos.y, pos.x);
-	// λþڷΧڣͬҪ
+	// 若两个位置均不在范围内，且所在象限相同，则不需要计算该视线
 	if ((entryOutOfRng & 1) != 0 && lat < minLatitute)
 		discard;
 	if ((entryOutOfRng & 2) != 0 && lat > maxLatitute)
@@ -148,7 +157,7 @@ void main() {
 	float hDlt = maxHeight - minHeight;
 	float latDlt = maxLatitute - minLatitute;
 	float lonDlt = maxLongtitute - minLongtitute;
-	// 
+	// 处理切面
 	SliceOnSphere slice;
 	if (useSlice != 0) {
 		slice = computeSliceOnSphere();
@@ -173,14 +182,14 @@ void main() {
 					if (lon < .5f) lon += .5f;
 					else lon -= .5f;
 
-				float scalar = texture(volTex, vec3(lon, lat, r)).r;
+				float scalar = sampleVolume(vec3(lon, lat, r));
 				gl_FragColor = texture(tfTex, scalar);
 				gl_FragColor.a = 1.f;
 				return;
 			}
 		}
 	}
-	// ִйߴ㷨
+	// 执行光线传播算法
 	vec4 color = vec4(0, 0, 0, 0);
 	float tAcc = 0.f;
 	float prevScalar = -1.f;
@@ -207,11 +216,11 @@ void main() {
 			vec4 tfCol;
 			vec3 samplePos = vec3(lon, lat, r);
 			if (usePreIntTF == 0) {
-				float scalar = texture(volTex, samplePos).r;
+				float scalar = sampleVolume(samplePos);
 				tfCol = texture(tfTex, scalar);
 			}
 			else {
-				float scalar = texture(volTex, samplePos).r;
+				float scalar = sampleVolume(samplePos);
 				if (prevScalar < 0.f) prevScalar = scalar;
 				tfCol = texture(tfTexPreInt, vec2(prevScalar, scalar));
 				prevScalar = scalar;
@@ -219,9 +228,9 @@ void main() {
 
 			if (useShading != 0 && tfCol.a > 0.f) {
 				vec3 N;
-				N.x = texture(volTex, samplePos + vec3(dSamplePos.x, 0, 0)).r - texture(volTex, samplePos - vec3(dSamplePos.x, 0, 0)).r;
-				N.y = texture(volTex, samplePos + vec3(0, dSamplePos.y, 0)).r - texture(volTex, samplePos - vec3(0, dSamplePos.y, 0)).r;
-				N.z = texture(volTex, samplePos + vec3(0, 0, dSamplePos.z)).r - texture(volTex, samplePos - vec3(0, 0, dSamplePos.z)).r;
+				N.x = sampleVolume(samplePos + vec3(dSamplePos.x, 0, 0)) - sampleVolume(samplePos - vec3(dSamplePos.x, 0, 0));
+				N.y = sampleVolume(samplePos + vec3(0, dSamplePos.y, 0)) - sampleVolume(samplePos - vec3(0, dSamplePos.y, 0));
+				N.z = sampleVolume(samplePos + vec3(0, 0, dSamplePos.z)) - sampleVolume(samplePos - vec3(0, 0, dSamplePos.z));
 				N = rotMat * normalize(N);
 				if (dot(N, d) > 0) N = -N;
 
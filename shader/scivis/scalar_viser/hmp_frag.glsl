@@ -1,6 +1,7 @@
 #version 130
 
 uniform sampler3D volTex;
+uniform vec3 volTexScale;
 uniform sampler1D colTblTex;
 uniform float minLatitute;
 uniform float maxLatitute;
@@ -31,7 +32,7 @@ void main() {
         if (lon < .5f) lon += .5f;
         else lon -= .5f;
 
-    float scalar = texture(volTex, vec3(lon, lat, r)).r;
+    float scalar = texture(volTex, vec3(lon, lat, r) * volTexScale).r;
     vec4 col = texture(colTblTex, scalar);
     gl_FragColor.rgb = col.rgb;
     gl_FragColor.a = .5f;
@@ -4,8 +4,10 @@
 #define PI (3.14159f)
 
 uniform sampler3D volTex0;
+uniform vec3 volTexScale0;
 uniform sampler2D tfTexPreInt0;
 uniform sampler3D volTex1;
+uniform vec3 volTexScale1;
 uniform sampler2D tfTexPreInt1;
 uniform vec3 eyePos;
 uniform vec2 longtitudeRange;
@@ -23,11 +25,11 @@ struct Hit {
 	float tExit;
 };
 /*
-* : intersectSphere
-* : ཻλ
-* :
-* -- d: ӵķ
-* -- r: 뾶
+* 函数: intersectSphere
+* 功能: 返回视线与球相交的位置
+* 参数:
+* -- d: 视点出发的方向
+* -- r: 球半径
 */
 Hit intersectSphere(vec3 d, float r) {
 	Hit hit = Hit(0, 0.f, 0.f);
@@ -59,7 +61,7 @@ void main() {
 	float lat = atan(pos.z / r);
 	r = length(pos);
 	float lon = atan(pos.y, pos.x);
-	// жһ㣨λã
+	// 判断视线与外球第一个交点（即进入体的位置）所在象限
 	int entryOutOfRng = 0;
 	if (lat < latitudeRange[0])
 		entryOutOfRng |= 1;
@@ -73,12 +75,12 @@ void main() {
 	hit = intersectSphere(d, heightRange[0]);
 	if (hit.isHit != 0)
 		tExit = hit.tEntry;
-	// ж뿪λ
+	// 判断视线离开体的位置所在象限
 	pos = eyePos + tExit * d;
 	r = sqrt(pos.x * pos.x + pos.y * pos.y);
 	lat = atan(pos.z / r);
 	lon = atan(pos.y, pos.x);
-	// λþڷΧڣͬҪ
+	// 若两个位置均不在范围内，且所在象限相同，则不需要计算该视线
 	if ((entryOutOfRng & 1) != 0 && lat < latitudeRange[0])
 		discard;
 	if ((entryOutOfRng & 2) != 0 && lat > latitudeRange[1])
@@ -88,7 +90,7 @@ void main() {
 	if ((entryOutOfRng & 8) != 0 && lon > longtitudeRange[1])
 		discard;
 
-	// ִйߴ㷨
+	// 执行光线传播算法
 	float hDlt = heightRange[1] - heightRange[0];
 	float latDlt = latitudeRange[1] - latitudeRange[0];
 	float lonDlt = longtitudeRange[1] - longtitudeRange[0];
@@ -116,12 +118,12 @@ void main() {
 				else lon -= .5f;
 
 			vec3 samplePos = vec3(lon, lat, r);
-			float scalar = texture(volTex0, samplePos).r;
+			float scalar = texture(volTex0, samplePos * volTexScale0).r;
 			if (prevScalar0 < 0.f) prevScalar0 = scalar;
 			vec4 tfCol0 = texture(tfTexPreInt0, vec2(prevScalar0, scalar));
 			prevScalar0 = scalar;
 
-			scalar = texture(volTex1, samplePos).r;
+			scalar = texture(volTex1, samplePos * volTexScale1).r;
 			if (prevScalar1 < 0.f) prevScalar1 = scalar;
 			vec4 tfCol1 = texture(tfTexPreInt1, vec2(prevScalar1, scalar));
 			prevScalar1 = scalar;
@@ -5,6 +5,7 @@
 #define PI (3.14159f)
 
 uniform sampler3D volTex;
+uniform vec3 volTexScale;
 uniform vec3 eyePos;
 uniform float dt;
 uniform float minLatitute;
@@ -20,17 +21,25 @@ uniform int volStartFromZeroLon;
 
 varying vec3 vertex;
 
+/*
+* 函数: sampleVolume
+* 功能: 以体的归一化坐标采样体纹理
+*/
+float sampleVolume(vec3 pos) {
+	return texture(volTex, pos * volTexScale).r;
+}
+
 struct Hit {
 	int isHit;
 	float tEntry;
 	float tExit;
 };
 /*
-* : intersectSphere
-* : ཻλ
-* :
-* -- d: ӵķ
-* -- r: 뾶
+* 函数: intersectSphere
+* 功能: 返回视线与球相交的位置
+* 参数:
+* -- d: 视点出发的方向
+* -- r: 球半径
 */
 Hit intersectSphere(vec3 d, float r) {
 	Hit hit = Hit(0, 0.f, 0.f);
@@ -62,7 +71,7 @@ void main() {
 	float lat = atan(pos.z / r);
 	r = length(pos);
 	float lon = atan(pos.y, pos.x);
-	// жһ㣨λã
+	// 判断视线与外球第一个交点（即进入体的位置）所在象限
 	int entryOutOfRng = 0;
 	if (lat < minLatitute)
 		entryOutOfRng |= 1;
@@ -76,12 +85,12 @@ void main() {
 	hit = intersectSphere(d, minHeight);
 	if (hit.isHit != 0)
 		tExit = hit.tEntry;
-	// ж뿪λ
+	// 判断视线离开体的位置所在象限
 	pos = eyePos + tExit * d;
 	r = sqrt(pos.x * pos.x + pos.y * pos.y);
 	lat = atan(pos.z / r);
 	lon = atan(pos.y, pos.x);
-	// λþڷΧڣͬҪ
+	// 若两个位置均不在范围内，且所在象限相同，则不需要计算该视线
 	if ((entryOutOfRng & 1) != 0 && lat < minLatitute)
 		discard;
 	if ((entryOutOfRng & 2) != 0 && lat > maxLatitute)
@@ -91,7 +100,7 @@ void main() {
 	if ((entryOutOfRng & 8) != 0 && lon > maxLongtitute)
 		discard;
 
-	// ִйߴ㷨
+	// 执行光线传播算法
 	float hDlt = maxHeight - minHeight;
 	float latDlt = maxLatitute - minLatitute;
 	float lonDlt = maxLongtitute - minLongtitute;
@@ -119,7 +128,7 @@ void main() {
 				else lon -= .5f;
 
 			vec3 samplePos = vec3(lon, lat, r);
-			float scalar = texture(volTex, samplePos).r;
+			float scalar = sampleVolume(samplePos);
 
 			if (prevScalar < 0.f) {
 				prevScalar = scalar;
@@ -0,0 +1,195 @@
+#version 130
+
+#define SkipAlpha (.95f)
+#define PI (3.14159f)
+
+uniform sampler3D poolTex;
+uniform sampler3D pageTex;
+uniform sampler1D tfTex;
+uniform sampler2D tfTexPreInt;
+uniform vec3 voxPerVol;
+uniform vec3 brickPerVol;
+uniform vec3 poolVoxPerTex;
+uniform float brickLen;
+uniform vec3 eyePos;
+uniform vec3 lightPos;
+uniform vec3 dSamplePos;
+uniform mat3 rotMat;
+uniform float dt;
+uniform float minLatitute;
+uniform float maxLatitute;
+uniform float minLongtitute;
+uniform float maxLongtitute;
+uniform float minHeight;
+uniform float maxHeight;
+uniform float ka;
+uniform float kd;
+uniform float ks;
+uniform float shininess;
+uniform int maxStepCnt;
+uniform int useShading;
+uniform int usePreIntTF;
+
+varying vec3 vertex;
+
+/*
+* 函数: sampleVolume
+* 功能: 以体的归一化坐标采样。先由间接表查得覆盖该处的块所在的槽位与级别，再在块池中三线性插值。
+*       块在槽位中带有1个体素的边框，插值不会越过槽位。该处不含有效体素时返回-1
+*/
+float sampleVolume(vec3 pos) {
+	vec3 vox = clamp(pos, 0.f, 1.f) * voxPerVol;
+	ivec3 cell = min(ivec3(vox / brickLen), ivec3(brickPerVol) - 1);
+	vec4 entry = texelFetch(pageTex, cell, 0);
+	if (entry.w < 0.f) return -1.f;
+
+	int lod = int(entry.w);
+	vec3 local = vox / exp2(entry.w) - vec3(cell >> lod) * brickLen;
+	vec3 texel = entry.xyz * (brickLen + 2.f) + 1.f + local;
+	return texture(poolTex, texel / poolVoxPerTex).r;
+}
+
+struct Hit {
+	int isHit;
+	float tEntry;
+	float tExit;
+};
+/*
+* 函数: intersectSphere
+* 功能: 返回视线与球相交的位置
+* 参数:
+* -- d: 视点出发的方向
+* -- r: 球半径
+*/
+Hit intersectSphere(vec3 d, float r) {
+	Hit hit = Hit(0, 0.f, 0.f);
+
+	float tVert = -dot(eyePos, d);
+	vec3 pVert = eyePos + tVert * d;
+
+	float r2 = r * r;
+	float pVert2 = pVert.x * pVert.x + pVert.y * pVert.y + pVert.z * pVert.z;
+	if (pVert2 >= r2) return hit;
+	float l = sqrt(r2 - pVert2);
+
+	hit.isHit = 1;
+	hit.tEntry = tVert - l;
+	hit.tExit = tVert + l;
+	return hit;
+}
+
+void main() {
+	vec3 d = normalize(vertex - eyePos);
+	Hit hit = intersectSphere(d, maxHeight);
+	if (hit.isHit == 0)
+		discard;
+	float tEntry = hit.tEntry;
+	vec3 outerX = eyePos + tEntry * d;
+
+	vec3 pos = outerX;
+	float r = sqrt(pos.x * pos.x + pos.y * pos.y);
+	float lat = atan(pos.z / r);
+	r = length(pos);
+	float lon = atan(pos.y, pos.x);
+	// 判断视线与外球第一个交点（即进入体的位置）所在象限
+	int entryOutOfRng = 0;
+	if (lat < minLatitute)
+		entryOutOfRng |= 1;
+	if (lat > maxLatitute)
+		entryOutOfRng |= 2;
+	if (lon < minLongtitute)
+		entryOutOfRng |= 4;
+	if (lon > maxLongtitute)
+		entryOutOfRng |= 8;
+	float tExit = hit.tExit;
+	hit = intersectSphere(d, minHeight);
+	if (hit.isHit != 0)
+		tExit = hit.tEntry;
+	// 判断视线离开体的位置所在象限
+	pos = eyePos + tExit * d;
+	r = sqrt(pos.x * pos.x + pos.y * pos.y);
+	lat = atan(pos.z / r);
+	lon = atan(pos.y, pos.x);
+	// 若两个位置均不在范围内，且所在象限相同，则不需要计算该视线
+	if ((entryOutOfRng & 1) != 0 && lat < minLatitute)
+		discard;
+	if ((entryOutOfRng & 2) != 0 && lat > maxLatitute)
+		discard;
+	if ((entryOutOfRng & 4) != 0 && lon < minLongtitute)
+		discard;
+	if ((entryOutOfRng & 8) != 0 && lon > maxLongtitute)
+		discard;
+
+	float hDlt = maxHeight - minHeight;
+	float latDlt = maxLatitute - minLatitute;
+	float lonDlt = maxLongtitute - minLongtitute;
+	// 执行光线传播算法
+	vec4 color = vec4(0, 0, 0, 0);
+	float tAcc = 0.f;
+	float prevScalar = -1.f;
+	int stepCnt = 0;
+	pos = outerX;
+	tExit -= tEntry;
+	do {
+		r = sqrt(pos.x * pos.x + pos.y * pos.y);
+		lat = atan(pos.z / r);
+		r = length(pos);
+		lon = atan(pos.y, pos.x);
+
+		if (lat < minLatitute || lat > maxLatitute || lon < minLongtitute || lon > maxLongtitute) {}
+		else {
+			r = (r - minHeight) / hDlt;
+			lat = (lat - minLatitute) / latDlt;
+			lon = (lon - minLongtitute) / lonDlt;
+
+			vec3 samplePos = vec3(lon, lat, r);
+			float scalar = sampleVolume(samplePos);
+			// 不含有效体素的块视为透明
+			if (scalar < 0.f)
+				prevScalar = -1.f;
+			else {
+				vec4 tfCol;
+				if (usePreIntTF == 0)
+					tfCol = texture(tfTex, scalar);
+				else {
+					if (prevScalar < 0.f) prevScalar = scalar;
+					tfCol = texture(tfTexPreInt, vec2(prevScalar, scalar));
+					prevScalar = scalar;
+				}
+
+				if (useShading != 0 && tfCol.a > 0.f) {
+					vec3 N;
+					N.x = max(sampleVolume(samplePos + vec3(dSamplePos.x, 0, 0)), 0.f) - max(sampleVolume(samplePos - vec3(dSamplePos.x, 0, 0)), 0.f);
+					N.y = max(sampleVolume(samplePos + vec3(0, dSamplePos.y, 0)), 0.f) - max(sampleVolume(samplePos - vec3(0, dSamplePos.y, 0)), 0.f);
+					N.z = max(sampleVolume(samplePos + vec3(0, 0, dSamplePos.z)), 0.f) - max(sampleVolume(samplePos - vec3(0, 0, dSamplePos.z)), 0.f);
+					N = rotMat * normalize(N);
+					if (dot(N, d) > 0) N = -N;
+
+					vec3 p2l = normalize(lightPos - pos);
+					vec3 hfDir = normalize(-d + p2l);
+
+					float ambient = ka;
+					float diffuse = kd * max(0, dot(N, p2l));
+					float specular = ks * pow(max(0, dot(N, hfDir)), shininess);
+					tfCol.rgb = (ambient + diffuse + specular) * tfCol.rgb;
+				}
+
+				if (tfCol.a > 0.f) {
+					if (usePreIntTF == 0)
+						color.rgb = color.rgb + (1.f - color.a) * tfCol.a * tfCol.rgb;
+					else
+						color.rgb = color.rgb + (1.f - color.a) * tfCol.rgb;
+					color.a = color.a + (1.f - color.a) * tfCol.a;
+					if (color.a > SkipAlpha)
+						break;
+				}
+			}
+		}
+
+		pos += dt * d;
+		tAcc += dt;
+		++stepCnt;
+	} while (tAcc < tExit && stepCnt <= maxStepCnt);
+
+	gl_FragColor = color;
+}